@@ -0,0 +1,144 @@
+#include "database/btree_index.hpp"
+#include "database/schema.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <shared_mutex>
+#include <vector>
+
+namespace {
+
+constexpr int64_t RECORDS = 1000000;
+
+/**
+ * @brief ZipfianGenerator - YCSB's scrambled Zipfian key chooser (theta 0.99)
+ *
+ * Draws ranks as in Gray et al., "Quickly Generating Billion-Record
+ * Synthetic Databases", then hashes them so the hot keys are spread over
+ * the key space instead of sitting in the same few leaves.
+ */
+class ZipfianGenerator {
+public:
+  explicit ZipfianGenerator(uint64_t items) : items_(items) {
+    for (uint64_t i = 1; i <= items; ++i) {
+      zeta_n_ += 1.0 / std::pow(static_cast<double>(i), THETA);
+    }
+    double zeta_2 = 1.0 + 1.0 / std::pow(2.0, THETA);
+    alpha_ = 1.0 / (1.0 - THETA);
+    eta_ = (1.0 - std::pow(2.0 / static_cast<double>(items), 1.0 - THETA)) / (1.0 - zeta_2 / zeta_n_);
+  }
+
+  [[nodiscard]] int64_t next(std::mt19937_64& rng) const {
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    double uz = u * zeta_n_;
+    uint64_t rank;
+    if (uz < 1.0) {
+      rank = 0;
+    } else if (uz < 1.0 + std::pow(0.5, THETA)) {
+      rank = 1;
+    } else {
+      rank = static_cast<uint64_t>(static_cast<double>(items_) * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+    }
+    // FNV-1a of the rank, as YCSB's ScrambledZipfianGenerator does
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (int shift = 0; shift < 64; shift += 8) {
+      hash = (hash ^ ((rank >> shift) & 0xFF)) * 0x100000001B3ULL;
+    }
+    return static_cast<int64_t>(hash % items_);
+  }
+
+private:
+  static constexpr double THETA = 0.99;
+
+  uint64_t items_;
+  double zeta_n_ = 0.0;
+  double alpha_ = 0.0;
+  double eta_ = 0.0;
+};
+
+database::Schema* schema = nullptr;
+database::BTreeIndex* index = nullptr;
+ZipfianGenerator* keys = nullptr;
+std::shared_mutex* index_latch = nullptr;
+
+void createIndex(const benchmark::State&) {
+  schema = new database::Schema();
+  schema->addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  index = database::BTreeIndex::createPrimaryKey(*schema).release();
+  for (int64_t id = 0; id < RECORDS; ++id) {
+    std::vector<database::Value> key = { database::Value{ id } };
+    index->insert(key, { static_cast<database::PageId>(id + 1), 0 });
+  }
+  keys = new ZipfianGenerator(RECORDS);
+  index_latch = new std::shared_mutex();
+}
+
+void destroyIndex(const benchmark::State&) {
+  delete index_latch;
+  delete keys;
+  delete index;
+  delete schema;
+}
+
+/**
+ * @brief Run a YCSB-style mix of point lookups and updates over Zipfian keys
+ *
+ * An update moves a key's entry to a new TupleId, as a non-HOT row update
+ * does: a remove and an insert, both writing to the key's leaf.
+ */
+template <bool LATCHED>
+void runWorkload(benchmark::State& state) {
+  int64_t read_percent = state.range(0);
+  std::mt19937_64 rng(static_cast<uint64_t>(state.thread_index()) + 1);
+  std::vector<database::Value> key(1);
+  auto new_slot = static_cast<uint16_t>(state.thread_index() + 1);
+
+  for (auto _ : state) {
+    key[0] = keys->next(rng);
+    if (static_cast<int64_t>(rng() % 100) < read_percent) {
+      std::shared_lock<std::shared_mutex> latch = LATCHED ? std::shared_lock<std::shared_mutex>(*index_latch)
+                                                          : std::shared_lock<std::shared_mutex>();
+      benchmark::DoNotOptimize(index->find(key));
+    } else {
+      std::unique_lock<std::shared_mutex> latch = LATCHED ? std::unique_lock<std::shared_mutex>(*index_latch)
+                                                          : std::unique_lock<std::shared_mutex>();
+      if (auto tuple_id = index->find(key)) {
+        index->remove(key, *tuple_id);
+        index->insert(key, { tuple_id->first, new_slot });
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Optimistic lock coupling: readers write nothing shared
+void BM_YcsbOptimistic(benchmark::State& state) {
+  runWorkload<false>(state);
+}
+BENCHMARK(BM_YcsbOptimistic)
+    ->Setup(createIndex)
+    ->Teardown(destroyIndex)
+    ->ArgName("read_percent")
+    ->Arg(100)  // Workload C
+    ->Arg(95)   // Workload B
+    ->Arg(50)   // Workload A
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+// Baseline: one reader-writer latch over the index, whose lock word every reader writes
+void BM_YcsbSharedLatch(benchmark::State& state) {
+  runWorkload<true>(state);
+}
+BENCHMARK(BM_YcsbSharedLatch)
+    ->Setup(createIndex)
+    ->Teardown(destroyIndex)
+    ->ArgName("read_percent")
+    ->Arg(100)
+    ->Arg(95)
+    ->Arg(50)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,111 @@
+#include "database/btree_index.hpp"
+#include "database/heap_file.hpp"
+#include "database/heap_scan.hpp"
+#include "database/schema.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Table - a heap file of rows with primary keys 0 .. rows - 1 and their index
+ */
+struct Table {
+  database::Schema schema;
+  std::unique_ptr<database::HeapFile> heap_file;
+  std::unique_ptr<database::BTreeIndex> index;
+};
+
+// Loading 100M rows takes minutes, so the table is loaded once for all benchmarks of a size
+Table& getTable(int64_t rows) {
+  static std::unique_ptr<Table> table;
+  static int64_t loaded_rows = 0;
+  if (!table || loaded_rows != rows) {
+    table.reset();  // One table in memory at a time
+    table = std::make_unique<Table>();
+    table->schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+    table->schema.addColumn(database::Column(1, "amount", database::DataType::DOUBLE, false, false));
+    table->heap_file = std::make_unique<database::HeapFile>(1, table->schema);
+    table->index = database::BTreeIndex::createPrimaryKey(table->schema);
+    for (int64_t id = 0; id < rows; ++id) {
+      std::vector<database::Value> values = { database::Value{ id }, database::Value{ static_cast<double>(id) * 0.5 } };
+      auto tuple_id = table->heap_file->insertTuple(database::Tuple(table->schema, values, 1), 1);
+      table->index->insert(std::span<const database::Value>(values.data(), 1), *tuple_id);
+    }
+    loaded_rows = rows;
+  }
+  return *table;
+}
+
+// Find a random row by primary key through the index
+void BM_IndexPointLookup(benchmark::State& state) {
+  Table& table = getTable(state.range(0));
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<int64_t> ids(0, state.range(0) - 1);
+  std::vector<database::Value> key(1);
+
+  for (auto _ : state) {
+    key[0] = ids(rng);
+    auto tuple_id = table.index->find(key);
+    auto tuple = table.heap_file->getTuple(*tuple_id);
+    benchmark::DoNotOptimize(tuple->getDouble(1));
+  }
+  state.counters["height"] = static_cast<double>(table.index->getHeight());
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Find a random row by primary key by scanning the heap file until it turns up
+void BM_FullScanPointLookup(benchmark::State& state) {
+  Table& table = getTable(state.range(0));
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<int64_t> ids(0, state.range(0) - 1);
+
+  for (auto _ : state) {
+    int64_t id = ids(rng);
+    database::HeapScan scan(*table.heap_file);
+    while (auto scanned = scan.next()) {
+      if (scanned->tuple.getInteger(0) == id) {
+        benchmark::DoNotOptimize(scanned->tuple.getDouble(1));
+        break;
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// A range of 100 consecutive keys through the index
+void BM_IndexRangeScan(benchmark::State& state) {
+  Table& table = getTable(state.range(0));
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<int64_t> ids(0, state.range(0) - 101);
+  std::vector<database::Value> lower(1);
+  std::vector<database::Value> upper(1);
+
+  for (auto _ : state) {
+    int64_t id = ids(rng);
+    lower[0] = id;
+    upper[0] = id + 99;
+    size_t count = table.index->scan(lower, true, upper, true, [](const database::TupleId&) { return true; });
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * 100);
+}
+
+void rowCounts(benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(1000000);
+  // 100M rows need about 8 GB of memory, so that size is opt-in
+  if (std::getenv("DATABASE_BENCHMARK_100M")) {
+    benchmark->Arg(100000000);
+  }
+}
+
+BENCHMARK(BM_IndexPointLookup)->Apply(rowCounts);
+BENCHMARK(BM_FullScanPointLookup)->Apply(rowCounts)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_IndexRangeScan)->Apply(rowCounts);
+
+}  // namespace
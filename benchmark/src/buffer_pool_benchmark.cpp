@@ -0,0 +1,63 @@
+#include "database/buffer_pool.hpp"
+#include "database/heap_file.hpp"
+#include "database/schema.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t POOL_FRAMES = 256;
+
+void makeSchema(database::Schema& schema) {
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+}
+
+// Random point lookups over a working set of state.range(0) pages, against
+// a pool of POOL_FRAMES frames. Working sets that fit are served from memory;
+// larger ones pay a pread per miss (from the page cache, not the device).
+void BM_PointLookupWorkingSet(benchmark::State& state) {
+  database::Schema schema;
+  makeSchema(schema);
+  std::string path = "buffer_pool_benchmark.heap";
+  std::remove(path.c_str());
+  std::remove((path + ".fsm").c_str());
+
+  database::BufferPool pool(POOL_FRAMES);
+  auto heap_file = database::HeapFile::open(1, schema, pool, path);
+  auto working_set_pages = static_cast<database::PageId>(state.range(0));
+
+  std::vector<database::TupleId> tuple_ids;
+  for (int64_t i = 0; heap_file->getPageCount() <= working_set_pages; ++i) {
+    database::Tuple tuple(schema, {database::Value{i}, database::Value{"name-" + std::to_string(i)}}, 1);
+    auto tuple_id = heap_file->insertTuple(tuple, 1);
+    if (tuple_id->first <= working_set_pages) {
+      tuple_ids.push_back(*tuple_id);
+    }
+  }
+  heap_file->flush();
+
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<size_t> pick(0, tuple_ids.size() - 1);
+  pool.resetStats();
+  for (auto _ : state) {
+    auto tuple = heap_file->getTuple(tuple_ids[pick(rng)]);
+    benchmark::DoNotOptimize(tuple->getInteger(0));
+  }
+
+  auto stats = pool.getStats();
+  state.counters["hit_rate"] = stats.getHitRate();
+  state.counters["evictions"] = static_cast<double>(stats.evictions);
+  state.SetItemsProcessed(state.iterations());
+
+  heap_file.reset();
+  std::remove(path.c_str());
+  std::remove((path + ".fsm").c_str());
+}
+BENCHMARK(BM_PointLookupWorkingSet)->Arg(POOL_FRAMES / 2)->Arg(POOL_FRAMES * 4)->Arg(POOL_FRAMES * 16);
+
+}  // namespace
@@ -0,0 +1,71 @@
+#include "database/bulk_loader.hpp"
+#include "database/heap_file.hpp"
+#include "database/schema.hpp"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+void makeSchema(database::Schema& schema) {
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  schema.addColumn(database::Column(2, "score", database::DataType::DOUBLE, true, false));
+}
+
+std::string makeCsv(int64_t rows) {
+  std::string csv;
+  for (int64_t i = 0; i < rows; ++i) {
+    csv += std::to_string(i) + ",name-" + std::to_string(i) + "," + std::to_string(i) + ".25\n";
+  }
+  return csv;
+}
+
+// Baseline: parse each line into Values and insert row by row
+void BM_CsvInsertRowByRow(benchmark::State& state) {
+  database::Schema schema;
+  makeSchema(schema);
+  std::string csv = makeCsv(state.range(0));
+
+  for (auto _ : state) {
+    database::HeapFile heap_file(1, schema);
+    size_t pos = 0;
+    while (pos < csv.size()) {
+      size_t end = csv.find('\n', pos);
+      std::string line = csv.substr(pos, end - pos);
+      pos = end + 1;
+      size_t first = line.find(',');
+      size_t second = line.find(',', first + 1);
+      database::Tuple tuple(schema,
+                            {database::Value{std::stoll(line.substr(0, first))},
+                             database::Value{line.substr(first + 1, second - first - 1)},
+                             database::Value{std::stod(line.substr(second + 1))}},
+                            1);
+      benchmark::DoNotOptimize(heap_file.insertTuple(tuple, 1));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(csv.size()));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CsvInsertRowByRow)->Arg(200000)->Unit(benchmark::kMillisecond);
+
+void BM_CsvBulkLoad(benchmark::State& state) {
+  database::Schema schema;
+  makeSchema(schema);
+  std::string csv = makeCsv(state.range(0));
+  database::BulkLoadOptions options;
+  options.thread_count = static_cast<size_t>(state.range(1));
+  options.min_chunk_size = 64 * 1024;
+
+  for (auto _ : state) {
+    database::HeapFile heap_file(1, schema);
+    database::BulkLoader loader(heap_file, options);
+    benchmark::DoNotOptimize(loader.loadCsvData(csv, 1));
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(csv.size()));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CsvBulkLoad)->Args({200000, 1})->Args({200000, 4})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,101 @@
+#include "database/catalog.hpp"
+#include "database/schema.hpp"
+#include "database/storage_manager.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* DATA_DIRECTORY = "catalog_benchmark_data";
+
+void removeDataDirectory() {
+  std::filesystem::remove_all(DATA_DIRECTORY);
+}
+
+std::string tableName(int64_t i) {
+  return "table_" + std::to_string(i);
+}
+
+database::Schema tableSchema() {
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  schema.addColumn(database::Column(2, "score", database::DataType::DOUBLE, true, false));
+  return schema;
+}
+
+// A data directory with the given number of empty tables, built once per size
+std::string buildDataDirectory(int64_t tables) {
+  static std::map<int64_t, std::string> built;
+  auto it = built.find(tables);
+  if (it != built.end()) {
+    return it->second;
+  }
+  if (built.empty()) {
+    removeDataDirectory();
+    std::atexit(removeDataDirectory);
+  }
+
+  std::string directory = std::string(DATA_DIRECTORY) + "/" + std::to_string(tables);
+  std::filesystem::create_directories(directory);
+  database::StorageManager storage(directory, database::StorageOptions{});
+  database::Schema schema = tableSchema();
+  for (int64_t i = 0; i < tables; ++i) {
+    storage.createTable(tableName(i), schema);
+  }
+  return built.emplace(tables, directory).first->second;
+}
+
+// Time to read the catalog: entries only, schemas stay on disk
+void BM_OpenCatalog(benchmark::State& state) {
+  std::string directory = buildDataDirectory(state.range(0));
+  for (auto _ : state) {
+    auto catalog = database::Catalog::open(directory + "/catalog");
+    benchmark::DoNotOptimize(catalog.get());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_OpenCatalog)->Arg(64)->Arg(1024)->Arg(4096);
+
+// Time from opening a data directory to reading one table's heap file,
+// which is all that is opened
+void BM_OpenStorageAndFirstTable(benchmark::State& state) {
+  std::string directory = buildDataDirectory(state.range(0));
+  database::StorageOptions options;
+  options.buffer_pool_frames = 64;
+  for (auto _ : state) {
+    database::StorageManager storage(directory, options);
+    auto* table = storage.getTable(tableName(state.range(0) / 2));
+    benchmark::DoNotOptimize(table->getPageCount());
+  }
+}
+BENCHMARK(BM_OpenStorageAndFirstTable)->Arg(64)->Arg(1024)->Arg(4096)->Unit(benchmark::kMicrosecond);
+
+// Name lookups of open tables
+void BM_GetTableByName(benchmark::State& state) {
+  std::string directory = buildDataDirectory(state.range(0));
+  database::StorageOptions options;
+  options.buffer_pool_frames = 64;
+  database::StorageManager storage(directory, options);
+
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<int64_t> pick(0, 63);
+  std::vector<std::string> names;
+  for (int64_t i = 0; i < 64; ++i) {
+    names.push_back(tableName(i * state.range(0) / 64));
+    storage.getTable(names.back());
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(storage.getTable(names[static_cast<size_t>(pick(rng))]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetTableByName)->Arg(64)->Arg(4096);
+
+}  // namespace
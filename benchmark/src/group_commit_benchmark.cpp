@@ -0,0 +1,45 @@
+#include "database/write_ahead_log.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace {
+
+constexpr char LOG_PATH[] = "group_commit_benchmark.log";
+
+std::unique_ptr<database::WriteAheadLog> wal;
+
+// Each thread runs small transactions: one insert record plus a commit that
+// waits for durability. Compare syncs_per_commit across thread counts: with
+// group commit it falls as committers share each fdatasync.
+void BM_DurableCommit(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    std::remove(LOG_PATH);
+    database::WalOptions options;
+    options.group_commit_delay = std::chrono::microseconds(state.range(0));
+    options.group_commit_size = static_cast<size_t>(state.threads());
+    wal = database::WriteAheadLog::open(LOG_PATH, options);
+  }
+
+  std::string payload(100, 'x');
+  auto payload_bytes = std::as_bytes(std::span(payload.data(), payload.size()));
+  auto txn_id = static_cast<database::TransactionId>(state.thread_index() + 1);
+  for (auto _ : state) {
+    wal->append(database::WalRecordType::INSERT, txn_id, 1, std::make_pair(1, 0), payload_bytes);
+    database::Lsn lsn = wal->append(database::WalRecordType::COMMIT, txn_id, 0, std::make_pair(0, 0));
+    benchmark::DoNotOptimize(wal->flush(lsn));
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index() == 0) {
+    auto commits = static_cast<double>(state.iterations()) * state.threads();
+    state.counters["syncs_per_commit"] = static_cast<double>(wal->getSyncCount()) / commits;
+    wal.reset();
+    std::remove(LOG_PATH);
+  }
+}
+BENCHMARK(BM_DurableCommit)->Arg(0)->Arg(200)->ThreadRange(1, 16)->UseRealTime();
+
+}  // namespace
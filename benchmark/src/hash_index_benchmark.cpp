@@ -0,0 +1,90 @@
+#include "database/btree_index.hpp"
+#include "database/hash_index.hpp"
+#include "database/schema.hpp"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr int64_t KEYS = 1000000;
+
+/**
+ * @brief Indexes - both index kinds over the integer keys 0 .. KEYS - 1
+ */
+struct Indexes {
+  database::Schema schema;
+  std::unique_ptr<database::HashIndex> hash_index;
+  std::unique_ptr<database::BTreeIndex> btree_index;
+};
+
+Indexes& getIndexes() {
+  static std::unique_ptr<Indexes> indexes;
+  if (!indexes) {
+    indexes = std::make_unique<Indexes>();
+    indexes->schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+    indexes->hash_index = database::HashIndex::create(indexes->schema, 0);
+    indexes->btree_index = database::BTreeIndex::createPrimaryKey(indexes->schema);
+    for (int64_t id = 0; id < KEYS; ++id) {
+      database::TupleId tuple_id(static_cast<database::PageId>(id / 100 + 1), static_cast<uint16_t>(id % 100));
+      indexes->hash_index->insert(database::Value{ id }, tuple_id);
+      std::vector<database::Value> key = { database::Value{ id } };
+      indexes->btree_index->insert(key, tuple_id);
+    }
+  }
+  return *indexes;
+}
+
+// Find the entry of a random key in the hash index
+void BM_HashPointLookup(benchmark::State& state) {
+  Indexes& indexes = getIndexes();
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<int64_t> ids(0, KEYS - 1);
+  std::vector<database::TupleId> tuple_ids;
+
+  for (auto _ : state) {
+    tuple_ids.clear();
+    indexes.hash_index->findCandidates(database::Value{ ids(rng) }, tuple_ids);
+    benchmark::DoNotOptimize(tuple_ids.data());
+  }
+  state.counters["overflow_fraction"] = static_cast<double>(indexes.hash_index->getOverflowBucketCount()) /
+                                        static_cast<double>(indexes.hash_index->getBucketCount());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HashPointLookup);
+
+// The same lookups in the B+tree, for comparison
+void BM_BTreePointLookup(benchmark::State& state) {
+  Indexes& indexes = getIndexes();
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<int64_t> ids(0, KEYS - 1);
+  std::vector<database::Value> key(1);
+
+  for (auto _ : state) {
+    key[0] = ids(rng);
+    benchmark::DoNotOptimize(indexes.btree_index->find(key));
+  }
+  state.counters["height"] = static_cast<double>(indexes.btree_index->getHeight());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BTreePointLookup);
+
+// Build a hash index of KEYS entries from empty, growing it as it goes
+void BM_HashInsert(benchmark::State& state) {
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+
+  for (auto _ : state) {
+    auto index = database::HashIndex::create(schema, 0);
+    for (int64_t id = 0; id < KEYS; ++id) {
+      index->insert(database::Value{ id }, { static_cast<database::PageId>(id + 1), 0 });
+    }
+    benchmark::DoNotOptimize(index->getBucketCount());
+  }
+  state.SetItemsProcessed(state.iterations() * KEYS);
+}
+BENCHMARK(BM_HashInsert)->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,53 @@
+#include "database/heap_file.hpp"
+#include "database/schema.hpp"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+void makeSchema(database::Schema& schema) {
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+}
+
+std::vector<database::Tuple> makeTuples(const database::Schema& schema, int64_t rows) {
+  std::vector<database::Tuple> tuples;
+  tuples.reserve(static_cast<size_t>(rows));
+  for (int64_t i = 0; i < rows; ++i) {
+    tuples.emplace_back(schema, std::vector<database::Value>{database::Value{i}, database::Value{"name-" + std::to_string(i)}}, 1);
+  }
+  return tuples;
+}
+
+void BM_InsertRowByRow(benchmark::State& state) {
+  database::Schema schema;
+  makeSchema(schema);
+  auto tuples = makeTuples(schema, state.range(0));
+
+  for (auto _ : state) {
+    database::HeapFile heap_file(1, schema);
+    for (const auto& tuple : tuples) {
+      benchmark::DoNotOptimize(heap_file.insertTuple(tuple, 1));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_InsertRowByRow)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+void BM_InsertBatch(benchmark::State& state) {
+  database::Schema schema;
+  makeSchema(schema);
+  auto tuples = makeTuples(schema, state.range(0));
+  std::vector<database::TupleId> tuple_ids(tuples.size());
+
+  for (auto _ : state) {
+    database::HeapFile heap_file(1, schema);
+    benchmark::DoNotOptimize(heap_file.insertBatch(tuples, tuple_ids, 1));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_InsertBatch)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+}  // namespace
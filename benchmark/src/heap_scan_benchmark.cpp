@@ -0,0 +1,114 @@
+#include "database/heap_file.hpp"
+#include "database/heap_scan.hpp"
+#include "database/schema.hpp"
+#include "database/transaction_manager.hpp"
+#include "database/visibility_checker.hpp"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+void makeSchema(database::Schema& schema) {
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "amount", database::DataType::DOUBLE, false, false));
+  schema.addColumn(database::Column(2, "name", database::DataType::TEXT, true, false));
+}
+
+void fillHeap(database::HeapFile& heap_file, const database::Schema& schema, int64_t rows) {
+  for (int64_t i = 0; i < rows; ++i) {
+    std::vector<database::Value> values = {
+      database::Value{i}, database::Value{static_cast<double>(i) * 0.5}, database::Value{"customer-" + std::to_string(i)}
+    };
+    heap_file.insertTuple(database::Tuple(schema, values, 1), 1);
+  }
+}
+
+// Sum one fixed-width column over every row; reports bytes of page memory scanned per second
+void BM_HeapScanSum(benchmark::State& state) {
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  fillHeap(heap_file, schema, state.range(0));
+
+  for (auto _ : state) {
+    database::HeapScan scan(heap_file);
+    int64_t sum = 0;
+    while (auto scanned = scan.next()) {
+      sum += scanned->tuple.getInteger(0);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(heap_file.getPageCount() * 8192));
+}
+BENCHMARK(BM_HeapScanSum)->Arg(10000)->Arg(1000000);
+
+void BM_HeapScanBatched(benchmark::State& state) {
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  fillHeap(heap_file, schema, state.range(0));
+
+  std::vector<database::ScannedTuple> batch;
+  for (auto _ : state) {
+    database::HeapScan scan(heap_file);
+    int64_t sum = 0;
+    while (scan.nextBatch(batch, 256) > 0) {
+      for (const auto& scanned : batch) {
+        sum += scanned.tuple.getInteger(0);
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(heap_file.getPageCount() * 8192));
+}
+BENCHMARK(BM_HeapScanBatched)->Arg(10000)->Arg(1000000);
+
+// Scan with a visibility check per row, over rows written by 1000
+// transactions of which every tenth aborted. Without hint bits every check
+// looks up the commit log and CSN log; with them (set by the first scan)
+// the headers decide alone.
+void BM_HeapScanVisibility(benchmark::State& state) {
+  bool hints = state.range(0) != 0;
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  database::TransactionManager txn_manager;
+  constexpr int64_t ROWS = 100000;
+  for (int64_t i = 0; i < ROWS; i += 100) {
+    auto txn_id = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+    for (int64_t row = i; row < i + 100; ++row) {
+      std::vector<database::Value> values = {
+        database::Value{row}, database::Value{static_cast<double>(row) * 0.5}, database::Value{"customer-" + std::to_string(row)}
+      };
+      heap_file.insertTuple(database::Tuple(schema, values, txn_id), txn_id);
+    }
+    if ((i / 100) % 10 == 9) {
+      txn_manager.rollbackTransaction(txn_id);
+    } else {
+      txn_manager.commitTransaction(txn_id);
+    }
+  }
+  static_cast<void>(txn_manager.getOldestActiveTransactionId());  // Publish the xmin horizon
+  database::VisibilityChecker checker(txn_manager);
+  auto snapshot = txn_manager.takeSnapshot();
+
+  for (auto _ : state) {
+    database::HeapScan scan(heap_file);
+    int64_t sum = 0;
+    while (auto scanned = scan.next()) {
+      if (checker.isVisible(scanned->tuple.getHeader(), snapshot, hints)) {
+        sum += scanned->tuple.getInteger(0);
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetLabel(hints ? "hint bits" : "status lookups");
+  state.SetItemsProcessed(state.iterations() * ROWS);
+}
+BENCHMARK(BM_HeapScanVisibility)->Arg(0)->Arg(1);
+
+}  // namespace
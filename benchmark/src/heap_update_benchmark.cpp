@@ -0,0 +1,53 @@
+#include "database/heap_file.hpp"
+#include "database/schema.hpp"
+#include "database/transaction_manager.hpp"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Each row of a 10000-row table is updated 20 times, one committed
+// transaction per update. Reports the table size at the end: without
+// pruning every version stays; with it updates reuse the space of the
+// versions no transaction can see any more.
+void BM_UpdateChurn(benchmark::State& state) {
+  bool prune = state.range(0) != 0;
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  constexpr int64_t ROWS = 10000;
+  constexpr int64_t ROUNDS = 20;
+
+  size_t pages = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    database::HeapFile heap_file(1, schema);
+    database::TransactionManager txn_manager;
+    heap_file.setTransactionManager(prune ? &txn_manager : nullptr);
+    std::vector<database::TupleId> latest;
+    latest.reserve(ROWS);
+    for (int64_t i = 0; i < ROWS; ++i) {
+      database::Tuple tuple(schema, {database::Value{i}, database::Value{"name-" + std::to_string(i)}}, 1);
+      latest.push_back(*heap_file.insertTuple(tuple, 1));
+    }
+    state.ResumeTiming();
+
+    for (int64_t round = 0; round < ROUNDS; ++round) {
+      for (auto& tuple_id : latest) {
+        auto txn_id = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+        database::Tuple tuple(schema, {database::Value{round}, database::Value{"name-" + std::to_string(round)}}, txn_id);
+        tuple_id = *heap_file.updateTuple(tuple_id, tuple, txn_id);
+        txn_manager.commitTransaction(txn_id);
+      }
+    }
+    pages = heap_file.getPageCount();
+  }
+  state.counters["pages"] = static_cast<double>(pages);
+  state.SetLabel(prune ? "pruning" : "no pruning");
+  state.SetItemsProcessed(state.iterations() * ROWS * ROUNDS);
+}
+BENCHMARK(BM_UpdateChurn)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+}  // namespace
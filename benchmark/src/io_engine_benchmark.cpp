@@ -0,0 +1,126 @@
+#include "database/buffer_pool.hpp"
+#include "database/heap_file.hpp"
+#include "database/heap_scan.hpp"
+#include "database/io_engine.hpp"
+#include "database/schema.hpp"
+#include "database/segment_file.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 8192;
+constexpr database::PageId FILE_PAGES = 4096;  // 32 MB
+constexpr size_t POOL_FRAMES = 256;
+
+const char* engineName(database::IoEngineType type) {
+  return type == database::IoEngineType::IO_URING ? "io_uring" : "pread";
+}
+
+// Random page reads straight through an engine, state.range(1) at a time.
+// The file stays in the page cache, so this measures per-request overhead
+// and how well batching amortizes it, not device queue depth.
+void BM_EngineRandomReads(benchmark::State& state) {
+  auto type = static_cast<database::IoEngineType>(state.range(0));
+  auto batch = static_cast<size_t>(state.range(1));
+  auto engine = database::IoEngine::create(type, batch);
+  if (!engine) {
+    state.SkipWithError("engine not available");
+    return;
+  }
+
+  std::string path = "io_engine_benchmark.heap";
+  std::remove(path.c_str());
+  auto segment = database::SegmentFile::open(path, PAGE_SIZE);
+  std::vector<std::byte> page(PAGE_SIZE, std::byte{1});
+  for (database::PageId page_id = 1; page_id <= FILE_PAGES; ++page_id) {
+    segment->writePage(page_id, page.data());
+  }
+
+  std::vector<std::vector<std::byte>> buffers(batch, std::vector<std::byte>(PAGE_SIZE));
+  std::vector<std::byte*> buffer_pointers;
+  for (auto& buffer : buffers) {
+    buffer_pointers.push_back(buffer.data());
+  }
+  bool registered = engine->registerBuffers(buffer_pointers, PAGE_SIZE);
+
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<database::PageId> pick(1, FILE_PAGES);
+  std::vector<database::IoCompletion> completions;
+  for (auto _ : state) {
+    for (size_t i = 0; i < batch; ++i) {
+      engine->prepare({ database::IoOperation::READ, segment.get(), pick(rng), buffer_pointers[i],
+                        registered ? static_cast<int>(i) : -1, i });
+    }
+    engine->submit();
+    completions.clear();
+    engine->reap(completions, batch);
+    benchmark::DoNotOptimize(completions.data());
+  }
+
+  state.SetLabel(std::string(engineName(engine->getType())) + (registered ? " registered" : ""));
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(batch * PAGE_SIZE));
+
+  segment.reset();
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_EngineRandomReads)
+    ->ArgsProduct({ { static_cast<int64_t>(database::IoEngineType::PREAD),
+                      static_cast<int64_t>(database::IoEngineType::IO_URING) },
+                    { 1, 8, 32, 128 } });
+
+// Full scan of a heap file much larger than the pool, with readahead
+// going through the given engine
+void BM_SequentialScanReadahead(benchmark::State& state) {
+  auto type = static_cast<database::IoEngineType>(state.range(0));
+  if (!database::IoEngine::create(type, 1)) {
+    state.SkipWithError("engine not available");
+    return;
+  }
+
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  std::string path = "io_engine_benchmark_scan.heap";
+  std::remove(path.c_str());
+  std::remove((path + ".fsm").c_str());
+
+  database::BufferPool pool(POOL_FRAMES, database::Page::DEFAULT_PAGE_SIZE, type);
+  auto heap_file = database::HeapFile::open(1, schema, pool, path);
+  for (int64_t i = 0; heap_file->getPageCount() < POOL_FRAMES * 8; ++i) {
+    database::Tuple tuple(schema, {database::Value{i}, database::Value{"name-" + std::to_string(i)}}, 1);
+    heap_file->insertTuple(tuple, 1);
+  }
+  heap_file->flush();
+
+  pool.resetStats();
+  size_t rows = 0;
+  for (auto _ : state) {
+    database::HeapScan scan(*heap_file);
+    while (auto scanned = scan.next()) {
+      benchmark::DoNotOptimize(scanned->tuple.getInteger(0));
+      ++rows;
+    }
+  }
+
+  auto stats = pool.getStats();
+  state.SetLabel(engineName(pool.getIoEngineType()));
+  state.counters["prefetched"] = static_cast<double>(stats.prefetches) / static_cast<double>(state.iterations());
+  state.counters["misses"] = static_cast<double>(stats.misses) / static_cast<double>(state.iterations());
+  state.SetItemsProcessed(static_cast<int64_t>(rows));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(heap_file->getPageCount() * PAGE_SIZE));
+
+  heap_file.reset();
+  std::remove(path.c_str());
+  std::remove((path + ".fsm").c_str());
+}
+BENCHMARK(BM_SequentialScanReadahead)
+    ->Arg(static_cast<int64_t>(database::IoEngineType::PREAD))
+    ->Arg(static_cast<int64_t>(database::IoEngineType::IO_URING));
+
+}  // namespace
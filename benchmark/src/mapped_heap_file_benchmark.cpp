@@ -0,0 +1,111 @@
+#include "database/buffer_pool.hpp"
+#include "database/heap_file.hpp"
+#include "database/heap_scan.hpp"
+#include "database/schema.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t TABLE_PAGES = 8192;  // 64 MB
+constexpr size_t POOL_FRAMES = 1024;
+const char* TABLE_PATH = "mapped_heap_file_benchmark.heap";
+
+void removeTable() {
+  std::remove(TABLE_PATH);
+  std::remove((std::string(TABLE_PATH) + ".fsm").c_str());
+}
+
+const database::Schema& tableSchema() {
+  static const database::Schema schema = [] {
+    database::Schema s;
+    s.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+    s.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+    return s;
+  }();
+  return schema;
+}
+
+// Built once and shared by every benchmark; removed at exit
+const std::vector<database::TupleId>& buildTable() {
+  static const std::vector<database::TupleId> tuple_ids = [] {
+    removeTable();
+    std::atexit(removeTable);
+    const database::Schema& schema = tableSchema();
+    database::BufferPool pool(POOL_FRAMES);
+    auto heap_file = database::HeapFile::open(1, schema, pool, TABLE_PATH);
+    std::vector<database::TupleId> ids;
+    for (int64_t i = 0; heap_file->getPageCount() < TABLE_PAGES; ++i) {
+      database::Tuple tuple(schema, {database::Value{i}, database::Value{"name-" + std::to_string(i)}}, 1);
+      ids.push_back(*heap_file->insertTuple(tuple, 1));
+    }
+    return ids;
+  }();
+  return tuple_ids;
+}
+
+std::unique_ptr<database::HeapFile> openTable(bool mapped, database::BufferPool& pool) {
+  return mapped ? database::HeapFile::openMapped(1, tableSchema(), TABLE_PATH)
+                : database::HeapFile::open(1, tableSchema(), pool, TABLE_PATH);
+}
+
+// Time to open the table. The buffered open loads the free space map (or
+// would rebuild it from every page); the mapped open touches no page.
+void BM_OpenTable(benchmark::State& state) {
+  buildTable();
+  bool mapped = state.range(0) != 0;
+  database::BufferPool pool(POOL_FRAMES);
+  for (auto _ : state) {
+    auto heap_file = openTable(mapped, pool);
+    benchmark::DoNotOptimize(heap_file.get());
+  }
+  state.SetLabel(mapped ? "mapped" : "buffer pool");
+}
+BENCHMARK(BM_OpenTable)->Arg(0)->Arg(1);
+
+// Full scan, with the file in the page cache: mapped pages are read in
+// place, buffered ones are copied into frames first
+void BM_ScanTable(benchmark::State& state) {
+  buildTable();
+  bool mapped = state.range(0) != 0;
+  database::BufferPool pool(POOL_FRAMES);
+  auto heap_file = openTable(mapped, pool);
+
+  size_t rows = 0;
+  for (auto _ : state) {
+    database::HeapScan scan(*heap_file);
+    while (auto scanned = scan.next()) {
+      benchmark::DoNotOptimize(scanned->tuple.getInteger(0));
+      ++rows;
+    }
+  }
+  state.SetLabel(mapped ? "mapped" : "buffer pool");
+  state.SetItemsProcessed(static_cast<int64_t>(rows));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(TABLE_PAGES * database::HeapFile::DEFAULT_PAGE_SIZE));
+}
+BENCHMARK(BM_ScanTable)->Arg(0)->Arg(1);
+
+// Random point lookups over the whole table, eight times the pool size
+void BM_PointLookup(benchmark::State& state) {
+  const auto& tuple_ids = buildTable();
+  bool mapped = state.range(0) != 0;
+  database::BufferPool pool(POOL_FRAMES);
+  auto heap_file = openTable(mapped, pool);
+
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<size_t> pick(0, tuple_ids.size() - 1);
+  for (auto _ : state) {
+    auto tuple = heap_file->getTuple(tuple_ids[pick(rng)]);
+    benchmark::DoNotOptimize(tuple->getInteger(0));
+  }
+  state.SetLabel(mapped ? "mapped" : "buffer pool");
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PointLookup)->Arg(0)->Arg(1);
+
+}  // namespace
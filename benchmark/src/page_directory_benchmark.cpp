@@ -0,0 +1,74 @@
+#include "database/page.hpp"
+#include "database/page_directory.hpp"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Small pages keep a 1M-page directory affordable; lookup cost does not depend on page size.
+constexpr size_t BENCH_PAGE_SIZE = 64;
+constexpr size_t LOOKUP_BATCH = 4096;
+
+std::vector<database::PageId> randomPageIds(size_t page_count) {
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<database::PageId> dist(1, page_count);
+  std::vector<database::PageId> ids(LOOKUP_BATCH);
+  for (auto& id : ids) {
+    id = dist(rng);
+  }
+  return ids;
+}
+
+std::vector<std::unique_ptr<database::Page>> makePages(size_t page_count) {
+  std::vector<std::unique_ptr<database::Page>> pages;
+  pages.reserve(page_count);
+  for (database::PageId page_id = 1; page_id <= page_count; ++page_id) {
+    pages.push_back(std::make_unique<database::Page>(page_id, BENCH_PAGE_SIZE));
+  }
+  return pages;
+}
+
+void BM_PageDirectoryLookup(benchmark::State& state) {
+  auto page_count = static_cast<size_t>(state.range(0));
+  auto pages = makePages(page_count);
+
+  database::PageDirectory directory;
+  for (const auto& page : pages) {
+    directory.set(page->getPageId(), page.get());
+  }
+
+  auto ids = randomPageIds(page_count);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(directory.get(ids[i++ & (LOOKUP_BATCH - 1)]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PageDirectoryLookup)->RangeMultiplier(10)->Range(10, 1000000);
+
+// The previous HeapFile::getPage: a linear scan comparing page IDs
+void BM_LinearScanLookup(benchmark::State& state) {
+  auto page_count = static_cast<size_t>(state.range(0));
+  auto pages = makePages(page_count);
+
+  auto ids = randomPageIds(page_count);
+  size_t i = 0;
+  for (auto _ : state) {
+    database::PageId wanted = ids[i++ & (LOOKUP_BATCH - 1)];
+    database::Page* found = nullptr;
+    for (const auto& page : pages) {
+      if (page->getPageId() == wanted) {
+        found = page.get();
+        break;
+      }
+    }
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LinearScanLookup)->RangeMultiplier(10)->Range(10, 100000);
+
+}  // namespace
@@ -0,0 +1,54 @@
+#include "database/heap_file.hpp"
+#include "database/parallel_heap_scan.hpp"
+#include "database/schema.hpp"
+
+#include <benchmark/benchmark.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int64_t ROW_COUNT = 2000000;
+
+const database::HeapFile& sharedHeap() {
+  static database::Schema schema = [] {
+    database::Schema s;
+    s.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+    s.addColumn(database::Column(1, "amount", database::DataType::DOUBLE, false, false));
+    return s;
+  }();
+  static database::HeapFile heap_file = [] {
+    database::HeapFile heap(1, schema);
+    for (int64_t i = 0; i < ROW_COUNT; ++i) {
+      std::vector<database::Value> values = {database::Value{i}, database::Value{static_cast<double>(i % 1000)}};
+      heap.insertTuple(database::Tuple(schema, values, 1), 1);
+    }
+    return heap;
+  }();
+  return heap_file;
+}
+
+// Filter-and-count over the whole table with 1..N worker threads
+void BM_ParallelScanFilterCount(benchmark::State& state) {
+  const auto& heap_file = sharedHeap();
+  database::ParallelHeapScan parallel_scan(heap_file, static_cast<size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    auto count = parallel_scan.run(
+      int64_t{0},
+      [](int64_t& partial, const database::ScannedTuple& scanned) {
+        partial += scanned.tuple.getDouble(1) < 100.0 ? 1 : 0;
+      },
+      [](int64_t& result, int64_t partial) { result += partial; });
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+  state.counters["threads"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_ParallelScanFilterCount)
+  ->RangeMultiplier(2)
+  ->Range(1, static_cast<int64_t>(std::max(1U, std::thread::hardware_concurrency())))
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,108 @@
+#include "database/recovery_manager.hpp"
+#include "database/heap_file.hpp"
+#include "database/schema.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr char IMAGE_DIRECTORY[] = "recovery_benchmark_image";
+constexpr char WORK_DIRECTORY[] = "recovery_benchmark_work";
+constexpr database::TableId TABLE_COUNT = 4;
+
+int64_t image_rows = 0;
+
+std::string segmentPath(const std::string& directory, database::TableId table_id) {
+  return directory + "/" + std::to_string(table_id) + ".heap";
+}
+
+// Leave IMAGE_DIRECTORY as a crash would: the whole log is durable, but only
+// the pages a small buffer pool evicted have reached the segment files.
+void buildCrashImage(int64_t rows) {
+  if (image_rows == rows) {
+    return;
+  }
+  if (image_rows == 0) {
+    std::atexit([] { std::filesystem::remove_all(IMAGE_DIRECTORY); });
+  }
+  std::string live = std::string(IMAGE_DIRECTORY) + "_live";
+  std::filesystem::remove_all(live);
+  std::filesystem::remove_all(IMAGE_DIRECTORY);
+  std::filesystem::create_directories(live);
+
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, false, false));
+
+  auto wal = database::WriteAheadLog::open(live + "/wal.log");
+  database::BufferPool pool(64);
+  pool.setWriteAheadLog(wal.get());
+  std::vector<std::unique_ptr<database::HeapFile>> tables;
+  for (database::TableId table_id = 1; table_id <= TABLE_COUNT; ++table_id) {
+    tables.push_back(database::HeapFile::open(table_id, schema, pool, segmentPath(live, table_id)));
+    tables.back()->setWriteAheadLog(wal.get());
+  }
+
+  for (int64_t i = 0; i < rows; ++i) {
+    database::Tuple tuple(schema, {database::Value{i}, database::Value{"customer " + std::to_string(i)}}, 1);
+    tables[static_cast<size_t>(i) % TABLE_COUNT]->insertTuple(tuple, 1);
+  }
+  wal->flushAll();
+  std::filesystem::copy(live, IMAGE_DIRECTORY, std::filesystem::copy_options::recursive);
+
+  tables.clear();
+  std::filesystem::remove_all(live);
+  image_rows = rows;
+}
+
+// Replays a log of range(0) inserts spread over four tables with range(1)
+// redo threads. Compare time against log volume, and across thread counts
+// for a fixed volume.
+void BM_Recovery(benchmark::State& state) {
+  buildCrashImage(state.range(0));
+  std::string wal_path = std::string(WORK_DIRECTORY) + "/wal.log";
+
+  size_t records = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::filesystem::remove_all(WORK_DIRECTORY);
+    std::filesystem::copy(IMAGE_DIRECTORY, WORK_DIRECTORY, std::filesystem::copy_options::recursive);
+    database::BufferPool pool(4096);
+    state.ResumeTiming();
+
+    database::RecoveryManager recovery(pool, wal_path, std::string(WORK_DIRECTORY) + "/control",
+                                       [](database::TableId table_id) {
+                                         return segmentPath(WORK_DIRECTORY, table_id);
+                                       });
+    auto result = recovery.recover(static_cast<size_t>(state.range(1)));
+    if (!result.success) {
+      state.SkipWithError(result.error_message.c_str());
+      break;
+    }
+    records = result.records_applied + result.records_skipped;
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(records));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(std::filesystem::file_size(wal_path)));
+  state.counters["wal_mb"] = static_cast<double>(std::filesystem::file_size(wal_path)) / (1 << 20);
+  std::filesystem::remove_all(WORK_DIRECTORY);
+}
+BENCHMARK(BM_Recovery)
+    ->Apply([](benchmark::internal::Benchmark* benchmark) {
+      // Threads vary fastest so each crash image is built once
+      for (int64_t records : { 25000, 100000, 400000 }) {
+        for (int64_t threads : { 1, 2, 4, 8 }) {
+          benchmark->Args({ records, threads });
+        }
+      }
+    })
+    ->ArgNames({ "records", "threads" })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
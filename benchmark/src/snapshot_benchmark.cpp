@@ -0,0 +1,71 @@
+#include "database/transaction_manager.hpp"
+#include "database/visibility_checker.hpp"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+namespace {
+
+std::unique_ptr<database::TransactionManager> txn_manager;
+
+// A manager with state.range(0) transactions running
+void createManager(const benchmark::State& state) {
+  txn_manager = std::make_unique<database::TransactionManager>(static_cast<size_t>(state.range(0)) + 64);
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    txn_manager->beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  }
+}
+
+void destroyManager(const benchmark::State&) {
+  txn_manager.reset();
+}
+
+// CSN snapshot: one atomic read whatever the number of running transactions
+void BM_TakeSnapshot(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(txn_manager->takeSnapshot());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TakeSnapshot)->Setup(createManager)->Teardown(destroyManager)->Arg(16)->Arg(1000)->ThreadRange(1, 8);
+
+// What an (xmin, xmax, in-progress list) snapshot would cost: copying the active set
+void BM_CopyActiveTransactionIds(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(txn_manager->getActiveTransactionIds());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CopyActiveTransactionIds)->Setup(createManager)->Teardown(destroyManager)->Arg(16)->Arg(1000)->ThreadRange(1, 8);
+
+// A READ_COMMITTED statement snapshot with no commits in between
+void BM_CachedStatementSnapshot(benchmark::State& state) {
+  auto* txn = txn_manager->getTransaction(1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(txn_manager->getSnapshot(*txn));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CachedStatementSnapshot)->Setup(createManager)->Teardown(destroyManager)->Arg(16);
+
+// Visibility of versions created by committed transactions
+void BM_IsVisible(benchmark::State& state) {
+  std::vector<database::TupleHeader> versions;
+  for (int i = 0; i < 1024; ++i) {
+    auto txn_id = txn_manager->beginTransaction(database::IsolationLevel::READ_COMMITTED);
+    txn_manager->commitTransaction(txn_id);
+    versions.emplace_back(txn_id);
+  }
+  database::VisibilityChecker checker(*txn_manager);
+  auto snapshot = txn_manager->takeSnapshot();
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(checker.isVisible(versions[i++ % versions.size()], snapshot));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IsVisible)->Setup(createManager)->Teardown(destroyManager)->Arg(16);
+
+}  // namespace
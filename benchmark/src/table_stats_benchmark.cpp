@@ -0,0 +1,47 @@
+#include "database/table_stats.hpp"
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+
+namespace {
+
+std::unique_ptr<database::TableStats> stats;
+std::atomic<uint64_t> shared_updates{0};
+
+void createStats(const benchmark::State&) {
+  stats = std::make_unique<database::TableStats>();
+}
+
+void destroyStats(const benchmark::State&) {
+  stats.reset();
+}
+
+// Per-thread stripes: each thread increments its own cache line
+void BM_CountUpdateStriped(benchmark::State& state) {
+  for (auto _ : state) {
+    stats->countUpdate();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CountUpdateStriped)->Setup(createStats)->Teardown(destroyStats)->ThreadRange(1, 8);
+
+// What one shared counter per table would cost: every thread bounces the same line
+void BM_CountUpdateShared(benchmark::State& state) {
+  for (auto _ : state) {
+    shared_updates.fetch_add(1, std::memory_order_relaxed);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CountUpdateShared)->ThreadRange(1, 8);
+
+// The scheduler's read, once per table per check
+void BM_ReadCounters(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(stats->read());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReadCounters)->Setup(createStats)->Teardown(destroyStats);
+
+}  // namespace
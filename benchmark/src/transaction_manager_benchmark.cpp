@@ -0,0 +1,53 @@
+#include "database/transaction_manager.hpp"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+
+namespace {
+
+std::unique_ptr<database::TransactionManager> txn_manager;
+
+void createManager(const benchmark::State&) {
+  txn_manager = std::make_unique<database::TransactionManager>();
+}
+
+void destroyManager(const benchmark::State&) {
+  txn_manager.reset();
+}
+
+// Begin/commit pairs from every thread against one manager
+void BM_BeginCommit(benchmark::State& state) {
+  for (auto _ : state) {
+    auto txn_id = txn_manager->beginTransaction(database::IsolationLevel::READ_COMMITTED);
+    txn_manager->commitTransaction(txn_id);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BeginCommit)
+    ->Setup(createManager)
+    ->Teardown(destroyManager)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+// Begin/commit while other threads keep polling the active set, as
+// snapshot-taking readers would
+void BM_BeginCommitWithActiveScans(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(txn_manager->getActiveTransactionIds());
+    }
+  } else {
+    for (auto _ : state) {
+      auto txn_id = txn_manager->beginTransaction(database::IsolationLevel::READ_COMMITTED);
+      txn_manager->commitTransaction(txn_id);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+}
+BENCHMARK(BM_BeginCommitWithActiveScans)
+    ->Setup(createManager)
+    ->Teardown(destroyManager)
+    ->ThreadRange(2, 64)
+    ->UseRealTime();
+
+}  // namespace
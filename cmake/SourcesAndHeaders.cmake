@@ -4,11 +4,35 @@ set(sources
     src/database/value.cpp
     src/database/schema.cpp
     src/database/tuple.cpp
+    src/database/tuple_builder.cpp
     src/database/page.cpp
+    src/database/free_space_map.cpp
+    src/database/visibility_map.cpp
+    src/database/table_stats.cpp
+    src/database/page_directory.cpp
+    src/database/segment_file.cpp
+    src/database/io_engine.cpp
+    src/database/io_uring_engine.cpp
+    src/database/buffer_pool.cpp
+    src/database/write_ahead_log.cpp
+    src/database/control_file.cpp
+    src/database/checkpointer.cpp
+    src/database/recovery_manager.cpp
     src/database/heap_file.cpp
+    src/database/heap_scan.cpp
+    src/database/parallel_heap_scan.cpp
+    src/database/mapped_file.cpp
+    src/database/bulk_loader.cpp
+    src/database/catalog.cpp
     src/database/storage_manager.cpp
     src/database/transaction.cpp
+    src/database/commit_log.cpp
+    src/database/csn_log.cpp
     src/database/transaction_manager.cpp
+    src/database/visibility_checker.cpp
+    src/database/vacuum_manager.cpp
+    src/database/btree_index.cpp
+    src/database/hash_index.cpp
 )
 
 set(objcxx_sources
@@ -31,11 +55,37 @@ set(headers
     include/database/value.hpp
     include/database/schema.hpp
     include/database/tuple.hpp
+    include/database/tuple_builder.hpp
     include/database/page.hpp
+    include/database/free_space_map.hpp
+    include/database/visibility_map.hpp
+    include/database/table_stats.hpp
+    include/database/page_directory.hpp
+    include/database/segment_file.hpp
+    include/database/io_engine.hpp
+    include/database/io_uring_engine.hpp
+    include/database/buffer_pool.hpp
+    include/database/write_ahead_log.hpp
+    include/database/control_file.hpp
+    include/database/checkpointer.hpp
+    include/database/recovery_manager.hpp
     include/database/heap_file.hpp
+    include/database/heap_scan.hpp
+    include/database/parallel_heap_scan.hpp
+    include/database/mapped_file.hpp
+    include/database/bulk_loader.hpp
+    include/database/catalog.hpp
     include/database/storage_manager.hpp
     include/database/transaction.hpp
+    include/database/xid_page_array.hpp
+    include/database/commit_log.hpp
+    include/database/csn_log.hpp
+    include/database/snapshot.hpp
     include/database/transaction_manager.hpp
+    include/database/visibility_checker.hpp
+    include/database/vacuum_manager.hpp
+    include/database/btree_index.hpp
+    include/database/hash_index.hpp
 )
 
 set(test_sources
@@ -44,9 +94,51 @@ set(test_sources
   src/value_test.cpp
   src/schema_test.cpp
   src/tuple_test.cpp
+  src/tuple_builder_test.cpp
   src/page_test.cpp
+  src/free_space_map_test.cpp
+  src/visibility_map_test.cpp
+  src/table_stats_test.cpp
+  src/page_directory_test.cpp
+  src/segment_file_test.cpp
+  src/io_engine_test.cpp
+  src/buffer_pool_test.cpp
   src/heap_file_test.cpp
+  src/heap_scan_test.cpp
+  src/parallel_heap_scan_test.cpp
+  src/bulk_loader_test.cpp
+  src/catalog_test.cpp
   src/storage_manager_test.cpp
   src/transaction_test.cpp
+  src/commit_log_test.cpp
+  src/csn_log_test.cpp
   src/transaction_manager_test.cpp
+  src/visibility_checker_test.cpp
+  src/vacuum_manager_test.cpp
+  src/btree_index_test.cpp
+  src/hash_index_test.cpp
+  src/write_ahead_log_test.cpp
+  src/checkpointer_test.cpp
+  src/recovery_manager_test.cpp
+)
+
+set(benchmark_sources
+  src/page_directory_benchmark.cpp
+  src/heap_scan_benchmark.cpp
+  src/parallel_heap_scan_benchmark.cpp
+  src/heap_insert_benchmark.cpp
+  src/bulk_load_benchmark.cpp
+  src/buffer_pool_benchmark.cpp
+  src/group_commit_benchmark.cpp
+  src/recovery_benchmark.cpp
+  src/io_engine_benchmark.cpp
+  src/mapped_heap_file_benchmark.cpp
+  src/catalog_benchmark.cpp
+  src/transaction_manager_benchmark.cpp
+  src/snapshot_benchmark.cpp
+  src/heap_update_benchmark.cpp
+  src/table_stats_benchmark.cpp
+  src/btree_index_benchmark.cpp
+  src/btree_concurrency_benchmark.cpp
+  src/hash_index_benchmark.cpp
 )
@@ -32,6 +32,13 @@ option(${PROJECT_NAME}_USE_GOOGLE_MOCK "Use the GoogleMock project for extending
 
 option(${PROJECT_NAME}_USE_CATCH2 "Use the Catch2 project for creating unit tests." OFF)
 
+#
+# Benchmarks
+#
+# Built with Google Benchmark from the `benchmark` subfolder.
+
+option(${PROJECT_NAME}_ENABLE_BENCHMARKS "Enable microbenchmarks for the project (from the `benchmark` subfolder)." OFF)
+
 #
 # Static analyzers
 #
@@ -0,0 +1,228 @@
+#ifndef DATABASE_BTREE_INDEX_HPP_
+#define DATABASE_BTREE_INDEX_HPP_
+
+#include "database/types.hpp"
+#include "database/schema.hpp"
+#include "database/tuple.hpp"
+#include "database/value.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace database {
+
+/**
+ * @brief BTreeIndex - B+tree mapping the values of key columns to TupleIds
+ *
+ * Nodes are NODE_SIZE byte pages, addressed by node ID rather than by
+ * pointer so they can be written to and read from disk as they are. Like
+ * a heap page, a node is slotted: a header, an array of fixed-size slots
+ * growing up and the entries (key bytes and a TupleId or child node ID)
+ * growing down from the end. With 8-byte keys a node holds about 250
+ * entries, so a lookup in a billion keys visits four nodes.
+ *
+ * Keys are encoded so that comparing the bytes with memcmp orders them
+ * like the values (see encodeKey()), and each slot keeps the first eight
+ * encoded bytes as an integer. Four slots fit a cache line, and the binary
+ * search within a node compares those integers, only reading an entry's
+ * bytes when they tie; INTEGER, DOUBLE and BOOLEAN keys never tie.
+ *
+ * A unique index refuses a second entry with the key of a live one. In a
+ * non-unique index each entry's key is suffixed with its TupleId, so
+ * entries stay unique and a key's entries are kept in TupleId order.
+ *
+ * Leaves are linked left to right for range scans. Separators copied up
+ * on a leaf split are truncated to the shortest prefix that separates the
+ * two leaves, and a split of the rightmost leaf at its end leaves the old
+ * leaf full, so ascending inserts fill leaves instead of halving them.
+ * Removing entries does not merge nodes; an emptied leaf stays linked.
+ *
+ * Any number of threads may use the index at once, with optimistic lock
+ * coupling (Leis et al.): every node has a version word whose low bit is
+ * a write lock. Readers never write to a node. They note a node's version,
+ * read what they need, and check the version is unchanged before trusting
+ * it or moving on to a child; if it changed they start over from the root.
+ * Writers descend the same way and lock only the nodes they change, by
+ * bumping the version they read, so a node that changed since fails the
+ * lock too. An inner node that could not take one more separator is split
+ * on the way down, so splitting a leaf locks just the leaf and its parent.
+ * Nodes are never freed while the index exists, so a reader can always
+ * look at a node it reached, whatever happened to it since.
+ *
+ * The index is kept in memory and is not logged; it is the caller's job
+ * to add an entry for every tuple it inserts into the heap file and remove
+ * it along with the tuple.
+ */
+class BTreeIndex {
+public:
+  static constexpr size_t NODE_SIZE = 8192;
+  static constexpr size_t MAX_KEY_SIZE = 2000;  // Encoded, TupleId suffix included
+  static constexpr size_t CHUNK_NODES = 1024;
+  static constexpr size_t MAX_CHUNKS = 16384;    // Up to 16M nodes (128 GB)
+
+  /**
+   * @brief Create an index on columns of schema (in that key order)
+   * @return nullptr if there are no columns or one does not exist
+   */
+  [[nodiscard]] static std::unique_ptr<BTreeIndex> create(const Schema& schema, std::vector<ColumnId> columns,
+                                                          bool unique);
+
+  /**
+   * @brief Create a unique index on the schema's primary key columns
+   * @return nullptr if the schema has no primary key column
+   */
+  [[nodiscard]] static std::unique_ptr<BTreeIndex> createPrimaryKey(const Schema& schema);
+
+  ~BTreeIndex();
+
+  // Disable copy and move (nodes refer to each other by ID)
+  BTreeIndex(const BTreeIndex&) = delete;
+  BTreeIndex& operator=(const BTreeIndex&) = delete;
+  BTreeIndex(BTreeIndex&&) = delete;
+  BTreeIndex& operator=(BTreeIndex&&) = delete;
+
+  [[nodiscard]] const std::vector<ColumnId>& getColumns() const noexcept { return columns_; }
+  [[nodiscard]] bool isUnique() const noexcept { return unique_; }
+  [[nodiscard]] size_t size() const noexcept { return entry_count_.load(std::memory_order_relaxed); }
+  [[nodiscard]] size_t getHeight() const noexcept { return height_.load(std::memory_order_relaxed); }
+  [[nodiscard]] size_t getNodeCount() const noexcept { return node_count_.load(std::memory_order_acquire) - 1; }
+
+  /**
+   * @brief Encode the first values.size() key columns' values
+   *
+   * INTEGER is stored big-endian with the sign bit flipped, DOUBLE the same
+   * way after flipping all bits of negative numbers (-0 is stored as 0),
+   * BOOLEAN as one byte, and TEXT with each 0x00 byte escaped as 0x00 0xFF
+   * and terminated by 0x00 0x00, so every encoded value delimits itself
+   * and a shorter key is a prefix of the longer keys starting with it.
+   *
+   * @return false if there are more values than key columns, a value is
+   *         NULL or does not have its column's type
+   */
+  [[nodiscard]] bool encodeKey(std::span<const Value> values, std::vector<std::byte>& key) const;
+
+  /**
+   * @brief Encode the key columns of a tuple
+   * @return false if a key column is NULL
+   */
+  [[nodiscard]] bool encodeKey(const TupleView& tuple, std::vector<std::byte>& key) const;
+
+  /**
+   * @brief Add an entry for the tuple at tuple_id with key key_values
+   *
+   * In a unique index an entry with the same key is a duplicate unless
+   * is_live (if given) says its tuple is gone, for example because the
+   * deleting transaction committed; the stale entry is then pointed at
+   * tuple_id instead. is_live is called with the entry's leaf locked.
+   *
+   * @return false if the key is a duplicate, incomplete, NULL or too long
+   */
+  bool insert(std::span<const Value> key_values, const TupleId& tuple_id,
+              const std::function<bool(const TupleId&)>& is_live = {});
+
+  /**
+   * @brief Add an entry for tuple, stored at tuple_id
+   */
+  bool insert(const TupleView& tuple, const TupleId& tuple_id,
+              const std::function<bool(const TupleId&)>& is_live = {});
+
+  /**
+   * @brief Remove the entry for the tuple at tuple_id with key key_values
+   * @return false if there is no such entry
+   */
+  bool remove(std::span<const Value> key_values, const TupleId& tuple_id);
+
+  /**
+   * @brief Find the tuple with key key_values (the first one in a non-unique index)
+   */
+  [[nodiscard]] std::optional<TupleId> find(std::span<const Value> key_values) const;
+
+  /**
+   * @brief Visit the entries between two bounds in key order
+   *
+   * A bound may name fewer values than there are key columns, comparing
+   * only those columns: with the same one value as both inclusive bounds,
+   * the scan visits every entry whose first key column has that value. An
+   * empty bound is unbounded.
+   *
+   * Each leaf's entries are read and validated before visit sees them, so
+   * visit runs without any node locked. A concurrent change may or may
+   * not be seen, but no entry is visited twice.
+   *
+   * @param visit Called with each TupleId; returning false stops the scan
+   * @return Number of entries visited, 0 if a bound cannot be encoded
+   */
+  size_t scan(std::span<const Value> lower, bool lower_inclusive, std::span<const Value> upper, bool upper_inclusive,
+              const std::function<bool(const TupleId&)>& visit) const;
+
+private:
+  struct Node;
+  struct NodeChunk;
+
+  /**
+   * @brief Descent - a node reached optimistically, its parent and the versions they were read at
+   */
+  struct Descent {
+    PageId node;
+    uint64_t node_version;
+    PageId parent;  // 0 if the node is the root
+    uint64_t parent_version;
+    bool full_inner;  // The node is a full inner node, not the leaf
+  };
+
+  std::vector<ColumnId> columns_;
+  std::vector<DataType> types_;  // Of columns_
+  bool unique_;
+  std::unique_ptr<std::unique_ptr<NodeChunk>[]> chunks_;  // Node ID / CHUNK_NODES; node 0 is never used
+  std::mutex allocation_mutex_;                           // Serializes allocateNode()
+  std::atomic<size_t> node_count_{1};
+  std::atomic<PageId> root_{0};
+  std::atomic<size_t> height_{1};
+  std::atomic<size_t> entry_count_{0};
+
+  BTreeIndex(std::vector<ColumnId> columns, std::vector<DataType> types, bool unique);
+
+  /**
+   * @brief The node with an ID read optimistically, nullptr if there is no such node
+   */
+  [[nodiscard]] Node* getNode(PageId node_id) const noexcept;
+
+  /**
+   * @brief A new node, which nothing refers to until the caller publishes its ID
+   */
+  [[nodiscard]] PageId allocateNode(uint16_t level, PageId link);
+
+  /**
+   * @brief Descend optimistically to the leaf key belongs in
+   * @param stop_at_full Stop at a full inner node on the way (for writers, to split it)
+   * @return std::nullopt if a node changed or was locked: start over
+   */
+  [[nodiscard]] std::optional<Descent> descend(std::span<const std::byte> key, bool stop_at_full) const;
+
+  /**
+   * @brief Lock the descent's parent, then its node, if neither changed since the descent
+   */
+  [[nodiscard]] bool lockForSplit(const Descent& descent);
+
+  bool insertKey(std::vector<std::byte>& key, const TupleId& tuple_id,
+                 const std::function<bool(const TupleId&)>& is_live);
+
+  /**
+   * @brief Split the descent's node, adding an entry at position if key is not empty
+   *
+   * The node and its parent (if it is not the root) must be locked with
+   * lockForSplit(), and the parent must have room for another separator.
+   * Unlocks both.
+   */
+  void split(const Descent& descent, uint16_t position, std::span<const std::byte> key, uint64_t value, uint16_t aux);
+};
+
+}  // namespace database
+
+#endif  // DATABASE_BTREE_INDEX_HPP_
@@ -0,0 +1,317 @@
+#ifndef DATABASE_BUFFER_POOL_HPP_
+#define DATABASE_BUFFER_POOL_HPP_
+
+#include "database/types.hpp"
+#include "database/page.hpp"
+#include "database/segment_file.hpp"
+#include "database/io_engine.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace database {
+
+class BufferPool;
+class WriteAheadLog;
+
+/**
+ * @brief PageGuard - RAII pin on a page
+ *
+ * While a guard is alive its page stays in memory at the same address.
+ * Guards from a BufferPool unpin on destruction; a guard can also wrap a
+ * page that is not pool-managed (in-memory heap files), in which case
+ * releasing it does nothing, or own a read-only Page::view() (mapped heap
+ * files), which releasing drops.
+ */
+class PageGuard {
+public:
+  PageGuard() noexcept = default;
+  explicit PageGuard(Page* page) noexcept : page_(page) {
+  }
+  explicit PageGuard(Page&& view) noexcept : view_(std::move(view)), page_(&*view_) {
+  }
+  ~PageGuard() { release(); }
+
+  // Disable copy (a guard owns one pin)
+  PageGuard(const PageGuard&) = delete;
+  PageGuard& operator=(const PageGuard&) = delete;
+
+  // Allow move
+  PageGuard(PageGuard&& other) noexcept;
+  PageGuard& operator=(PageGuard&& other) noexcept;
+
+  [[nodiscard]] Page* get() const noexcept { return page_; }
+  Page* operator->() const noexcept { return page_; }
+  Page& operator*() const noexcept { return *page_; }
+  explicit operator bool() const noexcept { return page_ != nullptr; }
+
+  /**
+   * @brief Record that the page was modified and must be written back
+   */
+  void markDirty() noexcept;
+
+  /**
+   * @brief Drop the pin early
+   */
+  void release() noexcept;
+
+private:
+  friend class BufferPool;
+
+  BufferPool* pool_ = nullptr;
+  size_t frame_index_ = 0;
+  std::optional<Page> view_;
+  Page* page_ = nullptr;
+
+  PageGuard(BufferPool* pool, size_t frame_index, Page* page) noexcept
+      : pool_(pool), frame_index_(frame_index), page_(page) {
+  }
+};
+
+/**
+ * @brief BufferPoolStats - counters since creation or the last resetStats()
+ */
+struct BufferPoolStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  uint64_t writes = 0;  // Dirty pages written back
+  uint64_t prefetches = 0;  // Reads started ahead of use by prefetchPages()
+
+  [[nodiscard]] double getHitRate() const noexcept {
+    uint64_t total = hits + misses;
+    return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+  }
+};
+
+/**
+ * @brief BufferPool - fixed set of page frames caching segment file pages
+ *
+ * Pages are pinned through PageGuards; a pinned frame is never evicted.
+ * Replacement uses PostgreSQL's clock sweep: every access bumps a frame's
+ * usage count (capped at MAX_USAGE_COUNT), and the clock hand decrements
+ * counts as it passes, evicting the first unpinned frame that reaches zero.
+ * Frequently used pages therefore survive a sweep that would evict pages
+ * touched once, such as a large sequential scan.
+ *
+ * Dirty pages are written back when evicted or flushed. With a write-ahead
+ * log attached, the log is first flushed up to the page's LSN, so no page
+ * reaches disk ahead of the records describing it. One latch protects
+ * the page table and the clock. It is released while a miss reads its page
+ * or an eviction writes its victim back: the frame is mapped and marked as
+ * having I/O in progress first, so other fetches of that page wait for the
+ * I/O while misses on other pages proceed.
+ *
+ * Misses, readahead and checkpoint writes go through an IoEngine (io_uring
+ * where available): requests are prepared under the latch and submitted
+ * after releasing it, readahead and checkpoints in batches. The frames are
+ * registered with the engine once. Whoever needs such a frame first reaps
+ * completions for everyone while others wait for it, so one thread can
+ * keep many requests in flight without a completion thread. Eviction
+ * write-backs, and misses that find the engine queue full, use plain
+ * pread/pwrite.
+ */
+class BufferPool {
+public:
+  static constexpr uint8_t MAX_USAGE_COUNT = 5;
+  static constexpr size_t MAX_IO_QUEUE_DEPTH = 256;
+
+  explicit BufferPool(size_t frame_count, size_t page_size = Page::DEFAULT_PAGE_SIZE,
+                      IoEngineType io_engine_type = IoEngineType::AUTO);
+
+  /**
+   * @brief Waits for outstanding asynchronous I/O
+   */
+  ~BufferPool();
+
+  // Disable copy and move (guards point back at the pool)
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+  BufferPool(BufferPool&&) = delete;
+  BufferPool& operator=(BufferPool&&) = delete;
+
+  [[nodiscard]] size_t getFrameCount() const noexcept { return frames_.size(); }
+  [[nodiscard]] size_t getPageSize() const noexcept { return page_size_; }
+  [[nodiscard]] IoEngineType getIoEngineType() const noexcept { return io_engine_->getType(); }
+
+  /**
+   * @brief Enforce the WAL rule against wal on every write-back
+   */
+  void setWriteAheadLog(WriteAheadLog* wal) noexcept { wal_ = wal; }
+
+  /**
+   * @brief Pin a page, reading it from the file on a miss
+   * @return Guard for the page, or an empty guard if the page cannot be read
+   *         or every frame is pinned
+   */
+  [[nodiscard]] PageGuard fetchPage(SegmentFile& file, PageId page_id);
+
+  /**
+   * @brief Start asynchronous reads of up to count pages from first_page_id on
+   *
+   * Pages already cached are skipped. A hint: readahead stops early at the
+   * end of the file, when the engine queue is full, or when reads in
+   * progress already hold a quarter of the frames.
+   * @return Number of pages from first_page_id on that are now cached or
+   *         being read; a later call can resume after them
+   */
+  size_t prefetchPages(SegmentFile& file, PageId first_page_id, size_t count);
+
+  /**
+   * @brief Pin a frame for a page that does not exist on disk yet
+   *
+   * The page is formatted empty and marked dirty.
+   * @return Guard for the page, or an empty guard if every frame is pinned
+   */
+  [[nodiscard]] PageGuard newPage(SegmentFile& file, PageId page_id);
+
+  /**
+   * @brief Write back every dirty page of a file and sync it
+   */
+  bool flushFile(SegmentFile& file);
+
+  /**
+   * @brief Write back every page that is dirty when the call starts, then sync
+   *
+   * Used by checkpoints. Pages are written pages_per_round at a time, each
+   * round as one batch through the I/O engine; between rounds the latch is
+   * released and throttle is called with the number of pages the round
+   * wrote, so the caller can spread the I/O out (and give up by returning
+   * false). Pinned pages may be mid-modification and are retried in a later
+   * round. Finally every file written since its last sync, including by
+   * evictions, is synced.
+   * @return false if a write or sync failed or throttle gave up
+   */
+  bool flushDirtyPages(size_t pages_per_round, const std::function<bool(size_t)>& throttle);
+
+  /**
+   * @brief Drop every cached page of a file without writing it back
+   *
+   * Used when a file is closed after being flushed. Pages still pinned are
+   * left in place.
+   */
+  void discardFile(const SegmentFile& file);
+
+  /**
+   * @brief Drop the cached pages of a file from first_page_id on without writing them back
+   *
+   * Used when those pages are cut off the end of the file. Pages still
+   * pinned are left in place.
+   */
+  void discardPages(const SegmentFile& file, PageId first_page_id);
+
+  [[nodiscard]] BufferPoolStats getStats() const;
+  void resetStats();
+
+private:
+  friend class PageGuard;
+
+  struct BufferTag {
+    const SegmentFile* file;
+    PageId page_id;
+
+    bool operator==(const BufferTag& other) const noexcept {
+      return file == other.file && page_id == other.page_id;
+    }
+  };
+
+  struct BufferTagHash {
+    size_t operator()(const BufferTag& tag) const noexcept {
+      return std::hash<const void*>()(tag.file) ^ (std::hash<PageId>()(tag.page_id) * 0x9E3779B97F4A7C15ULL);
+    }
+  };
+
+  struct Frame {
+    Page page;
+    SegmentFile* file = nullptr;  // nullptr = free frame
+    PageId page_id = 0;
+    uint32_t pin_count = 0;
+    uint8_t usage_count = 0;
+    bool dirty = false;
+    bool prefetched = false;      // Read ahead and not pinned since
+    bool io_in_progress = false;  // Not usable until io_operation completes
+    bool io_synchronous = false;  // io_operation runs on the thread that started it, not in the engine
+    bool io_failed = false;       // The last asynchronous write, or a demand read, failed
+    IoOperation io_operation = IoOperation::READ;
+
+    explicit Frame(size_t page_size) : page(0, page_size) {
+    }
+  };
+
+  size_t page_size_;
+  WriteAheadLog* wal_ = nullptr;
+  mutable std::mutex mutex_;
+  std::condition_variable io_cv_;  // Signals completions processed by the reaper
+  bool reaping_ = false;
+  size_t prefetched_frames_ = 0;   // Frames with readahead I/O in progress
+  std::vector<Frame> frames_;
+  std::unique_ptr<IoEngine> io_engine_;  // Declared after frames_ so it is closed before they are freed
+  bool buffers_registered_ = false;
+  std::vector<size_t> free_frames_;
+  std::unordered_map<BufferTag, size_t, BufferTagHash> page_table_;
+  std::unordered_set<SegmentFile*> unsynced_files_;  // Written to since their last sync
+  size_t clock_hand_ = 0;
+  BufferPoolStats stats_;
+
+  /**
+   * @brief Drop the unpinned frames of file's pages from first_page_id on (caller holds mutex_)
+   */
+  void discardFrames(std::unique_lock<std::mutex>& lock, const SegmentFile& file, PageId first_page_id);
+
+  /**
+   * @brief Claim a frame for a new page, evicting one if necessary
+   *
+   * Writing back a dirty victim releases the lock, so the caller must
+   * re-check the page table afterwards.
+   * @return Frame index, or std::nullopt if every frame is pinned or a
+   *         write-back failed (caller holds mutex_)
+   */
+  std::optional<size_t> allocateFrame(std::unique_lock<std::mutex>& lock);
+
+  /**
+   * @brief Write a dirty frame back to its file (caller holds mutex_)
+   *
+   * The frame is marked as having I/O in progress and the lock is released
+   * for the log flush and the write.
+   */
+  bool writeBack(std::unique_lock<std::mutex>& lock, size_t frame_index);
+
+  /**
+   * @brief Queue an asynchronous read or write of a frame (caller holds mutex_ and submits after releasing it)
+   */
+  bool prepareIo(size_t frame_index, IoOperation operation);
+
+  /**
+   * @brief Block until a frame's I/O has completed
+   *
+   * Reaps completions if no other thread is; the lock is released while
+   * waiting, so the caller must re-check the frame afterwards.
+   */
+  void waitForIo(std::unique_lock<std::mutex>& lock, size_t frame_index);
+
+  /**
+   * @brief Process completions that are already available (caller holds mutex_)
+   */
+  void pollIo();
+
+  void completeIo(const IoCompletion& completion);
+
+  /**
+   * @brief Pin an already mapped frame (caller holds mutex_)
+   */
+  PageGuard pin(size_t frame_index);
+
+  void unpin(size_t frame_index) noexcept;
+  void markDirty(size_t frame_index) noexcept;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_BUFFER_POOL_HPP_
@@ -0,0 +1,103 @@
+#ifndef DATABASE_BULK_LOADER_HPP_
+#define DATABASE_BULK_LOADER_HPP_
+
+#include "database/types.hpp"
+#include "database/heap_file.hpp"
+#include "database/snapshot.hpp"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace database {
+
+class VisibilityChecker;
+
+/**
+ * @brief BulkLoadOptions - knobs for a BulkLoader
+ */
+struct BulkLoadOptions {
+  char delimiter = ',';
+  bool has_header = false;        // Skip the first CSV line
+  size_t thread_count = 0;        // 0 = std::thread::hardware_concurrency()
+  size_t min_chunk_size = 1 << 20;  // Inputs are not split finer than this
+};
+
+/**
+ * @brief BulkLoadResult - outcome of a load
+ *
+ * On failure nothing is loaded; error_line is the 1-based CSV line (or
+ * binary record) that was rejected.
+ */
+struct BulkLoadResult {
+  bool success = false;
+  size_t rows_loaded = 0;
+  size_t error_line = 0;
+  std::string error_message;
+};
+
+/**
+ * @brief BulkLoader - streams CSV or binary files into a heap file
+ *
+ * Input files are memory-mapped and parsed in place. CSV input is split at
+ * line boundaries into one chunk per thread; each worker parses its chunk
+ * with std::from_chars, serializes rows through a TupleBuilder (TEXT fields
+ * are slices of the mapping) and fills private pages. Each chunk's pages
+ * are appended to the heap file as soon as it and the chunks before it are
+ * parsed, so the load bypasses the per-row insert path entirely and does
+ * not hold the whole input's pages in memory.
+ *
+ * CSV rules: fields are separated by the delimiter, an empty unquoted field
+ * is NULL, and fields may be double-quoted with "" as an escaped quote.
+ * Quoted fields may not contain line breaks. BOOLEAN accepts true/false,
+ * t/f and 1/0 in either case.
+ *
+ * The binary format is the magic "DBBULK01" followed by records of
+ * [uint32 length][serialized tuple], as written by dumpBinary(). It is
+ * split into chunks at record boundaries found by a quick pass over the
+ * length prefixes and loaded by the same per-chunk workers as CSV.
+ *
+ * Loads are all-or-nothing: the first bad row, or running out of buffer
+ * frames while appending, fails the load and cuts off the pages appended
+ * so far (see HeapFile::truncatePages()), leaving the heap file as it was.
+ */
+class BulkLoader {
+public:
+  static constexpr std::string_view BINARY_MAGIC = "DBBULK01";
+
+  explicit BulkLoader(HeapFile& heap_file, BulkLoadOptions options = {});
+
+  /**
+   * @brief Load a CSV file, stamping every row with txn_id
+   */
+  BulkLoadResult loadCsv(const std::string& path, TransactionId txn_id);
+
+  /**
+   * @brief Load CSV text that is already in memory
+   */
+  BulkLoadResult loadCsvData(std::string_view data, TransactionId txn_id);
+
+  /**
+   * @brief Load a binary file written by dumpBinary()
+   */
+  BulkLoadResult loadBinary(const std::string& path, TransactionId txn_id);
+
+  /**
+   * @brief Write the tuples of a heap file that snapshot sees in the binary bulk format
+   *
+   * Deleted and superseded versions are left out, so reloading the file
+   * gives one version per row.
+   * @return true if the file was written completely
+   */
+  static bool dumpBinary(const HeapFile& heap_file, const std::string& path, const VisibilityChecker& checker,
+                         const Snapshot& snapshot);
+
+private:
+  HeapFile& heap_file_;
+  BulkLoadOptions options_;
+
+  [[nodiscard]] size_t chunkCount(size_t data_size) const noexcept;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_BULK_LOADER_HPP_
@@ -0,0 +1,112 @@
+#ifndef DATABASE_CATALOG_HPP_
+#define DATABASE_CATALOG_HPP_
+
+#include "database/types.hpp"
+#include "database/schema.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace database {
+
+/**
+ * @brief CatalogEntry - what the catalog records about a table besides its schema
+ */
+struct CatalogEntry {
+  TableId table_id = 0;
+  std::string name;
+  std::string file_name;  // Segment file, relative to the data directory
+};
+
+/**
+ * @brief Catalog - table names, schemas and file locations
+ *
+ * Tables are found by name or by ID through hash maps in O(1). The catalog
+ * owns the schemas, so heap files can refer to them for as long as the
+ * catalog lives.
+ *
+ * A persistent catalog is one file: a header with the next table ID, the
+ * entries of all tables, then their serialized schemas. Opening it reads
+ * the header and entries in one go and leaves the schemas on disk until
+ * first use, so startup stays cheap with thousands of tables. createTable() rewrites
+ * the file atomically (see writeFileAtomically()) before returning, so a
+ * table is durable in the catalog before anything is logged for it. Schemas
+ * that were never loaded are copied over as raw bytes, not decoded.
+ *
+ * Not thread-safe.
+ */
+class Catalog {
+public:
+  /**
+   * @brief Create an in-memory catalog
+   */
+  Catalog() = default;
+
+  /**
+   * @brief Open a persistent catalog, starting empty if the file does not exist
+   * @return Catalog if successful, nullptr if the file is malformed
+   */
+  [[nodiscard]] static std::unique_ptr<Catalog> open(const std::string& path);
+
+  // Disable copy and move (heap files refer to the schemas)
+  Catalog(const Catalog&) = delete;
+  Catalog& operator=(const Catalog&) = delete;
+  Catalog(Catalog&&) = delete;
+  Catalog& operator=(Catalog&&) = delete;
+
+  /**
+   * @brief Register a table under a new ID, storing a copy of schema
+   *
+   * Its segment file is named "<table_id>.heap".
+   * @return TableId of the new table, 0 if name is empty or taken or the
+   *         catalog file could not be written
+   */
+  TableId createTable(const std::string& name, const Schema& schema);
+
+  /**
+   * @return TableId of the table called name, 0 if there is none
+   */
+  [[nodiscard]] TableId findTable(const std::string& name) const;
+
+  /**
+   * @return Entry of the table, nullptr if there is none
+   */
+  [[nodiscard]] const CatalogEntry* getEntry(TableId table_id) const;
+
+  /**
+   * @brief Get a table's schema, reading it from the catalog file on first use
+   * @return Schema, nullptr if there is no such table or its schema cannot be read
+   */
+  const Schema* getSchema(TableId table_id);
+
+  [[nodiscard]] size_t getTableCount() const noexcept { return tables_.size(); }
+
+  /**
+   * @brief Number of schemas decoded so far
+   */
+  [[nodiscard]] size_t getLoadedSchemaCount() const noexcept { return loaded_schemas_; }
+
+private:
+  struct Table {
+    CatalogEntry entry;
+    std::unique_ptr<Schema> schema;  // nullptr until loaded
+    uint64_t schema_offset = 0;      // Position of the schema in the catalog file
+    uint32_t schema_size = 0;        // Serialized size of the schema in the catalog file
+  };
+
+  std::string path_;  // Empty for an in-memory catalog
+  std::unordered_map<TableId, Table> tables_;
+  std::unordered_map<std::string, TableId> names_;
+  TableId next_table_id_ = 1;
+  size_t loaded_schemas_ = 0;
+
+  /**
+   * @brief Write every table to the catalog file (copying unloaded schemas from the old one)
+   */
+  bool persist();
+};
+
+}  // namespace database
+
+#endif  // DATABASE_CATALOG_HPP_
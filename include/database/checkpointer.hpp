@@ -0,0 +1,113 @@
+#ifndef DATABASE_CHECKPOINTER_HPP_
+#define DATABASE_CHECKPOINTER_HPP_
+
+#include "database/types.hpp"
+#include "database/buffer_pool.hpp"
+#include "database/write_ahead_log.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace database {
+
+class TransactionManager;
+
+/**
+ * @brief CheckpointOptions - how often checkpoints run and how hard they write
+ *
+ * A checkpoint writes at most pages_per_round pages and then sleeps for
+ * round_delay, bounding its write rate at pages_per_round / round_delay
+ * (PostgreSQL spreads checkpoint writes the same way). A checkpoint that
+ * cannot write a single page for pinned_page_timeout, because the pages
+ * left all stay pinned, gives up and leaves the previous checkpoint in
+ * force.
+ */
+struct CheckpointOptions {
+  std::chrono::milliseconds interval{0};  // Between background checkpoints, 0 = only on request
+  size_t pages_per_round = 64;
+  std::chrono::milliseconds round_delay{10};
+  std::chrono::milliseconds pinned_page_timeout{10000};
+};
+
+/**
+ * @brief Checkpointer - takes fuzzy checkpoints, optionally on a background thread
+ *
+ * A checkpoint notes the current end of the log as its redo LSN, writes back
+ * every page that is dirty at that point while normal work continues, syncs
+ * the segment files, logs a CHECKPOINT record and finally points the control
+ * file at it. Every change logged before the redo LSN is then on disk, so
+ * recovery only has to replay the log from there.
+ *
+ * Given a TransactionManager, the redo LSN is chosen while no commit is
+ * half recorded, and before the control file is written the commit log is
+ * saved (ControlFile::getCommitLogPath()) and the next transaction ID noted
+ * in it. The log before the redo LSN is then needed for nothing at all.
+ *
+ * When the checkpointer is being destroyed, a checkpoint in progress stops
+ * throttling and finishes at full speed.
+ */
+class Checkpointer {
+public:
+  /**
+   * @brief Starts the background thread if options.interval is non-zero
+   * @param txn_manager Whose commit log checkpoints save, nullptr for none;
+   *        must outlive the checkpointer
+   */
+  Checkpointer(WriteAheadLog& wal, BufferPool& buffer_pool, std::string control_path, CheckpointOptions options = {},
+               TransactionManager* txn_manager = nullptr);
+  ~Checkpointer();
+
+  // Disable copy and move (the background thread points at the checkpointer)
+  Checkpointer(const Checkpointer&) = delete;
+  Checkpointer& operator=(const Checkpointer&) = delete;
+  Checkpointer(Checkpointer&&) = delete;
+  Checkpointer& operator=(Checkpointer&&) = delete;
+
+  /**
+   * @brief Take a checkpoint now (thread-safe; concurrent calls run one after the other)
+   * @return true once the control file names the new checkpoint
+   */
+  bool checkpoint();
+
+  [[nodiscard]] uint64_t getCheckpointCount() const;
+
+  /**
+   * @brief Redo LSN of the last checkpoint this checkpointer completed, 0 if none
+   */
+  [[nodiscard]] Lsn getRedoLsn() const;
+
+private:
+  WriteAheadLog& wal_;
+  BufferPool& buffer_pool_;
+  std::string control_path_;
+  CheckpointOptions options_;
+  TransactionManager* txn_manager_;
+  std::mutex checkpoint_mutex_;  // Serializes checkpoints
+  mutable std::mutex mutex_;     // Protects the fields below
+  std::condition_variable stop_cv_;
+  bool stopping_ = false;
+  uint64_t checkpoint_count_ = 0;
+  Lsn redo_lsn_ = 0;
+  std::thread thread_;
+
+  void run();
+
+  /**
+   * @brief Save the transaction manager's commit log next to the control file
+   */
+  bool saveCommitLog();
+
+  /**
+   * @brief Pause between write rounds
+   * @return false once pinned pages have blocked progress for too long
+   */
+  bool throttle(size_t written, std::chrono::steady_clock::time_point& last_progress);
+};
+
+}  // namespace database
+
+#endif  // DATABASE_CHECKPOINTER_HPP_
@@ -0,0 +1,79 @@
+#ifndef DATABASE_COMMIT_LOG_HPP_
+#define DATABASE_COMMIT_LOG_HPP_
+
+#include "database/types.hpp"
+#include "database/xid_page_array.hpp"
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+namespace database {
+
+/**
+ * @brief Final (or current) status of a transaction, as stored in the commit log
+ */
+enum class TransactionStatus : uint8_t {
+  IN_PROGRESS = 0,   // Running, or never started
+  COMMITTED = 1,
+  ABORTED = 2,
+  SUB_COMMITTED = 3  // A subtransaction whose parent has not committed yet
+};
+
+/**
+ * @brief CommitLog - the status of every transaction, two bits per ID
+ *
+ * Like PostgreSQL's CLOG (pg_xact) it replaces per-transaction objects once
+ * a transaction finishes: a page of PAGE_SIZE bytes holds the statuses of
+ * XIDS_PER_PAGE consecutive IDs, so a million finished transactions take
+ * 256 KB. The pages are an XidPageArray, whose sequentially consistent
+ * reads and writes TransactionManager orders against its CSN counter.
+ *
+ * truncate() drops the pages whose IDs are all older than a horizon below
+ * which no status is needed any more. IDs before the oldest remaining page
+ * report COMMITTED: nothing written by an older aborted transaction may
+ * still be visible to anyone by then (it has been vacuumed or frozen).
+ */
+class CommitLog {
+public:
+  static constexpr size_t PAGE_SIZE = XidPageArray<2>::PAGE_SIZE;
+  static constexpr size_t XIDS_PER_PAGE = XidPageArray<2>::XIDS_PER_PAGE;
+
+  CommitLog() = default;
+
+  [[nodiscard]] TransactionStatus getStatus(TransactionId txn_id) const;
+
+  /**
+   * @brief Record a transaction's status; ignored for truncated IDs
+   */
+  void setStatus(TransactionId txn_id, TransactionStatus status);
+
+  /**
+   * @brief Drop every page whose IDs are all older than oldest_txn_id
+   */
+  void truncate(TransactionId oldest_txn_id);
+
+  /**
+   * @brief First ID whose status is still stored
+   */
+  [[nodiscard]] TransactionId getOldestTransactionId() const;
+
+  [[nodiscard]] size_t getPageCount() const;
+
+  /**
+   * @brief Save every stored status, e.g. for a checkpoint
+   */
+  bool writeTo(std::ostream& out) const;
+
+  /**
+   * @brief Replace every status with those saved by writeTo()
+   * @return false, leaving the log alone, if the stream is malformed
+   */
+  bool readFrom(std::istream& in);
+
+private:
+  XidPageArray<2> statuses_;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_COMMIT_LOG_HPP_
@@ -0,0 +1,62 @@
+#ifndef DATABASE_CONTROL_FILE_HPP_
+#define DATABASE_CONTROL_FILE_HPP_
+
+#include "database/types.hpp"
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace database {
+
+/**
+ * @brief Replace a file's contents so that a crash leaves either the old or the new version
+ *
+ * Writes a temporary file, syncs it, renames it over path and syncs the directory.
+ */
+bool writeFileAtomically(const std::string& path, std::span<const std::byte> data);
+
+/**
+ * @brief ControlData - where the last completed checkpoint left the log
+ */
+struct ControlData {
+  Lsn checkpoint_lsn = 0;         // End of the CHECKPOINT record
+  Lsn redo_lsn = 0;               // Crash recovery replays records ending after this
+  TransactionId next_txn_id = 0;  // First ID not assigned at the checkpoint, 0 if no commit log was saved
+  TransactionId oldest_txn_id = 1;  // Oldest running at the checkpoint; every earlier one has its outcome saved
+};
+
+/**
+ * @brief ControlFile - small file naming the last completed checkpoint
+ *
+ * Like PostgreSQL's pg_control it lets recovery start from the checkpoint's
+ * redo point instead of the beginning of the log. A new version is written
+ * to a temporary file, synced and renamed over the old one, so a crash
+ * leaves either the old or the new contents.
+ *
+ * A checkpoint that knows the transactions also saves the commit log next
+ * to it (getCommitLogPath()) before the control file names the checkpoint,
+ * so the outcomes of transactions logged before the redo LSN survive
+ * without that part of the log.
+ */
+class ControlFile {
+public:
+  /**
+   * @brief Where a checkpoint saves the commit log for the control file at control_path
+   */
+  [[nodiscard]] static std::string getCommitLogPath(const std::string& control_path);
+
+  /**
+   * @return The stored data, std::nullopt if the file is missing or malformed
+   */
+  [[nodiscard]] static std::optional<ControlData> read(const std::string& path);
+
+  /**
+   * @brief Atomically replace the file's contents
+   */
+  static bool write(const std::string& path, const ControlData& data);
+};
+
+}  // namespace database
+
+#endif  // DATABASE_CONTROL_FILE_HPP_
@@ -0,0 +1,51 @@
+#ifndef DATABASE_CSN_LOG_HPP_
+#define DATABASE_CSN_LOG_HPP_
+
+#include "database/types.hpp"
+#include "database/xid_page_array.hpp"
+#include <cstdint>
+
+namespace database {
+
+/**
+ * @brief CsnLog - the commit sequence number of every committed transaction
+ *
+ * Paged like CommitLog, with one 64-bit word per ID instead of two bits:
+ * a page of PAGE_SIZE bytes covers XIDS_PER_PAGE consecutive IDs. A word is
+ * 0 until its transaction commits, COMMITTING while the commit takes its
+ * CSN, then that CSN. Truncated IDs report FROZEN_CSN, which every snapshot
+ * sees.
+ */
+class CsnLog {
+public:
+  static constexpr size_t PAGE_SIZE = XidPageArray<64>::PAGE_SIZE;
+  static constexpr size_t XIDS_PER_PAGE = XidPageArray<64>::XIDS_PER_PAGE;
+  static constexpr CommitSeqNo COMMITTING = uint64_t{1} << 63;
+  static constexpr CommitSeqNo FROZEN_CSN = 1;
+
+  CsnLog() = default;
+
+  /**
+   * @return CSN, COMMITTING, or 0 if the transaction has not committed
+   */
+  [[nodiscard]] CommitSeqNo getCsn(TransactionId txn_id) const;
+
+  /**
+   * @brief Record csn (or COMMITTING) for txn_id; ignored for truncated IDs
+   */
+  void setCsn(TransactionId txn_id, CommitSeqNo csn);
+
+  /**
+   * @brief Drop every page whose IDs are all older than oldest_txn_id
+   */
+  void truncate(TransactionId oldest_txn_id);
+
+  [[nodiscard]] size_t getPageCount() const;
+
+private:
+  XidPageArray<64> csns_;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_CSN_LOG_HPP_
@@ -0,0 +1,80 @@
+#ifndef DATABASE_FREE_SPACE_MAP_HPP_
+#define DATABASE_FREE_SPACE_MAP_HPP_
+
+#include "database/types.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <vector>
+
+namespace database {
+
+/**
+ * @brief FreeSpaceMap - tracks approximate free space per page of a heap file
+ *
+ * Like PostgreSQL's FSM, each page's free space is stored as a one-byte
+ * category (free bytes / (page_size / 256), rounded down) in the leaves of a
+ * binary max-tree. Finding a page with room for a tuple descends the tree in
+ * O(log n); recording a page's free space updates one root-to-leaf path.
+ *
+ * Categories round down, so a page returned by findPage() has at least the
+ * requested space as long as the map is up to date. The map can lag behind
+ * the pages, so callers should still check the page and call update() if it
+ * was stale.
+ */
+class FreeSpaceMap {
+public:
+  explicit FreeSpaceMap(size_t page_size);
+
+  [[nodiscard]] size_t getPageSize() const noexcept { return page_size_; }
+
+  /**
+   * @brief Record the current free space of a page
+   */
+  void update(PageId page_id, size_t free_bytes);
+
+  /**
+   * @brief Forget a page (e.g. after it has been truncated away)
+   */
+  void remove(PageId page_id);
+
+  /**
+   * @brief Find the lowest-numbered page with at least required_size free bytes
+   * @return PageId if found, std::nullopt if no tracked page has enough room
+   */
+  [[nodiscard]] std::optional<PageId> findPage(size_t required_size) const;
+
+  /**
+   * @brief Free space recorded for a page (a lower bound of the real value)
+   */
+  [[nodiscard]] size_t getFreeSpace(PageId page_id) const noexcept;
+
+  /**
+   * @brief Persist the map (page size followed by one category byte per page)
+   * @return true if successful, false otherwise
+   */
+  bool writeTo(std::ostream& out) const;
+
+  /**
+   * @brief Load a map written by writeTo()
+   * @return FreeSpaceMap if the stream is well formed, std::nullopt otherwise
+   */
+  [[nodiscard]] static std::optional<FreeSpaceMap> readFrom(std::istream& in);
+
+private:
+  static constexpr size_t CATEGORY_COUNT = 256;
+
+  size_t page_size_;
+  size_t category_step_;
+  size_t capacity_;              // Number of leaves, always a power of two
+  std::vector<uint8_t> tree_;    // Heap-ordered max-tree, leaves at [capacity_, 2 * capacity_)
+
+  [[nodiscard]] uint8_t toCategory(size_t free_bytes) const noexcept;
+  [[nodiscard]] size_t requiredCategory(size_t required_size) const noexcept;
+  void setCategory(PageId page_id, uint8_t category);
+  void grow(size_t min_capacity);
+};
+
+}  // namespace database
+
+#endif  // DATABASE_FREE_SPACE_MAP_HPP_
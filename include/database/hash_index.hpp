@@ -0,0 +1,168 @@
+#ifndef DATABASE_HASH_INDEX_HPP_
+#define DATABASE_HASH_INDEX_HPP_
+
+#include "database/types.hpp"
+#include "database/heap_file.hpp"
+#include "database/schema.hpp"
+#include "database/snapshot.hpp"
+#include "database/tuple.hpp"
+#include "database/value.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace database {
+
+class VisibilityChecker;
+
+/**
+ * @brief HashIndex - linear hash table from one column's values to TupleIds
+ *
+ * For equality lookups, where a B+tree's comparisons on the way down are
+ * wasted. Like a PostgreSQL hash index, it stores only a 32-bit hash code
+ * per entry, not the key, so lookups recheck the key on the tuple (see
+ * find()); any number of tuples may share a key.
+ *
+ * A bucket is one cache line holding the hash codes and TupleIds of up to
+ * BUCKET_ENTRIES entries and the link to an overflow bucket, so a lookup
+ * reads the bucket directory (a few lines, which stay cached) and usually
+ * one bucket. The table grows by linear hashing (Litwin): whenever the
+ * entries exceed MAX_FILL of the bucket capacity, the next bucket in turn
+ * is split in two, moving about half of its entries to a new bucket at the
+ * end. Growth costs one bucket split per few inserts, never a rehash of
+ * the whole table, and buckets live in fixed-size segments so adding one
+ * never moves the others. Overflow buckets take the entries of a bucket
+ * that fills up before its turn to split comes.
+ *
+ * Removing entries does not shrink the table. The index is kept in memory
+ * and is not logged or thread-safe; the caller keeps it in step with the
+ * heap file, as for BTreeIndex.
+ */
+class HashIndex {
+public:
+  static constexpr size_t BUCKET_ENTRIES = 5;
+  static constexpr size_t SEGMENT_BUCKETS = 1024;
+  static constexpr double MAX_FILL = 0.5;
+
+  /**
+   * @brief Create an index on column column_id of schema
+   * @return nullptr if the column does not exist
+   */
+  [[nodiscard]] static std::unique_ptr<HashIndex> create(const Schema& schema, ColumnId column_id);
+
+  /**
+   * @brief Create an index on a column of heap_file and add every tuple in it
+   *
+   * Every version gets an entry, so that snapshots still seeing a deleted
+   * or superseded one find it, except heap-only versions: those are found
+   * by following the HOT chain from its root, as after an update.
+   * @return nullptr if the column does not exist
+   */
+  [[nodiscard]] static std::unique_ptr<HashIndex> build(const HeapFile& heap_file, ColumnId column_id);
+
+  ~HashIndex();
+
+  // Disable copy and move (buckets refer to each other by index)
+  HashIndex(const HashIndex&) = delete;
+  HashIndex& operator=(const HashIndex&) = delete;
+  HashIndex(HashIndex&&) = delete;
+  HashIndex& operator=(HashIndex&&) = delete;
+
+  [[nodiscard]] ColumnId getColumnId() const noexcept { return column_id_; }
+  [[nodiscard]] size_t size() const noexcept { return entry_count_; }
+  [[nodiscard]] size_t getBucketCount() const noexcept { return bucket_count_; }
+  [[nodiscard]] size_t getOverflowBucketCount() const noexcept { return overflow_count_; }
+
+  /**
+   * @brief Hash code of a key, std::nullopt if it is NULL or not of the column's type
+   *
+   * Equal keys have equal hash codes; -0 and 0 are equal.
+   */
+  [[nodiscard]] std::optional<uint32_t> hashKey(const Value& key) const noexcept;
+
+  /**
+   * @brief Add an entry for the tuple at tuple_id, whose column value is key
+   * @return false if the key is NULL or of the wrong type, or tuple_id is
+   *         not a heap tuple's (page 0 or beyond 2^48 pages)
+   */
+  bool insert(const Value& key, const TupleId& tuple_id);
+
+  /**
+   * @brief Add an entry for tuple, stored at tuple_id
+   */
+  bool insert(const TupleView& tuple, const TupleId& tuple_id);
+
+  /**
+   * @brief Remove the entry for the tuple at tuple_id with key key
+   * @return false if there is no such entry
+   */
+  bool remove(const Value& key, const TupleId& tuple_id);
+
+  /**
+   * @brief TupleIds of the entries whose hash code is key's
+   *
+   * These include every tuple with the key and, rarely, tuples whose keys
+   * merely share its hash code.
+   *
+   * @return Number of TupleIds appended to tuple_ids
+   */
+  size_t findCandidates(const Value& key, std::vector<TupleId>& tuple_ids) const;
+
+  /**
+   * @brief TupleIds of the tuples in heap_file whose column value is key
+   */
+  [[nodiscard]] std::vector<TupleId> find(const HeapFile& heap_file, const Value& key) const;
+
+  /**
+   * @brief The versions snapshot sees of the rows whose column value is key
+   *
+   * Follows each entry's version chain with HeapFile::getVisibleTuple()
+   * and rechecks the key on the visible version, which an update may have
+   * changed. A version reached from several entries is returned once.
+   */
+  [[nodiscard]] std::vector<PinnedTupleView> findVisible(const HeapFile& heap_file, const Value& key,
+                                                         const VisibilityChecker& checker,
+                                                         const Snapshot& snapshot) const;
+
+private:
+  struct Bucket;
+  struct Segment;
+
+  ColumnId column_id_;
+  DataType data_type_;
+  std::vector<std::unique_ptr<Segment>> buckets_;   // Primary buckets, SEGMENT_BUCKETS per segment
+  std::vector<std::unique_ptr<Segment>> overflow_;  // Overflow buckets; 0 is never used
+  std::vector<uint32_t> free_overflow_;
+  size_t bucket_count_ = 0;
+  size_t overflow_count_ = 0;   // In use
+  size_t overflow_limit_ = 1;   // Overflow bucket numbers handed out so far
+  unsigned level_ = 0;          // 2^level_ <= bucket_count_ < 2^(level_ + 1)
+  size_t entry_count_ = 0;
+
+  HashIndex(ColumnId column_id, DataType data_type);
+
+  [[nodiscard]] Bucket& getBucket(size_t bucket) const noexcept;
+  [[nodiscard]] Bucket& getOverflow(uint32_t overflow) const noexcept;
+  [[nodiscard]] size_t getBucketNumber(uint32_t hash) const noexcept;
+
+  /**
+   * @brief Add an entry to a bucket's chain, adding an overflow bucket if it is full
+   */
+  void addEntry(size_t bucket, uint32_t hash, uint64_t packed);
+
+  /**
+   * @brief Grow by one bucket, splitting the next bucket in turn
+   */
+  void splitNext();
+
+  /**
+   * @brief Whether the tuple's column value is key
+   */
+  [[nodiscard]] bool matches(const TupleView& tuple, const Value& key) const noexcept;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_HASH_INDEX_HPP_
@@ -5,12 +5,55 @@
 #include "database/tuple.hpp"
 #include "database/schema.hpp"
 #include "database/page.hpp"
+#include "database/free_space_map.hpp"
+#include "database/visibility_map.hpp"
+#include "database/table_stats.hpp"
+#include "database/page_directory.hpp"
+#include "database/buffer_pool.hpp"
+#include "database/segment_file.hpp"
+#include "database/mapped_file.hpp"
+#include "database/write_ahead_log.hpp"
+#include "database/snapshot.hpp"
 #include <vector>
 #include <memory>
-#include <unordered_map>
+#include <optional>
+#include <span>
+#include <string>
 
 namespace database {
 
+class HeapScan;
+class TransactionManager;
+class VisibilityChecker;
+
+/**
+ * @brief PinnedTupleView - TupleView that keeps its page pinned
+ * 
+ * Returned by HeapFile::getTuple so a view into a buffer pool frame stays
+ * valid for as long as it is held. Copying it out as a plain TupleView
+ * drops that guarantee.
+ */
+class PinnedTupleView : public TupleView {
+public:
+  PinnedTupleView(const TupleView& view, PageGuard page) noexcept
+      : TupleView(view), page_(std::move(page)) {
+  }
+
+private:
+  PageGuard page_;
+};
+
+/**
+ * @brief PageVacuumResult - what HeapFile::vacuumPage() did to a page
+ */
+struct PageVacuumResult {
+  size_t bytes_reclaimed = 0;
+  bool dirtied = false;          // Pruned, frozen or had line pointers freed, and logged
+  TransactionId frozen_xid = 0;  // No xmin or xmax below it on the page needs the commit log
+  size_t dead_lines_freed = 0;
+  std::vector<TupleId> dead_tuple_ids;  // DEAD line pointers left for index cleanup
+};
+
 /**
  * @brief HeapFile - represents a single table
  * 
@@ -18,11 +61,76 @@ namespace database {
  * - Tuple insertion, updates, and deletes
  * - Page allocation and management
  * - Tuple version chains (for MVCC)
+ * 
+ * An update never overwrites a row: it writes a new version and stamps the
+ * old one with the updater as xmax and the new version's TupleId as ctid,
+ * so each row is a chain of versions that readers follow to the one their
+ * snapshot sees. The new version is kept on the old one's page when it
+ * fits, which makes the update heap-only (HOT) unless it changes an
+ * indexed column (see TupleHeader).
+ * 
+ * Free space per page is tracked in a FreeSpaceMap so inserts find a page
+ * with room without scanning the whole file.
+ * 
+ * Given a TransactionManager, a page that an insert or update finds too
+ * full is first pruned (see Page::prune()) of versions dead to every
+ * running transaction, and the page is used if that made room. Under a
+ * steady update load the table thus reuses its space instead of growing.
+ * Vacuum (see VacuumManager) prunes the remaining pages, frees the DEAD
+ * line pointers pruning leaves behind once no index entry points at them,
+ * and records in a VisibilityMap which pages hold only versions everyone
+ * sees; every change to a page clears its bits. Inserts, updates and deletes are
+ * counted in TableStats, which autovacuum reads from other threads.
+ * 
+ * A heap file is either in-memory, owning its pages and resolving PageIds
+ * through a PageDirectory in constant time, or disk-backed (see open()),
+ * storing pages in a SegmentFile and accessing them through a BufferPool.
+ * A segment file can also be opened read-only (see openMapped()), serving
+ * reads straight from a memory mapping of it. All page access goes through
+ * PageGuards, so every kind behaves the same.
  */
 class HeapFile {
 public:
+  static constexpr size_t DEFAULT_PAGE_SIZE = Page::DEFAULT_PAGE_SIZE;
+  
+  /**
+   * @brief Create an empty in-memory heap file
+   */
   HeapFile(TableId table_id, const Schema& schema);
-  ~HeapFile() = default;
+  
+  /**
+   * @brief Open a disk-backed heap file, creating the segment file if needed
+   * 
+   * The free space map is loaded from "<path>.fsm" when present and rebuilt
+   * from the pages otherwise. buffer_pool must outlive the heap file and use
+   * DEFAULT_PAGE_SIZE pages.
+   * @return HeapFile if successful, nullptr otherwise
+   */
+  [[nodiscard]] static std::unique_ptr<HeapFile> open(TableId table_id, const Schema& schema,
+                                                      BufferPool& buffer_pool, const std::string& path);
+  
+  /**
+   * @brief Open a segment file read-only by memory-mapping it
+   * 
+   * Nothing is read or validated up front, so opening takes the same time
+   * for any file size; getTuple() and scans read the mapped pages in place,
+   * bypassing the buffer pool, and a page that turns out to be malformed
+   * reads as missing. The heap file rejects every modification. The file
+   * must not be written while it is mapped.
+   * @return HeapFile if the file could be mapped, nullptr otherwise
+   */
+  [[nodiscard]] static std::unique_ptr<HeapFile> openMapped(TableId table_id, const Schema& schema,
+                                                            const std::string& path);
+  
+  /**
+   * @brief Where open() persists the free space map of the segment file at segment_path
+   */
+  [[nodiscard]] static std::string getFreeSpaceMapPath(const std::string& segment_path);
+  
+  /**
+   * @brief Flushes a disk-backed heap file
+   */
+  ~HeapFile();
   
   // Disable copy (heap files are unique)
   HeapFile(const HeapFile&) = delete;
@@ -34,51 +142,246 @@ public:
   
   [[nodiscard]] TableId getTableId() const noexcept { return table_id_; }
   [[nodiscard]] const Schema& getSchema() const noexcept { return schema_; }
-  [[nodiscard]] size_t getPageCount() const noexcept { return pages_.size(); }
+  [[nodiscard]] size_t getPageCount() const noexcept { return next_page_id_ - 1; }
+  [[nodiscard]] PageId getPageIdLimit() const noexcept { return next_page_id_; }  // One past the last page ID
+  [[nodiscard]] const FreeSpaceMap& getFreeSpaceMap() const noexcept { return free_space_map_; }
+  [[nodiscard]] const VisibilityMap& getVisibilityMap() const noexcept { return visibility_map_; }
+  [[nodiscard]] const TableStats& getStats() const noexcept { return *stats_; }
+  [[nodiscard]] TableStats& getStats() noexcept { return *stats_; }
+  [[nodiscard]] bool isDiskBacked() const noexcept { return segment_ != nullptr || mapped_.has_value(); }
+  [[nodiscard]] bool isReadOnly() const noexcept { return mapped_.has_value(); }
+  
+  /**
+   * @brief Hint that pages [first_page_id, end_page_id) will be read in order (read-only heap files only)
+   */
+  void adviseSequential(PageId first_page_id, PageId end_page_id) const noexcept;
+  
+  /**
+   * @brief Hint that pages [first_page_id, end_page_id) are about to be read (read-only heap files only)
+   */
+  void adviseWillNeed(PageId first_page_id, PageId end_page_id) const noexcept;
+  
+  /**
+   * @brief Log every change to wal as a redo record and stamp pages with its LSN
+   */
+  void setWriteAheadLog(WriteAheadLog* wal) noexcept { wal_ = wal; }
+  
+  /**
+   * @brief Prune full pages of versions that are dead to every transaction of txn_manager
+   * 
+   * Snapshots must then be taken by transactions of txn_manager: one taken
+   * with no owner may lose versions it sees.
+   */
+  void setTransactionManager(const TransactionManager* txn_manager) noexcept { txn_manager_ = txn_manager; }
+  
+  /**
+   * @brief Write dirty pages and the free space map of a disk-backed heap file to disk
+   * @return true if successful (always for in-memory heap files)
+   */
+  bool flush();
   
   /**
    * @brief Insert a tuple into the heap file
-   * @return TupleId if successful, nullptr otherwise
+   * 
+   * The stored version gets a fresh header with txn_id as xmin; the header
+   * of tuple is ignored.
+   * @return TupleId if successful, nullptr otherwise (always for a read-only heap file)
    */
   std::unique_ptr<TupleId> insertTuple(const Tuple& tuple, TransactionId txn_id);
   
   /**
-   * @brief Update a tuple in the heap file
-   * @return New TupleId if successful (for version chaining), nullptr otherwise
+   * @brief Bulk-insert tuples into freshly allocated pages
+   * 
+   * Packs the tuples into new pages in one pass, bypassing the free space
+   * search, and writes each TupleId into tuple_ids (which must be at least as
+   * long as tuples). Does no per-row heap allocation. Stops at the first
+   * tuple that does not match the schema or cannot fit on a page. Like
+   * insertTuple(), stamps every stored version with txn_id as xmin.
+   * @return Number of tuples inserted (a prefix of tuples)
+   */
+  size_t insertBatch(std::span<const Tuple> tuples, std::span<TupleId> tuple_ids, TransactionId txn_id);
+  
+  /**
+   * @brief Append pages that were filled outside the heap file (e.g. by a bulk load)
+   * 
+   * The pages are renumbered to the next free page IDs, in order, and must
+   * hold tuples in this heap file's schema and page size. Either all of
+   * them are appended or none: if a disk-backed heap file runs out of
+   * buffer frames part way, the pages appended so far are cut off again.
+   * Their page images may already be in the write-ahead log, so the
+   * tuples must belong to a transaction that aborts if this fails.
+   * @return false if a disk-backed heap file ran out of buffer frames or
+   *         the heap file is read-only
+   */
+  bool appendPages(std::vector<std::unique_ptr<Page>> pages);
+  
+  /**
+   * @brief Cut off every page from first_page_id on
+   *
+   * Undoes appendPages() calls made since getPageIdLimit() was
+   * first_page_id, e.g. by a load that failed part way. As there, the
+   * page images may already be in the write-ahead log, so their tuples
+   * must belong to a transaction that aborts. Does nothing for a read-only
+   * heap file.
+   */
+  void truncatePages(PageId first_page_id);
+  
+  /**
+   * @brief Write new_tuple as the next version of tuple_id
+   * 
+   * The new version gets txn_id as xmin and goes on the old version's page
+   * if there is room, otherwise wherever an insert would go. It is
+   * heap-only, so indexes need no entry for it, when it stayed on the page
+   * and indexed_columns_changed is false. The caller must already have
+   * established that txn_id may update tuple_id (its xmax is unset or
+   * aborted).
+   * @return TupleId of the new version if successful, nullptr otherwise
    */
-  std::unique_ptr<TupleId> updateTuple(const TupleId& tuple_id, const Tuple& new_tuple, TransactionId txn_id);
+  std::unique_ptr<TupleId> updateTuple(const TupleId& tuple_id, const Tuple& new_tuple, TransactionId txn_id,
+                                       bool indexed_columns_changed = false);
   
   /**
    * @brief Delete a tuple from the heap file
+   *
+   * Stamps txn_id as the version's xmax: snapshots keep seeing it until
+   * txn_id commits, an abort brings it back, and it is pruned once no
+   * snapshot can see it. Does nothing if the slot holds no live version.
    */
   void deleteTuple(const TupleId& tuple_id, TransactionId txn_id);
   
   /**
    * @brief Get a tuple from the heap file
-   * @return Pointer to tuple if found, nullptr if deleted or not found
+   * 
+   * The view points into page memory and keeps the page pinned; it is
+   * invalidated by the next modification of that page.
+   * @return View of the tuple if found, std::nullopt if deleted or not found
    */
-  const Tuple* getTuple(const TupleId& tuple_id) const;
+  std::optional<PinnedTupleView> getTuple(const TupleId& tuple_id) const;
   
   /**
-   * @brief Get all tuples (for testing/debugging)
+   * @brief Prune a page now, whether or not it is full
+   * @return Bytes of free space gained, 0 without a transaction manager
    */
-  std::vector<Tuple> getAllTuples() const;
+  size_t prunePage(PageId page_id);
+  
+  /**
+   * @brief Prune a page and freeze it, setting its visibility map bits
+   * 
+   * The page is all-visible if, once pruned, each of its versions was
+   * created by a transaction the oldest running snapshot sees and has no
+   * xmax that may still commit. A version of an all-visible page whose xmin
+   * is below freeze_limit is frozen: its hint bits, now all set, are
+   * logged with the page. The page is all-frozen if all of them are.
+   * 
+   * With free_dead_lines, for a table no index points into, the page's
+   * DEAD line pointers are freed right away. Otherwise they are returned
+   * in dead_tuple_ids for the caller to clean out of its indexes and pass
+   * to freeDeadTuples(), and they keep the page from being all-visible
+   * until then, so the next vacuum visits it again.
+   * @return std::nullopt without a transaction manager, for a read-only
+   *         heap file, or if the page cannot be read
+   */
+  std::optional<PageVacuumResult> vacuumPage(PageId page_id, TransactionId freeze_limit,
+                                             bool free_dead_lines = false);
+  
+  /**
+   * @brief Free DEAD line pointers for reuse once no index entry points at them
+   * 
+   * TupleIds that do not name a DEAD line pointer are skipped. Each page
+   * changed is logged as a page image.
+   * @return Number of line pointers freed
+   */
+  size_t freeDeadTuples(std::span<const TupleId> tuple_ids);
+  
+  /**
+   * @brief Get the version of a row that snapshot sees
+   * 
+   * Starts at tuple_id, normally the version an index entry points at, and
+   * follows redirects and the ctid chain until it finds a visible version. A link whose
+   * target was not created by the previous version's xmax ends the chain,
+   * as the target slot then holds some other row.
+   * @return View of the visible version, std::nullopt if there is none
+   */
+  std::optional<PinnedTupleView> getVisibleTuple(const TupleId& tuple_id, const VisibilityChecker& checker,
+                                                 const Snapshot& snapshot) const;
 
 private:
+  friend class HeapScan;
+  
   TableId table_id_;
   const Schema& schema_;
   std::vector<std::unique_ptr<Page>> pages_;
+  PageDirectory page_directory_;
   PageId next_page_id_;
+  FreeSpaceMap free_space_map_;
+  VisibilityMap visibility_map_;
+  PageId target_page_id_;  // Page the last insert went to, tried before the free space map
+  BufferPool* buffer_pool_;             // Disk-backed only
+  std::unique_ptr<SegmentFile> segment_;  // Disk-backed only
+  std::optional<MappedFile> mapped_;      // Read-only only
+  WriteAheadLog* wal_;
+  const TransactionManager* txn_manager_;  // nullptr: pages are never pruned
+  std::unique_ptr<TableStats> stats_;      // Not movable itself
+  
+  HeapFile(TableId table_id, const Schema& schema, BufferPool& buffer_pool, std::unique_ptr<SegmentFile> segment);
+  HeapFile(TableId table_id, const Schema& schema, MappedFile mapped);
   
   /**
    * @brief Find or create a page with enough free space
    */
-  Page* findOrCreatePage(size_t required_size);
+  PageGuard findOrCreatePage(size_t required_size);
+  
+  /**
+   * @brief Prune page if it may hold dead versions, logging the result as a page image
+   * @return Bytes of free space gained
+   */
+  size_t prune(PageGuard& page);
+  
+  /**
+   * @brief Whether page has required_size bytes free, pruning it if that could help
+   */
+  bool makeRoom(PageGuard& page, size_t required_size);
+  
+  /**
+   * @brief Allocate a new empty page at the end of the file
+   * @return Guard for the page, empty if no buffer frame is available
+   */
+  PageGuard createPage();
+  
+  /**
+   * @brief Pin the page with the given ID
+   * @return Guard for the page, empty if it does not exist or cannot be read
+   */
+  PageGuard getPage(PageId page_id) const;
+  
+  /**
+   * @brief Start asynchronous reads of pages [first_page_id, first_page_id + count)
+   * 
+   * Goes through the buffer pool, or becomes a WILLNEED hint for a read-only heap file.
+   * @return Number of pages covered, as for BufferPool::prefetchPages() (count for in-memory heap files)
+   */
+  size_t prefetchPages(PageId first_page_id, size_t count) const;
+  
+  /**
+   * @brief Append a redo record for a change to page and stamp the page with its LSN
+   */
+  void logChange(PageGuard& page, WalRecordType type, TransactionId txn_id, const TupleId& tuple_id,
+                 std::span<const std::byte> payload = {});
+  
+  /**
+   * @brief Log the current bytes of a tuple as an INSERT or UPDATE record
+   */
+  void logTuple(PageGuard& page, WalRecordType type, TransactionId txn_id, const TupleId& tuple_id);
+  
+  /**
+   * @brief Log a full image of a page that was filled without per-tuple records
+   */
+  void logPageImage(PageGuard& page);
   
   /**
-   * @brief Get the page containing a tuple
+   * @brief Record a page's current free space in the free space map
    */
-  Page* getPage(PageId page_id) const;
+  void recordFreeSpace(const Page& page);
 };
 
 }  // namespace database
@@ -0,0 +1,111 @@
+#ifndef DATABASE_HEAP_SCAN_HPP_
+#define DATABASE_HEAP_SCAN_HPP_
+
+#include "database/types.hpp"
+#include "database/tuple.hpp"
+#include "database/heap_file.hpp"
+#include "database/snapshot.hpp"
+#include <optional>
+#include <vector>
+
+namespace database {
+
+class VisibilityChecker;
+
+/**
+ * @brief ScannedTuple - a tuple produced by a scan together with its location
+ */
+struct ScannedTuple {
+  TupleId tuple_id;
+  TupleView tuple;
+};
+
+/**
+ * @brief HeapScan - sequential scan cursor over a heap file
+ *
+ * Walks pages and slots in physical order and yields TupleViews pointing
+ * straight into page memory, so no row is copied unless the caller
+ * materializes it. Without a snapshot it yields every version still on the
+ * page, including deleted and superseded ones.
+ *
+ * A scan can be limited to a range of pages, which is how parallel scans
+ * split the work. Views are invalidated by modifications to their page, so
+ * the heap file must not be modified while a scan is open.
+ * 
+ * The scan pins the page it is on. For a disk-backed heap file a view from
+ * next() is therefore valid until the scan moves to the following page,
+ * and views from nextBatch() until the next nextBatch() call. It also
+ * keeps up to READAHEAD_PAGES pages ahead of itself being read
+ * asynchronously, so the pages are usually cached by the time it gets there.
+ * Over a read-only mapped heap file the scan instead advises the kernel that
+ * its range is read sequentially and that the readahead window is needed.
+ *
+ * Given a snapshot, the scan yields only the versions visible to it and
+ * leaves hint bits in the headers it checks (except in a read-only file).
+ * The hints are not logged and do not dirty the page, so they reach disk
+ * only with the page's next write.
+ */
+class HeapScan {
+public:
+  static constexpr size_t READAHEAD_PAGES = 32;
+
+  explicit HeapScan(const HeapFile& heap_file);
+
+  /**
+   * @brief Scan only pages in [first_page_id, end_page_id)
+   */
+  HeapScan(const HeapFile& heap_file, PageId first_page_id, PageId end_page_id);
+
+  /**
+   * @brief Yield only versions visible to snapshot from now on
+   * @param checker Must outlive the scan
+   */
+  void setSnapshot(const VisibilityChecker& checker, const Snapshot& snapshot);
+
+  /**
+   * @brief Advance to the next live tuple
+   * @return The tuple, or std::nullopt once the scan is exhausted
+   */
+  std::optional<ScannedTuple> next();
+
+  /**
+   * @brief Fill batch with up to max_tuples tuples
+   *
+   * batch is cleared first; reusing the same vector across calls avoids
+   * reallocating it.
+   * @return Number of tuples produced, 0 once the scan is exhausted
+   */
+  size_t nextBatch(std::vector<ScannedTuple>& batch, size_t max_tuples);
+
+private:
+  const HeapFile& heap_file_;
+  PageId end_page_id_;
+  PageId current_page_id_;
+  PageId readahead_page_id_;  // First page not yet prefetched
+  PageGuard current_page_;
+  uint16_t next_slot_;
+  std::vector<PageGuard> batch_pages_;  // Pages behind the current batch
+  bool in_batch_;
+  const VisibilityChecker* checker_;  // nullptr: every live tuple is yielded
+  Snapshot snapshot_;
+  
+  /**
+   * @brief Unpin the current page, keeping it pinned if a batch still refers to it
+   */
+  void releasePage();
+
+  /**
+   * @brief Move to the next page that exists in the heap file
+   * @return false once past the end of the range
+   */
+  bool advancePage();
+
+  /**
+   * @brief Keep readahead running READAHEAD_PAGES past the current page
+   */
+  void readAhead();
+};
+
+}  // namespace database
+
+#endif  // DATABASE_HEAP_SCAN_HPP_
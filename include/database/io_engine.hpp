@@ -0,0 +1,133 @@
+#ifndef DATABASE_IO_ENGINE_HPP_
+#define DATABASE_IO_ENGINE_HPP_
+
+#include "database/types.hpp"
+#include "database/segment_file.hpp"
+#include <cstddef>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace database {
+
+enum class IoOperation : uint8_t {
+  READ,
+  WRITE
+};
+
+/**
+ * @brief IoRequest - one page read or write
+ */
+struct IoRequest {
+  IoOperation operation;
+  SegmentFile* file;
+  PageId page_id;
+  std::byte* buffer;      // page_size bytes of the file
+  int buffer_index;       // Index passed to registerBuffers(), -1 if the buffer is not registered
+  uint64_t user_data;     // Handed back in the completion
+};
+
+/**
+ * @brief IoCompletion - a finished request
+ */
+struct IoCompletion {
+  uint64_t user_data;
+  size_t transferred;  // Bytes read or written; short of a page means the request failed
+};
+
+/**
+ * @brief Which IoEngine implementation to use
+ */
+enum class IoEngineType : uint8_t {
+  AUTO,      // io_uring where the kernel supports it, pread/pwrite otherwise
+  IO_URING,
+  PREAD
+};
+
+/**
+ * @brief IoEngine - batched, asynchronous page I/O
+ *
+ * Requests are queued with prepare() and handed over in one batch by
+ * submit(); finished requests are collected with reap(). At most
+ * getQueueDepth() requests are in flight, from prepare() until reaped.
+ *
+ * prepare() and submit() may be called from any thread, also concurrently:
+ * the buffer pool prepares under its latch and submits after releasing it,
+ * so a synchronous engine does its I/O without the latch. reap() runs on
+ * one thread at a time; the buffer pool lets a single waiter reap.
+ */
+class IoEngine {
+public:
+  virtual ~IoEngine() = default;
+
+  /**
+   * @brief Create an engine of the given type
+   * @return The engine, nullptr if type is unavailable on this system
+   */
+  [[nodiscard]] static std::unique_ptr<IoEngine> create(IoEngineType type = IoEngineType::AUTO,
+                                                        size_t queue_depth = 64);
+
+  [[nodiscard]] virtual IoEngineType getType() const noexcept = 0;
+  [[nodiscard]] size_t getQueueDepth() const noexcept { return queue_depth_; }
+  [[nodiscard]] size_t getInFlight() const noexcept { return in_flight_.load(); }
+
+  /**
+   * @brief Register page buffers once so requests on them skip per-I/O page pinning
+   * @return false if the engine does not support it; requests then pass buffer_index -1
+   */
+  virtual bool registerBuffers(std::span<std::byte* const> buffers, size_t buffer_size);
+
+  /**
+   * @brief Queue a request for the next submit()
+   * @return false if getQueueDepth() requests are already in flight
+   */
+  virtual bool prepare(const IoRequest& request) = 0;
+
+  /**
+   * @brief Start every prepared request
+   */
+  virtual void submit() = 0;
+
+  /**
+   * @brief Move finished requests into completions (appending)
+   *
+   * Blocks until at least min_complete requests have finished; min_complete
+   * must not exceed getInFlight().
+   * @return Number of completions added
+   */
+  virtual size_t reap(std::vector<IoCompletion>& completions, size_t min_complete) = 0;
+
+protected:
+  explicit IoEngine(size_t queue_depth) noexcept : queue_depth_(queue_depth) {
+  }
+
+  size_t queue_depth_;
+  std::atomic<size_t> in_flight_{ 0 };  // Prepared and not yet reaped
+};
+
+/**
+ * @brief PreadIoEngine - portable engine that performs requests synchronously
+ *
+ * submit() runs the batch with pread/pwrite; reap() never blocks.
+ */
+class PreadIoEngine final : public IoEngine {
+public:
+  explicit PreadIoEngine(size_t queue_depth);
+
+  [[nodiscard]] IoEngineType getType() const noexcept override { return IoEngineType::PREAD; }
+  bool prepare(const IoRequest& request) override;
+  void submit() override;
+  size_t reap(std::vector<IoCompletion>& completions, size_t min_complete) override;
+
+private:
+  std::mutex mutex_;  // Guards prepared_ and completed_ between prepare(), submit() and reap()
+  std::vector<IoRequest> prepared_;
+  std::vector<IoCompletion> completed_;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_IO_ENGINE_HPP_
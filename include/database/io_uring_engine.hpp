@@ -0,0 +1,71 @@
+#ifndef DATABASE_IO_URING_ENGINE_HPP_
+#define DATABASE_IO_URING_ENGINE_HPP_
+
+#include "database/io_engine.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace database {
+
+/**
+ * @brief IoUringEngine - Linux io_uring backend
+ *
+ * Talks to the kernel through the raw io_uring system calls, so no library
+ * is needed. Prepared requests become submission queue entries and one
+ * io_uring_enter() submits the whole batch; reap() reads the completion
+ * queue directly and only enters the kernel when it has to wait. With
+ * registered buffers, requests use READ_FIXED/WRITE_FIXED and the kernel
+ * does not pin the page frames on every I/O.
+ */
+class IoUringEngine final : public IoEngine {
+public:
+  /**
+   * @brief Set up a ring with room for queue_depth requests
+   * @return The engine, nullptr if io_uring is unavailable (non-Linux
+   *         systems, old kernels, or blocked by a sandbox)
+   */
+  [[nodiscard]] static std::unique_ptr<IoUringEngine> open(size_t queue_depth);
+
+  ~IoUringEngine() override;
+
+  // Disable copy and move (the rings are mapped at fixed addresses)
+  IoUringEngine(const IoUringEngine&) = delete;
+  IoUringEngine& operator=(const IoUringEngine&) = delete;
+  IoUringEngine(IoUringEngine&&) = delete;
+  IoUringEngine& operator=(IoUringEngine&&) = delete;
+
+  [[nodiscard]] IoEngineType getType() const noexcept override { return IoEngineType::IO_URING; }
+  bool registerBuffers(std::span<std::byte* const> buffers, size_t buffer_size) override;
+  bool prepare(const IoRequest& request) override;
+  void submit() override;
+  size_t reap(std::vector<IoCompletion>& completions, size_t min_complete) override;
+
+private:
+  int ring_fd_;
+  void* ring_ = nullptr;  // Submission and completion rings share one mapping
+  size_t ring_size_ = 0;
+  void* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+  void* cqes_ = nullptr;
+  uint32_t* sq_head_ = nullptr;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t* sq_array_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t* cq_head_ = nullptr;
+  uint32_t* cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  std::mutex submit_mutex_;  // Guards the submission queue tail and unsubmitted_
+  uint32_t unsubmitted_ = 0;
+  bool buffers_registered_ = false;
+  std::mutex failed_mutex_;           // Guards failed_ between submit() and reap()
+  std::vector<IoCompletion> failed_;  // Requests the kernel refused to take
+
+  IoUringEngine(int ring_fd, size_t queue_depth) noexcept;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_IO_URING_ENGINE_HPP_
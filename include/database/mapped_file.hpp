@@ -0,0 +1,69 @@
+#ifndef DATABASE_MAPPED_FILE_HPP_
+#define DATABASE_MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace database {
+
+/**
+ * @brief MappedFile - read-only memory mapping of a whole file
+ *
+ * Owns the mapping and unmaps it on destruction. Access hints are forwarded
+ * to madvise(); they are no-ops where the platform has no equivalent.
+ */
+class MappedFile {
+public:
+  /**
+   * @brief Map a file read-only
+   * @return MappedFile if the file could be opened and mapped, std::nullopt otherwise
+   */
+  [[nodiscard]] static std::optional<MappedFile> open(const std::string& path);
+
+  ~MappedFile();
+
+  // Disable copy (the mapping is unique)
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // Allow move
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  [[nodiscard]] const std::byte* data() const noexcept { return data_; }
+  [[nodiscard]] size_t size() const noexcept { return size_; }
+
+  /**
+   * @brief Hint that the mapping will be read front to back
+   */
+  void adviseSequential() const noexcept;
+
+  /**
+   * @brief Hint that [offset, offset + length) will be read front to back
+   */
+  void adviseSequential(size_t offset, size_t length) const noexcept;
+
+  /**
+   * @brief Hint that [offset, offset + length) will be read soon
+   */
+  void adviseWillNeed(size_t offset, size_t length) const noexcept;
+
+private:
+  std::byte* data_;
+  size_t size_;
+
+  MappedFile(std::byte* data, size_t size) noexcept : data_(data), size_(size) {
+  }
+
+  void unmap() noexcept;
+
+  /**
+   * @brief Apply a madvise() advice to the pages covering [offset, offset + length)
+   */
+  void advise(size_t offset, size_t length, int advice) const noexcept;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_MAPPED_FILE_HPP_
@@ -3,58 +3,256 @@
 
 #include "database/types.hpp"
 #include "database/tuple.hpp"
-#include <vector>
+#include "database/schema.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
-#include <unordered_map>
+#include <optional>
+#include <span>
+#include <vector>
 
 namespace database {
 
+/**
+ * @brief PageHeader - fixed header at the start of every page
+ *
+ * lower is the end of the line pointer array (grows towards the end of the
+ * page), upper is the start of the tuple data (grows towards the header).
+ * The gap between them is the page's free space.
+ */
+struct PageHeader {
+  static constexpr uint16_t PRUNABLE = 0x0001;        // May hold versions that have died since the last prune
+  static constexpr uint16_t HAS_FREE_LINES = 0x0002;  // Some line pointer is UNUSED
+
+  PageId page_id;
+  Lsn lsn;  // End of the last WAL record that modified the page
+  uint16_t lower;
+  uint16_t upper;
+  uint16_t slot_count;
+  uint16_t flags;
+};
+
+/**
+ * @brief LinePointer - slot entry pointing at a tuple's bytes within the page
+ *
+ * Packed into 32 bits like PostgreSQL's ItemId: 15 bits of offset, 2 bits of
+ * state and 15 bits of length. A REDIRECT pointer stores the slot it
+ * redirects to in the offset bits.
+ */
+class LinePointer {
+public:
+  enum class State : uint8_t {
+    UNUSED = 0,    // Free for reuse
+    NORMAL = 1,
+    REDIRECT = 2,  // Root of a HOT chain whose first versions were pruned
+    DEAD = 3       // Pruned chain root that indexes may still point at
+  };
+
+  LinePointer() = default;
+  LinePointer(uint16_t offset, uint16_t length, State state) noexcept
+      : word_((static_cast<uint32_t>(offset) & 0x7FFFU) |
+              ((static_cast<uint32_t>(state) & 0x3U) << 15) |
+              ((static_cast<uint32_t>(length) & 0x7FFFU) << 17)) {
+  }
+
+  [[nodiscard]] uint16_t getOffset() const noexcept { return static_cast<uint16_t>(word_ & 0x7FFFU); }
+  [[nodiscard]] uint16_t getLength() const noexcept { return static_cast<uint16_t>((word_ >> 17) & 0x7FFFU); }
+  [[nodiscard]] State getState() const noexcept { return static_cast<State>((word_ >> 15) & 0x3U); }
+  [[nodiscard]] bool isNormal() const noexcept { return getState() == State::NORMAL; }
+  [[nodiscard]] bool isRedirect() const noexcept { return getState() == State::REDIRECT; }
+
+private:
+  uint32_t word_ = 0;
+};
+
+static_assert(sizeof(LinePointer) == 4, "LinePointer must stay 4 bytes");
+
 /**
  * @brief Page - fixed-size storage unit containing tuples
- * 
+ *
  * A page is a fixed-size storage unit (typically 8KB) that contains
  * multiple tuple slots. Pages manage tuple insertion, updates, and deletes
  * within their storage space.
+ *
+ * The page is a single contiguous buffer laid out as a slotted page:
+ *
+ *   | PageHeader | LinePointer[0..n) -> free space <- tuple data |
+ *
+ * Tuples are stored serialized and 8-byte aligned, so a point lookup reads
+ * one line pointer and then the tuple bytes directly.
+ *
+ * prune() reclaims the space of versions that no snapshot can see any
+ * more, PostgreSQL-style: dead heap-only versions free their line pointer
+ * for reuse, the root of a HOT chain whose head died becomes a redirect to
+ * the first surviving version (or DEAD if none survives, since indexes
+ * point at roots), and the remaining tuples are packed together so the
+ * freed bytes become one contiguous free space. A DEAD line pointer is
+ * freed by freeDeadLines() once no index entry points at it any more.
  */
 class Page {
 public:
+  static constexpr size_t DEFAULT_PAGE_SIZE = 8192;  // 8KB
+  static constexpr size_t MAX_PAGE_SIZE = 32768;  // Line pointer offsets are 15 bits
+  static constexpr size_t TUPLE_ALIGNMENT = 8;
+
+  /**
+   * @throws std::invalid_argument if page_size cannot hold a header or exceeds MAX_PAGE_SIZE
+   */
   Page(PageId page_id, size_t page_size);
+
+  /**
+   * @brief Read-only view over page bytes owned elsewhere, such as a file mapping
+   *
+   * The view never copies the bytes; it must not be modified and must not
+   * outlive them.
+   * @return The view, std::nullopt if the bytes are not a well-formed page numbered page_id
+   */
+  [[nodiscard]] static std::optional<Page> view(PageId page_id, const std::byte* data, size_t page_size) noexcept;
   ~Page() = default;
-  
+
   // Disable copy (pages are unique)
   Page(const Page&) = delete;
   Page& operator=(const Page&) = delete;
-  
+
   // Allow move
   Page(Page&&) = default;
   Page& operator=(Page&&) = default;
-  
+
   [[nodiscard]] PageId getPageId() const noexcept { return page_id_; }
-  [[nodiscard]] size_t getFreeSpace() const noexcept { return free_space_; }
   
+  /**
+   * @brief Renumber the page, used when a heap file adopts a page built outside it
+   */
+  void setPageId(PageId page_id) noexcept;
+  [[nodiscard]] size_t getPageSize() const noexcept { return page_size_; }
+  [[nodiscard]] Lsn getLsn() const noexcept { return header().lsn; }
+  void setLsn(Lsn lsn) noexcept { header().lsn = lsn; }
+  
+  /**
+   * @brief Raw page bytes, for reading and writing the page to disk
+   */
+  [[nodiscard]] std::byte* getData() noexcept { return data_; }
+  [[nodiscard]] const std::byte* getData() const noexcept { return data_; }
+  
+  /**
+   * @brief Re-format the page as an empty page with the given ID
+   */
+  void reset(PageId page_id) noexcept;
+  
+  /**
+   * @brief Adopt the header after the bytes were filled in from disk
+   * @return false if the bytes are not a well-formed page numbered page_id
+   */
+  [[nodiscard]] bool loadHeader(PageId page_id) noexcept;
+  [[nodiscard]] size_t getFreeSpace() const noexcept;
+  [[nodiscard]] uint16_t getSlotCount() const noexcept { return header().slot_count; }
+
+  /**
+   * @brief Space a tuple of tuple_size bytes consumes on a page, including its line pointer
+   */
+  [[nodiscard]] static constexpr size_t getRequiredSpace(size_t tuple_size) noexcept {
+    return alignTupleSize(tuple_size) + sizeof(LinePointer);
+  }
+
   /**
    * @brief Insert a tuple into the page
-   * @return TupleId (page_id, slot_number) if successful, nullptr otherwise
+   * @return TupleId (page_id, slot_number) if successful, nullptr if it does
+   *         not fit or does not match its schema
    */
   std::unique_ptr<TupleId> insertTuple(const Tuple& tuple);
   
+  /**
+   * @brief Insert a tuple without allocating a TupleId
+   * 
+   * Skips the schema check; the caller must have validated the tuple.
+   * @return Slot number if the tuple fits, std::nullopt otherwise
+   */
+  std::optional<uint16_t> addTuple(const Tuple& tuple, size_t tuple_size);
+  
+  /**
+   * @brief Insert an already serialized tuple (e.g. from TupleBuilder)
+   * @return Slot number if the tuple fits, std::nullopt otherwise
+   */
+  std::optional<uint16_t> addTupleBytes(std::span<const std::byte> tuple_bytes);
+
   /**
    * @brief Get a tuple from the page
-   * @return Pointer to tuple if found, nullptr if deleted or not found
+   * @return View over the tuple's bytes if found, std::nullopt if deleted or not found
+   */
+  [[nodiscard]] std::optional<TupleView> getTuple(const TupleId& tuple_id, const Schema& schema) const;
+
+  /**
+   * @brief Whether the page may hold versions prune() could remove
+   */
+  [[nodiscard]] bool isPrunable() const noexcept { return (header().flags & PageHeader::PRUNABLE) != 0; }
+  
+  /**
+   * @brief Note that a version on the page was deleted or superseded
+   */
+  void setPrunable() noexcept { header().flags = static_cast<uint16_t>(header().flags | PageHeader::PRUNABLE); }
+  
+  /**
+   * @brief Remove dead versions and compact the tuple area
+   *
+   * is_dead is asked about every NORMAL tuple that deleteTuple() has not
+   * already removed outright. The page stays PRUNABLE if
+   * a version that is not dead yet has been deleted or superseded.
+   * @return Bytes of free space gained
+   */
+  size_t prune(const std::function<bool(const TupleHeader&)>& is_dead);
+  
+  /**
+   * @brief Append the slots whose line pointer is DEAD to slots
+   */
+  void collectDeadLines(std::vector<uint16_t>& slots) const;
+  
+  /**
+   * @brief Mark the DEAD line pointers among slots UNUSED, so inserts reuse them
+   *
+   * Slots that are not DEAD are left alone. The caller must have removed
+   * every index entry pointing at the slots first.
+   * @return Number of line pointers freed
    */
-  const Tuple* getTuple(const TupleId& tuple_id) const;
+  size_t freeDeadLines(std::span<const uint16_t> slots) noexcept;
   
+  /**
+   * @brief Where tuple_id leads: the slot a REDIRECT points at, else tuple_id itself
+   */
+  [[nodiscard]] TupleId resolveRedirect(const TupleId& tuple_id) const noexcept;
+
+  /**
+   * @brief Header of a live tuple, for stamping it in place (xmax, ctid, flags)
+   * @return Header, nullptr if tuple_id does not name a live tuple on this page
+   */
+  [[nodiscard]] TupleHeader* getTupleHeader(const TupleId& tuple_id) noexcept;
+
   /**
    * @brief Update a tuple in the page
+   *
+   * Overwrites the old bytes when the new tuple fits in them, otherwise moves
+   * the tuple into the page's free space.
    * @return true if successful, false otherwise
    */
   bool updateTuple(const TupleId& tuple_id, const Tuple& new_tuple);
-  
+
+  /**
+   * @brief Update a tuple from already serialized bytes (e.g. during WAL redo)
+   *
+   * Places the bytes exactly where updateTuple() would place a tuple of the
+   * same size.
+   * @return true if successful, false otherwise
+   */
+  bool updateTupleBytes(const TupleId& tuple_id, std::span<const std::byte> tuple_bytes);
+
   /**
-   * @brief Delete a tuple from the page
+   * @brief Delete a tuple from the page outright, with no MVCC
+   *
+   * The tuple disappears at once and its space is reclaimed by the next
+   * prune(); HeapFile::deleteTuple() stamps xmax instead.
    */
   void deleteTuple(const TupleId& tuple_id);
-  
+
   /**
    * @brief Check if page has enough free space for a tuple
    */
@@ -63,16 +261,55 @@ public:
 private:
   PageId page_id_;
   size_t page_size_;
-  size_t free_space_;
+  std::unique_ptr<std::byte[]> storage_;  // Empty for a view
+  std::byte* data_;
+  
+  Page(PageId page_id, size_t page_size, std::byte* data) noexcept;
+
+  [[nodiscard]] static constexpr size_t alignTupleSize(size_t size) noexcept {
+    return (size + TUPLE_ALIGNMENT - 1) & ~(TUPLE_ALIGNMENT - 1);
+  }
+
+  [[nodiscard]] PageHeader& header() noexcept { return *reinterpret_cast<PageHeader*>(data_); }
+  [[nodiscard]] const PageHeader& header() const noexcept { return *reinterpret_cast<const PageHeader*>(data_); }
+  [[nodiscard]] TupleHeader& tupleHeaderAt(uint16_t offset) noexcept {
+    return *reinterpret_cast<TupleHeader*>(data_ + offset);
+  }
+  [[nodiscard]] const TupleHeader& tupleHeaderAt(uint16_t offset) const noexcept {
+    return *reinterpret_cast<const TupleHeader*>(data_ + offset);
+  }
+  [[nodiscard]] LinePointer* linePointers() noexcept;
+  [[nodiscard]] const LinePointer* linePointers() const noexcept;
+
+  /**
+   * @brief Resolve a TupleId to its line pointer, nullptr if it does not name a live tuple here
+   */
+  [[nodiscard]] const LinePointer* findLinePointer(const TupleId& tuple_id) const noexcept;
+
+  /**
+   * @brief Carve tuple_size bytes off the top of the free space
+   * @return Offset of the reserved bytes, std::nullopt if they do not fit
+   */
+  std::optional<uint16_t> allocateTupleSpace(size_t tuple_size, size_t extra) noexcept;
+
+  /**
+   * @brief Choose where the new version of a live tuple goes
+   * @return Offset for new_size bytes, std::nullopt if the tuple is not live or they do not fit
+   */
+  std::optional<uint16_t> placeUpdate(const TupleId& tuple_id, size_t new_size) noexcept;
   
-  // Store tuples by slot number
-  std::unordered_map<uint16_t, std::unique_ptr<Tuple>> slots_;
-  uint16_t next_slot_;
+  /**
+   * @brief Drop trailing UNUSED line pointers and recompute HAS_FREE_LINES
+   */
+  void trimLinePointers() noexcept;
   
-  size_t calculateSlotSize(const Tuple& tuple) const;
+  /**
+   * @brief Add a line pointer for tuple bytes already written at offset,
+   *        reusing an UNUSED one if there is any
+   */
+  uint16_t addLinePointer(uint16_t offset, size_t tuple_size) noexcept;
 };
 
 }  // namespace database
 
 #endif  // DATABASE_PAGE_HPP_
-
@@ -0,0 +1,77 @@
+#ifndef DATABASE_PAGE_DIRECTORY_HPP_
+#define DATABASE_PAGE_DIRECTORY_HPP_
+
+#include "database/types.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace database {
+
+class Page;
+
+/**
+ * @brief PageDirectory - constant-time PageId to Page lookup
+ *
+ * Page IDs are handed out densely, so the directory is a two-level array:
+ * the high bits of a PageId select a chunk and the low bits an entry in it.
+ * A lookup is two dependent loads regardless of how many pages exist.
+ *
+ * Entries are non-owning. A page that is truncated away or evicted is
+ * simply erased; chunks that become empty are released so sparse or
+ * truncated ranges do not keep memory alive.
+ */
+class PageDirectory {
+public:
+  static constexpr size_t CHUNK_BITS = 10;
+  static constexpr size_t CHUNK_SIZE = size_t{1} << CHUNK_BITS;
+
+  PageDirectory() = default;
+  ~PageDirectory() = default;
+
+  // Disable copy (entries mirror pages owned elsewhere)
+  PageDirectory(const PageDirectory&) = delete;
+  PageDirectory& operator=(const PageDirectory&) = delete;
+
+  // Allow move
+  PageDirectory(PageDirectory&&) = default;
+  PageDirectory& operator=(PageDirectory&&) = default;
+
+  /**
+   * @brief Look up a page
+   * @return Pointer to Page if present, nullptr otherwise
+   */
+  [[nodiscard]] Page* get(PageId page_id) const noexcept {
+    size_t chunk_index = page_id >> CHUNK_BITS;
+    if (chunk_index >= chunks_.size() || !chunks_[chunk_index]) {
+      return nullptr;
+    }
+    return chunks_[chunk_index]->entries[page_id & (CHUNK_SIZE - 1)];
+  }
+
+  /**
+   * @brief Register (or replace) the page stored under page_id
+   */
+  void set(PageId page_id, Page* page);
+
+  /**
+   * @brief Remove a page from the directory
+   */
+  void erase(PageId page_id);
+
+  [[nodiscard]] size_t size() const noexcept { return size_; }
+
+private:
+  struct Chunk {
+    std::array<Page*, CHUNK_SIZE> entries{};
+    size_t used = 0;
+  };
+
+  std::vector<std::unique_ptr<Chunk>> chunks_;
+  size_t size_ = 0;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_PAGE_DIRECTORY_HPP_
@@ -0,0 +1,94 @@
+#ifndef DATABASE_PARALLEL_HEAP_SCAN_HPP_
+#define DATABASE_PARALLEL_HEAP_SCAN_HPP_
+
+#include "database/types.hpp"
+#include "database/heap_file.hpp"
+#include "database/heap_scan.hpp"
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace database {
+
+/**
+ * @brief ParallelHeapScan - splits a heap file scan across worker threads
+ *
+ * The page space is cut into fixed-size chunks of consecutive pages. Workers
+ * claim chunks through a shared atomic cursor, so faster workers simply take
+ * more chunks and no thread idles while work remains. Each worker scans its
+ * chunks with a HeapScan into a private partial result; the partials are
+ * merged once all workers have finished.
+ *
+ * As with HeapScan, the heap file must not be modified during the scan.
+ */
+class ParallelHeapScan {
+public:
+  static constexpr size_t DEFAULT_PAGES_PER_CHUNK = 32;
+
+  ParallelHeapScan(const HeapFile& heap_file, size_t worker_count, size_t pages_per_chunk = DEFAULT_PAGES_PER_CHUNK);
+
+  // Disable copy and move (workers share the cursor)
+  ParallelHeapScan(const ParallelHeapScan&) = delete;
+  ParallelHeapScan& operator=(const ParallelHeapScan&) = delete;
+  ParallelHeapScan(ParallelHeapScan&&) = delete;
+  ParallelHeapScan& operator=(ParallelHeapScan&&) = delete;
+
+  [[nodiscard]] size_t getWorkerCount() const noexcept { return worker_count_; }
+
+  /**
+   * @brief Claim the next unscanned chunk (thread-safe)
+   * @return Scan over the chunk's pages, std::nullopt once every chunk is claimed
+   */
+  std::optional<HeapScan> claimChunk();
+
+  /**
+   * @brief Run the scan and aggregate its result
+   *
+   * Every worker starts from a copy of initial and calls
+   * scan_fn(partial, const ScannedTuple&) for each tuple it reads. The
+   * partials are then folded together with merge_fn(result, partial).
+   * Resets the cursor first, so the same object can run several scans.
+   */
+  template <typename Result, typename ScanFn, typename MergeFn>
+  Result run(const Result& initial, ScanFn scan_fn, MergeFn merge_fn) {
+    next_page_id_.store(1, std::memory_order_relaxed);
+
+    std::vector<Result> partials(worker_count_, initial);
+    auto worker = [&](size_t index) {
+      Result& partial = partials[index];
+      while (auto scan = claimChunk()) {
+        while (auto scanned = scan->next()) {
+          scan_fn(partial, *scanned);
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(worker_count_ - 1);
+    for (size_t i = 1; i < worker_count_; ++i) {
+      threads.emplace_back(worker, i);
+    }
+    worker(0);  // The calling thread works too
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    Result result = initial;
+    for (const auto& partial : partials) {
+      merge_fn(result, partial);
+    }
+    return result;
+  }
+
+private:
+  const HeapFile& heap_file_;
+  size_t worker_count_;
+  size_t pages_per_chunk_;
+  PageId end_page_id_;
+  alignas(64) std::atomic<PageId> next_page_id_;  // Own cache line; every claim writes it
+};
+
+}  // namespace database
+
+#endif  // DATABASE_PARALLEL_HEAP_SCAN_HPP_
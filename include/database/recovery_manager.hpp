@@ -0,0 +1,83 @@
+#ifndef DATABASE_RECOVERY_MANAGER_HPP_
+#define DATABASE_RECOVERY_MANAGER_HPP_
+
+#include "database/types.hpp"
+#include "database/buffer_pool.hpp"
+#include "database/write_ahead_log.hpp"
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace database {
+
+class TransactionManager;
+
+/**
+ * @brief RecoveryResult - outcome of a crash recovery
+ */
+struct RecoveryResult {
+  bool success = false;
+  Lsn redo_lsn = 0;            // Where replay started
+  size_t records_applied = 0;  // Page changes redone
+  size_t records_skipped = 0;  // Page changes the page already had
+  size_t transactions_recovered = 0;  // Outcomes replayed into the TransactionManager
+  std::string error_message;
+};
+
+/**
+ * @brief RecoveryManager - redoes logged page changes after a crash
+ *
+ * Replay starts at the redo LSN of the last checkpoint named by the control
+ * file (the start of the log if there is none). Page changes are physical
+ * and each page's LSN says which records it already reflects, so redo is
+ * idempotent and only has to keep each page's records in log order.
+ * Records are therefore partitioned by (TableId, PageId) across threads and
+ * every thread replays its pages independently. Pages that never reached
+ * disk are re-created from their records.
+ *
+ * Redo repeats history: changes of transactions that never committed are
+ * redone as well and left to visibility checks. Given a TransactionManager,
+ * recovery therefore also restores every transaction's outcome: those
+ * decided before the redo LSN from the commit log the checkpoint saved,
+ * the rest from the COMMIT and ABORT records replayed. A transaction with
+ * no outcome was cut off by the crash and is ABORTED. The manager then
+ * assigns IDs from the checkpoint's next ID or past the largest one
+ * replayed, so none already in a tuple header is reused. The log before
+ * the redo LSN is never read and can be recycled. Recovery must run before
+ * the tables are opened; on success every replayed page has been written
+ * back and synced, and the free space maps of the replayed tables are
+ * removed so they are rebuilt from the pages.
+ */
+class RecoveryManager {
+public:
+  /**
+   * @brief Maps a table to the path of its segment file
+   */
+  using SegmentPathFunction = std::function<std::string(TableId)>;
+
+  /**
+   * @param txn_manager Receives the recovered transaction outcomes; nullptr
+   *        to only redo page changes
+   */
+  RecoveryManager(BufferPool& buffer_pool, std::string wal_path, std::string control_path,
+                  SegmentPathFunction segment_path, TransactionManager* txn_manager = nullptr);
+
+  /**
+   * @brief Replay the log with thread_count threads
+   *
+   * thread_count 0 means std::thread::hardware_concurrency(); it is capped
+   * at the buffer pool's frame count since every thread pins one page.
+   */
+  RecoveryResult recover(size_t thread_count);
+
+private:
+  BufferPool& buffer_pool_;
+  std::string wal_path_;
+  std::string control_path_;
+  SegmentPathFunction segment_path_;
+  TransactionManager* txn_manager_;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_RECOVERY_MANAGER_HPP_
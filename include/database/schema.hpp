@@ -3,6 +3,8 @@
 
 #include "database/types.hpp"
 #include "database/value.hpp"
+#include <iosfwd>
+#include <optional>
 #include <string>
 #include <vector>
 #include <memory>
@@ -41,6 +43,47 @@ private:
   bool primary_key_;
 };
 
+/**
+ * @brief TupleLayout - byte layout of a serialized tuple for one schema
+ * 
+ * A serialized tuple is laid out as:
+ * - TupleHeader
+ * - Null bitmap, one bit per column (set = NULL)
+ * - Fixed-width area, 8-byte aligned: INTEGER/DOUBLE values first, then
+ *   (offset, length) descriptors for TEXT columns, then BOOLEAN bytes
+ * - Varlena area holding TEXT bytes
+ * 
+ * Offsets are computed once per schema so reading a column is a single
+ * offset add. Columns are addressed by their position in the schema.
+ */
+class TupleLayout {
+public:
+  TupleLayout() = default;
+  explicit TupleLayout(const std::vector<Column>& columns);
+  
+  [[nodiscard]] size_t getColumnCount() const noexcept { return column_offsets_.size(); }
+  [[nodiscard]] DataType getColumnType(ColumnId column_id) const noexcept { return column_types_[column_id]; }
+  [[nodiscard]] uint16_t getColumnOffset(ColumnId column_id) const noexcept { return column_offsets_[column_id]; }
+  [[nodiscard]] uint16_t getNullBitmapOffset() const noexcept { return null_bitmap_offset_; }
+  [[nodiscard]] uint16_t getFixedSize() const noexcept { return fixed_size_; }  // Also the varlena start
+  [[nodiscard]] const std::vector<ColumnId>& getTextColumns() const noexcept { return text_columns_; }
+
+private:
+  uint16_t null_bitmap_offset_ = 0;
+  uint16_t fixed_size_ = 0;
+  std::vector<uint16_t> column_offsets_;
+  std::vector<DataType> column_types_;
+  std::vector<ColumnId> text_columns_;
+};
+
+/**
+ * @brief TextDescriptor - fixed-width slot locating a TEXT value in the varlena area
+ */
+struct TextDescriptor {
+  uint16_t offset;  // From the start of the tuple
+  uint16_t length;
+};
+
 /**
  * @brief Schema - represents a table schema with columns
  */
@@ -58,9 +101,29 @@ public:
   void addColumn(const Column& column);
   [[nodiscard]] const Column* getColumn(ColumnId column_id) const;
   [[nodiscard]] size_t getColumnCount() const noexcept { return columns_.size(); }
+  [[nodiscard]] const std::vector<Column>& getColumns() const noexcept { return columns_; }
+  [[nodiscard]] const TupleLayout& getLayout() const noexcept { return layout_; }
+  
+  /**
+   * @brief Explicit copy, for owners that must not depend on the caller's schema (e.g. the catalog)
+   */
+  [[nodiscard]] Schema clone() const;
+  
+  /**
+   * @brief Persist the schema (column count, then per column its ID, type, flags and name)
+   * @return true if successful, false otherwise
+   */
+  bool writeTo(std::ostream& out) const;
+  
+  /**
+   * @brief Load a schema written by writeTo()
+   * @return Schema if the stream is well formed, std::nullopt otherwise
+   */
+  [[nodiscard]] static std::optional<Schema> readFrom(std::istream& in);
 
 private:
   std::vector<Column> columns_;
+  TupleLayout layout_;  // Recomputed whenever a column is added
 };
 
 }  // namespace database
@@ -0,0 +1,82 @@
+#ifndef DATABASE_SEGMENT_FILE_HPP_
+#define DATABASE_SEGMENT_FILE_HPP_
+
+#include "database/types.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+
+namespace database {
+
+/**
+ * @brief SegmentFile - on-disk page store for one table
+ *
+ * Pages are fixed size and stored back to back: page N (page IDs start at
+ * 1) lives at byte offset (N - 1) * page_size. Reads and writes use
+ * pread/pwrite, so concurrent callers do not share a file position.
+ */
+class SegmentFile {
+public:
+  /**
+   * @brief Open a segment file, creating it if it does not exist
+   * @return SegmentFile if successful, nullptr otherwise
+   */
+  [[nodiscard]] static std::unique_ptr<SegmentFile> open(const std::string& path, size_t page_size);
+
+  ~SegmentFile();
+
+  // Disable copy and move (buffer frames refer to segment files by address)
+  SegmentFile(const SegmentFile&) = delete;
+  SegmentFile& operator=(const SegmentFile&) = delete;
+  SegmentFile(SegmentFile&&) = delete;
+  SegmentFile& operator=(SegmentFile&&) = delete;
+
+  [[nodiscard]] const std::string& getPath() const noexcept { return path_; }
+  [[nodiscard]] size_t getPageSize() const noexcept { return page_size_; }
+
+  /**
+   * @brief Descriptor and byte offset of a page, for I/O engines that bypass readPage/writePage
+   */
+  [[nodiscard]] int getFileDescriptor() const noexcept { return fd_; }
+  [[nodiscard]] off_t getPageOffset(PageId page_id) const noexcept;
+
+  /**
+   * @brief Number of whole pages currently stored in the file
+   */
+  [[nodiscard]] size_t getPageCount() const;
+
+  /**
+   * @brief Read a page into out (page_size bytes)
+   * @return false on I/O error or if the page lies past the end of the file
+   */
+  bool readPage(PageId page_id, std::byte* out) const;
+
+  /**
+   * @brief Write a page from data (page_size bytes), extending the file if needed
+   */
+  bool writePage(PageId page_id, const std::byte* data);
+
+  /**
+   * @brief Cut the file down to its first page_count pages (a larger count is a no-op)
+   */
+  bool truncate(size_t page_count);
+
+  /**
+   * @brief Flush written pages to stable storage
+   */
+  bool sync();
+
+private:
+  std::string path_;
+  size_t page_size_;
+  int fd_;
+
+  SegmentFile(std::string path, size_t page_size, int fd) noexcept
+      : path_(std::move(path)), page_size_(page_size), fd_(fd) {
+  }
+};
+
+}  // namespace database
+
+#endif  // DATABASE_SEGMENT_FILE_HPP_
@@ -0,0 +1,29 @@
+#ifndef DATABASE_SNAPSHOT_HPP_
+#define DATABASE_SNAPSHOT_HPP_
+
+#include "database/types.hpp"
+
+namespace database {
+
+/**
+ * @brief Snapshot - which transactions' changes a reader sees
+ *
+ * Instead of PostgreSQL's (xmin, xmax, in-progress list), a snapshot is
+ * the commit sequence number current when it was taken: it sees every
+ * transaction that committed with a CSN up to that one, plus its owner's
+ * own changes. Taking one is two atomic reads, however many transactions
+ * are running.
+ *
+ * xmin is a lower bound on the transactions running when it was taken:
+ * one with a smaller ID that committed did so before the snapshot, so a
+ * version whose header hints that its xmin committed needs no CSN lookup.
+ */
+struct Snapshot {
+  CommitSeqNo csn = 0;
+  TransactionId txn_id = 0;  // Owner, whose own changes are visible (0 for none)
+  TransactionId xmin = 0;    // Every transaction below this had finished (0 if unknown)
+};
+
+}  // namespace database
+
+#endif  // DATABASE_SNAPSHOT_HPP_
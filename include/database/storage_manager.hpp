@@ -3,9 +3,15 @@
 
 #include "database/types.hpp"
 #include "database/schema.hpp"
+#include "database/catalog.hpp"
 #include "database/heap_file.hpp"
+#include "database/buffer_pool.hpp"
+#include "database/write_ahead_log.hpp"
+#include "database/checkpointer.hpp"
+#include "database/recovery_manager.hpp"
+#include "database/transaction_manager.hpp"
 #include <string>
-#include <map>
+#include <unordered_map>
 #include <memory>
 
 namespace database {
@@ -20,42 +26,142 @@ public:
   virtual HeapFile* getTable(TableId table_id) = 0;
 };
 
+/**
+ * @brief StorageOptions - configuration of a disk-backed StorageManager
+ */
+struct StorageOptions {
+  size_t buffer_pool_frames = 1024;
+  WalOptions wal;
+  CheckpointOptions checkpoint;  // Background checkpoints are off unless checkpoint.interval is set
+  size_t redo_threads = 0;       // Crash recovery threads, 0 = std::thread::hardware_concurrency()
+  bool read_only = false;        // Map existing tables read-only; no log, recovery or buffer pool
+};
+
 /**
  * @brief StorageManager - manages all heap files (tables)
  * 
  * The StorageManager is responsible for:
  * - Creating and managing tables (heap files)
- * - Providing access to tables by ID
- * - Allocating table IDs
+ * - Providing access to tables by ID or name
+ * - Allocating table IDs (through the Catalog)
+ * 
+ * By default tables live in memory. Given a data directory, every table is
+ * a disk-backed heap file ("<table_id>.heap" in that directory) and all of
+ * them share one buffer pool and one write-ahead log ("wal.log"). Opening a
+ * data directory first replays the log from the last checkpoint recorded in
+ * its control file ("control"), so a crashed instance restarts consistent.
+ * The transaction manager of a data directory is built by that recovery
+ * from the commit log each checkpoint saves and the log replayed after it:
+ * it knows which transactions committed and continues their IDs, so rows
+ * written before a restart stay visible to new snapshots.
+ *
+ * Table names and schemas are kept in a persistent catalog ("catalog"), so
+ * the tables of a data directory are there again after a restart. They are
+ * opened lazily: startup reads only the catalog's entries, and a table's
+ * schema and heap file are loaded by the first getTable() that asks for it.
+ *
+ * With StorageOptions::read_only (e.g. on a reporting replica) the data
+ * directory is never written: there is no log, recovery or buffer pool,
+ * createTable() fails, and tables are mapped with HeapFile::openMapped(),
+ * so even a huge table opens in constant time.
+ *
+ * Not thread-safe: getTable() may open a table.
  */
 class StorageManager : public IStorageManager {
 public:
   StorageManager();
+  
+  /**
+   * @brief Store tables under data_directory, recovering it after a crash
+   * @throws std::runtime_error if the catalog or write-ahead log cannot be opened or recovery fails
+   */
+  StorageManager(const std::string& data_directory, StorageOptions options);
   ~StorageManager() = default;
   
   // Disable copy (storage manager is unique)
   StorageManager(const StorageManager&) = delete;
   StorageManager& operator=(const StorageManager&) = delete;
   
-  // Allow move
+  // Allow move (but not move assignment: replacing the log and pool before
+  // the old tables and checkpointer are torn down would leave them writing
+  // to freed objects)
   StorageManager(StorageManager&&) = default;
-  StorageManager& operator=(StorageManager&&) = default;
+  StorageManager& operator=(StorageManager&&) = delete;
+  
+  /**
+   * @brief Buffer pool shared by disk-backed tables, nullptr when in memory
+   */
+  [[nodiscard]] BufferPool* getBufferPool() const noexcept { return buffer_pool_.get(); }
+  
+  /**
+   * @brief Write-ahead log shared by disk-backed tables, nullptr when in memory
+   */
+  [[nodiscard]] WriteAheadLog* getWriteAheadLog() const noexcept { return wal_.get(); }
+  
+  /**
+   * @brief Transaction manager recovered from the write-ahead log, whose
+   *        commits the disk-backed tables log; nullptr when in memory or read-only
+   */
+  [[nodiscard]] TransactionManager* getTransactionManager() const noexcept { return txn_manager_.get(); }
+  
+  /**
+   * @brief What crash recovery did when the data directory was opened
+   */
+  [[nodiscard]] const RecoveryResult& getRecoveryResult() const noexcept { return recovery_result_; }
+  
+  /**
+   * @brief Take a checkpoint now
+   * @return false if it failed or tables are in memory
+   */
+  bool checkpoint();
+  
+  /**
+   * @brief Catalog of every table, open or not
+   */
+  [[nodiscard]] const Catalog& getCatalog() const noexcept { return *catalog_; }
   
   /**
    * @brief Create a new table
-   * @return TableId for the created table
+   * @return TableId for the created table, 0 if the name is taken, the
+   *         storage is read-only or the table's file cannot be opened
    */
   TableId createTable(const std::string& name, const Schema& schema) override;
   
   /**
-   * @brief Get a table by ID
+   * @brief Get a table by ID, opening it on first use
    * @return Pointer to HeapFile if found, nullptr otherwise
    */
   HeapFile* getTable(TableId table_id) override;
+  
+  /**
+   * @brief Get a table by name, opening it on first use
+   * @return Pointer to HeapFile if found, nullptr otherwise
+   */
+  HeapFile* getTable(const std::string& name);
+  
+  /**
+   * @return TableId of the table called name, 0 if there is none
+   */
+  [[nodiscard]] TableId getTableId(const std::string& name) const;
+  
+  /**
+   * @brief Number of tables opened so far
+   */
+  [[nodiscard]] size_t getOpenTableCount() const noexcept { return heap_files_.size(); }
 
 private:
-  std::map<TableId, std::unique_ptr<HeapFile>> heap_files_;
-  TableId next_table_id_;
+  std::string data_directory_;
+  bool read_only_ = false;
+  std::unique_ptr<WriteAheadLog> wal_;       // Outlives the pool, whose write-backs flush it
+  std::unique_ptr<BufferPool> buffer_pool_;  // Outlives the heap files
+  std::unique_ptr<TransactionManager> txn_manager_;  // Outlives the heap files, which prune with it
+  std::unique_ptr<Catalog> catalog_;         // Owns the schemas the heap files refer to
+  std::unordered_map<TableId, std::unique_ptr<HeapFile>> heap_files_;  // Open tables
+  RecoveryResult recovery_result_;
+  std::unique_ptr<Checkpointer> checkpointer_;  // Stops before anything it writes is destroyed
+
+  [[nodiscard]] std::string getSegmentPath(TableId table_id) const;
+  HeapFile* openTable(TableId table_id);
 };
 
 }  // namespace database
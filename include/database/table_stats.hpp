@@ -0,0 +1,85 @@
+#ifndef DATABASE_TABLE_STATS_HPP_
+#define DATABASE_TABLE_STATS_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace database {
+
+/**
+ * @brief TableCounters - a table's modification counts at one point in time
+ */
+struct TableCounters {
+  uint64_t inserts = 0;
+  uint64_t updates = 0;
+  uint64_t deletes = 0;
+  uint64_t dead_tuples = 0;  // Estimated, since the last vacuum
+
+  /**
+   * @brief Estimated number of live tuples
+   */
+  [[nodiscard]] uint64_t getLiveTuples() const noexcept { return inserts > deletes ? inserts - deletes : 0; }
+};
+
+/**
+ * @brief TableStats - insert, update and delete counters of one table
+ *
+ * Each update and delete leaves one dead version behind, so their sum
+ * since the last vacuum estimates the dead tuples autovacuum looks at
+ * (versions of aborted transactions are not counted). Like PostgreSQL's
+ * pending per-backend statistics, every thread counts into its own
+ * cache-line-sized stripe, so threads changing the same table never
+ * write a shared line; read() adds the stripes up. Threads beyond
+ * STRIPE_COUNT share stripes round-robin. All operations are lock-free
+ * and may run concurrently.
+ */
+class TableStats {
+public:
+  static constexpr size_t STRIPE_COUNT = 16;
+
+  TableStats() = default;
+
+  // Disable copy and move (atomic counters)
+  TableStats(const TableStats&) = delete;
+  TableStats& operator=(const TableStats&) = delete;
+  TableStats(TableStats&&) = delete;
+  TableStats& operator=(TableStats&&) = delete;
+
+  void countInserts(uint64_t count) noexcept { stripe().inserts.fetch_add(count, std::memory_order_relaxed); }
+  void countUpdate() noexcept { stripe().updates.fetch_add(1, std::memory_order_relaxed); }
+  void countDelete() noexcept { stripe().deletes.fetch_add(1, std::memory_order_relaxed); }
+
+  /**
+   * @brief Sum of the stripes; counts made concurrently may or may not be included
+   */
+  [[nodiscard]] TableCounters read() const noexcept;
+
+  /**
+   * @brief Record a vacuum that started when the counters were at_start
+   *
+   * Dead tuples counted by then are taken as reclaimed; those counted
+   * since stay in the estimate.
+   */
+  void markVacuumed(const TableCounters& at_start) noexcept;
+
+private:
+  /**
+   * @brief Stripe - one thread's counters, alone on a cache line
+   */
+  struct alignas(64) Stripe {
+    std::atomic<uint64_t> inserts{0};
+    std::atomic<uint64_t> updates{0};
+    std::atomic<uint64_t> deletes{0};
+  };
+
+  std::array<Stripe, STRIPE_COUNT> stripes_;
+  std::atomic<uint64_t> vacuumed_dead_{0};  // Updates plus deletes up to the last vacuum
+
+  [[nodiscard]] Stripe& stripe() noexcept;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_TABLE_STATS_HPP_
@@ -2,8 +2,10 @@
 #define DATABASE_TRANSACTION_HPP_
 
 #include "database/types.hpp"
+#include "database/snapshot.hpp"
 #include <vector>
 #include <chrono>
+#include <optional>
 
 namespace database {
 
@@ -46,6 +48,7 @@ struct Operation {
  * - State (ACTIVE, COMMITTED, ABORTED, IN_COMMIT)
  * - Operations performed
  * - Start time
+ * - Snapshot for visibility checks (see TransactionManager::getSnapshot())
  * 
  * Uses State pattern for transaction state management.
  */
@@ -67,12 +70,21 @@ public:
   [[nodiscard]] TransactionState getState() const noexcept { return state_; }
   [[nodiscard]] const std::vector<Operation>& getOperations() const noexcept { return operations_; }
   [[nodiscard]] std::chrono::time_point<std::chrono::steady_clock> getStartTime() const noexcept { return start_time_; }
+  [[nodiscard]] const std::optional<Snapshot>& getSnapshot() const noexcept { return snapshot_; }
+  
+  void setSnapshot(const Snapshot& snapshot) noexcept { snapshot_ = snapshot; }
   
   /**
    * @brief Add an operation to the transaction
    */
   void addOperation(const Operation& op);
   
+  /**
+   * @brief Move an active transaction to IN_COMMIT while its commit record is made durable
+   * @return true if successful, false if not active
+   */
+  bool prepareCommit();
+  
   /**
    * @brief Commit the transaction
    * @return true if successful, false if already committed/aborted
@@ -90,6 +102,7 @@ private:
   TransactionState state_;
   std::vector<Operation> operations_;
   std::chrono::time_point<std::chrono::steady_clock> start_time_;
+  std::optional<Snapshot> snapshot_;  // Latest snapshot taken for it
 };
 
 }  // namespace database
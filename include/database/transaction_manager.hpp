@@ -3,11 +3,18 @@
 
 #include "database/types.hpp"
 #include "database/transaction.hpp"
+#include "database/commit_log.hpp"
+#include "database/csn_log.hpp"
+#include "database/snapshot.hpp"
+#include "database/write_ahead_log.hpp"
 #include <map>
+#include <unordered_map>
 #include <memory>
 #include <vector>
 #include <atomic>
+#include <istream>
 #include <mutex>
+#include <shared_mutex>
 
 namespace database {
 
@@ -21,10 +28,57 @@ namespace database {
  * - Providing transaction lookup
  * 
  * Uses Factory pattern for transaction creation.
+ * 
+ * With a write-ahead log, commit appends a COMMIT record and returns only
+ * once the log is durable up to it. No lock is held while waiting, so
+ * concurrent commits share one log flush (group commit).
+ *
+ * There is no global lock. Transaction IDs come from an atomic counter.
+ * Each running transaction holds a slot in a fixed-size proc array, one
+ * atomic word per cache line that packs its ID with an IN_COMMIT flag, so
+ * getActiveTransactionIds() reads it without locking. The Transaction
+ * objects are spread over independently locked shards by ID, so threads
+ * beginning and committing different transactions rarely meet on a lock.
+ *
+ * A transaction's object lives only while it runs. Committing or rolling
+ * back records the outcome in the commit log and retires the object, so
+ * visibility checks ask getTransactionStatus() and memory stays bounded
+ * by the number of running transactions.
+ *
+ * A checkpoint picks its redo LSN inside withCommitsSettled(), so every
+ * COMMIT record before it is already in the commit log the checkpoint
+ * saves. After a crash, loadCommitLog() and recoverTransactions() restore
+ * that log and the outcomes replayed since (see RecoveryManager) before any
+ * transaction begins, so rows written before the crash keep their
+ * visibility and no ID is reused.
+ *
+ * Each commit also takes the next commit sequence number (CSN), kept in a
+ * CsnLog. A Snapshot is the last CSN assigned, so takeSnapshot() is two
+ * atomic reads, and isCommittedInSnapshot() compares a transaction's CSN
+ * with it. Snapshots also carry an xmin horizon (see Snapshot) so that
+ * hint bits can settle visibility without any lookup. A commit marks its
+ * CSN COMMITTING and its status COMMITTED
+ * before taking a CSN, all with sequentially consistent operations, so a
+ * reader that finds a transaction uncommitted knows its CSN will be newer
+ * than the reader's snapshot, and one that finds it COMMITTING waits for
+ * the CSN.
+ *
+ * The CSN log is truncated as the xmin horizon advances: every
+ * HORIZON_REFRESH_COMMITS commits the horizon and the last CSN are noted,
+ * and the IDs below a noted horizon are dropped once every running
+ * transaction began after its CSN, so their snapshots see those commits
+ * anyway. Truncated IDs report FROZEN_CSN.
  */
 class TransactionManager {
 public:
-  TransactionManager();
+  static constexpr size_t DEFAULT_MAX_ACTIVE_TRANSACTIONS = 1024;
+  
+  explicit TransactionManager(size_t max_active_transactions = DEFAULT_MAX_ACTIVE_TRANSACTIONS);
+  
+  /**
+   * @brief Make commits durable through wal, which must outlive the manager
+   */
+  explicit TransactionManager(WriteAheadLog& wal, size_t max_active_transactions = DEFAULT_MAX_ACTIVE_TRANSACTIONS);
   ~TransactionManager() = default;
   
   // Disable copy (transaction manager is unique)
@@ -37,13 +91,19 @@ public:
   
   /**
    * @brief Begin a new transaction
-   * @return TransactionId for the new transaction
+   * @return TransactionId for the new transaction, 0 if max_active_transactions
+   *         are already running
    */
   TransactionId beginTransaction(IsolationLevel isolation_level);
   
   /**
    * @brief Commit a transaction
    * @return true if successful, false otherwise
+   *
+   * If the log flush fails, the COMMIT record may still reach disk later, so
+   * the outcome is unknown: the transaction stays IN_COMMIT, neither
+   * committed nor aborted, and keeps its proc array slot (holding back the
+   * oldest active transaction) until recovery decides it from the log.
    */
   bool commitTransaction(TransactionId txn_id);
   
@@ -54,8 +114,9 @@ public:
   bool rollbackTransaction(TransactionId txn_id);
   
   /**
-   * @brief Get a transaction by ID
-   * @return Pointer to Transaction if found, nullptr otherwise
+   * @brief Get a running transaction by ID
+   * @return Pointer to Transaction, valid until it commits or rolls back;
+   *         nullptr if it is not running
    */
   Transaction* getTransaction(TransactionId txn_id);
   
@@ -65,14 +126,180 @@ public:
   [[nodiscard]] bool isTransactionActive(TransactionId txn_id) const;
   
   /**
-   * @brief Get all active transaction IDs
+   * @brief Get all active transaction IDs, in ascending order
+   *
+   * Reads the proc array without locking, so a transaction beginning or
+   * finishing concurrently may or may not be included.
    */
   [[nodiscard]] std::vector<TransactionId> getActiveTransactionIds() const;
+  
+  /**
+   * @brief Oldest running transaction, or the next ID to be assigned if none runs
+   *
+   * Also advances the xmin of later snapshots, which commits otherwise
+   * refresh every HORIZON_REFRESH_COMMITS commits.
+   */
+  [[nodiscard]] TransactionId getOldestActiveTransactionId() const;
+  
+  /**
+   * @brief Status of any transaction, running or finished, from the commit log
+   */
+  [[nodiscard]] TransactionStatus getTransactionStatus(TransactionId txn_id) const {
+    return commit_log_.getStatus(txn_id);
+  }
+  
+  [[nodiscard]] const CommitLog& getCommitLog() const noexcept { return commit_log_; }
+  [[nodiscard]] const CsnLog& getCsnLog() const noexcept { return csn_log_; }
+  
+  /**
+   * @brief Snapshot of everything committed so far, seeing txn_id's own changes
+   */
+  [[nodiscard]] Snapshot takeSnapshot(TransactionId txn_id = 0) const noexcept {
+    TransactionId xmin = xmin_horizon_.load();  // Before the CSN: it must not cover later commits
+    return Snapshot{ last_csn_.load(), txn_id, xmin };
+  }
+  
+  /**
+   * @brief Snapshot for txn's next statement, as its isolation level requires
+   *
+   * REPEATABLE_READ and SERIALIZABLE keep the snapshot of their first
+   * statement. READ_COMMITTED (and READ_UNCOMMITTED, which behaves the same)
+   * takes a new one per statement, reusing the cached one while no
+   * transaction has committed since.
+   */
+  const Snapshot& getSnapshot(Transaction& txn) const;
+  
+  /**
+   * @brief A snapshot no newer than any running transaction's snapshots
+   *
+   * Every transaction's snapshots are at least as new as the last CSN when
+   * it began, so this is the oldest such CSN. A version deleted by a
+   * transaction this snapshot sees is dead to all of them. Snapshots taken
+   * outside a transaction (takeSnapshot() with no owner) are not covered.
+   */
+  [[nodiscard]] Snapshot getOldestSnapshot() const;
+  
+  /**
+   * @brief Whether snapshot sees txn_id's changes: it is the snapshot's owner
+   *        or committed no later than the snapshot was taken
+   */
+  [[nodiscard]] bool isCommittedInSnapshot(TransactionId txn_id, const Snapshot& snapshot) const;
+  
+  /**
+   * @brief Whether txn_id, known to have committed (e.g. from a hint bit),
+   *        did so no later than the snapshot was taken
+   */
+  [[nodiscard]] bool isCommittedBefore(TransactionId txn_id, const Snapshot& snapshot) const;
+  
+  /**
+   * @brief Last commit sequence number assigned
+   */
+  [[nodiscard]] CommitSeqNo getLastCommitSeqNo() const noexcept { return last_csn_.load(); }
+  
+  /**
+   * @brief Drop commit log and CSN log pages older than frozen_txn_id
+   *
+   * frozen_txn_id is the horizon below which no tuple header still needs
+   * its creator's status (see CommitLog::truncate()); it is capped at the
+   * oldest running transaction.
+   */
+  void truncateCommitLog(TransactionId frozen_txn_id);
+  
+  /**
+   * @brief First ID not assigned yet
+   */
+  [[nodiscard]] TransactionId getNextTransactionId() const noexcept { return next_txn_id_.load(); }
+  
+  /**
+   * @brief Run fn while no commit is between logging its COMMIT record and
+   *        recording it in the commit log, e.g. to choose a redo LSN
+   */
+  template <typename Fn>
+  auto withCommitsSettled(Fn&& fn) {
+    std::unique_lock<std::shared_mutex> lock(commit_barrier_);
+    return fn();
+  }
+  
+  /**
+   * @brief Replace the commit log with one a checkpoint saved (see
+   *        CommitLog::writeTo()); before any transaction begins
+   */
+  bool loadCommitLog(std::istream& in) { return commit_log_.readFrom(in); }
+  
+  /**
+   * @brief Resume after crash recovery: record the outcomes replayed from
+   *        the log and assign IDs from next_txn_id or past the largest one
+   *
+   * Every earlier transaction from oldest_txn_id on still without an
+   * outcome was cut off by the crash and becomes ABORTED; older ones had
+   * finished when the loaded commit log was saved, so only the IDs since
+   * the checkpoint's oldest running transaction are visited. Recovered
+   * commits fall below the xmin of every later snapshot, so they are
+   * visible to all of them. Must be called before any transaction begins.
+   */
+  void recoverTransactions(const std::map<TransactionId, TransactionStatus>& statuses, TransactionId next_txn_id,
+                           TransactionId oldest_txn_id = 1);
+  
+  [[nodiscard]] size_t getMaxActiveTransactions() const noexcept { return proc_array_.size(); }
 
 private:
+  static constexpr size_t SHARD_COUNT = 64;
+  static constexpr CommitSeqNo HORIZON_REFRESH_COMMITS = 64;
+  static constexpr uint64_t IN_COMMIT_FLAG = uint64_t{1} << 63;  // In a proc array word
+  static constexpr uint64_t RESERVED_SLOT = IN_COMMIT_FLAG;        // Claimed, ID not assigned yet
+  static constexpr size_t NO_SLOT = SIZE_MAX;
+  
+  /**
+   * @brief ProcSlot - one proc array entry: 0 if free, RESERVED_SLOT while
+   *        its transaction takes an ID, else that ID, with IN_COMMIT_FLAG
+   *        while it commits; and the last CSN when it began
+   */
+  struct alignas(64) ProcSlot {
+    std::atomic<uint64_t> word{0};
+    std::atomic<CommitSeqNo> begin_csn{0};  // Set while RESERVED_SLOT
+  };
+  
+  struct TransactionEntry {
+    std::unique_ptr<Transaction> txn;
+    size_t slot;
+  };
+  
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    std::unordered_map<TransactionId, TransactionEntry> transactions;
+  };
+  
   std::atomic<TransactionId> next_txn_id_;
-  std::map<TransactionId, std::unique_ptr<Transaction>> active_transactions_;
-  mutable std::mutex mutex_;  // For thread safety
+  WriteAheadLog* wal_;
+  std::shared_mutex commit_barrier_;  // Shared from logging a COMMIT until its status is set
+  std::vector<ProcSlot> proc_array_;
+  mutable std::vector<Shard> shards_;  // Locked by const lookups too
+  CommitLog commit_log_;
+  CsnLog csn_log_;
+  std::atomic<CommitSeqNo> last_csn_;
+  mutable std::atomic<TransactionId> xmin_horizon_;  // No transaction below it runs; only grows
+  std::mutex csn_truncation_mutex_;                  // Guards the two fields below
+  TransactionId csn_truncation_xid_ = 0;  // Noted horizon: the CSN log below it can go once
+  CommitSeqNo csn_truncation_csn_ = 0;    // every running transaction began at this CSN or later
+  
+  [[nodiscard]] Shard& getShard(TransactionId txn_id) const;
+  
+  /**
+   * @brief Claim a free proc array slot, marking it RESERVED_SLOT
+   * @return Slot index, NO_SLOT if every slot is taken
+   */
+  size_t claimSlot();
+  
+  /**
+   * @brief Record a finished transaction's outcome, free its slot and
+   *        retire its object (shard lock held)
+   */
+  void retireTransaction(Shard& shard, TransactionId txn_id, TransactionStatus status);
+  
+  /**
+   * @brief Advance the xmin horizon and truncate the CSN log below the last noted one if it is safe
+   */
+  void refreshHorizon();
   
   /**
    * @brief Create a new transaction (Factory pattern)
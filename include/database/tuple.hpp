@@ -4,8 +4,13 @@
 #include "database/types.hpp"
 #include "database/value.hpp"
 #include "database/schema.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstring>
 #include <vector>
 #include <optional>
+#include <string_view>
+#include <type_traits>
 
 namespace database {
 
@@ -17,27 +22,85 @@ namespace database {
  * - xmax: Transaction ID that deleted/updated this version (0 if not set)
  * - ctid: Pointer to next version in chain (for version chaining)
  * - deleted: Flag indicating if tuple is deleted
+ * - infomask: Hint bits caching the outcome of xmin and xmax, and the HOT flags
+ *
+ * Hint bits are set by readers once they have looked up a transaction's
+ * status, so later visibility checks of the same version skip the lookup.
+ * A hint only ever records a final outcome, so readers may set it through
+ * a const header in page memory while others read it: it is written with a
+ * relaxed atomic OR, and only if not already set.
+ *
+ * An update that keeps the new version on the same page and changes no
+ * indexed column is a heap-only tuple (HOT) update: the old version is
+ * marked HOT_UPDATED and the new one HEAP_ONLY, meaning no index entry
+ * points at it and it is only reached through the ctid chain.
  */
 class TupleHeader {
 public:
+  static constexpr uint16_t XMIN_COMMITTED = 0x0001;
+  static constexpr uint16_t XMIN_INVALID = 0x0002;    // xmin aborted
+  static constexpr uint16_t XMAX_COMMITTED = 0x0004;
+  static constexpr uint16_t XMAX_INVALID = 0x0008;    // xmax aborted (or none)
+  static constexpr uint16_t HINT_BITS = XMIN_COMMITTED | XMIN_INVALID | XMAX_COMMITTED | XMAX_INVALID;
+  static constexpr uint16_t HOT_UPDATED = 0x0010;     // Successor is a heap-only tuple on this page
+  static constexpr uint16_t HEAP_ONLY = 0x0020;       // Not referenced by any index
+
   explicit TupleHeader(TransactionId xmin);
   
   [[nodiscard]] TransactionId getXmin() const noexcept { return xmin_; }
   [[nodiscard]] TransactionId getXmax() const noexcept { return xmax_; }
-  [[nodiscard]] TupleId getCtid() const noexcept { return ctid_; }
+  [[nodiscard]] TupleId getCtid() const noexcept { return std::make_pair(ctid_page_, ctid_slot_); }
   [[nodiscard]] bool isDeleted() const noexcept { return deleted_; }
+  [[nodiscard]] bool hasSuccessor() const noexcept { return ctid_page_ != 0; }
+  [[nodiscard]] bool isHotUpdated() const noexcept { return (getInfomask() & HOT_UPDATED) != 0; }
+  [[nodiscard]] bool isHeapOnly() const noexcept { return (getInfomask() & HEAP_ONLY) != 0; }
+  
+  [[nodiscard]] uint16_t getInfomask() const noexcept {
+    return std::atomic_ref<uint16_t>(infomask_).load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] bool hasHintBits(uint16_t bits) const noexcept { return (getInfomask() & bits) == bits; }
   
-  void setXmax(TransactionId xmax) noexcept { xmax_ = xmax; }
-  void setCtid(TupleId ctid) noexcept { ctid_ = ctid; }
+  /**
+   * @brief Record hint bits; callable on a header that is otherwise read-only
+   */
+  void setHintBits(uint16_t bits) const noexcept {
+    if (!hasHintBits(bits)) {
+      std::atomic_ref<uint16_t>(infomask_).fetch_or(bits, std::memory_order_relaxed);
+    }
+  }
+  
+  /**
+   * @brief Set a new xmax, dropping hints about the previous one
+   */
+  void setXmax(TransactionId xmax) noexcept {
+    xmax_ = xmax;
+    infomask_ = static_cast<uint16_t>(infomask_ & ~(XMAX_COMMITTED | XMAX_INVALID));
+  }
+  void setCtid(TupleId ctid) noexcept { ctid_page_ = ctid.first; ctid_slot_ = ctid.second; }
   void setDeleted(bool deleted) noexcept { deleted_ = deleted; }
+  void setHotUpdated(bool hot_updated) noexcept { setFlag(HOT_UPDATED, hot_updated); }
+  void setHeapOnly(bool heap_only) noexcept { setFlag(HEAP_ONLY, heap_only); }
 
 private:
   TransactionId xmin_;
   TransactionId xmax_;
-  TupleId ctid_;  // Next version in chain (default: (0, 0))
+  // Next version in chain (default: (0, 0)). Stored as two fields rather than a
+  // TupleId so the header stays trivially copyable and can live in page bytes.
+  PageId ctid_page_;
+  uint16_t ctid_slot_;
   bool deleted_;
+  alignas(std::atomic_ref<uint16_t>::required_alignment) mutable uint16_t infomask_;  // In what was padding
+  
+  void setFlag(uint16_t flag, bool set) noexcept {
+    infomask_ = static_cast<uint16_t>(set ? infomask_ | flag : infomask_ & ~flag);
+  }
 };
 
+static_assert(std::is_trivially_copyable_v<TupleHeader>, "TupleHeader is copied to and from page bytes");
+static_assert(sizeof(TupleHeader) == 32, "The infomask must not change the on-page header size");
+
+class TupleView;
+
 /**
  * @brief Tuple - represents a single row of data
  * 
@@ -45,18 +108,48 @@ private:
  * - A schema defining its structure
  * - Values for each column
  * - A header with MVCC metadata
+ * 
+ * Tuple is the owning form used to build rows and to materialize them out of
+ * a page. Stored rows live in the compact format described by TupleLayout and
+ * are read through TupleView.
  */
 class Tuple {
 public:
   Tuple(const Schema& schema, const std::vector<Value>& values, TransactionId xmin);
   
+  /**
+   * @brief Materialize a tuple from its serialized form
+   */
+  explicit Tuple(const TupleView& view);
+  
   [[nodiscard]] size_t getColumnCount() const noexcept { return values_.size(); }
   [[nodiscard]] TransactionId getXmin() const noexcept { return header_.getXmin(); }
   [[nodiscard]] const TupleHeader& getHeader() const noexcept { return header_; }
   [[nodiscard]] TupleHeader& getHeader() noexcept { return header_; }
+  [[nodiscard]] const Schema& getSchema() const noexcept { return schema_; }
   
   [[nodiscard]] std::optional<Value> getValue(ColumnId column_id) const;
-  [[nodiscard]] size_t getSize() const;  // Approximate size in bytes
+  [[nodiscard]] size_t getSize() const;  // Serialized size in bytes
+  
+  /**
+   * @brief Check that there is one value per column, of the column's type,
+   * and no NULL in a non-nullable column
+   */
+  [[nodiscard]] bool matchesSchema() const;
+  
+  /**
+   * @brief Serialize the tuple in the schema's TupleLayout format into out
+   * 
+   * out must have room for getSize() bytes and be 8-byte aligned.
+   * The tuple must match its schema.
+   */
+  void serialize(std::byte* out) const;
+  
+  /**
+   * @brief Rebuild a tuple from bytes written by serialize()
+   * @return Tuple if the bytes are well formed, std::nullopt otherwise
+   */
+  [[nodiscard]] static std::optional<Tuple> deserialize(const Schema& schema, const std::byte* data, size_t size);
 
 private:
   const Schema& schema_;
@@ -64,7 +157,70 @@ private:
   TupleHeader header_;
 };
 
+/**
+ * @brief TupleView - non-owning view over a serialized tuple
+ * 
+ * Reads fields straight out of the bytes (usually page memory) using the
+ * schema's precomputed TupleLayout. The view is only valid while the
+ * underlying bytes are: a page modification may move or overwrite them.
+ * 
+ * The typed accessors (getInteger, getText, ...) do not check the column
+ * type; use getValue() when the type is not known up front.
+ */
+class TupleView {
+public:
+  TupleView(const Schema& schema, const std::byte* data, size_t size) noexcept
+      : schema_(&schema), data_(data), size_(size) {
+  }
+  
+  [[nodiscard]] const Schema& getSchema() const noexcept { return *schema_; }
+  [[nodiscard]] const std::byte* getData() const noexcept { return data_; }
+  [[nodiscard]] size_t getSize() const noexcept { return size_; }
+  [[nodiscard]] size_t getColumnCount() const noexcept { return layout().getColumnCount(); }
+  
+  [[nodiscard]] const TupleHeader& getHeader() const noexcept { return *reinterpret_cast<const TupleHeader*>(data_); }
+  [[nodiscard]] TransactionId getXmin() const noexcept { return getHeader().getXmin(); }
+  
+  [[nodiscard]] bool isNull(ColumnId column_id) const noexcept {
+    auto bits = std::to_integer<unsigned>(data_[layout().getNullBitmapOffset() + column_id / 8]);
+    return (bits & (1U << (column_id % 8))) != 0;
+  }
+  
+  [[nodiscard]] int64_t getInteger(ColumnId column_id) const noexcept { return read<int64_t>(column_id); }
+  [[nodiscard]] double getDouble(ColumnId column_id) const noexcept { return read<double>(column_id); }
+  [[nodiscard]] bool getBoolean(ColumnId column_id) const noexcept { return read<uint8_t>(column_id) != 0; }
+  [[nodiscard]] std::string_view getText(ColumnId column_id) const noexcept {
+    auto desc = read<TextDescriptor>(column_id);
+    return std::string_view(reinterpret_cast<const char*>(data_ + desc.offset), desc.length);
+  }
+  
+  /**
+   * @brief Get a column as a Value (copies TEXT into a std::string)
+   * @return Value (nullptr_t for NULL), std::nullopt for an invalid column
+   */
+  [[nodiscard]] std::optional<Value> getValue(ColumnId column_id) const;
+  
+  /**
+   * @brief Check that the bytes are large enough for the layout and every
+   * TEXT value points inside them (for bytes from an untrusted source)
+   */
+  [[nodiscard]] bool isWellFormed() const noexcept;
+
+private:
+  const Schema* schema_;
+  const std::byte* data_;
+  size_t size_;
+  
+  [[nodiscard]] const TupleLayout& layout() const noexcept { return schema_->getLayout(); }
+  
+  template <typename T>
+  [[nodiscard]] T read(ColumnId column_id) const noexcept {
+    T value;
+    std::memcpy(&value, data_ + layout().getColumnOffset(column_id), sizeof(T));
+    return value;
+  }
+};
+
 }  // namespace database
 
 #endif  // DATABASE_TUPLE_HPP_
-
@@ -0,0 +1,63 @@
+#ifndef DATABASE_TUPLE_BUILDER_HPP_
+#define DATABASE_TUPLE_BUILDER_HPP_
+
+#include "database/types.hpp"
+#include "database/schema.hpp"
+#include "database/tuple.hpp"
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace database {
+
+/**
+ * @brief TupleBuilder - serializes typed fields straight into the tuple format
+ *
+ * Builds the TupleLayout byte format without going through Value or
+ * std::string: fixed-width fields are written in place and TEXT values are
+ * taken as slices and copied once into the varlena area. The output buffer is
+ * reused across rows, so building a row does not allocate once the buffer
+ * has grown to the largest row seen.
+ *
+ * Columns start out NULL after reset().
+ */
+class TupleBuilder {
+public:
+  explicit TupleBuilder(const Schema& schema);
+
+  /**
+   * @brief Start a new row created by xmin
+   */
+  void reset(TransactionId xmin);
+
+  void setNull(ColumnId column_id) noexcept;
+  void setInteger(ColumnId column_id, int64_t value) noexcept;
+  void setDouble(ColumnId column_id, double value) noexcept;
+  void setBoolean(ColumnId column_id, bool value) noexcept;
+
+  /**
+   * @brief Set a TEXT column; the slice must stay valid until build()
+   */
+  void setText(ColumnId column_id, std::string_view value) noexcept;
+
+  /**
+   * @brief Finish the row
+   * @return Serialized bytes (valid until the next reset()), or std::nullopt
+   *         if a non-nullable column is NULL or the row is too large
+   */
+  [[nodiscard]] std::optional<std::span<const std::byte>> build();
+
+private:
+  const Schema& schema_;
+  std::vector<std::byte> buffer_;
+  std::vector<std::string_view> text_values_;
+
+  void setNullBit(ColumnId column_id, bool is_null) noexcept;
+  [[nodiscard]] bool isNull(ColumnId column_id) const noexcept;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_TUPLE_BUILDER_HPP_
@@ -38,6 +38,23 @@ using PageId = uint64_t;
  */
 using TupleId = std::pair<PageId, uint16_t>;  // (page_id, slot_number)
 
+/**
+ * @brief Log sequence number - position in the write-ahead log
+ * 
+ * An LSN is the byte offset just past a log record, so LSNs grow
+ * monotonically and "flushed up to LSN" is a plain comparison.
+ */
+using Lsn = uint64_t;
+
+/**
+ * @brief Commit sequence number - position of a commit in commit order
+ * 
+ * Every commit takes the next CSN, so a snapshot is just the last CSN
+ * assigned when it was taken: it sees exactly the transactions whose CSN
+ * is not greater.
+ */
+using CommitSeqNo = uint64_t;
+
 /**
  * @brief Column ID - identifier for a column within a table
  * 
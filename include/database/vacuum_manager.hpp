@@ -0,0 +1,226 @@
+#ifndef DATABASE_VACUUM_MANAGER_HPP_
+#define DATABASE_VACUUM_MANAGER_HPP_
+
+#include "database/types.hpp"
+#include "database/heap_file.hpp"
+#include "database/transaction_manager.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace database {
+
+/**
+ * @brief VacuumOptions - when background vacuums run and how hard they work
+ *
+ * Every interval the scheduler checks the registered tables, as
+ * PostgreSQL's autovacuum launcher does: a table is due once its estimated
+ * dead tuples exceed vacuum_threshold + vacuum_scale_factor * its live
+ * tuples (see TableStats). Up to workers tables are vacuumed at once.
+ *
+ * A vacuum pauses for round_delay after reading pages_per_round pages or
+ * dirtying dirty_pages_per_round of them, whichever comes first, which
+ * bounds both the CPU time and the reads it takes and the page writes and
+ * log volume it causes (PostgreSQL's cost-based vacuum delay does the same
+ * with weighted costs). Pages the visibility map lets it skip are free.
+ *
+ * Versions whose xmin is more than freeze_min_age transactions older than
+ * the oldest running one are frozen. A table whose frozen_xid has fallen
+ * more than freeze_table_age transactions behind is due for an aggressive
+ * vacuum, visiting all-visible pages too, whatever its dead tuples.
+ *
+ * A vacuum of an indexed table hands the DEAD line pointers it finds to
+ * the table's IndexCleanup in batches of up to max_dead_tuples.
+ */
+struct VacuumOptions {
+  std::chrono::milliseconds interval{0};  // Between scheduler checks, 0 = only on request
+  size_t workers = 1;
+  uint64_t vacuum_threshold = 50;
+  double vacuum_scale_factor = 0.2;
+  size_t pages_per_round = 64;
+  size_t dirty_pages_per_round = 16;
+  std::chrono::milliseconds round_delay{10};
+  TransactionId freeze_min_age = 50000;
+  TransactionId freeze_table_age = 150000;
+  size_t max_dead_tuples = 65536;
+};
+
+/**
+ * @brief VacuumStats - what one vacuum of a table did
+ */
+struct VacuumStats {
+  size_t pages_scanned = 0;
+  size_t pages_skipped = 0;      // Per the visibility map
+  size_t pages_pruned = 0;
+  size_t pages_dirtied = 0;
+  size_t bytes_reclaimed = 0;
+  size_t pages_all_visible = 0;  // In the table afterwards
+  size_t pages_all_frozen = 0;
+  TransactionId frozen_xid = 0;  // Aggressive vacuums that finished only: no version below it needs the commit log
+  size_t dead_lines_freed = 0;
+  size_t index_cleanups = 0;     // IndexCleanup calls
+  bool completed = false;        // false if stopped part way
+};
+
+/**
+ * @brief IndexCleanup - removes a table's index entries that point at dead tuples
+ *
+ * Called with the TupleIds of DEAD line pointers, sorted. It returns true
+ * once no index entry points at any of them; the vacuum then frees them
+ * for reuse. Returning false leaves them DEAD for a later vacuum.
+ */
+using IndexCleanup = std::function<bool(std::span<const TupleId>)>;
+
+/**
+ * @brief VacuumManager - reclaims dead versions and maintains visibility maps
+ *
+ * A vacuum walks a heap file page by page. Each page it visits is pruned
+ * of the versions no running transaction can see any more (the horizon is
+ * TransactionManager::getOldestSnapshot()) and its visibility map bits are
+ * set (see HeapFile::vacuumPage()). Pages already all-visible hold nothing
+ * to prune and are skipped; an aggressive vacuum also visits them to
+ * freeze them, skipping only all-frozen pages, and reports a frozen_xid
+ * that the caller may pass to TransactionManager::truncateCommitLog() once
+ * every table is frozen up to it. The background workers do so themselves
+ * once every table added has had an aggressive vacuum, up to the oldest
+ * of their frozen_xids.
+ *
+ * Tables added with addTable() are vacuumed in the background once they
+ * are due (see VacuumOptions). A scheduler thread queues the due tables,
+ * those gaining dead tuples the fastest since their last vacuum first,
+ * and a pool of worker threads takes them off the queue; a table is never
+ * vacuumed by two workers at once. HeapFile is not thread-safe, so each
+ * table comes with a mutex that its foreground users hold while they use
+ * it; a worker holds it for one round of pages at a time and releases it
+ * while pausing between rounds, so foreground work waits at most for one
+ * round. The scheduler only reads the tables' TableStats, which needs no
+ * mutex.
+ *
+ * Pruning leaves a DEAD line pointer where a chain root died, since index
+ * entries may still point at it. A table registered without an
+ * IndexCleanup has no index, and its DEAD line pointers are freed as each
+ * page is vacuumed. Otherwise the vacuum collects them and, after its pass
+ * over the pages or whenever max_dead_tuples have piled up, has the
+ * IndexCleanup remove their index entries and then frees them (see
+ * HeapFile::freeDeadTuples()), so inserts reuse them and a table under
+ * steady insert and delete churn stops growing.
+ */
+class VacuumManager {
+public:
+  /**
+   * @brief Starts the scheduler and options.workers workers if options.interval is non-zero
+   * @param txn_manager Must outlive the vacuum manager and be the heap
+   *        files' transaction manager
+   */
+  explicit VacuumManager(TransactionManager& txn_manager, VacuumOptions options = {});
+  ~VacuumManager();
+
+  // Disable copy and move (the background threads point at the vacuum manager)
+  VacuumManager(const VacuumManager&) = delete;
+  VacuumManager& operator=(const VacuumManager&) = delete;
+  VacuumManager(VacuumManager&&) = delete;
+  VacuumManager& operator=(VacuumManager&&) = delete;
+
+  /**
+   * @brief Vacuum a table now, on the calling thread
+   *
+   * Pauses between rounds like a background vacuum. The caller must keep
+   * every other thread away from table until it returns.
+   * @param index_cleanup Cleans the table's indexes, empty if it has none
+   */
+  VacuumStats vacuum(HeapFile& table, bool aggressive = false, const IndexCleanup& index_cleanup = {});
+
+  /**
+   * @brief Have background workers vacuum table when it is due, locking table_mutex
+   *
+   * Both must stay alive until removeTable(). index_cleanup is called with
+   * table_mutex held.
+   */
+  void addTable(HeapFile& table, std::mutex& table_mutex, IndexCleanup index_cleanup = {});
+
+  /**
+   * @brief Stop vacuuming table, waiting for a vacuum of it in progress
+   *
+   * The caller must not hold the table's mutex, which that vacuum may need.
+   */
+  void removeTable(HeapFile& table);
+
+  /**
+   * @brief Number of background vacuums completed or stopped
+   */
+  [[nodiscard]] uint64_t getVacuumCount() const;
+
+  /**
+   * @brief Statistics of the last background vacuum of table, default ones if none
+   */
+  [[nodiscard]] VacuumStats getLastStats(const HeapFile& table) const;
+
+private:
+  /**
+   * @brief TableEntry - a table the background workers vacuum
+   */
+  struct TableEntry {
+    HeapFile* table;
+    std::mutex* table_mutex;
+    IndexCleanup index_cleanup;
+    TransactionId frozen_xid = 0;  // From its last completed aggressive vacuum, 0 if none
+    std::chrono::steady_clock::time_point last_vacuum;  // Or when it was added
+    bool in_progress = false;
+    VacuumStats last_stats;
+  };
+
+  TransactionManager& txn_manager_;
+  VacuumOptions options_;
+  mutable std::mutex mutex_;  // Protects the fields below
+  std::condition_variable stop_cv_;
+  std::condition_variable work_cv_;
+  std::condition_variable table_done_cv_;
+  bool stopping_ = false;
+  std::vector<TableEntry> tables_;
+  std::deque<HeapFile*> queue_;  // Due tables, most urgent first
+  uint64_t vacuum_count_ = 0;
+  std::thread scheduler_;
+  std::vector<std::thread> workers_;
+
+  /**
+   * @brief Scheduler thread: queue the due tables every interval
+   */
+  void schedule();
+
+  /**
+   * @brief Worker thread: vacuum queued tables until stopping
+   */
+  void work();
+
+  [[nodiscard]] bool needsAggressive(const TableEntry& entry) const;
+
+  /**
+   * @brief Truncate the commit log below every table's frozen_xid, if all have one (caller holds mutex_)
+   */
+  void truncateCommitLog();
+
+  [[nodiscard]] std::vector<TableEntry>::iterator findTable(const HeapFile* table);
+
+  /**
+   * @brief Vacuum table, holding table_mutex (if any) except between rounds
+   */
+  VacuumStats vacuumTable(HeapFile& table, std::mutex* table_mutex, bool aggressive,
+                          const IndexCleanup& index_cleanup);
+
+  /**
+   * @brief Pause between rounds
+   * @return false once the vacuum manager is being destroyed
+   */
+  bool throttle();
+};
+
+}  // namespace database
+
+#endif  // DATABASE_VACUUM_MANAGER_HPP_
@@ -0,0 +1,62 @@
+#ifndef DATABASE_VISIBILITY_CHECKER_HPP_
+#define DATABASE_VISIBILITY_CHECKER_HPP_
+
+#include "database/snapshot.hpp"
+#include "database/transaction_manager.hpp"
+#include "database/tuple.hpp"
+
+namespace database {
+
+/**
+ * @brief VisibilityChecker - decides which tuple versions a snapshot sees
+ *
+ * A version is visible if the snapshot sees its creator (xmin) and does not
+ * see a deleter (xmax). "Sees" means the transaction is the snapshot's own
+ * or committed no later than the snapshot was taken; the commit log and
+ * CSN log answer that, not per-transaction objects.
+ *
+ * The first check of a version whose xmin or xmax has finished records
+ * the outcome in the header's hint bits. Later checks of a version with
+ * an aborted transaction, or with a committed one older than the
+ * snapshot's xmin, then decide from the header alone.
+ */
+class VisibilityChecker {
+public:
+  /**
+   * @param txn_manager Must outlive the checker
+   */
+  explicit VisibilityChecker(const TransactionManager& txn_manager) : txn_manager_(txn_manager) {}
+
+  /**
+   * @param set_hints false where the header must not be written, e.g. in a
+   *                  read-only mapped heap file
+   */
+  [[nodiscard]] bool isVisible(const TupleHeader& header, const Snapshot& snapshot, bool set_hints = true) const;
+  
+  /**
+   * @brief Whether no snapshot can see the version any more, so its space can be reclaimed
+   *
+   * True if its creator aborted or its xmax is seen by oldest_snapshot (see TransactionManager::getOldestSnapshot()).
+   */
+  [[nodiscard]] bool isDead(const TupleHeader& header, const Snapshot& oldest_snapshot, bool set_hints = true) const;
+
+private:
+  const TransactionManager& txn_manager_;
+
+  /**
+   * @brief Whether snapshot sees txn_id, header's xmin or xmax, using and
+   *        recording the given pair of hint bits
+   */
+  [[nodiscard]] bool sees(const TupleHeader& header, TransactionId txn_id, const Snapshot& snapshot, bool set_hints,
+                          uint16_t committed_hint, uint16_t invalid_hint) const;
+  
+  /**
+   * @brief Whether txn_id, header's xmin or xmax, aborted, using and recording the given hints
+   */
+  [[nodiscard]] bool hasAborted(const TupleHeader& header, TransactionId txn_id, bool set_hints,
+                                uint16_t committed_hint, uint16_t invalid_hint) const;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_VISIBILITY_CHECKER_HPP_
@@ -0,0 +1,60 @@
+#ifndef DATABASE_VISIBILITY_MAP_HPP_
+#define DATABASE_VISIBILITY_MAP_HPP_
+
+#include "database/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace database {
+
+/**
+ * @brief VisibilityMap - two bits per page of a heap file, set by vacuum
+ *
+ * Like PostgreSQL's visibility map:
+ * - ALL_VISIBLE: every tuple on the page is visible to every snapshot,
+ *   present and future, and the page holds nothing to prune
+ * - ALL_FROZEN: in addition, every tuple's xmin and xmax outcome is
+ *   recorded in its hint bits and logged, so the page no longer needs the
+ *   commit log (see TransactionManager::truncateCommitLog())
+ *
+ * Vacuum skips pages whose bits say there is nothing for it to do. Any
+ * change to a page clears both of its bits, so a set bit is always true;
+ * a clear bit only means the page has to be looked at. The map is kept in
+ * memory, so after a restart the first vacuum of a table visits every page.
+ */
+class VisibilityMap {
+public:
+  static constexpr uint8_t ALL_VISIBLE = 0x1;
+  static constexpr uint8_t ALL_FROZEN = 0x2;
+
+  VisibilityMap() = default;
+
+  [[nodiscard]] uint8_t getBits(PageId page_id) const noexcept;
+  [[nodiscard]] bool isAllVisible(PageId page_id) const noexcept { return (getBits(page_id) & ALL_VISIBLE) != 0; }
+  [[nodiscard]] bool isAllFrozen(PageId page_id) const noexcept { return (getBits(page_id) & ALL_FROZEN) != 0; }
+
+  /**
+   * @brief Replace a page's bits; ALL_FROZEN is only kept together with ALL_VISIBLE
+   */
+  void setBits(PageId page_id, uint8_t bits);
+
+  /**
+   * @brief Clear both bits of a page (cheap when they are already clear)
+   */
+  void clear(PageId page_id) noexcept;
+
+  [[nodiscard]] size_t countAllVisible() const noexcept;
+  [[nodiscard]] size_t countAllFrozen() const noexcept;
+
+private:
+  static constexpr size_t PAGES_PER_WORD = 32;
+
+  std::vector<uint64_t> words_;  // Page p's bits at (p % PAGES_PER_WORD) * 2 of word p / PAGES_PER_WORD
+
+  [[nodiscard]] size_t countBits(uint64_t mask) const noexcept;
+};
+
+}  // namespace database
+
+#endif  // DATABASE_VISIBILITY_MAP_HPP_
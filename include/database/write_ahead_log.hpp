@@ -0,0 +1,167 @@
+#ifndef DATABASE_WRITE_AHEAD_LOG_HPP_
+#define DATABASE_WRITE_AHEAD_LOG_HPP_
+
+#include "database/types.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace database {
+
+/**
+ * @brief Kinds of WAL records
+ */
+enum class WalRecordType : uint8_t {
+  INSERT = 1,      // payload: serialized tuple
+  UPDATE = 2,      // payload: serialized new version, same TupleId
+  DELETE = 3,      // no payload: stamps the record's txn as xmax (HeapFile logs deletes as UPDATEs)
+  PAGE_IMAGE = 4,  // payload: full page, slot unused
+  COMMIT = 5,
+  ABORT = 6,
+  CHECKPOINT = 7   // payload: redo LSN of the checkpoint
+};
+
+/**
+ * @brief WalRecordHeader - fixed part of every record in the log file
+ *
+ * The checksum is a CRC-32 over the rest of the header and the payload,
+ * so a record torn by a crash is detected on the next open.
+ */
+struct WalRecordHeader {
+  uint32_t length;    // Header plus payload
+  uint32_t checksum;
+  TransactionId txn_id;
+  PageId page_id;
+  TableId table_id;
+  uint16_t slot;
+  WalRecordType type;
+  uint8_t reserved;
+};
+
+/**
+ * @brief WalRecord - a decoded log record
+ */
+struct WalRecord {
+  WalRecordType type;
+  TransactionId txn_id;
+  TableId table_id;
+  TupleId tuple_id;
+  Lsn lsn;  // End of the record
+  std::vector<std::byte> payload;
+};
+
+/**
+ * @brief WalOptions - group commit tuning
+ *
+ * Committers that arrive while a flush is in progress are always covered
+ * by the next one. On top of that, a flush leader can wait up to
+ * group_commit_delay for more commits to join, stopping early once
+ * group_commit_size commits are pending (PostgreSQL's commit_delay and
+ * commit_siblings). A zero delay never waits.
+ */
+struct WalOptions {
+  std::chrono::microseconds group_commit_delay{0};
+  size_t group_commit_size = 16;
+  size_t buffer_size = 1 << 20;  // Write the log buffer out once it grows past this
+};
+
+/**
+ * @brief WriteAheadLog - append-only redo log with group commit
+ *
+ * Records are appended to an in-memory buffer and only reach the file when
+ * someone calls flush(). flush() uses leader/follower group commit: the
+ * first caller becomes the leader, swaps out the buffer and writes it with
+ * a single fdatasync while appenders keep filling a fresh buffer; callers
+ * whose LSN that write covers return without issuing their own sync.
+ *
+ * A write or sync failure is sticky: once one fails, every later flush()
+ * fails, since it is unknown what reached the disk.
+ */
+class WriteAheadLog {
+public:
+  /**
+   * @brief Open (or create) a log file
+   *
+   * Existing records are validated and a torn tail left by a crash is
+   * truncated, so new records continue from the last valid one.
+   * @return WriteAheadLog if successful, nullptr otherwise
+   */
+  [[nodiscard]] static std::unique_ptr<WriteAheadLog> open(const std::string& path, WalOptions options = {});
+
+  ~WriteAheadLog();
+
+  // Disable copy and move (waiters block on members)
+  WriteAheadLog(const WriteAheadLog&) = delete;
+  WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+  WriteAheadLog(WriteAheadLog&&) = delete;
+  WriteAheadLog& operator=(WriteAheadLog&&) = delete;
+
+  /**
+   * @brief Append a record to the log buffer (thread-safe)
+   * @return LSN of the end of the record
+   */
+  Lsn append(WalRecordType type, TransactionId txn_id, TableId table_id, TupleId tuple_id,
+             std::span<const std::byte> payload = {});
+
+  /**
+   * @brief Make the log durable up to at least lsn (thread-safe)
+   * @return false if the log could not be written
+   */
+  bool flush(Lsn lsn);
+
+  /**
+   * @brief Make everything appended so far durable
+   */
+  bool flushAll();
+
+  [[nodiscard]] Lsn getCurrentLsn() const;
+  [[nodiscard]] Lsn getFlushedLsn() const;
+
+  /**
+   * @brief Number of fdatasync calls issued, for measuring group commit
+   */
+  [[nodiscard]] uint64_t getSyncCount() const;
+
+  /**
+   * @brief Decode every valid record in a log file from start_lsn on
+   *
+   * start_lsn must be a record boundary, such as a checkpoint's redo LSN.
+   * @return Records in log order, std::nullopt if the file cannot be read
+   *         or ends before start_lsn
+   */
+  [[nodiscard]] static std::optional<std::vector<WalRecord>> readAll(const std::string& path, Lsn start_lsn = 0);
+
+private:
+  int fd_;
+  WalOptions options_;
+  mutable std::mutex mutex_;
+  std::condition_variable flushed_cv_;   // Signals a finished flush
+  std::condition_variable commits_cv_;   // Signals a leader waiting for group_commit_size
+  std::vector<std::byte> buffer_;        // Appended, not yet being written
+  std::vector<std::byte> write_buffer_;  // Being written by the leader
+  Lsn buffer_start_lsn_;                 // LSN of buffer_[0]
+  Lsn current_lsn_;
+  Lsn flushed_lsn_;
+  size_t pending_commits_ = 0;
+  uint64_t sync_count_ = 0;
+  bool flush_in_progress_ = false;
+  bool failed_ = false;
+
+  WriteAheadLog(int fd, Lsn end_lsn, WalOptions options);
+
+  /**
+   * @brief Write one buffer at start_lsn and sync it (called without mutex_)
+   */
+  bool writeAndSync(const std::vector<std::byte>& data, Lsn start_lsn);
+};
+
+}  // namespace database
+
+#endif  // DATABASE_WRITE_AHEAD_LOG_HPP_
@@ -0,0 +1,205 @@
+#ifndef DATABASE_XID_PAGE_ARRAY_HPP_
+#define DATABASE_XID_PAGE_ARRAY_HPP_
+
+#include "database/types.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <vector>
+
+namespace database {
+
+/**
+ * @brief XidPageArray - a BITS_PER_XID-bit entry for every transaction ID,
+ *        in pages that can be dropped from the old end
+ *
+ * The storage behind CommitLog and CsnLog (PostgreSQL's SLRU): a page of
+ * PAGE_SIZE bytes holds the entries of XIDS_PER_PAGE consecutive IDs,
+ * packed into 64-bit words. Pages are allocated as IDs reach them and an
+ * entry reads 0 until it is set. Entries are read and written with
+ * sequentially consistent atomic operations; the directory of pages is
+ * behind a shared lock that only growth and truncation take exclusively.
+ *
+ * truncate() drops the pages whose IDs are all older than a horizon; the
+ * owner decides what such IDs report. writeTo() and readFrom() save and
+ * restore the pages, truncation included.
+ */
+template <size_t BITS_PER_XID>
+class XidPageArray {
+  static_assert(BITS_PER_XID > 0 && 64 % BITS_PER_XID == 0, "entries must tile a 64-bit word");
+
+public:
+  static constexpr size_t PAGE_SIZE = 8192;
+  static constexpr size_t XIDS_PER_WORD = 64 / BITS_PER_XID;
+  static constexpr size_t XIDS_PER_PAGE = PAGE_SIZE / sizeof(uint64_t) * XIDS_PER_WORD;
+
+  XidPageArray() = default;
+
+  // Disable copy and move (atomic words, shared lock)
+  XidPageArray(const XidPageArray&) = delete;
+  XidPageArray& operator=(const XidPageArray&) = delete;
+  XidPageArray(XidPageArray&&) = delete;
+  XidPageArray& operator=(XidPageArray&&) = delete;
+
+  /**
+   * @return txn_id's entry, 0 if its page is not allocated yet, or
+   *         truncated_value if its page has been truncated
+   */
+  [[nodiscard]] uint64_t get(TransactionId txn_id, uint64_t truncated_value) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (txn_id / XIDS_PER_PAGE < first_page_) {
+      return truncated_value;
+    }
+    const std::atomic<uint64_t>* word = findWord(txn_id);
+    if (!word) {
+      return 0;
+    }
+    return (word->load() >> shiftOf(txn_id)) & ENTRY_MASK;
+  }
+
+  /**
+   * @brief Set txn_id's entry, allocating its page; ignored for truncated IDs
+   */
+  void set(TransactionId txn_id, uint64_t value) {
+    uint64_t page_no = txn_id / XIDS_PER_PAGE;
+    std::atomic<uint64_t>* word = nullptr;
+    {
+      std::shared_lock<std::shared_mutex> lock(mutex_);
+      if (page_no < first_page_) {
+        return;
+      }
+      word = findWord(txn_id);
+    }
+    if (!word) {
+      std::unique_lock<std::shared_mutex> lock(mutex_);
+      if (page_no < first_page_) {
+        return;
+      }
+      while (first_page_ + pages_.size() <= page_no) {
+        pages_.push_back(std::make_unique<XidPage>());
+      }
+      word = findWord(txn_id);
+    }
+    // Pages are only freed by truncate(), which never reaches an ID still being finished
+
+    if constexpr (XIDS_PER_WORD == 1) {
+      word->store(value);
+    } else {
+      uint64_t shift = shiftOf(txn_id);
+      uint64_t bits = (value & ENTRY_MASK) << shift;
+      uint64_t current = word->load(std::memory_order_relaxed);
+      while (!word->compare_exchange_weak(current, (current & ~(ENTRY_MASK << shift)) | bits)) {
+      }
+    }
+  }
+
+  /**
+   * @brief Drop every page whose IDs are all older than oldest_txn_id
+   */
+  void truncate(TransactionId oldest_txn_id) {
+    uint64_t keep_page = oldest_txn_id / XIDS_PER_PAGE;
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (keep_page <= first_page_) {
+      return;
+    }
+    size_t dropped = std::min<uint64_t>(keep_page - first_page_, pages_.size());
+    pages_.erase(pages_.begin(), pages_.begin() + static_cast<std::ptrdiff_t>(dropped));
+    first_page_ = keep_page;
+  }
+
+  /**
+   * @brief First ID whose entry is still stored
+   */
+  [[nodiscard]] TransactionId getOldestTransactionId() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return first_page_ * XIDS_PER_PAGE;
+  }
+
+  [[nodiscard]] size_t getPageCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return pages_.size();
+  }
+
+  /**
+   * @brief Write the pages; entries set concurrently may or may not be included
+   */
+  bool writeTo(std::ostream& out) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    uint64_t header[2] = { first_page_, pages_.size() };
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    std::vector<uint64_t> words(PAGE_SIZE / sizeof(uint64_t));
+    for (const auto& page : pages_) {
+      std::transform(page->words.begin(), page->words.end(), words.begin(),
+                     [](const std::atomic<uint64_t>& word) { return word.load(); });
+      out.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(PAGE_SIZE));
+    }
+    return static_cast<bool>(out);
+  }
+
+  /**
+   * @brief Replace the contents with pages written by writeTo()
+   * @return false, leaving the contents alone, if the stream is malformed
+   */
+  bool readFrom(std::istream& in) {
+    uint64_t header[2] = {};
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in) {
+      return false;
+    }
+    std::deque<std::unique_ptr<XidPage>> pages;
+    std::vector<uint64_t> words(PAGE_SIZE / sizeof(uint64_t));
+    for (uint64_t i = 0; i < header[1]; ++i) {
+      in.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(PAGE_SIZE));
+      if (!in) {
+        return false;
+      }
+      auto page = std::make_unique<XidPage>();
+      for (size_t w = 0; w < words.size(); ++w) {
+        page->words[w].store(words[w], std::memory_order_relaxed);
+      }
+      pages.push_back(std::move(page));
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    first_page_ = header[0];
+    pages_ = std::move(pages);
+    return true;
+  }
+
+private:
+  static constexpr uint64_t ENTRY_MASK = BITS_PER_XID == 64 ? ~uint64_t{0} : (uint64_t{1} << BITS_PER_XID) - 1;
+
+  struct XidPage {
+    std::array<std::atomic<uint64_t>, PAGE_SIZE / sizeof(uint64_t)> words{};
+  };
+
+  mutable std::shared_mutex mutex_;  // Guards the directory, not the words
+  std::deque<std::unique_ptr<XidPage>> pages_;
+  uint64_t first_page_ = 0;  // Page number of pages_.front()
+
+  static uint64_t shiftOf(TransactionId txn_id) noexcept { return (txn_id % XIDS_PER_WORD) * BITS_PER_XID; }
+
+  /**
+   * @brief Word holding txn_id's entry (directory lock held)
+   * @return nullptr if its page is truncated or not allocated yet
+   */
+  [[nodiscard]] std::atomic<uint64_t>* findWord(TransactionId txn_id) const {
+    uint64_t page_no = txn_id / XIDS_PER_PAGE;
+    if (page_no < first_page_ || page_no - first_page_ >= pages_.size()) {
+      return nullptr;
+    }
+    return &pages_[page_no - first_page_]->words[(txn_id % XIDS_PER_PAGE) / XIDS_PER_WORD];
+  }
+};
+
+}  // namespace database
+
+#endif  // DATABASE_XID_PAGE_ARRAY_HPP_
@@ -0,0 +1,779 @@
+#include "database/btree_index.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace database {
+
+namespace {
+
+/**
+ * @brief NodeHeader - start of every node
+ */
+struct NodeHeader {
+  uint64_t version;        // Bumped by every change; odd while a writer has the node locked
+  PageId link;             // Leaf: next leaf, 0 for the last; inner node: child left of the first separator
+  uint16_t level;          // 0 for leaves
+  uint16_t count;
+  uint16_t entries_start;  // Entries occupy [entries_start, NODE_SIZE)
+  uint16_t garbage;        // Bytes of removed entries not compacted away yet
+};
+
+/**
+ * @brief Slot - where an entry is and the first eight bytes of its key
+ *
+ * An entry is its 8-byte value (the tuple's PageId or a child node ID)
+ * followed by its key bytes; a leaf entry's TupleId slot number is aux.
+ */
+struct Slot {
+  uint64_t head;  // Big-endian, zero-padded: compares like the key's first eight bytes
+  uint16_t offset;
+  uint16_t length;
+  uint16_t aux;
+  uint16_t reserved;
+};
+
+constexpr size_t HEADER_SIZE = 64;  // Slots start on a cache line
+constexpr size_t VALUE_SIZE = sizeof(uint64_t);
+constexpr uint64_t SIGN_BIT = uint64_t{1} << 63;
+constexpr uint64_t LOCKED = 1;
+constexpr size_t MAX_SLOTS = (BTreeIndex::NODE_SIZE - HEADER_SIZE) / sizeof(Slot);
+constexpr size_t MAX_ENTRY_SIZE = sizeof(Slot) + VALUE_SIZE + BTreeIndex::MAX_KEY_SIZE;
+constexpr uint16_t NO_POSITION = UINT16_MAX;
+
+static_assert(sizeof(NodeHeader) <= HEADER_SIZE);
+static_assert(sizeof(Slot) == 16);
+
+[[nodiscard]] uint64_t keyHead(std::span<const std::byte> key) noexcept {
+  uint64_t head = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+    head = (head << 8) | (i < key.size() ? std::to_integer<uint64_t>(key[i]) : 0);
+  }
+  return head;
+}
+
+/**
+ * @brief Compare a key with a bound, looking only at as many bytes as the bound has
+ */
+[[nodiscard]] int comparePrefix(std::span<const std::byte> key, std::span<const std::byte> bound) noexcept {
+  size_t length = std::min(key.size(), bound.size());
+  int result = length > 0 ? std::memcmp(key.data(), bound.data(), length) : 0;
+  if (result != 0) {
+    return result;
+  }
+  return key.size() >= bound.size() ? 0 : -1;
+}
+
+void appendUint64(std::vector<std::byte>& key, uint64_t value) {
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    key.push_back(static_cast<std::byte>(value >> shift));
+  }
+}
+
+void appendInteger(std::vector<std::byte>& key, int64_t value) {
+  appendUint64(key, static_cast<uint64_t>(value) ^ SIGN_BIT);
+}
+
+void appendDouble(std::vector<std::byte>& key, double value) {
+  if (value == 0.0) {
+    value = 0.0;  // -0 equals 0
+  } else if (std::isnan(value)) {
+    value = std::numeric_limits<double>::quiet_NaN();  // One NaN, after +inf
+  }
+  auto bits = std::bit_cast<uint64_t>(value);
+  appendUint64(key, (bits & SIGN_BIT) != 0 ? ~bits : bits | SIGN_BIT);
+}
+
+void appendText(std::vector<std::byte>& key, std::string_view value) {
+  for (char c : value) {
+    key.push_back(static_cast<std::byte>(c));
+    if (c == '\0') {
+      key.push_back(std::byte{0xFF});
+    }
+  }
+  key.push_back(std::byte{0});
+  key.push_back(std::byte{0});
+}
+
+void appendTupleId(std::vector<std::byte>& key, const TupleId& tuple_id) {
+  appendUint64(key, tuple_id.first);
+  key.push_back(static_cast<std::byte>(tuple_id.second >> 8));
+  key.push_back(static_cast<std::byte>(tuple_id.second & 0xFF));
+}
+
+/**
+ * @brief Wait a little before starting over after a conflict
+ */
+void backoff(size_t attempt) noexcept {
+  if (attempt > 3) {
+    std::this_thread::yield();  // The node's writer may need this CPU to finish
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Node - one page of the tree
+ *
+ * Readers look at nodes that writers may be changing, so the accessors
+ * used before validation keep every read inside the node, whatever its
+ * bytes say.
+ */
+struct alignas(64) BTreeIndex::Node {
+  std::array<std::byte, NODE_SIZE> bytes{};
+
+  [[nodiscard]] NodeHeader& header() noexcept { return *reinterpret_cast<NodeHeader*>(bytes.data()); }
+  [[nodiscard]] const NodeHeader& header() const noexcept { return *reinterpret_cast<const NodeHeader*>(bytes.data()); }
+  [[nodiscard]] Slot* slots() noexcept { return reinterpret_cast<Slot*>(bytes.data() + HEADER_SIZE); }
+  [[nodiscard]] const Slot* slots() const noexcept { return reinterpret_cast<const Slot*>(bytes.data() + HEADER_SIZE); }
+  [[nodiscard]] uint16_t count() const noexcept { return std::min(header().count, static_cast<uint16_t>(MAX_SLOTS)); }
+  [[nodiscard]] bool isLeaf() const noexcept { return header().level == 0; }
+
+  [[nodiscard]] std::span<const std::byte> key(uint16_t index) const noexcept {
+    const Slot& slot = slots()[index];
+    size_t offset = std::min<size_t>(slot.offset, NODE_SIZE - VALUE_SIZE) + VALUE_SIZE;
+    return { bytes.data() + offset, std::min<size_t>(slot.length, NODE_SIZE - offset) };
+  }
+
+  [[nodiscard]] uint64_t value(uint16_t index) const noexcept {
+    uint64_t value;
+    std::memcpy(&value, bytes.data() + std::min<size_t>(slots()[index].offset, NODE_SIZE - VALUE_SIZE), sizeof(value));
+    return value;
+  }
+
+  [[nodiscard]] TupleId tupleId(uint16_t index) const noexcept { return { value(index), slots()[index].aux }; }
+
+  void setTupleId(uint16_t index, const TupleId& tuple_id) noexcept {
+    std::memcpy(bytes.data() + slots()[index].offset, &tuple_id.first, sizeof(tuple_id.first));
+    slots()[index].aux = tuple_id.second;
+  }
+
+  /**
+   * @brief Empty the node, keeping its version
+   */
+  void init(uint16_t level, PageId link) noexcept {
+    NodeHeader& h = header();
+    h.link = link;
+    h.level = level;
+    h.count = 0;
+    h.entries_start = static_cast<uint16_t>(NODE_SIZE);
+    h.garbage = 0;
+  }
+
+  [[nodiscard]] size_t getFreeSpace() const noexcept {
+    return size_t{ header().entries_start } - HEADER_SIZE - size_t{ header().count } * sizeof(Slot);
+  }
+
+  [[nodiscard]] bool hasRoom(size_t entry_size) const noexcept {
+    return getFreeSpace() + header().garbage >= entry_size;
+  }
+
+  [[nodiscard]] std::atomic_ref<uint64_t> versionWord() const noexcept {
+    return std::atomic_ref<uint64_t>(const_cast<NodeHeader&>(header()).version);
+  }
+
+  /**
+   * @brief The version to validate reads against, std::nullopt while the node is locked
+   */
+  [[nodiscard]] std::optional<uint64_t> readVersion() const noexcept {
+    uint64_t version = versionWord().load(std::memory_order_acquire);
+    return (version & LOCKED) == 0 ? std::optional<uint64_t>(version) : std::nullopt;
+  }
+
+  /**
+   * @brief Check that nothing changed the node since readVersion() returned version
+   */
+  [[nodiscard]] bool validate(uint64_t version) const noexcept {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return versionWord().load(std::memory_order_relaxed) == version;
+  }
+
+  /**
+   * @brief Lock the node if it is still at version
+   */
+  [[nodiscard]] bool tryLock(uint64_t version) noexcept {
+    if (!versionWord().compare_exchange_strong(version, version + LOCKED, std::memory_order_acquire)) {
+      return false;
+    }
+    std::atomic_thread_fence(std::memory_order_release);  // Readers see the lock before any change
+    return true;
+  }
+
+  void unlock() noexcept { versionWord().fetch_add(LOCKED, std::memory_order_release); }
+
+  [[nodiscard]] int compare(uint16_t index, std::span<const std::byte> key, uint64_t head) const noexcept {
+    uint64_t slot_head = slots()[index].head;
+    if (slot_head != head) {
+      return slot_head < head ? -1 : 1;
+    }
+    std::span<const std::byte> slot_key = this->key(index);
+    size_t length = std::min(slot_key.size(), key.size());
+    if (length > sizeof(uint64_t)) {
+      int result = std::memcmp(slot_key.data() + sizeof(uint64_t), key.data() + sizeof(uint64_t),
+                               length - sizeof(uint64_t));
+      if (result != 0) {
+        return result;
+      }
+    }
+    return slot_key.size() < key.size() ? -1 : (slot_key.size() > key.size() ? 1 : 0);
+  }
+
+  /**
+   * @brief Index of the first entry not less than key (greater than key if after_equal)
+   */
+  [[nodiscard]] uint16_t search(std::span<const std::byte> key, uint64_t head, bool after_equal) const noexcept {
+    uint16_t low = 0;
+    uint16_t high = count();
+    while (low < high) {
+      auto middle = static_cast<uint16_t>((low + high) / 2);
+      int result = compare(middle, key, head);
+      if (result < 0 || (after_equal && result == 0)) {
+        low = static_cast<uint16_t>(middle + 1);
+      } else {
+        high = middle;
+      }
+    }
+    return low;
+  }
+
+  /**
+   * @brief Add an entry at index, compacting if that makes room
+   * @return false if it does not fit
+   */
+  bool add(uint16_t index, std::span<const std::byte> key, uint64_t value, uint16_t aux) noexcept {
+    size_t needed = sizeof(Slot) + VALUE_SIZE + key.size();
+    if (getFreeSpace() < needed) {
+      if (header().garbage == 0) {
+        return false;
+      }
+      compact();
+      if (getFreeSpace() < needed) {
+        return false;
+      }
+    }
+    NodeHeader& h = header();
+    auto offset = static_cast<uint16_t>(h.entries_start - VALUE_SIZE - key.size());
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+    std::memcpy(bytes.data() + offset + VALUE_SIZE, key.data(), key.size());
+    h.entries_start = offset;
+
+    Slot* s = slots();
+    std::memmove(s + index + 1, s + index, static_cast<size_t>(h.count - index) * sizeof(Slot));
+    s[index] = Slot{ keyHead(key), offset, static_cast<uint16_t>(key.size()), aux, 0 };
+    ++h.count;
+    return true;
+  }
+
+  void erase(uint16_t index) noexcept {
+    NodeHeader& h = header();
+    Slot* s = slots();
+    h.garbage = static_cast<uint16_t>(h.garbage + VALUE_SIZE + s[index].length);
+    std::memmove(s + index, s + index + 1, static_cast<size_t>(h.count - index - 1) * sizeof(Slot));
+    --h.count;
+  }
+
+  /**
+   * @brief Move the entries together at the end of the node, dropping removed ones
+   */
+  void compact() noexcept {
+    std::array<std::byte, NODE_SIZE> old = bytes;
+    size_t top = NODE_SIZE;
+    Slot* s = slots();
+    for (uint16_t i = 0; i < count(); ++i) {
+      size_t size = VALUE_SIZE + s[i].length;
+      top -= size;
+      std::memcpy(bytes.data() + top, old.data() + s[i].offset, size);
+      s[i].offset = static_cast<uint16_t>(top);
+    }
+    header().entries_start = static_cast<uint16_t>(top);
+    header().garbage = 0;
+  }
+};
+
+/**
+ * @brief NodeChunk - CHUNK_NODES consecutive node IDs' nodes
+ */
+struct BTreeIndex::NodeChunk {
+  std::array<std::unique_ptr<Node>, CHUNK_NODES> nodes;
+};
+
+BTreeIndex::BTreeIndex(std::vector<ColumnId> columns, std::vector<DataType> types, bool unique)
+    : columns_(std::move(columns)),
+      types_(std::move(types)),
+      unique_(unique),
+      chunks_(std::make_unique<std::unique_ptr<NodeChunk>[]>(MAX_CHUNKS)) {
+  root_.store(allocateNode(0, 0), std::memory_order_release);
+}
+
+BTreeIndex::~BTreeIndex() = default;
+
+std::unique_ptr<BTreeIndex> BTreeIndex::create(const Schema& schema, std::vector<ColumnId> columns, bool unique) {
+  if (columns.empty()) {
+    return nullptr;
+  }
+  std::vector<DataType> types;
+  for (ColumnId column_id : columns) {
+    const Column* column = schema.getColumn(column_id);
+    if (!column) {
+      return nullptr;
+    }
+    types.push_back(column->getDataType());
+  }
+  return std::unique_ptr<BTreeIndex>(new BTreeIndex(std::move(columns), std::move(types), unique));
+}
+
+std::unique_ptr<BTreeIndex> BTreeIndex::createPrimaryKey(const Schema& schema) {
+  std::vector<ColumnId> columns;
+  for (const Column& column : schema.getColumns()) {
+    if (column.isPrimaryKey()) {
+      columns.push_back(column.getColumnId());
+    }
+  }
+  return create(schema, std::move(columns), true);
+}
+
+bool BTreeIndex::encodeKey(std::span<const Value> values, std::vector<std::byte>& key) const {
+  key.clear();
+  if (values.size() > columns_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    const Value& value = values[i];
+    switch (types_[i]) {
+      case DataType::INTEGER:
+        if (!std::holds_alternative<int64_t>(value)) {
+          return false;
+        }
+        appendInteger(key, std::get<int64_t>(value));
+        break;
+      case DataType::DOUBLE:
+        if (!std::holds_alternative<double>(value)) {
+          return false;
+        }
+        appendDouble(key, std::get<double>(value));
+        break;
+      case DataType::TEXT:
+        if (!std::holds_alternative<std::string>(value)) {
+          return false;
+        }
+        appendText(key, std::get<std::string>(value));
+        break;
+      case DataType::BOOLEAN:
+        if (!std::holds_alternative<bool>(value)) {
+          return false;
+        }
+        key.push_back(std::byte{ std::get<bool>(value) ? uint8_t{1} : uint8_t{0} });
+        break;
+    }
+  }
+  return true;
+}
+
+bool BTreeIndex::encodeKey(const TupleView& tuple, std::vector<std::byte>& key) const {
+  key.clear();
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    ColumnId column_id = columns_[i];
+    if (tuple.isNull(column_id)) {
+      return false;
+    }
+    switch (types_[i]) {
+      case DataType::INTEGER:
+        appendInteger(key, tuple.getInteger(column_id));
+        break;
+      case DataType::DOUBLE:
+        appendDouble(key, tuple.getDouble(column_id));
+        break;
+      case DataType::TEXT:
+        appendText(key, tuple.getText(column_id));
+        break;
+      case DataType::BOOLEAN:
+        key.push_back(std::byte{ tuple.getBoolean(column_id) ? uint8_t{1} : uint8_t{0} });
+        break;
+    }
+  }
+  return true;
+}
+
+bool BTreeIndex::insert(std::span<const Value> key_values, const TupleId& tuple_id,
+                        const std::function<bool(const TupleId&)>& is_live) {
+  std::vector<std::byte> key;
+  if (key_values.size() != columns_.size() || !encodeKey(key_values, key)) {
+    return false;
+  }
+  return insertKey(key, tuple_id, is_live);
+}
+
+bool BTreeIndex::insert(const TupleView& tuple, const TupleId& tuple_id,
+                        const std::function<bool(const TupleId&)>& is_live) {
+  std::vector<std::byte> key;
+  if (!encodeKey(tuple, key)) {
+    return false;
+  }
+  return insertKey(key, tuple_id, is_live);
+}
+
+bool BTreeIndex::remove(std::span<const Value> key_values, const TupleId& tuple_id) {
+  std::vector<std::byte> key;
+  if (key_values.size() != columns_.size() || !encodeKey(key_values, key)) {
+    return false;
+  }
+  if (!unique_) {
+    appendTupleId(key, tuple_id);
+  }
+  uint64_t head = keyHead(key);
+  for (size_t attempt = 0;; backoff(++attempt)) {
+    std::optional<Descent> descent = descend(key, false);
+    if (!descent) {
+      continue;
+    }
+    Node& leaf = *getNode(descent->node);
+    if (!leaf.tryLock(descent->node_version)) {
+      continue;
+    }
+    uint16_t index = leaf.search(key, head, false);
+    bool found = index < leaf.count() && leaf.compare(index, key, head) == 0 && leaf.tupleId(index) == tuple_id;
+    if (found) {
+      leaf.erase(index);
+      entry_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    leaf.unlock();
+    return found;
+  }
+}
+
+std::optional<TupleId> BTreeIndex::find(std::span<const Value> key_values) const {
+  std::optional<TupleId> found;
+  if (key_values.size() != columns_.size()) {
+    return found;
+  }
+  if (!unique_) {
+    // The key's first entry may be in a later leaf than the key itself would be
+    scan(key_values, true, key_values, true, [&found](const TupleId& tuple_id) {
+      found = tuple_id;
+      return false;
+    });
+    return found;
+  }
+
+  std::vector<std::byte> key;
+  if (!encodeKey(key_values, key)) {
+    return found;
+  }
+  uint64_t head = keyHead(key);
+  for (size_t attempt = 0;; backoff(++attempt)) {
+    std::optional<Descent> descent = descend(key, false);
+    if (!descent) {
+      continue;
+    }
+    const Node& leaf = *getNode(descent->node);
+    uint16_t index = leaf.search(key, head, false);
+    found = index < leaf.count() && leaf.compare(index, key, head) == 0 ? std::optional<TupleId>(leaf.tupleId(index))
+                                                                       : std::nullopt;
+    if (leaf.validate(descent->node_version)) {
+      return found;
+    }
+  }
+}
+
+size_t BTreeIndex::scan(std::span<const Value> lower, bool lower_inclusive, std::span<const Value> upper,
+                        bool upper_inclusive, const std::function<bool(const TupleId&)>& visit) const {
+  std::vector<std::byte> lower_key;
+  std::vector<std::byte> upper_key;
+  if (!encodeKey(lower, lower_key) || !encodeKey(upper, upper_key)) {
+    return 0;
+  }
+
+  // Each leaf's entries are copied out and validated before they are
+  // visited. After a conflict the scan starts over from the root, past the
+  // last entry it visited.
+  std::vector<std::byte> resume_key;
+  bool resumed = false;
+  std::vector<TupleId> batch;
+  std::vector<std::byte> batch_last;
+  size_t visited = 0;
+  for (size_t attempt = 0;; backoff(++attempt)) {
+    const std::vector<std::byte>& start = resumed ? resume_key : lower_key;
+    std::optional<Descent> descent = descend(start, false);
+    if (!descent) {
+      continue;
+    }
+    // The first entry not below the bound may be in a following leaf: a key
+    // can fall between a leaf's last entry and the next separator
+    PageId node_id = descent->node;
+    uint64_t version = descent->node_version;
+    const Node* leaf = getNode(node_id);
+    uint16_t index = leaf->search(start, keyHead(start), resumed);
+    while (true) {
+      batch.clear();
+      uint16_t last_index = 0;
+      bool at_end = false;
+      for (; index < leaf->count(); ++index) {
+        std::span<const std::byte> key = leaf->key(index);
+        if (!resumed && !lower_inclusive && !lower.empty() && comparePrefix(key, lower_key) == 0) {
+          continue;
+        }
+        if (!upper.empty()) {
+          int result = comparePrefix(key, upper_key);
+          if (result > 0 || (result == 0 && !upper_inclusive)) {
+            at_end = true;
+            break;
+          }
+        }
+        batch.push_back(leaf->tupleId(index));
+        last_index = index;
+      }
+      if (!batch.empty()) {
+        std::span<const std::byte> last = leaf->key(last_index);
+        batch_last.assign(last.begin(), last.end());
+      }
+      PageId next_id = leaf->header().link;
+      if (!leaf->validate(version)) {
+        break;  // Start over past the entries visited so far
+      }
+
+      for (const TupleId& tuple_id : batch) {
+        ++visited;
+        if (!visit(tuple_id)) {
+          return visited;
+        }
+      }
+      if (!batch.empty()) {
+        resume_key.swap(batch_last);
+        resumed = true;
+      }
+      if (at_end || next_id == 0) {
+        return visited;
+      }
+
+      const Node* next = getNode(next_id);
+      std::optional<uint64_t> next_version = next ? next->readVersion() : std::nullopt;
+      if (!next_version || !leaf->validate(version)) {
+        break;
+      }
+      node_id = next_id;
+      leaf = next;
+      version = *next_version;
+      index = 0;
+    }
+  }
+}
+
+BTreeIndex::Node* BTreeIndex::getNode(PageId node_id) const noexcept {
+  if (node_id == 0 || node_id >= node_count_.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  return chunks_[node_id / CHUNK_NODES]->nodes[node_id % CHUNK_NODES].get();
+}
+
+PageId BTreeIndex::allocateNode(uint16_t level, PageId link) {
+  std::lock_guard<std::mutex> lock(allocation_mutex_);
+  PageId node_id = node_count_.load(std::memory_order_relaxed);
+  auto& chunk = chunks_[node_id / CHUNK_NODES];
+  if (!chunk) {
+    chunk = std::make_unique<NodeChunk>();
+  }
+  auto& node = chunk->nodes[node_id % CHUNK_NODES];
+  node = std::make_unique<Node>();
+  node->init(level, link);
+  node_count_.store(node_id + 1, std::memory_order_release);  // Publishes the node to getNode()
+  return node_id;
+}
+
+std::optional<BTreeIndex::Descent> BTreeIndex::descend(std::span<const std::byte> key, bool stop_at_full) const {
+  uint64_t head = keyHead(key);
+  PageId node_id = root_.load(std::memory_order_acquire);
+  const Node* node = getNode(node_id);
+  std::optional<uint64_t> version = node->readVersion();
+  if (!version || root_.load(std::memory_order_acquire) != node_id) {
+    return std::nullopt;
+  }
+
+  PageId parent_id = 0;
+  uint64_t parent_version = 0;
+  while (!node->isLeaf()) {
+    if (stop_at_full && !node->hasRoom(MAX_ENTRY_SIZE)) {
+      return Descent{ node_id, *version, parent_id, parent_version, true };
+    }
+
+    // Follow the last separator not greater than the key, once the node
+    // is known not to have changed while it was read
+    uint16_t index = node->search(key, head, true);
+    PageId child_id = index == 0 ? node->header().link : node->value(static_cast<uint16_t>(index - 1));
+    if (!node->validate(*version)) {
+      return std::nullopt;
+    }
+    const Node* child = getNode(child_id);
+    std::optional<uint64_t> child_version = child ? child->readVersion() : std::nullopt;
+    if (!child_version || !node->validate(*version)) {
+      return std::nullopt;
+    }
+    parent_id = node_id;
+    parent_version = *version;
+    node_id = child_id;
+    node = child;
+    version = child_version;
+  }
+  return Descent{ node_id, *version, parent_id, parent_version, false };
+}
+
+bool BTreeIndex::lockForSplit(const Descent& descent) {
+  Node* parent = descent.parent != 0 ? getNode(descent.parent) : nullptr;
+  if (parent && !parent->tryLock(descent.parent_version)) {
+    return false;
+  }
+  if (!getNode(descent.node)->tryLock(descent.node_version)) {
+    if (parent) {
+      parent->unlock();
+    }
+    return false;
+  }
+  return true;
+}
+
+bool BTreeIndex::insertKey(std::vector<std::byte>& key, const TupleId& tuple_id,
+                           const std::function<bool(const TupleId&)>& is_live) {
+  if (!unique_) {
+    appendTupleId(key, tuple_id);
+  }
+  // Leave enough node IDs for splits that concurrent inserts are in the middle of
+  if (key.size() > MAX_KEY_SIZE || node_count_.load(std::memory_order_relaxed) + CHUNK_NODES > MAX_CHUNKS * CHUNK_NODES) {
+    return false;
+  }
+
+  uint64_t head = keyHead(key);
+  for (size_t attempt = 0;; backoff(++attempt)) {
+    std::optional<Descent> descent = descend(key, true);
+    if (!descent) {
+      continue;
+    }
+    if (descent->full_inner) {
+      // Make room for a separator now, so that splitting a node below
+      // never has to lock more than that node and its parent
+      if (lockForSplit(*descent)) {
+        split(*descent, NO_POSITION, {}, 0, 0);
+      }
+      continue;
+    }
+
+    Node& leaf = *getNode(descent->node);
+    if (!leaf.tryLock(descent->node_version)) {
+      continue;
+    }
+    uint16_t index = leaf.search(key, head, false);
+    if (index < leaf.count() && leaf.compare(index, key, head) == 0) {
+      // Like PostgreSQL's _bt_check_unique(), an entry of a dead tuple does not count
+      bool replace = unique_ && is_live && !is_live(leaf.tupleId(index));
+      if (replace) {
+        leaf.setTupleId(index, tuple_id);
+      }
+      leaf.unlock();
+      return replace;
+    }
+    if (!leaf.add(index, key, tuple_id.first, tuple_id.second)) {
+      // The leaf is full: split it with its parent locked too, in the usual order
+      leaf.unlock();
+      descent->node_version += 2 * LOCKED;
+      if (!lockForSplit(*descent)) {
+        continue;
+      }
+      split(*descent, index, key, tuple_id.first, tuple_id.second);
+    } else {
+      leaf.unlock();
+    }
+    entry_count_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+}
+
+void BTreeIndex::split(const Descent& descent, uint16_t position, std::span<const std::byte> key, uint64_t value,
+                       uint16_t aux) {
+  // Lay the old entries out again with the new one, in two nodes
+  PageId node_id = descent.node;
+  Node& left = *getNode(node_id);
+  auto old = std::make_unique<Node>(left);
+  uint16_t level = old->header().level;
+  if (key.empty()) {
+    position = NO_POSITION;
+  }
+  auto total = static_cast<uint16_t>(old->count() + (key.empty() ? 0 : 1));
+  auto entryKey = [&](uint16_t i) {
+    return i == position ? key : old->key(i < position ? i : static_cast<uint16_t>(i - 1));
+  };
+  auto entryValue = [&](uint16_t i) {
+    return i == position ? value : old->value(i < position ? i : static_cast<uint16_t>(i - 1));
+  };
+  auto entryAux = [&](uint16_t i) {
+    return i == position ? aux : old->slots()[i < position ? i : i - 1].aux;
+  };
+
+  // Split at half the bytes, except that ascending inserts into the last
+  // leaf leave it full and start a new one
+  uint16_t middle;
+  if (level == 0 && old->header().link == 0 && position == old->count()) {
+    middle = static_cast<uint16_t>(total - 1);
+  } else {
+    size_t bytes = 0;
+    for (uint16_t i = 0; i < total; ++i) {
+      bytes += sizeof(Slot) + VALUE_SIZE + entryKey(i).size();
+    }
+    size_t left_bytes = 0;
+    middle = 0;
+    while (middle < total - 1 && left_bytes < bytes / 2) {
+      left_bytes += sizeof(Slot) + VALUE_SIZE + entryKey(middle).size();
+      ++middle;
+    }
+    middle = std::clamp<uint16_t>(middle, 1, static_cast<uint16_t>(level == 0 ? total - 1 : total - 2));
+  }
+
+  // The right node is only reachable once the parent or the left leaf's
+  // link points at it, and both are locked
+  PageId right_id = allocateNode(level, 0);
+  Node& right = *getNode(right_id);
+  std::vector<std::byte> separator;
+  uint16_t right_first;
+  if (level == 0) {
+    // The shortest prefix of the right leaf's first key above the left leaf's last
+    std::span<const std::byte> last = entryKey(static_cast<uint16_t>(middle - 1));
+    std::span<const std::byte> first = entryKey(middle);
+    size_t length = 0;
+    while (length < last.size() && last[length] == first[length]) {
+      ++length;
+    }
+    separator.assign(first.begin(), first.begin() + static_cast<std::ptrdiff_t>(length + 1));
+    right.init(level, old->header().link);
+    left.init(level, right_id);
+    right_first = middle;
+  } else {
+    // The middle separator moves up; its child becomes the right node's leftmost
+    std::span<const std::byte> up = entryKey(middle);
+    separator.assign(up.begin(), up.end());
+    right.init(level, entryValue(middle));
+    left.init(level, old->header().link);
+    right_first = static_cast<uint16_t>(middle + 1);
+  }
+  for (uint16_t i = 0; i < middle; ++i) {
+    left.add(left.count(), entryKey(i), entryValue(i), entryAux(i));
+  }
+  for (uint16_t i = right_first; i < total; ++i) {
+    right.add(right.count(), entryKey(i), entryValue(i), entryAux(i));
+  }
+
+  if (descent.parent == 0) {
+    PageId root_id = allocateNode(static_cast<uint16_t>(level + 1), node_id);
+    getNode(root_id)->add(0, separator, right_id, 0);
+    height_.fetch_add(1, std::memory_order_relaxed);
+    root_.store(root_id, std::memory_order_release);
+  } else {
+    Node& parent = *getNode(descent.parent);
+    uint16_t index = parent.search(separator, keyHead(separator), true);
+    parent.add(index, separator, right_id, 0);  // Room was made on the way down
+    parent.unlock();
+  }
+  left.unlock();
+}
+
+}  // namespace database
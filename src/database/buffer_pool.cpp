@@ -0,0 +1,554 @@
+#include "database/buffer_pool.hpp"
+#include "database/write_ahead_log.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace database {
+
+PageGuard::PageGuard(PageGuard&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)),
+      frame_index_(other.frame_index_),
+      view_(std::move(other.view_)),
+      page_(view_ ? &*view_ : other.page_) {
+  other.release();
+}
+
+PageGuard& PageGuard::operator=(PageGuard&& other) noexcept {
+  if (this != &other) {
+    release();
+    pool_ = std::exchange(other.pool_, nullptr);
+    frame_index_ = other.frame_index_;
+    view_ = std::move(other.view_);
+    page_ = view_ ? &*view_ : other.page_;
+    other.release();
+  }
+  return *this;
+}
+
+void PageGuard::markDirty() noexcept {
+  if (pool_) {
+    pool_->markDirty(frame_index_);
+  }
+}
+
+void PageGuard::release() noexcept {
+  if (pool_) {
+    pool_->unpin(frame_index_);
+  }
+  pool_ = nullptr;
+  view_.reset();
+  page_ = nullptr;
+}
+
+BufferPool::BufferPool(size_t frame_count, size_t page_size, IoEngineType io_engine_type)
+    : page_size_(page_size) {
+  frame_count = std::max<size_t>(1, frame_count);
+  frames_.reserve(frame_count);
+  free_frames_.reserve(frame_count);
+  for (size_t i = 0; i < frame_count; ++i) {
+    frames_.emplace_back(page_size);
+    free_frames_.push_back(frame_count - 1 - i);  // Hand out low frames first
+  }
+  page_table_.reserve(frame_count);
+
+  io_engine_ = IoEngine::create(io_engine_type, std::min<size_t>(frame_count, MAX_IO_QUEUE_DEPTH));
+  if (!io_engine_) {
+    io_engine_ = IoEngine::create(IoEngineType::PREAD, std::min<size_t>(frame_count, MAX_IO_QUEUE_DEPTH));
+  }
+  std::vector<std::byte*> buffers;
+  buffers.reserve(frame_count);
+  for (Frame& frame : frames_) {
+    buffers.push_back(frame.page.getData());
+  }
+  buffers_registered_ = io_engine_->registerBuffers(buffers, page_size_);
+}
+
+BufferPool::~BufferPool() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < frames_.size(); ++i) {
+    waitForIo(lock, i);
+  }
+}
+
+PageGuard BufferPool::fetchPage(SegmentFile& file, PageId page_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  BufferTag tag{ &file, page_id };
+  std::optional<size_t> frame_index;
+  while (!frame_index) {
+    for (auto it = page_table_.find(tag); it != page_table_.end(); it = page_table_.find(tag)) {
+      if (!frames_[it->second].io_in_progress) {
+        ++stats_.hits;
+        return pin(it->second);
+      }
+      waitForIo(lock, it->second);  // Being read by another thread; the read may also have failed
+    }
+
+    frame_index = allocateFrame(lock);
+    if (!frame_index) {
+      return PageGuard();
+    }
+    if (page_table_.count(tag) > 0) {
+      // Another thread mapped the page while an eviction had the latch released
+      free_frames_.push_back(*frame_index);
+      frame_index.reset();
+    }
+  }
+  ++stats_.misses;
+
+  // Mapped before the read, so concurrent fetches of the page wait for it.
+  // The pin keeps the frame ours once the read has finished.
+  Frame& frame = frames_[*frame_index];
+  frame.file = &file;
+  frame.page_id = page_id;
+  frame.dirty = false;
+  frame.usage_count = 0;
+  frame.prefetched = false;
+  frame.pin_count = 1;
+  page_table_.emplace(tag, *frame_index);
+
+  bool success = false;
+  if (prepareIo(*frame_index, IoOperation::READ)) {
+    lock.unlock();
+    io_engine_->submit();
+    lock.lock();
+    waitForIo(lock, *frame_index);
+    success = !frame.io_failed;  // A failed read was already unmapped
+    frame.io_failed = false;
+  } else {
+    // The engine is full: read directly
+    frame.io_in_progress = true;
+    frame.io_synchronous = true;
+    frame.io_operation = IoOperation::READ;
+    lock.unlock();
+    success = file.readPage(page_id, frame.page.getData()) && frame.page.loadHeader(page_id);
+    lock.lock();
+    frame.io_in_progress = false;
+    frame.io_synchronous = false;
+    io_cv_.notify_all();
+    if (!success) {
+      page_table_.erase(tag);
+    }
+  }
+
+  --frame.pin_count;
+  if (!success) {
+    frame.file = nullptr;
+    free_frames_.push_back(*frame_index);
+    return PageGuard();
+  }
+  return pin(*frame_index);
+}
+
+size_t BufferPool::prefetchPages(SegmentFile& file, PageId first_page_id, size_t count) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  pollIo();
+
+  size_t file_pages = file.getPageCount();
+  size_t started = 0;
+  PageId page_id = first_page_id;
+  for (; page_id < first_page_id + count; ++page_id) {
+    if (page_table_.count(BufferTag{ &file, page_id }) > 0) {
+      continue;
+    }
+    if (page_id == 0 || page_id > file_pages || prefetched_frames_ >= frames_.size() / 4 ||
+        io_engine_->getInFlight() >= io_engine_->getQueueDepth()) {
+      break;
+    }
+    auto frame_index = allocateFrame(lock);
+    if (!frame_index) {
+      break;
+    }
+    if (page_table_.count(BufferTag{ &file, page_id }) > 0) {
+      free_frames_.push_back(*frame_index);  // Fetched while an eviction had the latch released
+      continue;
+    }
+
+    Frame& frame = frames_[*frame_index];
+    frame.file = &file;
+    frame.page_id = page_id;
+    frame.dirty = false;
+    frame.usage_count = 1;  // The read counts as the first use, not the pin that consumes it
+    frame.prefetched = true;
+    if (!prepareIo(*frame_index, IoOperation::READ)) {
+      frame.file = nullptr;
+      free_frames_.push_back(*frame_index);
+      break;
+    }
+    page_table_.emplace(BufferTag{ &file, page_id }, *frame_index);
+    ++prefetched_frames_;
+    ++started;
+  }
+
+  if (started > 0) {
+    stats_.prefetches += started;
+    lock.unlock();
+    io_engine_->submit();
+  }
+  return page_id - first_page_id;
+}
+
+PageGuard BufferPool::newPage(SegmentFile& file, PageId page_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  // A stale cached copy (e.g. of a page past a truncated end) is replaced
+  BufferTag tag{ &file, page_id };
+  size_t frame_index = 0;
+  while (true) {
+    auto it = page_table_.find(tag);
+    if (it != page_table_.end() && frames_[it->second].io_in_progress) {
+      waitForIo(lock, it->second);
+      continue;
+    }
+    if (it != page_table_.end()) {
+      frame_index = it->second;
+      if (frames_[frame_index].pin_count > 0) {
+        return PageGuard();
+      }
+      break;
+    }
+
+    auto allocated = allocateFrame(lock);
+    if (!allocated) {
+      return PageGuard();
+    }
+    if (page_table_.count(tag) > 0) {
+      free_frames_.push_back(*allocated);  // Mapped while an eviction had the latch released
+      continue;
+    }
+    frame_index = *allocated;
+    page_table_.emplace(tag, frame_index);
+    break;
+  }
+
+  Frame& frame = frames_[frame_index];
+  frame.page.reset(page_id);
+  frame.file = &file;
+  frame.page_id = page_id;
+  frame.dirty = true;
+  frame.usage_count = 0;
+  frame.prefetched = false;
+  return pin(frame_index);
+}
+
+bool BufferPool::flushFile(SegmentFile& file) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  bool ok = true;
+  for (size_t i = 0; i < frames_.size(); ++i) {
+    if (frames_[i].file == &file) {
+      waitForIo(lock, i);
+    }
+    Frame& frame = frames_[i];
+    if (frame.file == &file && frame.dirty) {
+      ok = writeBack(lock, i) && ok;
+    }
+  }
+  if (!file.sync()) {
+    return false;
+  }
+  unsynced_files_.erase(&file);
+  return ok;
+}
+
+bool BufferPool::flushDirtyPages(size_t pages_per_round, const std::function<bool(size_t)>& throttle) {
+  std::vector<BufferTag> pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Frame& frame : frames_) {
+      if (frame.file && frame.dirty) {
+        pending.push_back(BufferTag{ frame.file, frame.page_id });
+      }
+    }
+  }
+
+  pages_per_round = std::max<size_t>(1, pages_per_round);
+  std::vector<size_t> batch;
+  while (!pending.empty()) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    pollIo();
+
+    // Pick this round's pages. A page evicted since the snapshot was written back on eviction.
+    std::vector<BufferTag> retry;
+    batch.clear();
+    Lsn batch_lsn = 0;
+    size_t i = 0;
+    for (; i < pending.size() && batch.size() < pages_per_round; ++i) {
+      auto it = page_table_.find(pending[i]);
+      if (it == page_table_.end() || !frames_[it->second].dirty) {
+        continue;
+      }
+      Frame& frame = frames_[it->second];
+      if (frame.pin_count > 0 || frame.io_in_progress) {
+        retry.push_back(pending[i]);
+        continue;
+      }
+      batch.push_back(it->second);
+      batch_lsn = std::max(batch_lsn, frame.page.getLsn());
+    }
+    retry.insert(retry.end(), pending.begin() + static_cast<std::ptrdiff_t>(i), pending.end());
+    pending.swap(retry);
+
+    // One log flush covers the batch, then its writes are submitted together
+    if (!batch.empty() && wal_ && !wal_->flush(batch_lsn)) {
+      return false;
+    }
+    bool ok = true;
+    size_t queued = 0;
+    while (queued < batch.size() && prepareIo(batch[queued], IoOperation::WRITE)) {
+      ++queued;
+    }
+    lock.unlock();
+    io_engine_->submit();
+    lock.lock();
+
+    // The engine is full: write the rest directly. That releases the latch,
+    // so each frame is checked again first.
+    for (size_t j = queued; j < batch.size(); ++j) {
+      if (frames_[batch[j]].dirty && !frames_[batch[j]].io_in_progress) {
+        ok = writeBack(lock, batch[j]) && ok;
+      }
+    }
+    batch.resize(queued);
+    for (size_t frame_index : batch) {
+      waitForIo(lock, frame_index);
+      ok = !frames_[frame_index].io_failed && ok;
+      frames_[frame_index].io_failed = false;
+    }
+    if (!ok) {
+      return false;
+    }
+
+    lock.unlock();
+    if (!pending.empty() && !throttle(batch.size())) {
+      return false;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = unsynced_files_.begin(); it != unsynced_files_.end();) {
+    if (!(*it)->sync()) {
+      return false;
+    }
+    it = unsynced_files_.erase(it);
+  }
+  return true;
+}
+
+void BufferPool::discardFile(const SegmentFile& file) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  std::erase_if(unsynced_files_, [&file](const SegmentFile* unsynced) { return unsynced == &file; });
+  discardFrames(lock, file, 1);
+}
+
+void BufferPool::discardPages(const SegmentFile& file, PageId first_page_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  discardFrames(lock, file, first_page_id);
+}
+
+void BufferPool::discardFrames(std::unique_lock<std::mutex>& lock, const SegmentFile& file, PageId first_page_id) {
+  for (size_t i = 0; i < frames_.size(); ++i) {
+    if (frames_[i].file == &file && frames_[i].page_id >= first_page_id) {
+      waitForIo(lock, i);
+    }
+    Frame& frame = frames_[i];
+    if (frame.file != &file || frame.page_id < first_page_id || frame.pin_count > 0) {
+      continue;
+    }
+    page_table_.erase(BufferTag{ frame.file, frame.page_id });
+    frame.file = nullptr;
+    frame.dirty = false;
+    free_frames_.push_back(i);
+  }
+}
+
+BufferPoolStats BufferPool::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void BufferPool::resetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_ = BufferPoolStats{};
+}
+
+std::optional<size_t> BufferPool::allocateFrame(std::unique_lock<std::mutex>& lock) {
+  if (free_frames_.empty()) {
+    pollIo();  // Finished readahead frames become evictable
+  }
+  if (!free_frames_.empty()) {
+    size_t frame_index = free_frames_.back();
+    free_frames_.pop_back();
+    return frame_index;
+  }
+
+  // Clock sweep. A full pass decrements every usage count by one, so after
+  // MAX_USAGE_COUNT + 1 passes any unpinned frame has reached zero.
+  size_t max_steps = frames_.size() * (MAX_USAGE_COUNT + 1U);
+  for (size_t step = 0; step < max_steps; ++step) {
+    size_t frame_index = clock_hand_;
+    clock_hand_ = (clock_hand_ + 1) % frames_.size();
+
+    Frame& frame = frames_[frame_index];
+    if (frame.pin_count > 0 || frame.io_in_progress) {
+      continue;
+    }
+    if (frame.usage_count > 0) {
+      --frame.usage_count;
+      continue;
+    }
+
+    if (frame.dirty) {
+      BufferTag tag{ frame.file, frame.page_id };
+      if (!writeBack(lock, frame_index)) {
+        return std::nullopt;
+      }
+      // While the latch was released the page may have been used again,
+      // or the frame freed and reused
+      if (!free_frames_.empty()) {
+        size_t free_index = free_frames_.back();
+        free_frames_.pop_back();
+        return free_index;
+      }
+      if (frame.file != tag.file || frame.page_id != tag.page_id || frame.pin_count > 0 || frame.usage_count > 0 ||
+          frame.dirty || frame.io_in_progress) {
+        continue;
+      }
+    }
+    page_table_.erase(BufferTag{ frame.file, frame.page_id });
+    frame.file = nullptr;
+    ++stats_.evictions;
+    return frame_index;
+  }
+
+  return std::nullopt;  // Every frame is pinned
+}
+
+bool BufferPool::writeBack(std::unique_lock<std::mutex>& lock, size_t frame_index) {
+  Frame& frame = frames_[frame_index];
+  SegmentFile* file = frame.file;
+  PageId page_id = frame.page_id;
+  Lsn lsn = frame.page.getLsn();
+  frame.dirty = false;  // Cleared first, so a markDirty() during the write is kept
+  frame.io_in_progress = true;
+  frame.io_synchronous = true;
+  frame.io_operation = IoOperation::WRITE;
+
+  lock.unlock();
+  bool success = (!wal_ || wal_->flush(lsn)) && file->writePage(page_id, frame.page.getData());
+  lock.lock();
+  frame.io_in_progress = false;
+  frame.io_synchronous = false;
+  io_cv_.notify_all();
+
+  if (!success) {
+    frame.dirty = true;
+    return false;
+  }
+  unsynced_files_.insert(file);
+  ++stats_.writes;
+  return true;
+}
+
+bool BufferPool::prepareIo(size_t frame_index, IoOperation operation) {
+  Frame& frame = frames_[frame_index];
+  IoRequest request{ operation, frame.file, frame.page_id, frame.page.getData(),
+                     buffers_registered_ ? static_cast<int>(frame_index) : -1, frame_index };
+  if (!io_engine_->prepare(request)) {
+    return false;
+  }
+  frame.io_in_progress = true;
+  frame.io_operation = operation;
+  return true;
+}
+
+void BufferPool::waitForIo(std::unique_lock<std::mutex>& lock, size_t frame_index) {
+  std::vector<IoCompletion> completions;
+  while (frames_[frame_index].io_in_progress) {
+    // Synchronous I/O is finished by the thread running it
+    if (reaping_ || frames_[frame_index].io_synchronous) {
+      io_cv_.wait(lock);
+      continue;
+    }
+
+    reaping_ = true;
+    lock.unlock();
+    io_engine_->submit();  // In case the thread that prepared the I/O has not submitted it yet
+    completions.clear();
+    io_engine_->reap(completions, 1);
+    lock.lock();
+    for (const IoCompletion& completion : completions) {
+      completeIo(completion);
+    }
+    reaping_ = false;
+    io_cv_.notify_all();
+  }
+}
+
+void BufferPool::pollIo() {
+  if (reaping_ || io_engine_->getInFlight() == 0) {
+    return;  // The reaper processes completions when it gets the latch back
+  }
+  std::vector<IoCompletion> completions;
+  io_engine_->reap(completions, 0);
+  for (const IoCompletion& completion : completions) {
+    completeIo(completion);
+  }
+}
+
+void BufferPool::completeIo(const IoCompletion& completion) {
+  size_t frame_index = static_cast<size_t>(completion.user_data);
+  Frame& frame = frames_[frame_index];
+  bool success = completion.transferred == page_size_;
+  frame.io_in_progress = false;
+
+  if (frame.io_operation == IoOperation::WRITE) {
+    frame.io_failed = !success;
+    if (success) {
+      frame.dirty = false;
+      unsynced_files_.insert(frame.file);
+      ++stats_.writes;
+    }
+    return;
+  }
+
+  bool loaded = success && frame.page.loadHeader(frame.page_id);
+  if (!loaded) {
+    page_table_.erase(BufferTag{ frame.file, frame.page_id });
+  }
+  if (!frame.prefetched) {
+    frame.io_failed = !loaded;  // A demand read: the fetch holding the frame frees it
+    return;
+  }
+
+  --prefetched_frames_;
+  if (!loaded) {
+    // Leave the page to a later fetch, which reports the error
+    frame.file = nullptr;
+    free_frames_.push_back(frame_index);
+  }
+}
+
+PageGuard BufferPool::pin(size_t frame_index) {
+  Frame& frame = frames_[frame_index];
+  ++frame.pin_count;
+  if (frame.prefetched) {
+    frame.prefetched = false;
+  } else {
+    frame.usage_count = static_cast<uint8_t>(std::min<unsigned>(frame.usage_count + 1U, MAX_USAGE_COUNT));
+  }
+  return PageGuard(this, frame_index, &frame.page);
+}
+
+void BufferPool::unpin(size_t frame_index) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  --frames_[frame_index].pin_count;
+}
+
+void BufferPool::markDirty(size_t frame_index) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  frames_[frame_index].dirty = true;
+}
+
+}  // namespace database
@@ -0,0 +1,507 @@
+#include "database/bulk_loader.hpp"
+#include "database/heap_scan.hpp"
+#include "database/mapped_file.hpp"
+#include "database/tuple_builder.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace database {
+
+namespace {
+
+/**
+ * @brief Fills private pages with serialized tuples
+ */
+class PageWriter {
+public:
+  explicit PageWriter(std::vector<std::unique_ptr<Page>>& pages) : pages_(pages) {
+  }
+
+  bool append(std::span<const std::byte> tuple_bytes) {
+    if (!pages_.empty() && pages_.back()->addTupleBytes(tuple_bytes)) {
+      return true;
+    }
+    // Page IDs are assigned when the heap file adopts the pages
+    pages_.push_back(std::make_unique<Page>(0, HeapFile::DEFAULT_PAGE_SIZE));
+    return pages_.back()->addTupleBytes(tuple_bytes).has_value();
+  }
+
+private:
+  std::vector<std::unique_ptr<Page>>& pages_;
+};
+
+/**
+ * @brief What one worker produced from its chunk
+ */
+struct ChunkResult {
+  std::vector<std::unique_ptr<Page>> pages;
+  size_t rows = 0;
+  size_t lines = 0;  // Lines or records consumed, including the failing one
+  bool failed = false;
+  std::string error_message;
+};
+
+template <typename T>
+bool parseNumber(std::string_view field, T& value) {
+  auto [end, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+  return ec == std::errc() && end == field.data() + field.size();
+}
+
+bool parseBoolean(std::string_view field, bool& value) {
+  std::array<char, 5> lower{};
+  if (field.empty() || field.size() > lower.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < field.size(); ++i) {
+    lower[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(field[i])));
+  }
+
+  std::string_view word(lower.data(), field.size());
+  if (word == "true" || word == "t" || word == "1") {
+    value = true;
+    return true;
+  }
+  if (word == "false" || word == "f" || word == "0") {
+    value = false;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Parses CSV lines of one chunk into rows
+ */
+class CsvChunkParser {
+public:
+  CsvChunkParser(const Schema& schema, char delimiter, TransactionId txn_id)
+      : schema_(schema),
+        delimiter_(delimiter),
+        txn_id_(txn_id),
+        builder_(schema),
+        scratch_(schema.getColumnCount()) {
+  }
+
+  void parse(std::string_view chunk, ChunkResult& result, const std::atomic<bool>& stop) {
+    PageWriter writer(result.pages);
+    size_t pos = 0;
+
+    while (pos < chunk.size() && !stop.load(std::memory_order_relaxed)) {
+      size_t end = chunk.find('\n', pos);
+      if (end == std::string_view::npos) {
+        end = chunk.size();
+      }
+      std::string_view line = chunk.substr(pos, end - pos);
+      pos = end + 1;
+      ++result.lines;
+
+      if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+      }
+      if (line.empty()) {
+        continue;
+      }
+
+      std::string_view error = parseRow(line);
+      if (error.empty()) {
+        auto tuple_bytes = builder_.build();
+        if (!tuple_bytes) {
+          error = "NULL in a non-nullable column or row too large";
+        } else if (!writer.append(*tuple_bytes)) {
+          error = "row does not fit in a page";
+        }
+      }
+      if (!error.empty()) {
+        result.failed = true;
+        result.error_message = std::string(error);
+        return;
+      }
+      ++result.rows;
+    }
+  }
+
+private:
+  const Schema& schema_;
+  char delimiter_;
+  TransactionId txn_id_;
+  TupleBuilder builder_;
+  std::vector<std::string> scratch_;  // Unescaped quoted fields, per column
+
+  /**
+   * @return Empty on success, otherwise the error message
+   */
+  std::string_view parseRow(std::string_view line) {
+    const auto& columns = schema_.getColumns();
+    builder_.reset(txn_id_);
+
+    ColumnId column_id = 0;
+    size_t pos = 0;
+    while (true) {
+      if (column_id >= columns.size()) {
+        return "too many fields";
+      }
+
+      std::string_view field;
+      bool quoted = pos < line.size() && line[pos] == '"';
+      if (quoted) {
+        size_t start = ++pos;
+        bool escaped = false;
+        while (pos < line.size()) {
+          if (line[pos] == '"') {
+            if (pos + 1 < line.size() && line[pos + 1] == '"') {
+              escaped = true;
+              pos += 2;
+              continue;
+            }
+            break;
+          }
+          ++pos;
+        }
+        if (pos >= line.size()) {
+          return "unterminated quoted field";
+        }
+        field = line.substr(start, pos - start);
+        ++pos;  // Closing quote
+        if (pos < line.size() && line[pos] != delimiter_) {
+          return "unexpected character after quoted field";
+        }
+        if (escaped) {
+          field = unescape(column_id, field);
+        }
+      } else {
+        size_t end = std::min(line.find(delimiter_, pos), line.size());
+        field = line.substr(pos, end - pos);
+        pos = end;
+      }
+
+      if (!setField(column_id, field, quoted)) {
+        return "invalid value";
+      }
+      ++column_id;
+
+      if (pos >= line.size()) {
+        break;
+      }
+      ++pos;  // Delimiter
+    }
+
+    if (column_id != columns.size()) {
+      return "too few fields";
+    }
+    return {};
+  }
+
+  std::string_view unescape(ColumnId column_id, std::string_view field) {
+    std::string& out = scratch_[column_id];
+    out.clear();
+    for (size_t i = 0; i < field.size(); ++i) {
+      out.push_back(field[i]);
+      if (field[i] == '"') {
+        ++i;  // Skip the second quote of the pair
+      }
+    }
+    return out;
+  }
+
+  bool setField(ColumnId column_id, std::string_view field, bool quoted) {
+    if (field.empty() && !quoted) {
+      builder_.setNull(column_id);
+      return true;
+    }
+
+    switch (schema_.getLayout().getColumnType(column_id)) {
+      case DataType::INTEGER: {
+        int64_t value = 0;
+        if (!parseNumber(field, value)) {
+          return false;
+        }
+        builder_.setInteger(column_id, value);
+        return true;
+      }
+      case DataType::DOUBLE: {
+        double value = 0;
+        if (!parseNumber(field, value)) {
+          return false;
+        }
+        builder_.setDouble(column_id, value);
+        return true;
+      }
+      case DataType::BOOLEAN: {
+        bool value = false;
+        if (!parseBoolean(field, value)) {
+          return false;
+        }
+        builder_.setBoolean(column_id, value);
+        return true;
+      }
+      case DataType::TEXT:
+        builder_.setText(column_id, field);
+        return true;
+    }
+    return false;
+  }
+};
+
+/**
+ * @brief Checks records of one chunk of a binary file and restamps them
+ */
+class BinaryChunkParser {
+public:
+  BinaryChunkParser(const Schema& schema, TransactionId txn_id) : schema_(schema), txn_id_(txn_id) {
+  }
+
+  void parse(std::span<const std::byte> chunk, ChunkResult& result, const std::atomic<bool>& stop) {
+    PageWriter writer(result.pages);
+    size_t pos = 0;
+
+    while (pos < chunk.size() && !stop.load(std::memory_order_relaxed)) {
+      ++result.lines;
+      std::string_view error = parseRecord(chunk, pos, writer);
+      if (!error.empty()) {
+        result.failed = true;
+        result.error_message = std::string(error);
+        return;
+      }
+      ++result.rows;
+    }
+  }
+
+private:
+  const Schema& schema_;
+  TransactionId txn_id_;
+  std::vector<std::byte> record_;
+
+  /**
+   * @return Empty on success, otherwise the error message
+   */
+  std::string_view parseRecord(std::span<const std::byte> chunk, size_t& pos, PageWriter& writer) {
+    uint32_t length = 0;
+    if (chunk.size() - pos < sizeof(length)) {
+      return "truncated record header";
+    }
+    std::memcpy(&length, chunk.data() + pos, sizeof(length));
+    pos += sizeof(length);
+    if (chunk.size() - pos < length) {
+      return "truncated record";
+    }
+
+    TupleView view(schema_, chunk.data() + pos, length);
+    if (length > std::numeric_limits<uint16_t>::max() || !view.isWellFormed()) {
+      return "malformed tuple";
+    }
+    const auto& columns = schema_.getColumns();
+    for (ColumnId i = 0; i < columns.size(); ++i) {
+      if (!columns[i].isNullable() && view.isNull(i)) {
+        return "NULL in a non-nullable column";
+      }
+    }
+
+    // The rows belong to the loading transaction, not the one that wrote them
+    record_.assign(chunk.data() + pos, chunk.data() + pos + length);
+    TupleHeader header(txn_id_);
+    std::memcpy(record_.data(), &header, sizeof(header));
+    if (!writer.append(record_)) {
+      return "row does not fit in a page";
+    }
+    pos += length;
+    return {};
+  }
+};
+
+BulkLoadResult failure(size_t line, std::string message) {
+  BulkLoadResult result;
+  result.error_line = line;
+  result.error_message = std::move(message);
+  return result;
+}
+
+/**
+ * @brief Parse chunk_count chunks in parallel and append their pages in input order
+ *
+ * worker(index, result, stop) parses chunk index into result, giving up
+ * once stop is set. The calling thread parses the first chunk and then
+ * appends each chunk's pages as soon as that chunk is parsed, so pages do
+ * not pile up in memory until the end. The first failure stops the other
+ * workers and cuts off every page appended so far.
+ */
+template <typename Worker>
+BulkLoadResult loadChunks(HeapFile& heap_file, size_t chunk_count, size_t first_line, const Worker& worker) {
+  std::vector<ChunkResult> results(chunk_count);
+  std::atomic<bool> stop{ false };
+  std::vector<std::thread> threads;
+  threads.reserve(chunk_count);
+  for (size_t i = 1; i < chunk_count; ++i) {
+    threads.emplace_back([&worker, &results, &stop, i] { worker(i, results[i], stop); });
+  }
+  if (chunk_count > 0) {
+    worker(0, results[0], stop);
+  }
+
+  // Chunks before a failure were parsed completely, so their line counts
+  // give the failing row's line number
+  PageId first_page_id = heap_file.getPageIdLimit();
+  BulkLoadResult result;
+  result.success = true;
+  size_t line = first_line;
+  for (size_t i = 0; i < chunk_count; ++i) {
+    if (i > 0) {
+      threads[i - 1].join();
+    }
+    ChunkResult& chunk = results[i];
+    if (chunk.failed) {
+      result = failure(line + chunk.lines - 1, std::move(chunk.error_message));
+      break;
+    }
+    if (!heap_file.appendPages(std::move(chunk.pages))) {
+      result = failure(0, "out of buffer frames while appending pages");
+      break;
+    }
+    line += chunk.lines;
+    result.rows_loaded += chunk.rows;
+  }
+
+  if (!result.success) {
+    stop = true;
+    for (auto& thread : threads) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+    heap_file.truncatePages(first_page_id);
+  }
+  return result;
+}
+
+}  // namespace
+
+BulkLoader::BulkLoader(HeapFile& heap_file, BulkLoadOptions options)
+    : heap_file_(heap_file),
+      options_(options) {
+}
+
+BulkLoadResult BulkLoader::loadCsv(const std::string& path, TransactionId txn_id) {
+  auto file = MappedFile::open(path);
+  if (!file) {
+    return failure(0, "cannot open " + path);
+  }
+  file->adviseSequential();
+  return loadCsvData(std::string_view(reinterpret_cast<const char*>(file->data()), file->size()), txn_id);
+}
+
+BulkLoadResult BulkLoader::loadCsvData(std::string_view data, TransactionId txn_id) {
+  size_t first_line = 1;
+  if (options_.has_header) {
+    size_t end = data.find('\n');
+    data.remove_prefix(end == std::string_view::npos ? data.size() : end + 1);
+    first_line = 2;
+  }
+
+  // Split at line boundaries so every chunk holds whole rows
+  size_t chunk_count = chunkCount(data.size());
+  std::vector<std::string_view> chunks;
+  chunks.reserve(chunk_count);
+  size_t start = 0;
+  for (size_t i = 1; i <= chunk_count && start < data.size(); ++i) {
+    size_t end = data.size();
+    if (i < chunk_count) {
+      end = data.find('\n', std::max(start, data.size() * i / chunk_count));
+      end = end == std::string_view::npos ? data.size() : end + 1;
+    }
+    chunks.push_back(data.substr(start, end - start));
+    start = end;
+  }
+
+  const Schema& schema = heap_file_.getSchema();
+  return loadChunks(heap_file_, chunks.size(), first_line,
+                    [&](size_t index, ChunkResult& result, const std::atomic<bool>& stop) {
+                      CsvChunkParser parser(schema, options_.delimiter, txn_id);
+                      parser.parse(chunks[index], result, stop);
+                    });
+}
+
+BulkLoadResult BulkLoader::loadBinary(const std::string& path, TransactionId txn_id) {
+  auto file = MappedFile::open(path);
+  if (!file) {
+    return failure(0, "cannot open " + path);
+  }
+  file->adviseSequential();
+
+  const std::byte* data = file->data();
+  size_t size = file->size();
+  if (size < BINARY_MAGIC.size() || std::memcmp(data, BINARY_MAGIC.data(), BINARY_MAGIC.size()) != 0) {
+    return failure(0, "not a bulk load file");
+  }
+
+  // A quick pass over the length prefixes finds record boundaries to split
+  // at. It stops at the first damaged header, leaving the rest to the last
+  // chunk, whose worker reports the error.
+  std::span<const std::byte> records(data + BINARY_MAGIC.size(), size - BINARY_MAGIC.size());
+  size_t chunk_count = chunkCount(records.size());
+  std::vector<std::span<const std::byte>> chunks;
+  chunks.reserve(chunk_count);
+  size_t start = 0;
+  size_t pos = 0;
+  for (size_t i = 1; i < chunk_count; ++i) {
+    size_t target = records.size() * i / chunk_count;
+    uint32_t length = 0;
+    while (pos < target && records.size() - pos >= sizeof(length)) {
+      std::memcpy(&length, records.data() + pos, sizeof(length));
+      if (records.size() - pos - sizeof(length) < length) {
+        break;
+      }
+      pos += sizeof(length) + length;
+    }
+    if (pos < target) {
+      break;
+    }
+    chunks.push_back(records.subspan(start, pos - start));
+    start = pos;
+  }
+  chunks.push_back(records.subspan(start));
+
+  const Schema& schema = heap_file_.getSchema();
+  return loadChunks(heap_file_, chunks.size(), 1,
+                    [&](size_t index, ChunkResult& result, const std::atomic<bool>& stop) {
+                      BinaryChunkParser parser(schema, txn_id);
+                      parser.parse(chunks[index], result, stop);
+                    });
+}
+
+bool BulkLoader::dumpBinary(const HeapFile& heap_file, const std::string& path, const VisibilityChecker& checker,
+                            const Snapshot& snapshot) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    return false;
+  }
+
+  out.write(BINARY_MAGIC.data(), static_cast<std::streamsize>(BINARY_MAGIC.size()));
+  HeapScan scan(heap_file);
+  scan.setSnapshot(checker, snapshot);
+  while (auto scanned = scan.next()) {
+    auto length = static_cast<uint32_t>(scanned->tuple.getSize());
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.write(reinterpret_cast<const char*>(scanned->tuple.getData()), static_cast<std::streamsize>(length));
+  }
+
+  out.close();
+  return !out.fail();
+}
+
+size_t BulkLoader::chunkCount(size_t data_size) const noexcept {
+  size_t threads = options_.thread_count;
+  if (threads == 0) {
+    threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+  size_t by_size = data_size / std::max<size_t>(1, options_.min_chunk_size);
+  return std::clamp<size_t>(by_size, 1, threads);
+}
+
+}  // namespace database
@@ -0,0 +1,203 @@
+#include "database/catalog.hpp"
+#include "database/control_file.hpp"
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+namespace database {
+
+namespace {
+
+constexpr uint64_t CATALOG_MAGIC = 0x31304C5441434244ULL;  // "DBCATL01"
+
+struct CatalogHeader {
+  uint64_t magic;
+  TableId next_table_id;
+  uint32_t table_count;
+  uint64_t index_size;  // Bytes of entries following the header; the schemas come after them
+};
+
+struct EntryHeader {
+  TableId table_id;
+  uint16_t name_length;
+  uint16_t file_name_length;
+  uint32_t schema_size;
+};
+
+static_assert(sizeof(CatalogHeader) == 24 && sizeof(EntryHeader) == 12, "Catalog headers must not contain padding");
+
+template <typename T>
+bool readRaw(std::istream& in, T& value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+template <typename T>
+void writeRaw(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool readString(std::istream& in, size_t length, std::string& value) {
+  value.assign(length, '\0');
+  return static_cast<bool>(in.read(value.data(), static_cast<std::streamsize>(length)));
+}
+
+}  // namespace
+
+std::unique_ptr<Catalog> Catalog::open(const std::string& path) {
+  auto catalog = std::make_unique<Catalog>();
+  catalog->path_ = path;
+
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    return catalog;  // A new data directory
+  }
+  auto file_size = static_cast<uint64_t>(in.tellg());
+  in.seekg(0);
+
+  // The entries are read in one go; the schemas after them are left on disk
+  CatalogHeader header{};
+  if (!readRaw(in, header) || header.magic != CATALOG_MAGIC || header.index_size > file_size - sizeof(header)) {
+    return nullptr;
+  }
+  std::string index;
+  if (!readString(in, header.index_size, index)) {
+    return nullptr;
+  }
+  std::istringstream entries(std::move(index));
+  catalog->next_table_id_ = header.next_table_id;
+
+  uint64_t schema_offset = sizeof(header) + header.index_size;
+  catalog->tables_.reserve(header.table_count);
+  catalog->names_.reserve(header.table_count);
+  for (uint32_t i = 0; i < header.table_count; ++i) {
+    EntryHeader entry_header{};
+    Table table;
+    if (!readRaw(entries, entry_header) || !readString(entries, entry_header.name_length, table.entry.name) ||
+        !readString(entries, entry_header.file_name_length, table.entry.file_name)) {
+      return nullptr;
+    }
+    table.entry.table_id = entry_header.table_id;
+    table.schema_offset = schema_offset;
+    table.schema_size = entry_header.schema_size;
+    schema_offset += entry_header.schema_size;
+    if (schema_offset > file_size || entry_header.table_id == 0 || entry_header.table_id >= catalog->next_table_id_) {
+      return nullptr;
+    }
+
+    if (!catalog->names_.emplace(table.entry.name, table.entry.table_id).second ||
+        !catalog->tables_.emplace(table.entry.table_id, std::move(table)).second) {
+      return nullptr;  // Duplicate name or ID
+    }
+  }
+  return catalog;
+}
+
+TableId Catalog::createTable(const std::string& name, const Schema& schema) {
+  if (name.empty() || name.size() > std::numeric_limits<uint16_t>::max() || names_.count(name) > 0) {
+    return 0;
+  }
+
+  TableId table_id = next_table_id_++;
+  Table table;
+  table.entry = CatalogEntry{ table_id, name, std::to_string(table_id) + ".heap" };
+  table.schema = std::make_unique<Schema>(schema.clone());
+  tables_.emplace(table_id, std::move(table));
+  names_.emplace(name, table_id);
+  ++loaded_schemas_;
+
+  if (!persist()) {
+    tables_.erase(table_id);
+    names_.erase(name);
+    --loaded_schemas_;
+    --next_table_id_;
+    return 0;
+  }
+  return table_id;
+}
+
+TableId Catalog::findTable(const std::string& name) const {
+  auto it = names_.find(name);
+  return it == names_.end() ? 0 : it->second;
+}
+
+const CatalogEntry* Catalog::getEntry(TableId table_id) const {
+  auto it = tables_.find(table_id);
+  return it == tables_.end() ? nullptr : &it->second.entry;
+}
+
+const Schema* Catalog::getSchema(TableId table_id) {
+  auto it = tables_.find(table_id);
+  if (it == tables_.end()) {
+    return nullptr;
+  }
+
+  Table& table = it->second;
+  if (!table.schema) {
+    std::ifstream in(path_, std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(table.schema_offset));
+    auto schema = Schema::readFrom(in);
+    if (!schema) {
+      return nullptr;
+    }
+    table.schema = std::make_unique<Schema>(std::move(*schema));
+    ++loaded_schemas_;
+  }
+  return table.schema.get();
+}
+
+bool Catalog::persist() {
+  if (path_.empty()) {
+    return true;
+  }
+
+  // Schemas that were never loaded are copied byte for byte from the old file
+  std::ifstream old_file;
+  std::string raw_schema;
+  std::ostringstream entries;
+  std::ostringstream schemas;
+  std::vector<std::pair<uint64_t, uint32_t>> placements;  // New offset (from the schemas) and size per table
+  placements.reserve(tables_.size());
+  for (const auto& [table_id, table] : tables_) {
+    auto schema_start = schemas.tellp();
+    if (table.schema) {
+      table.schema->writeTo(schemas);
+    } else {
+      if (!old_file.is_open()) {
+        old_file.open(path_, std::ios::binary);
+      }
+      old_file.seekg(static_cast<std::streamoff>(table.schema_offset));
+      if (!readString(old_file, table.schema_size, raw_schema)) {
+        return false;
+      }
+      schemas << raw_schema;
+    }
+    auto schema_size = static_cast<uint32_t>(schemas.tellp() - schema_start);
+    placements.emplace_back(static_cast<uint64_t>(schema_start), schema_size);
+    writeRaw(entries, EntryHeader{ table_id, static_cast<uint16_t>(table.entry.name.size()),
+                                   static_cast<uint16_t>(table.entry.file_name.size()), schema_size });
+    entries << table.entry.name << table.entry.file_name;
+  }
+
+  std::ostringstream out;
+  std::string index = entries.str();
+  writeRaw(out, CatalogHeader{ CATALOG_MAGIC, next_table_id_, static_cast<uint32_t>(tables_.size()), index.size() });
+  out << index << schemas.str();
+
+  std::string image = out.str();
+  if (!writeFileAtomically(path_, std::as_bytes(std::span(image.data(), image.size())))) {
+    return false;
+  }
+
+  // The old offsets stay valid until the new file has replaced the old one
+  uint64_t schemas_start = sizeof(CatalogHeader) + index.size();
+  auto placement = placements.begin();
+  for (auto& [table_id, table] : tables_) {
+    table.schema_offset = schemas_start + placement->first;
+    table.schema_size = placement->second;
+    ++placement;
+  }
+  return true;
+}
+
+}  // namespace database
@@ -0,0 +1,115 @@
+#include "database/checkpointer.hpp"
+#include "database/control_file.hpp"
+#include "database/transaction_manager.hpp"
+#include <sstream>
+
+namespace database {
+
+Checkpointer::Checkpointer(WriteAheadLog& wal, BufferPool& buffer_pool, std::string control_path,
+                           CheckpointOptions options, TransactionManager* txn_manager)
+    : wal_(wal),
+      buffer_pool_(buffer_pool),
+      control_path_(std::move(control_path)),
+      options_(options),
+      txn_manager_(txn_manager) {
+  if (options_.interval.count() > 0) {
+    thread_ = std::thread(&Checkpointer::run, this);
+  }
+}
+
+Checkpointer::~Checkpointer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  stop_cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool Checkpointer::checkpoint() {
+  std::lock_guard<std::mutex> checkpoint_lock(checkpoint_mutex_);
+
+  // Changes logged before redo_lsn are in pages that are dirty by now (pages
+  // are marked dirty before their record is appended), or already written.
+  // Commits logged before it are in the commit log by the time it is saved.
+  Lsn redo_lsn = txn_manager_ ? txn_manager_->withCommitsSettled([this] { return wal_.getCurrentLsn(); })
+                              : wal_.getCurrentLsn();
+
+  auto last_progress = std::chrono::steady_clock::now();
+  bool flushed = buffer_pool_.flushDirtyPages(options_.pages_per_round, [this, &last_progress](size_t written) {
+    return throttle(written, last_progress);
+  });
+  if (!flushed) {
+    return false;
+  }
+
+  // Read after redo_lsn, so it exceeds every ID in the log before it. Every
+  // transaction older than oldest_txn_id has finished, so the commit log
+  // saved next holds its outcome.
+  TransactionId next_txn_id = txn_manager_ ? txn_manager_->getNextTransactionId() : 0;
+  TransactionId oldest_txn_id = txn_manager_ ? txn_manager_->getOldestActiveTransactionId() : 1;
+  if (txn_manager_ && !saveCommitLog()) {
+    return false;
+  }
+
+  auto payload = std::as_bytes(std::span(&redo_lsn, 1));
+  Lsn checkpoint_lsn = wal_.append(WalRecordType::CHECKPOINT, 0, 0, std::make_pair(0, 0), payload);
+  if (!wal_.flush(checkpoint_lsn) ||
+      !ControlFile::write(control_path_, ControlData{ checkpoint_lsn, redo_lsn, next_txn_id, oldest_txn_id })) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++checkpoint_count_;
+  redo_lsn_ = redo_lsn;
+  return true;
+}
+
+uint64_t Checkpointer::getCheckpointCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return checkpoint_count_;
+}
+
+Lsn Checkpointer::getRedoLsn() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return redo_lsn_;
+}
+
+bool Checkpointer::saveCommitLog() {
+  std::ostringstream out;
+  if (!txn_manager_->getCommitLog().writeTo(out)) {
+    return false;
+  }
+  std::string image = out.str();
+  return writeFileAtomically(ControlFile::getCommitLogPath(control_path_),
+                             std::as_bytes(std::span(image.data(), image.size())));
+}
+
+void Checkpointer::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_cv_.wait_for(lock, options_.interval, [this] { return stopping_; })) {
+    lock.unlock();
+    checkpoint();  // A failed checkpoint leaves the previous one in force; try again next interval
+    lock.lock();
+  }
+}
+
+bool Checkpointer::throttle(size_t written, std::chrono::steady_clock::time_point& last_progress) {
+  auto now = std::chrono::steady_clock::now();
+  if (written > 0) {
+    last_progress = now;
+  } else if (now - last_progress >= options_.pinned_page_timeout) {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (stopping_ && written > 0) {
+    return true;  // Shutting down: finish at full speed
+  }
+  stop_cv_.wait_for(lock, options_.round_delay, [this, written] { return stopping_ && written > 0; });
+  return true;
+}
+
+}  // namespace database
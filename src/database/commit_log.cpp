@@ -0,0 +1,34 @@
+#include "database/commit_log.hpp"
+
+namespace database {
+
+TransactionStatus CommitLog::getStatus(TransactionId txn_id) const {
+  // Truncated IDs report COMMITTED, unallocated ones IN_PROGRESS (0)
+  return static_cast<TransactionStatus>(statuses_.get(txn_id, static_cast<uint64_t>(TransactionStatus::COMMITTED)));
+}
+
+void CommitLog::setStatus(TransactionId txn_id, TransactionStatus status) {
+  statuses_.set(txn_id, static_cast<uint64_t>(status));
+}
+
+void CommitLog::truncate(TransactionId oldest_txn_id) {
+  statuses_.truncate(oldest_txn_id);
+}
+
+TransactionId CommitLog::getOldestTransactionId() const {
+  return statuses_.getOldestTransactionId();
+}
+
+size_t CommitLog::getPageCount() const {
+  return statuses_.getPageCount();
+}
+
+bool CommitLog::writeTo(std::ostream& out) const {
+  return statuses_.writeTo(out);
+}
+
+bool CommitLog::readFrom(std::istream& in) {
+  return statuses_.readFrom(in);
+}
+
+}  // namespace database
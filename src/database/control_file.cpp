@@ -0,0 +1,91 @@
+#include "database/control_file.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace database {
+
+namespace {
+
+constexpr uint64_t CONTROL_MAGIC = 0x33304C5254434244ULL;  // "DBCTRL03"
+
+struct ControlImage {
+  uint64_t magic;
+  Lsn checkpoint_lsn;
+  Lsn redo_lsn;
+  TransactionId next_txn_id;
+  TransactionId oldest_txn_id;
+};
+
+std::string parentDirectory(const std::string& path) {
+  size_t slash = path.rfind('/');
+  if (slash == std::string::npos) {
+    return ".";
+  }
+  return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+}  // namespace
+
+std::optional<ControlData> ControlFile::read(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+  ControlImage image{};
+  ssize_t n = ::pread(fd, &image, sizeof(image), 0);
+  ::close(fd);
+
+  if (n != static_cast<ssize_t>(sizeof(image)) || image.magic != CONTROL_MAGIC ||
+      image.redo_lsn > image.checkpoint_lsn) {
+    return std::nullopt;
+  }
+  return ControlData{ image.checkpoint_lsn, image.redo_lsn, image.next_txn_id, image.oldest_txn_id };
+}
+
+bool ControlFile::write(const std::string& path, const ControlData& data) {
+  ControlImage image{ CONTROL_MAGIC, data.checkpoint_lsn, data.redo_lsn, data.next_txn_id, data.oldest_txn_id };
+  return writeFileAtomically(path, std::as_bytes(std::span(&image, 1)));
+}
+
+std::string ControlFile::getCommitLogPath(const std::string& control_path) {
+  return control_path + ".clog";
+}
+
+bool writeFileAtomically(const std::string& path, std::span<const std::byte> data) {
+  std::string temp_path = path + ".tmp";
+  int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+
+  size_t done = 0;
+  while (done < data.size()) {
+    ssize_t n = ::pwrite(fd, data.data() + done, data.size() - done, static_cast<off_t>(done));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    done += static_cast<size_t>(n);
+  }
+  bool ok = done == data.size() && ::fdatasync(fd) == 0;
+  ::close(fd);
+  if (!ok || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    return false;
+  }
+
+  // Make the rename itself durable
+  int dir_fd = ::open(parentDirectory(path).c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dir_fd < 0) {
+    return false;
+  }
+  ok = ::fsync(dir_fd) == 0;
+  ::close(dir_fd);
+  return ok;
+}
+
+}  // namespace database
@@ -0,0 +1,21 @@
+#include "database/csn_log.hpp"
+
+namespace database {
+
+CommitSeqNo CsnLog::getCsn(TransactionId txn_id) const {
+  return csns_.get(txn_id, FROZEN_CSN);
+}
+
+void CsnLog::setCsn(TransactionId txn_id, CommitSeqNo csn) {
+  csns_.set(txn_id, csn);
+}
+
+void CsnLog::truncate(TransactionId oldest_txn_id) {
+  csns_.truncate(oldest_txn_id);
+}
+
+size_t CsnLog::getPageCount() const {
+  return csns_.getPageCount();
+}
+
+}  // namespace database
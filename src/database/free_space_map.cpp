@@ -0,0 +1,137 @@
+#include "database/free_space_map.hpp"
+#include <algorithm>
+#include <istream>
+#include <ostream>
+
+namespace database {
+
+namespace {
+
+constexpr size_t INITIAL_CAPACITY = 64;
+
+}  // namespace
+
+FreeSpaceMap::FreeSpaceMap(size_t page_size)
+    : page_size_(page_size),
+      category_step_(std::max<size_t>(1, page_size / CATEGORY_COUNT)),
+      capacity_(INITIAL_CAPACITY),
+      tree_(2 * INITIAL_CAPACITY, 0) {
+}
+
+void FreeSpaceMap::update(PageId page_id, size_t free_bytes) {
+  setCategory(page_id, toCategory(free_bytes));
+}
+
+void FreeSpaceMap::remove(PageId page_id) {
+  if (page_id < capacity_) {
+    setCategory(page_id, 0);
+  }
+}
+
+std::optional<PageId> FreeSpaceMap::findPage(size_t required_size) const {
+  size_t needed = requiredCategory(required_size);
+  if (needed >= CATEGORY_COUNT || tree_[1] < needed) {
+    return std::nullopt;
+  }
+
+  // Descend towards the leftmost leaf whose category is large enough
+  size_t node = 1;
+  while (node < capacity_) {
+    node = tree_[2 * node] >= needed ? 2 * node : 2 * node + 1;
+  }
+
+  return node - capacity_;
+}
+
+size_t FreeSpaceMap::getFreeSpace(PageId page_id) const noexcept {
+  if (page_id >= capacity_) {
+    return 0;
+  }
+  return tree_[capacity_ + page_id] * category_step_;
+}
+
+bool FreeSpaceMap::writeTo(std::ostream& out) const {
+  uint64_t page_size = page_size_;
+  uint64_t page_count = capacity_;
+  out.write(reinterpret_cast<const char*>(&page_size), sizeof(page_size));
+  out.write(reinterpret_cast<const char*>(&page_count), sizeof(page_count));
+  out.write(reinterpret_cast<const char*>(tree_.data() + capacity_), static_cast<std::streamsize>(capacity_));
+  return static_cast<bool>(out);
+}
+
+std::optional<FreeSpaceMap> FreeSpaceMap::readFrom(std::istream& in) {
+  uint64_t page_size = 0;
+  uint64_t page_count = 0;
+  in.read(reinterpret_cast<char*>(&page_size), sizeof(page_size));
+  in.read(reinterpret_cast<char*>(&page_count), sizeof(page_count));
+  if (!in || page_size == 0) {
+    return std::nullopt;
+  }
+
+  // page_count comes from the file and may be garbage, so the leaves are
+  // read in bounded chunks instead of being allocated up front
+  constexpr uint64_t READ_CHUNK = 64 * 1024;
+  std::vector<uint8_t> leaves;
+  while (leaves.size() < page_count) {
+    size_t offset = leaves.size();
+    size_t chunk = static_cast<size_t>(std::min(READ_CHUNK, page_count - offset));
+    leaves.resize(offset + chunk);
+    in.read(reinterpret_cast<char*>(leaves.data() + offset), static_cast<std::streamsize>(chunk));
+    if (!in) {
+      return std::nullopt;
+    }
+  }
+
+  FreeSpaceMap fsm(page_size);
+  for (size_t page_id = 0; page_id < leaves.size(); ++page_id) {
+    if (leaves[page_id] != 0) {
+      fsm.setCategory(page_id, leaves[page_id]);
+    }
+  }
+  return fsm;
+}
+
+uint8_t FreeSpaceMap::toCategory(size_t free_bytes) const noexcept {
+  return static_cast<uint8_t>(std::min(free_bytes / category_step_, CATEGORY_COUNT - 1));
+}
+
+size_t FreeSpaceMap::requiredCategory(size_t required_size) const noexcept {
+  return std::max<size_t>(1, (required_size + category_step_ - 1) / category_step_);
+}
+
+void FreeSpaceMap::setCategory(PageId page_id, uint8_t category) {
+  if (page_id >= capacity_) {
+    grow(page_id + 1);
+  }
+
+  size_t node = capacity_ + page_id;
+  tree_[node] = category;
+
+  // Propagate towards the root, stopping once a parent no longer changes
+  for (node /= 2; node >= 1; node /= 2) {
+    uint8_t max_child = std::max(tree_[2 * node], tree_[2 * node + 1]);
+    if (tree_[node] == max_child) {
+      break;
+    }
+    tree_[node] = max_child;
+  }
+}
+
+void FreeSpaceMap::grow(size_t min_capacity) {
+  size_t new_capacity = capacity_;
+  while (new_capacity < min_capacity) {
+    new_capacity *= 2;
+  }
+
+  std::vector<uint8_t> new_tree(2 * new_capacity, 0);
+  std::copy(tree_.begin() + static_cast<std::ptrdiff_t>(capacity_), tree_.end(),
+            new_tree.begin() + static_cast<std::ptrdiff_t>(new_capacity));
+  for (size_t node = new_capacity - 1; node >= 1; --node) {
+    new_tree[node] = std::max(new_tree[2 * node], new_tree[2 * node + 1]);
+  }
+
+  capacity_ = new_capacity;
+  tree_ = std::move(new_tree);
+}
+
+}  // namespace database
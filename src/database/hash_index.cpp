@@ -0,0 +1,362 @@
+#include "database/hash_index.hpp"
+#include "database/heap_scan.hpp"
+#include "database/visibility_checker.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <string_view>
+
+namespace database {
+
+namespace {
+
+constexpr unsigned SLOT_BITS = 16;
+constexpr uint64_t MAX_PAGE_ID = (uint64_t{1} << (64 - SLOT_BITS)) - 1;
+constexpr unsigned INITIAL_LEVEL = 4;  // 16 buckets
+
+/**
+ * @brief Final mix of MurmurHash3, so nearby integers land in unrelated buckets
+ */
+[[nodiscard]] uint64_t mix(uint64_t value) noexcept {
+  value ^= value >> 33;
+  value *= 0xFF51AFD7ED558CCDULL;
+  value ^= value >> 33;
+  value *= 0xC4CEB9FE1A85EC53ULL;
+  value ^= value >> 33;
+  return value;
+}
+
+[[nodiscard]] uint32_t toHashCode(uint64_t hash) noexcept {
+  return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+[[nodiscard]] uint32_t hashInteger(int64_t value) noexcept {
+  return toHashCode(mix(static_cast<uint64_t>(value)));
+}
+
+[[nodiscard]] uint32_t hashDouble(double value) noexcept {
+  if (value == 0.0) {
+    value = 0.0;  // -0 equals 0
+  }
+  return toHashCode(mix(std::bit_cast<uint64_t>(value)));
+}
+
+[[nodiscard]] uint32_t hashText(std::string_view value) noexcept {
+  return toHashCode(mix(std::hash<std::string_view>{}(value)));
+}
+
+[[nodiscard]] uint32_t hashBoolean(bool value) noexcept {
+  return toHashCode(mix(value ? 1 : 0));
+}
+
+// A TupleId in 8 bytes; 0 marks a free entry, as heap pages start at 1
+[[nodiscard]] uint64_t pack(const TupleId& tuple_id) noexcept {
+  return (tuple_id.first << SLOT_BITS) | tuple_id.second;
+}
+
+[[nodiscard]] TupleId unpack(uint64_t packed) noexcept {
+  return { packed >> SLOT_BITS, static_cast<uint16_t>(packed & 0xFFFF) };
+}
+
+}  // namespace
+
+/**
+ * @brief Bucket - one cache line of entries
+ *
+ * Entries fill the slots from the front; the free slots after them have
+ * packed TupleId 0.
+ */
+struct alignas(64) HashIndex::Bucket {
+  std::array<uint32_t, BUCKET_ENTRIES> hashes{};
+  uint32_t overflow = 0;  // Next bucket of the chain, 0 if none
+  std::array<uint64_t, BUCKET_ENTRIES> tuples{};
+
+  [[nodiscard]] bool isFull() const noexcept { return tuples[BUCKET_ENTRIES - 1] != 0; }
+
+  [[nodiscard]] size_t count() const noexcept {
+    return static_cast<size_t>(std::find(tuples.begin(), tuples.end(), uint64_t{0}) - tuples.begin());
+  }
+};
+
+/**
+ * @brief Segment - SEGMENT_BUCKETS consecutive buckets
+ */
+struct HashIndex::Segment {
+  std::array<Bucket, SEGMENT_BUCKETS> buckets;
+};
+
+HashIndex::HashIndex(ColumnId column_id, DataType data_type)
+    : column_id_(column_id),
+      data_type_(data_type) {
+  static_assert(sizeof(Bucket) == 64, "A bucket is one cache line");
+  bucket_count_ = size_t{1} << INITIAL_LEVEL;
+  level_ = INITIAL_LEVEL;
+  buckets_.push_back(std::make_unique<Segment>());
+}
+
+HashIndex::~HashIndex() = default;
+
+std::unique_ptr<HashIndex> HashIndex::create(const Schema& schema, ColumnId column_id) {
+  const Column* column = schema.getColumn(column_id);
+  if (!column) {
+    return nullptr;
+  }
+  return std::unique_ptr<HashIndex>(new HashIndex(column_id, column->getDataType()));
+}
+
+std::unique_ptr<HashIndex> HashIndex::build(const HeapFile& heap_file, ColumnId column_id) {
+  auto index = create(heap_file.getSchema(), column_id);
+  if (index) {
+    HeapScan scan(heap_file);
+    while (auto scanned = scan.next()) {
+      // A heap-only version is reached from the root of its HOT chain
+      if (!scanned->tuple.getHeader().isHeapOnly()) {
+        index->insert(scanned->tuple, scanned->tuple_id);
+      }
+    }
+  }
+  return index;
+}
+
+std::optional<uint32_t> HashIndex::hashKey(const Value& key) const noexcept {
+  switch (data_type_) {
+    case DataType::INTEGER:
+      if (const auto* value = std::get_if<int64_t>(&key)) {
+        return hashInteger(*value);
+      }
+      break;
+    case DataType::DOUBLE:
+      if (const auto* value = std::get_if<double>(&key)) {
+        return hashDouble(*value);
+      }
+      break;
+    case DataType::TEXT:
+      if (const auto* value = std::get_if<std::string>(&key)) {
+        return hashText(*value);
+      }
+      break;
+    case DataType::BOOLEAN:
+      if (const auto* value = std::get_if<bool>(&key)) {
+        return hashBoolean(*value);
+      }
+      break;
+  }
+  return std::nullopt;
+}
+
+bool HashIndex::insert(const Value& key, const TupleId& tuple_id) {
+  std::optional<uint32_t> hash = hashKey(key);
+  if (!hash || tuple_id.first == 0 || tuple_id.first > MAX_PAGE_ID) {
+    return false;
+  }
+  addEntry(getBucketNumber(*hash), *hash, pack(tuple_id));
+  ++entry_count_;
+  if (static_cast<double>(entry_count_) > MAX_FILL * static_cast<double>(bucket_count_ * BUCKET_ENTRIES)) {
+    splitNext();
+  }
+  return true;
+}
+
+bool HashIndex::insert(const TupleView& tuple, const TupleId& tuple_id) {
+  if (tuple.isNull(column_id_)) {
+    return false;
+  }
+  switch (data_type_) {
+    case DataType::INTEGER:
+      return insert(Value{ tuple.getInteger(column_id_) }, tuple_id);
+    case DataType::DOUBLE:
+      return insert(Value{ tuple.getDouble(column_id_) }, tuple_id);
+    case DataType::TEXT:
+      return insert(Value{ std::string(tuple.getText(column_id_)) }, tuple_id);
+    case DataType::BOOLEAN:
+      return insert(Value{ tuple.getBoolean(column_id_) }, tuple_id);
+  }
+  return false;
+}
+
+bool HashIndex::remove(const Value& key, const TupleId& tuple_id) {
+  std::optional<uint32_t> hash = hashKey(key);
+  if (!hash || tuple_id.first == 0 || tuple_id.first > MAX_PAGE_ID) {
+    return false;
+  }
+  uint64_t packed = pack(tuple_id);
+  Bucket* found = nullptr;
+  size_t found_index = 0;
+  Bucket* primary = &getBucket(getBucketNumber(*hash));
+  Bucket* last = primary;
+  for (Bucket* bucket = primary; bucket; bucket = bucket->overflow ? &getOverflow(bucket->overflow) : nullptr) {
+    for (size_t i = 0; i < BUCKET_ENTRIES && bucket->tuples[i] != 0; ++i) {
+      if (bucket->tuples[i] == packed && bucket->hashes[i] == *hash) {
+        found = bucket;
+        found_index = i;
+      }
+    }
+    last = bucket;
+  }
+  if (!found) {
+    return false;
+  }
+
+  // Fill the hole with the chain's last entry, so entries stay at the front
+  size_t last_index = last->count() - 1;
+  found->hashes[found_index] = last->hashes[last_index];
+  found->tuples[found_index] = last->tuples[last_index];
+  last->tuples[last_index] = 0;
+  if (last_index == 0 && last != primary) {
+    // The emptied overflow bucket goes back on the free list
+    Bucket* previous = primary;
+    while (&getOverflow(previous->overflow) != last) {
+      previous = &getOverflow(previous->overflow);
+    }
+    free_overflow_.push_back(previous->overflow);
+    previous->overflow = 0;
+    --overflow_count_;
+  }
+  --entry_count_;
+  return true;
+}
+
+size_t HashIndex::findCandidates(const Value& key, std::vector<TupleId>& tuple_ids) const {
+  std::optional<uint32_t> hash = hashKey(key);
+  if (!hash) {
+    return 0;
+  }
+  size_t found = 0;
+  const Bucket* bucket = &getBucket(getBucketNumber(*hash));
+  while (true) {
+    for (size_t i = 0; i < BUCKET_ENTRIES && bucket->tuples[i] != 0; ++i) {
+      if (bucket->hashes[i] == *hash) {
+        tuple_ids.push_back(unpack(bucket->tuples[i]));
+        ++found;
+      }
+    }
+    if (bucket->overflow == 0) {
+      return found;
+    }
+    bucket = &getOverflow(bucket->overflow);
+  }
+}
+
+std::vector<TupleId> HashIndex::find(const HeapFile& heap_file, const Value& key) const {
+  std::vector<TupleId> tuple_ids;
+  findCandidates(key, tuple_ids);
+  std::erase_if(tuple_ids, [&](const TupleId& tuple_id) {
+    auto tuple = heap_file.getTuple(tuple_id);
+    return !tuple || !matches(*tuple, key);
+  });
+  return tuple_ids;
+}
+
+std::vector<PinnedTupleView> HashIndex::findVisible(const HeapFile& heap_file, const Value& key,
+                                                    const VisibilityChecker& checker, const Snapshot& snapshot) const {
+  std::vector<TupleId> candidates;
+  findCandidates(key, candidates);
+  std::vector<PinnedTupleView> tuples;
+  for (const TupleId& tuple_id : candidates) {
+    auto tuple = heap_file.getVisibleTuple(tuple_id, checker, snapshot);
+    if (!tuple || !matches(*tuple, key)) {
+      continue;
+    }
+    bool seen = std::any_of(tuples.begin(), tuples.end(), [&tuple](const PinnedTupleView& other) {
+      return other.getData() == tuple->getData();
+    });
+    if (!seen) {
+      tuples.push_back(std::move(*tuple));
+    }
+  }
+  return tuples;
+}
+
+HashIndex::Bucket& HashIndex::getBucket(size_t bucket) const noexcept {
+  return buckets_[bucket / SEGMENT_BUCKETS]->buckets[bucket % SEGMENT_BUCKETS];
+}
+
+HashIndex::Bucket& HashIndex::getOverflow(uint32_t overflow) const noexcept {
+  return overflow_[overflow / SEGMENT_BUCKETS]->buckets[overflow % SEGMENT_BUCKETS];
+}
+
+size_t HashIndex::getBucketNumber(uint32_t hash) const noexcept {
+  // Buckets below the split point have been split already and use one more bit
+  size_t bucket = hash & ((size_t{1} << (level_ + 1)) - 1);
+  return bucket < bucket_count_ ? bucket : hash & ((size_t{1} << level_) - 1);
+}
+
+void HashIndex::addEntry(size_t bucket_number, uint32_t hash, uint64_t packed) {
+  Bucket* bucket = &getBucket(bucket_number);
+  while (bucket->isFull() && bucket->overflow != 0) {
+    bucket = &getOverflow(bucket->overflow);
+  }
+  if (bucket->isFull()) {
+    uint32_t overflow;
+    if (!free_overflow_.empty()) {
+      overflow = free_overflow_.back();
+      free_overflow_.pop_back();
+    } else {
+      overflow = static_cast<uint32_t>(overflow_limit_++);
+      if (overflow / SEGMENT_BUCKETS >= overflow_.size()) {
+        overflow_.push_back(std::make_unique<Segment>());
+      }
+    }
+    getOverflow(overflow) = Bucket{};
+    bucket->overflow = overflow;
+    bucket = &getOverflow(overflow);
+    ++overflow_count_;
+  }
+  size_t index = bucket->count();
+  bucket->hashes[index] = hash;
+  bucket->tuples[index] = packed;
+}
+
+void HashIndex::splitNext() {
+  size_t old_number = bucket_count_ - (size_t{1} << level_);
+  size_t new_number = bucket_count_;
+  if (new_number / SEGMENT_BUCKETS >= buckets_.size()) {
+    buckets_.push_back(std::make_unique<Segment>());
+  }
+
+  // Take the old bucket's chain apart, then deal its entries out by the next hash bit
+  std::vector<std::pair<uint32_t, uint64_t>> entries;
+  Bucket& old_bucket = getBucket(old_number);
+  for (Bucket* bucket = &old_bucket; bucket; bucket = bucket->overflow ? &getOverflow(bucket->overflow) : nullptr) {
+    for (size_t i = 0; i < BUCKET_ENTRIES && bucket->tuples[i] != 0; ++i) {
+      entries.emplace_back(bucket->hashes[i], bucket->tuples[i]);
+    }
+    if (bucket != &old_bucket) {
+      --overflow_count_;
+    }
+  }
+  for (uint32_t overflow = old_bucket.overflow; overflow != 0; overflow = getOverflow(overflow).overflow) {
+    free_overflow_.push_back(overflow);
+  }
+  old_bucket = Bucket{};
+  getBucket(new_number) = Bucket{};
+
+  ++bucket_count_;
+  if (bucket_count_ == size_t{1} << (level_ + 1)) {
+    ++level_;
+  }
+  for (const auto& [hash, packed] : entries) {
+    addEntry(getBucketNumber(hash), hash, packed);
+  }
+}
+
+bool HashIndex::matches(const TupleView& tuple, const Value& key) const noexcept {
+  if (tuple.isNull(column_id_)) {
+    return false;
+  }
+  switch (data_type_) {
+    case DataType::INTEGER:
+      return std::get<int64_t>(key) == tuple.getInteger(column_id_);
+    case DataType::DOUBLE:
+      return std::get<double>(key) == tuple.getDouble(column_id_);
+    case DataType::TEXT:
+      return std::get<std::string>(key) == tuple.getText(column_id_);
+    case DataType::BOOLEAN:
+      return std::get<bool>(key) == tuple.getBoolean(column_id_);
+  }
+  return false;
+}
+
+}  // namespace database
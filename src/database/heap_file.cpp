@@ -1,105 +1,623 @@
 #include "database/heap_file.hpp"
+#include "database/visibility_checker.hpp"
 #include <algorithm>
+#include <cstring>
+#include <fstream>
 
 namespace database {
 
-constexpr size_t DEFAULT_PAGE_SIZE = 8192;  // 8KB
+namespace {
+
+constexpr size_t MAX_TUPLE_SPACE = HeapFile::DEFAULT_PAGE_SIZE - sizeof(PageHeader);
+constexpr size_t PRUNE_HEADROOM = HeapFile::DEFAULT_PAGE_SIZE / 10;
+
+}  // namespace
 
 HeapFile::HeapFile(TableId table_id, const Schema& schema)
     : table_id_(table_id),
       schema_(schema),
-      next_page_id_(1) {
+      next_page_id_(1),
+      free_space_map_(DEFAULT_PAGE_SIZE),
+      target_page_id_(0),
+      buffer_pool_(nullptr),
+      wal_(nullptr),
+      txn_manager_(nullptr),
+      stats_(std::make_unique<TableStats>()) {
+}
+
+HeapFile::HeapFile(TableId table_id, const Schema& schema, BufferPool& buffer_pool, std::unique_ptr<SegmentFile> segment)
+    : table_id_(table_id),
+      schema_(schema),
+      next_page_id_(segment->getPageCount() + 1),
+      free_space_map_(DEFAULT_PAGE_SIZE),
+      target_page_id_(0),
+      buffer_pool_(&buffer_pool),
+      segment_(std::move(segment)),
+      wal_(nullptr),
+      txn_manager_(nullptr),
+      stats_(std::make_unique<TableStats>()) {
+}
+
+HeapFile::HeapFile(TableId table_id, const Schema& schema, MappedFile mapped)
+    : table_id_(table_id),
+      schema_(schema),
+      next_page_id_(mapped.size() / DEFAULT_PAGE_SIZE + 1),
+      free_space_map_(DEFAULT_PAGE_SIZE),
+      target_page_id_(0),
+      buffer_pool_(nullptr),
+      mapped_(std::move(mapped)),
+      wal_(nullptr),
+      txn_manager_(nullptr),
+      stats_(std::make_unique<TableStats>()) {
+}
+
+std::unique_ptr<HeapFile> HeapFile::open(TableId table_id, const Schema& schema,
+                                         BufferPool& buffer_pool, const std::string& path) {
+  if (buffer_pool.getPageSize() != DEFAULT_PAGE_SIZE) {
+    return nullptr;
+  }
+  auto segment = SegmentFile::open(path, DEFAULT_PAGE_SIZE);
+  if (!segment) {
+    return nullptr;
+  }
+
+  std::unique_ptr<HeapFile> heap_file(new HeapFile(table_id, schema, buffer_pool, std::move(segment)));
+
+  // The persisted map is only a hint, so an unreadable one is rebuilt
+  std::ifstream in(getFreeSpaceMapPath(heap_file->segment_->getPath()), std::ios::binary);
+  std::optional<FreeSpaceMap> free_space_map = in ? FreeSpaceMap::readFrom(in) : std::nullopt;
+  if (free_space_map && free_space_map->getPageSize() == DEFAULT_PAGE_SIZE) {
+    heap_file->free_space_map_ = std::move(*free_space_map);
+  } else {
+    for (PageId page_id = 1; page_id < heap_file->next_page_id_; ++page_id) {
+      PageGuard page = heap_file->getPage(page_id);
+      if (!page) {
+        return nullptr;  // Corrupt or unreadable page
+      }
+      heap_file->recordFreeSpace(*page);
+    }
+  }
+
+  return heap_file;
+}
+
+std::unique_ptr<HeapFile> HeapFile::openMapped(TableId table_id, const Schema& schema, const std::string& path) {
+  auto mapped = MappedFile::open(path);
+  if (!mapped) {
+    return nullptr;
+  }
+  return std::unique_ptr<HeapFile>(new HeapFile(table_id, schema, std::move(*mapped)));
+}
+
+std::string HeapFile::getFreeSpaceMapPath(const std::string& segment_path) {
+  return segment_path + ".fsm";
+}
+
+HeapFile::~HeapFile() {
+  if (segment_) {
+    flush();
+    buffer_pool_->discardFile(*segment_);
+  }
+}
+
+bool HeapFile::flush() {
+  if (!segment_) {
+    return true;
+  }
+
+  bool ok = buffer_pool_->flushFile(*segment_);
+  std::ofstream out(getFreeSpaceMapPath(segment_->getPath()), std::ios::binary | std::ios::trunc);
+  return free_space_map_.writeTo(out) && ok;
+}
+
+void HeapFile::adviseSequential(PageId first_page_id, PageId end_page_id) const noexcept {
+  if (mapped_ && first_page_id < end_page_id) {
+    mapped_->adviseSequential((first_page_id - 1) * DEFAULT_PAGE_SIZE, (end_page_id - first_page_id) * DEFAULT_PAGE_SIZE);
+  }
+}
+
+void HeapFile::adviseWillNeed(PageId first_page_id, PageId end_page_id) const noexcept {
+  if (mapped_ && first_page_id < end_page_id) {
+    mapped_->adviseWillNeed((first_page_id - 1) * DEFAULT_PAGE_SIZE, (end_page_id - first_page_id) * DEFAULT_PAGE_SIZE);
+  }
 }
 
 std::unique_ptr<TupleId> HeapFile::insertTuple(const Tuple& tuple, TransactionId txn_id) {
-  size_t required_size = tuple.getSize();
+  if (mapped_ || !tuple.matchesSchema()) {
+    return nullptr;
+  }
+  
+  size_t tuple_size = tuple.getSize();
+  size_t required_size = Page::getRequiredSpace(tuple_size);
+  if (required_size > MAX_TUPLE_SPACE) {
+    return nullptr;  // Tuple can never fit on a page
+  }
   
   // Find or create a page with enough space
-  Page* page = findOrCreatePage(required_size);
+  PageGuard page = findOrCreatePage(required_size);
   if (!page) {
     return nullptr;
   }
   
   // Insert tuple into page
-  return page->insertTuple(tuple);
+  auto slot = page->addTuple(tuple, tuple_size);
+  page.markDirty();
+  recordFreeSpace(*page);
+  if (!slot) {
+    return nullptr;
+  }
+  visibility_map_.clear(page->getPageId());
+  stats_->countInserts(1);
+  
+  // The row belongs to the inserting transaction, whatever header the caller's tuple carried
+  TupleId tuple_id = std::make_pair(page->getPageId(), *slot);
+  *page->getTupleHeader(tuple_id) = TupleHeader(txn_id);
+  logTuple(page, WalRecordType::INSERT, txn_id, tuple_id);
+  return std::make_unique<TupleId>(tuple_id);
 }
 
-std::unique_ptr<TupleId> HeapFile::updateTuple(const TupleId& tuple_id, const Tuple& new_tuple, TransactionId txn_id) {
-  // Get the page containing the tuple
-  Page* page = getPage(tuple_id.first);
-  if (!page) {
+size_t HeapFile::insertBatch(std::span<const Tuple> tuples, std::span<TupleId> tuple_ids, TransactionId txn_id) {
+  size_t count = mapped_ ? 0 : std::min(tuples.size(), tuple_ids.size());
+  
+  // Validate and size the batch up front so the page vector grows once
+  size_t valid = 0;
+  size_t total_space = 0;
+  for (; valid < count; ++valid) {
+    if (!tuples[valid].matchesSchema()) {
+      break;
+    }
+    size_t required_size = Page::getRequiredSpace(tuples[valid].getSize());
+    if (required_size > MAX_TUPLE_SPACE) {
+      break;
+    }
+    total_space += required_size;
+  }
+  if (!segment_) {
+    pages_.reserve(pages_.size() + total_space / MAX_TUPLE_SPACE + 1);
+  }
+  
+  // Fill one fresh page at a time; the free space map is updated once per page
+  PageGuard page;
+  size_t inserted = 0;
+  for (; inserted < valid; ++inserted) {
+    size_t tuple_size = tuples[inserted].getSize();
+    std::optional<uint16_t> slot = page ? page->addTuple(tuples[inserted], tuple_size) : std::nullopt;
+    if (!slot) {
+      if (page) {
+        page.markDirty();
+        recordFreeSpace(*page);
+      }
+      page = createPage();
+      if (!page) {
+        break;  // No buffer frame for a new page
+      }
+      slot = page->addTuple(tuples[inserted], tuple_size);
+    }
+    tuple_ids[inserted] = std::make_pair(page->getPageId(), *slot);
+    *page->getTupleHeader(tuple_ids[inserted]) = TupleHeader(txn_id);
+    logTuple(page, WalRecordType::INSERT, txn_id, tuple_ids[inserted]);
+  }
+  if (page) {
+    page.markDirty();
+    recordFreeSpace(*page);
+  }
+  stats_->countInserts(inserted);
+  
+  return inserted;
+}
+
+bool HeapFile::appendPages(std::vector<std::unique_ptr<Page>> pages) {
+  if (mapped_) {
+    return false;
+  }
+  if (segment_) {
+    // Copy into buffer frames; the pages are written out on eviction or flush
+    PageId first_page_id = next_page_id_;
+    for (const auto& page : pages) {
+      PageGuard frame = createPage();
+      if (!frame) {
+        truncatePages(first_page_id);  // Cut off the pages appended so far
+        return false;
+      }
+      PageId page_id = frame->getPageId();
+      std::memcpy(frame->getData(), page->getData(), DEFAULT_PAGE_SIZE);
+      frame->setPageId(page_id);
+      frame.markDirty();
+      recordFreeSpace(*frame);
+      logPageImage(frame);
+    }
+    return true;
+  }
+
+  pages_.reserve(pages_.size() + pages.size());
+  for (auto& page : pages) {
+    PageId page_id = next_page_id_++;
+    page->setPageId(page_id);
+    page_directory_.set(page_id, page.get());
+    recordFreeSpace(*page);
+    PageGuard guard(page.get());
+    logPageImage(guard);
+    pages_.push_back(std::move(page));
+  }
+  return true;
+}
+
+void HeapFile::truncatePages(PageId first_page_id) {
+  if (mapped_ || first_page_id == 0 || first_page_id >= next_page_id_) {
+    return;
+  }
+  // The images stay in the log, but the rows on them belong to a transaction that never commits
+  for (PageId page_id = first_page_id; page_id < next_page_id_; ++page_id) {
+    free_space_map_.remove(page_id);
+    visibility_map_.clear(page_id);
+    page_directory_.erase(page_id);
+  }
+  if (segment_) {
+    buffer_pool_->discardPages(*segment_, first_page_id);
+    segment_->truncate(first_page_id - 1);
+  } else {
+    pages_.resize(first_page_id - 1);
+  }
+  next_page_id_ = first_page_id;
+  if (target_page_id_ >= first_page_id) {
+    target_page_id_ = 0;
+  }
+}
+
+std::unique_ptr<TupleId> HeapFile::updateTuple(const TupleId& tuple_id, const Tuple& new_tuple, TransactionId txn_id,
+                                               bool indexed_columns_changed) {
+  if (mapped_ || !new_tuple.matchesSchema()) {
     return nullptr;
   }
   
-  // Try to update in place first
-  if (page->updateTuple(tuple_id, new_tuple)) {
-    // Update successful, return same tuple_id
-    return std::make_unique<TupleId>(tuple_id);
+  size_t tuple_size = new_tuple.getSize();
+  size_t required_size = Page::getRequiredSpace(tuple_size);
+  PageGuard old_page = getPage(tuple_id.first);
+  if (required_size > MAX_TUPLE_SPACE || !old_page || !old_page->getTupleHeader(tuple_id)) {
+    return nullptr;
   }
   
-  // Update failed (not enough space), create new version
-  // For now, just insert as new tuple (proper version chaining will come later)
-  return insertTuple(new_tuple, txn_id);
+  // Keep the new version next to the old one if it fits, so the chain stays on one page
+  bool same_page = makeRoom(old_page, required_size);
+  if (!old_page->getTupleHeader(tuple_id)) {
+    return nullptr;  // Pruned: it was already dead
+  }
+  // A page taking moved versions keeps PRUNE_HEADROOM for updates of its own rows
+  PageGuard new_page = same_page ? PageGuard() : findOrCreatePage(required_size + PRUNE_HEADROOM);
+  PageGuard& page = same_page ? old_page : new_page;
+  if (!page) {
+    return nullptr;
+  }
+  auto slot = page->addTuple(new_tuple, tuple_size);
+  page.markDirty();
+  recordFreeSpace(*page);
+  if (!slot) {
+    return nullptr;
+  }
+  visibility_map_.clear(page->getPageId());
+  visibility_map_.clear(tuple_id.first);
+  
+  bool hot = same_page && !indexed_columns_changed;
+  TupleId new_tuple_id = std::make_pair(page->getPageId(), *slot);
+  TupleHeader* new_header = page->getTupleHeader(new_tuple_id);
+  *new_header = TupleHeader(txn_id);
+  new_header->setHeapOnly(hot);
+  logTuple(page, WalRecordType::INSERT, txn_id, new_tuple_id);
+  
+  // Link the old version; the stamped header is logged as an UPDATE of the same size
+  TupleHeader* old_header = old_page->getTupleHeader(tuple_id);
+  old_header->setXmax(txn_id);
+  old_header->setCtid(new_tuple_id);
+  old_header->setHotUpdated(hot);
+  old_page->setPrunable();
+  old_page.markDirty();
+  logTuple(old_page, WalRecordType::UPDATE, txn_id, tuple_id);
+  stats_->countUpdate();
+  return std::make_unique<TupleId>(new_tuple_id);
 }
 
 void HeapFile::deleteTuple(const TupleId& tuple_id, TransactionId txn_id) {
-  // Get the page containing the tuple
-  Page* page = getPage(tuple_id.first);
-  if (!page) {
-    return;
+  PageGuard page = mapped_ ? PageGuard() : getPage(tuple_id.first);
+  TupleHeader* header = page ? page->getTupleHeader(tuple_id) : nullptr;
+  if (!header) {
+    return;  // No live version in that slot
   }
   
-  // Delete tuple from page
-  page->deleteTuple(tuple_id);
+  // Stamp the version like an update does; snapshots and pruning decide from xmax and the commit log
+  header->setXmax(txn_id);
+  page->setPrunable();
+  page.markDirty();
+  visibility_map_.clear(tuple_id.first);
+  stats_->countDelete();
+  logTuple(page, WalRecordType::UPDATE, txn_id, tuple_id);
 }
 
-const Tuple* HeapFile::getTuple(const TupleId& tuple_id) const {
+std::optional<PinnedTupleView> HeapFile::getTuple(const TupleId& tuple_id) const {
   // Get the page containing the tuple
-  const Page* page = getPage(tuple_id.first);
+  PageGuard page = getPage(tuple_id.first);
   if (!page) {
-    return nullptr;
+    return std::nullopt;
   }
   
   // Get tuple from page
-  return page->getTuple(tuple_id);
+  auto tuple = page->getTuple(tuple_id, schema_);
+  if (!tuple) {
+    return std::nullopt;
+  }
+  return PinnedTupleView(*tuple, std::move(page));
+}
+
+size_t HeapFile::prunePage(PageId page_id) {
+  PageGuard page = mapped_ ? PageGuard() : getPage(page_id);
+  if (!page) {
+    return 0;
+  }
+  page->setPrunable();
+  return prune(page);
 }
 
-std::vector<Tuple> HeapFile::getAllTuples() const {
-  std::vector<Tuple> all_tuples;
+std::optional<PageVacuumResult> HeapFile::vacuumPage(PageId page_id, TransactionId freeze_limit,
+                                                     bool free_dead_lines) {
+  PageGuard page = mapped_ || !txn_manager_ ? PageGuard() : getPage(page_id);
+  if (!page) {
+    return std::nullopt;
+  }
+  
+  PageVacuumResult result;
+  page->setPrunable();
+  result.bytes_reclaimed = prune(page);
+  result.dirtied = result.bytes_reclaimed > 0;
+  result.frozen_xid = freeze_limit;
   
-  for (const auto& page : pages_) {
-    // This is a simplified version - in a real implementation,
-    // we'd need to iterate through all slots in each page
-    // For now, this is just a placeholder
+  std::vector<uint16_t> dead_slots;
+  page->collectDeadLines(dead_slots);
+  if (free_dead_lines) {
+    result.dead_lines_freed = page->freeDeadLines(dead_slots);
+  } else {
+    for (uint16_t slot : dead_slots) {
+      result.dead_tuple_ids.emplace_back(page_id, slot);
+    }
   }
   
-  return all_tuples;
+  // Checking each version against the oldest snapshot also sets all its hint bits
+  VisibilityChecker checker(*txn_manager_);
+  Snapshot oldest_snapshot = txn_manager_->getOldestSnapshot();
+  bool all_visible = result.dead_tuple_ids.empty();
+  bool all_frozen = true;
+  bool any_frozen = false;
+  for (uint16_t slot = 0; slot < page->getSlotCount(); ++slot) {
+    const TupleHeader* header = page->getTupleHeader(std::make_pair(page_id, slot));
+    if (!header) {
+      continue;  // Unused, dead or a redirect
+    }
+    TransactionId xmax = header->getXmax();
+    bool visible_to_all = checker.isVisible(*header, oldest_snapshot) &&
+                          (xmax == 0 || header->hasHintBits(TupleHeader::XMAX_INVALID));
+    if (visible_to_all && header->getXmin() < freeze_limit) {
+      any_frozen = true;
+      continue;
+    }
+    all_visible = all_visible && visible_to_all;
+    all_frozen = false;
+    for (TransactionId txn_id : { header->getXmin(), xmax }) {
+      if (txn_id != 0 && txn_id < result.frozen_xid) {
+        result.frozen_xid = txn_id;
+      }
+    }
+  }
+  
+  // Hint bits alone never dirty a page, so a frozen version's are logged
+  // here; once the page is all-frozen that has been done for good
+  if (result.dead_lines_freed > 0 || (any_frozen && !visibility_map_.isAllFrozen(page_id))) {
+    page.markDirty();
+    recordFreeSpace(*page);
+    logPageImage(page);
+    result.dirtied = true;
+  }
+  visibility_map_.setBits(page_id, all_visible ? (all_frozen ? VisibilityMap::ALL_VISIBLE | VisibilityMap::ALL_FROZEN
+                                                             : VisibilityMap::ALL_VISIBLE)
+                                               : 0);
+  return result;
 }
 
-Page* HeapFile::findOrCreatePage(size_t required_size) {
-  // Try to find an existing page with enough space
-  for (auto& page : pages_) {
-    if (page->hasFreeSpace(required_size)) {
-      return page.get();
+size_t HeapFile::freeDeadTuples(std::span<const TupleId> tuple_ids) {
+  size_t freed = 0;
+  std::vector<uint16_t> slots;
+  for (size_t i = 0; i < tuple_ids.size();) {
+    // Free each run of TupleIds on the same page with one page image
+    PageId page_id = tuple_ids[i].first;
+    slots.clear();
+    for (; i < tuple_ids.size() && tuple_ids[i].first == page_id; ++i) {
+      slots.push_back(tuple_ids[i].second);
+    }
+    PageGuard page = mapped_ ? PageGuard() : getPage(page_id);
+    size_t page_freed = page ? page->freeDeadLines(slots) : 0;
+    if (page_freed > 0) {
+      page.markDirty();
+      recordFreeSpace(*page);
+      logPageImage(page);
+      freed += page_freed;
+    }
+  }
+  return freed;
+}
+
+std::optional<PinnedTupleView> HeapFile::getVisibleTuple(const TupleId& tuple_id, const VisibilityChecker& checker,
+                                                         const Snapshot& snapshot) const {
+  TupleId current = tuple_id;
+  TransactionId expected_xmin = 0;  // xmax of the previous version, 0 if unknown
+  while (PageGuard page = getPage(current.first)) {
+    TupleId resolved = page->resolveRedirect(current);
+    if (resolved != current) {
+      expected_xmin = 0;  // The versions before the redirect target were pruned
+      current = resolved;
+    }
+    auto tuple = page->getTuple(current, schema_);
+    if (!tuple) {
+      return std::nullopt;
+    }
+    const TupleHeader& header = tuple->getHeader();
+    if (expected_xmin != 0 && header.getXmin() != expected_xmin) {
+      return std::nullopt;
+    }
+    if (checker.isVisible(header, snapshot, !mapped_)) {
+      return PinnedTupleView(*tuple, std::move(page));
+    }
+    if (!header.hasSuccessor()) {
+      return std::nullopt;
+    }
+    expected_xmin = header.getXmax();
+    current = header.getCtid();
+  }
+  return std::nullopt;
+}
+
+PageGuard HeapFile::findOrCreatePage(size_t required_size) {
+  // The free space map rounds free space down to its categories, so first
+  // try the page the last insert used with its exact free space
+  if (target_page_id_ != 0) {
+    PageGuard page = getPage(target_page_id_);
+    if (page && makeRoom(page, required_size)) {
+      return page;
     }
   }
   
+  // Ask the free space map for a page with enough space. Its entries may be
+  // stale, so confirm against the page and correct the map if needed.
+  while (auto page_id = free_space_map_.findPage(required_size)) {
+    PageGuard page = getPage(*page_id);
+    if (!page) {
+      if (*page_id < next_page_id_) {
+        break;  // The page exists but no frame is free right now; keep its entry
+      }
+      free_space_map_.remove(*page_id);
+      continue;
+    }
+    if (makeRoom(page, required_size)) {
+      target_page_id_ = *page_id;
+      return page;
+    }
+    recordFreeSpace(*page);
+  }
+  
   // No page with enough space, create a new one
-  PageId new_page_id = next_page_id_++;
+  PageGuard page = createPage();
+  if (page) {
+    target_page_id_ = page->getPageId();
+  }
+  return page;
+}
+
+size_t HeapFile::prune(PageGuard& page) {
+  if (!txn_manager_ || !page->isPrunable()) {
+    return 0;
+  }
+  VisibilityChecker checker(*txn_manager_);
+  Snapshot oldest_snapshot = txn_manager_->getOldestSnapshot();
+  size_t reclaimed = page->prune([&](const TupleHeader& header) { return checker.isDead(header, oldest_snapshot); });
+  if (reclaimed == 0) {
+    return 0;  // Nothing changed but the PRUNABLE flag, which need not reach disk
+  }
+  
+  page.markDirty();
+  recordFreeSpace(*page);
+  logPageImage(page);
+  return reclaimed;
+}
+
+bool HeapFile::makeRoom(PageGuard& page, size_t required_size) {
+  if (page->hasFreeSpace(required_size)) {
+    return true;
+  }
+  // A page that pruning leaves nearly full of live rows would need pruning
+  // again on the next change, so the row goes elsewhere until it has
+  // PRUNE_HEADROOM free and each prune frees a batch of versions
+  return prune(page) > 0 && page->hasFreeSpace(required_size + PRUNE_HEADROOM);
+}
+
+PageGuard HeapFile::createPage() {
+  PageId new_page_id = next_page_id_;
+  if (segment_) {
+    PageGuard page = buffer_pool_->newPage(*segment_, new_page_id);
+    if (!page) {
+      return page;
+    }
+    ++next_page_id_;
+    recordFreeSpace(*page);
+    return page;
+  }
+  
+  ++next_page_id_;
   auto new_page = std::make_unique<Page>(new_page_id, DEFAULT_PAGE_SIZE);
   Page* page_ptr = new_page.get();
   pages_.push_back(std::move(new_page));
+  page_directory_.set(new_page_id, page_ptr);
+  recordFreeSpace(*page_ptr);
   
-  return page_ptr;
+  return PageGuard(page_ptr);
 }
 
-Page* HeapFile::getPage(PageId page_id) const {
-  for (const auto& page : pages_) {
-    if (page->getPageId() == page_id) {
-      return page.get();
+PageGuard HeapFile::getPage(PageId page_id) const {
+  if (segment_) {
+    if (page_id == 0 || page_id >= next_page_id_) {
+      return PageGuard();
+    }
+    return buffer_pool_->fetchPage(*segment_, page_id);
+  }
+  if (mapped_) {
+    if (page_id == 0 || page_id >= next_page_id_) {
+      return PageGuard();
     }
+    auto view = Page::view(page_id, mapped_->data() + (page_id - 1) * DEFAULT_PAGE_SIZE, DEFAULT_PAGE_SIZE);
+    return view ? PageGuard(std::move(*view)) : PageGuard();
   }
-  return nullptr;
+  return PageGuard(page_directory_.get(page_id));
+}
+
+size_t HeapFile::prefetchPages(PageId first_page_id, size_t count) const {
+  if (!segment_ && !mapped_) {
+    return count;  // Every page is in memory
+  }
+  if (first_page_id >= next_page_id_) {
+    return 0;
+  }
+  count = std::min<size_t>(count, next_page_id_ - first_page_id);
+  if (mapped_) {
+    adviseWillNeed(first_page_id, first_page_id + count);
+    return count;
+  }
+  return buffer_pool_->prefetchPages(*segment_, first_page_id, count);
+}
+
+void HeapFile::logChange(PageGuard& page, WalRecordType type, TransactionId txn_id, const TupleId& tuple_id,
+                         std::span<const std::byte> payload) {
+  if (wal_) {
+    page->setLsn(wal_->append(type, txn_id, table_id_, tuple_id, payload));
+  }
+}
+
+void HeapFile::logTuple(PageGuard& page, WalRecordType type, TransactionId txn_id, const TupleId& tuple_id) {
+  if (!wal_) {
+    return;
+  }
+  // Log the bytes as they sit on the page, so redo needs no re-serialization
+  if (auto tuple = page->getTuple(tuple_id, schema_)) {
+    logChange(page, type, txn_id, tuple_id, std::span(tuple->getData(), tuple->getSize()));
+  }
+}
+
+void HeapFile::logPageImage(PageGuard& page) {
+  if (!wal_) {
+    return;
+  }
+  // The image is logged with its LSN field still at the previous value;
+  // redo stamps it with the record's LSN
+  std::span<const std::byte> image(page->getData(), page->getPageSize());
+  logChange(page, WalRecordType::PAGE_IMAGE, 0, std::make_pair(page->getPageId(), 0), image);
+}
+
+void HeapFile::recordFreeSpace(const Page& page) {
+  free_space_map_.update(page.getPageId(), page.getFreeSpace());
 }
 
 }  // namespace database
@@ -0,0 +1,98 @@
+#include "database/heap_scan.hpp"
+#include "database/visibility_checker.hpp"
+#include <algorithm>
+
+namespace database {
+
+HeapScan::HeapScan(const HeapFile& heap_file)
+    : HeapScan(heap_file, 1, heap_file.getPageIdLimit()) {
+}
+
+HeapScan::HeapScan(const HeapFile& heap_file, PageId first_page_id, PageId end_page_id)
+    : heap_file_(heap_file),
+      end_page_id_(end_page_id),
+      current_page_id_(first_page_id),
+      readahead_page_id_(first_page_id),
+      next_slot_(0),
+      in_batch_(false),
+      checker_(nullptr) {
+  if (current_page_id_ < end_page_id_) {
+    heap_file_.adviseSequential(current_page_id_, end_page_id_);
+    readAhead();
+    current_page_ = heap_file_.getPage(current_page_id_);
+  }
+}
+
+void HeapScan::setSnapshot(const VisibilityChecker& checker, const Snapshot& snapshot) {
+  checker_ = &checker;
+  snapshot_ = snapshot;
+}
+
+std::optional<ScannedTuple> HeapScan::next() {
+  const Schema& schema = heap_file_.getSchema();
+  bool set_hints = !heap_file_.isReadOnly();
+
+  while (current_page_ || advancePage()) {
+    uint16_t slot_count = current_page_->getSlotCount();
+    while (next_slot_ < slot_count) {
+      TupleId tuple_id = std::make_pair(current_page_id_, next_slot_++);
+      auto tuple = current_page_->getTuple(tuple_id, schema);
+      if (tuple && (!checker_ || checker_->isVisible(tuple->getHeader(), snapshot_, set_hints))) {
+        return ScannedTuple{ tuple_id, *tuple };
+      }
+    }
+    releasePage();
+  }
+
+  return std::nullopt;
+}
+
+size_t HeapScan::nextBatch(std::vector<ScannedTuple>& batch, size_t max_tuples) {
+  batch.clear();
+  batch_pages_.clear();  // Views from the previous batch are released
+  in_batch_ = true;
+  while (batch.size() < max_tuples) {
+    auto scanned = next();
+    if (!scanned) {
+      break;
+    }
+    batch.push_back(*scanned);
+  }
+  in_batch_ = false;
+  return batch.size();
+}
+
+void HeapScan::releasePage() {
+  if (in_batch_) {
+    batch_pages_.push_back(std::move(current_page_));
+  }
+  current_page_.release();
+}
+
+bool HeapScan::advancePage() {
+  // Page IDs can have gaps (e.g. after truncation), so skip IDs with no page
+  while (++current_page_id_ < end_page_id_) {
+    readAhead();
+    current_page_ = heap_file_.getPage(current_page_id_);
+    if (current_page_) {
+      next_slot_ = 0;
+      return true;
+    }
+  }
+  return false;
+}
+
+void HeapScan::readAhead() {
+  // Top the window up once half of it is used, so each call submits many reads at once
+  if (!heap_file_.isDiskBacked() || readahead_page_id_ >= end_page_id_ ||
+      readahead_page_id_ > current_page_id_ + READAHEAD_PAGES / 2) {
+    return;
+  }
+  readahead_page_id_ = std::max(readahead_page_id_, current_page_id_);
+  PageId window_end = std::min<PageId>(end_page_id_, current_page_id_ + READAHEAD_PAGES);
+  if (readahead_page_id_ < window_end) {
+    readahead_page_id_ += heap_file_.prefetchPages(readahead_page_id_, window_end - readahead_page_id_);
+  }
+}
+
+}  // namespace database
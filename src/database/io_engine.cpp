@@ -0,0 +1,66 @@
+#include "database/io_engine.hpp"
+#include "database/io_uring_engine.hpp"
+#include <algorithm>
+
+namespace database {
+
+std::unique_ptr<IoEngine> IoEngine::create(IoEngineType type, size_t queue_depth) {
+  queue_depth = std::max<size_t>(1, queue_depth);
+  if (type != IoEngineType::PREAD) {
+    if (auto engine = IoUringEngine::open(queue_depth)) {
+      return engine;
+    }
+    if (type == IoEngineType::IO_URING) {
+      return nullptr;
+    }
+  }
+  return std::make_unique<PreadIoEngine>(queue_depth);
+}
+
+bool IoEngine::registerBuffers([[maybe_unused]] std::span<std::byte* const> buffers,
+                               [[maybe_unused]] size_t buffer_size) {
+  return false;
+}
+
+PreadIoEngine::PreadIoEngine(size_t queue_depth)
+    : IoEngine(queue_depth) {
+  prepared_.reserve(queue_depth);
+  completed_.reserve(queue_depth);
+}
+
+bool PreadIoEngine::prepare(const IoRequest& request) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (in_flight_ >= queue_depth_) {
+    return false;
+  }
+  ++in_flight_;
+  prepared_.push_back(request);
+  return true;
+}
+
+void PreadIoEngine::submit() {
+  // Take the batch and run it unlocked, so other threads can prepare meanwhile
+  std::vector<IoRequest> batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch.swap(prepared_);
+  }
+  for (const IoRequest& request : batch) {
+    bool success = request.operation == IoOperation::READ ? request.file->readPage(request.page_id, request.buffer)
+                                                          : request.file->writePage(request.page_id, request.buffer);
+    std::lock_guard<std::mutex> lock(mutex_);
+    completed_.push_back(IoCompletion{ request.user_data, success ? request.file->getPageSize() : 0 });
+  }
+}
+
+size_t PreadIoEngine::reap(std::vector<IoCompletion>& completions, [[maybe_unused]] size_t min_complete) {
+  // Requests finish inside submit(), so whatever min_complete asks for is already here
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t count = completed_.size();
+  completions.insert(completions.end(), completed_.begin(), completed_.end());
+  completed_.clear();
+  in_flight_ -= count;
+  return count;
+}
+
+}  // namespace database
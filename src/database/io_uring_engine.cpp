@@ -0,0 +1,248 @@
+#include "database/io_uring_engine.hpp"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define DATABASE_HAVE_IO_URING 1
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace database {
+
+#ifdef DATABASE_HAVE_IO_URING
+
+namespace {
+
+int ioUringSetup(size_t entries, io_uring_params* params) {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, static_cast<unsigned>(entries), params));
+}
+
+int ioUringEnter(int ring_fd, uint32_t to_submit, size_t min_complete, unsigned flags) {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit, static_cast<unsigned>(min_complete),
+                                    flags, nullptr, 0));
+}
+
+template <typename T>
+T* ringField(void* ring, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<std::byte*>(ring) + offset);
+}
+
+// The kernel reads the submission tail and writes the completion tail
+// concurrently with us, so the ring indices are accessed atomically
+uint32_t loadAcquire(uint32_t* index) {
+  return std::atomic_ref<uint32_t>(*index).load(std::memory_order_acquire);
+}
+
+void storeRelease(uint32_t* index, uint32_t value) {
+  std::atomic_ref<uint32_t>(*index).store(value, std::memory_order_release);
+}
+
+}  // namespace
+
+std::unique_ptr<IoUringEngine> IoUringEngine::open(size_t queue_depth) {
+  io_uring_params params{};
+  int ring_fd = ioUringSetup(queue_depth, &params);
+  if (ring_fd < 0) {
+    return nullptr;
+  }
+  std::unique_ptr<IoUringEngine> engine(new IoUringEngine(ring_fd, queue_depth));
+
+  // One mapping for both rings (kernel 5.4+); NODROP keeps completions that
+  // do not fit the completion ring instead of losing them (5.5+)
+  if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0 || (params.features & IORING_FEAT_NODROP) == 0) {
+    return nullptr;
+  }
+
+  size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  size_t ring_size = std::max(sq_size, cq_size);
+  void* ring = ::mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                      IORING_OFF_SQ_RING);
+  if (ring == MAP_FAILED) {
+    return nullptr;
+  }
+  engine->ring_ = ring;
+  engine->ring_size_ = ring_size;
+
+  size_t sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = ::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                      static_cast<off_t>(IORING_OFF_SQES));
+  if (sqes == MAP_FAILED) {
+    return nullptr;
+  }
+  engine->sqes_ = sqes;
+  engine->sqes_size_ = sqes_size;
+
+  engine->sq_head_ = ringField<uint32_t>(ring, params.sq_off.head);
+  engine->sq_tail_ = ringField<uint32_t>(ring, params.sq_off.tail);
+  engine->sq_array_ = ringField<uint32_t>(ring, params.sq_off.array);
+  engine->sq_mask_ = *ringField<uint32_t>(ring, params.sq_off.ring_mask);
+  engine->cq_head_ = ringField<uint32_t>(ring, params.cq_off.head);
+  engine->cq_tail_ = ringField<uint32_t>(ring, params.cq_off.tail);
+  engine->cq_mask_ = *ringField<uint32_t>(ring, params.cq_off.ring_mask);
+  engine->cqes_ = ringField<io_uring_cqe>(ring, params.cq_off.cqes);
+  return engine;
+}
+
+IoUringEngine::IoUringEngine(int ring_fd, size_t queue_depth) noexcept
+    : IoEngine(queue_depth),
+      ring_fd_(ring_fd) {
+}
+
+IoUringEngine::~IoUringEngine() {
+  if (sqes_) {
+    ::munmap(sqes_, sqes_size_);
+  }
+  if (ring_) {
+    ::munmap(ring_, ring_size_);
+  }
+  ::close(ring_fd_);
+}
+
+bool IoUringEngine::registerBuffers(std::span<std::byte* const> buffers, size_t buffer_size) {
+  if (buffers.empty() || buffers.size() > std::numeric_limits<uint16_t>::max() || in_flight_ > 0) {
+    return false;
+  }
+
+  std::vector<iovec> iovecs;
+  iovecs.reserve(buffers.size());
+  for (std::byte* buffer : buffers) {
+    iovecs.push_back(iovec{ buffer, buffer_size });
+  }
+  // Fails e.g. when the buffers exceed RLIMIT_MEMLOCK; plain reads and writes still work
+  buffers_registered_ = ::syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_BUFFERS, iovecs.data(),
+                                  static_cast<unsigned>(iovecs.size())) == 0;
+  return buffers_registered_;
+}
+
+bool IoUringEngine::prepare(const IoRequest& request) {
+  std::lock_guard<std::mutex> submit_lock(submit_mutex_);
+  if (in_flight_ >= queue_depth_) {
+    return false;
+  }
+
+  // Only the holder of submit_mutex_ moves the tail. The ring has at least
+  // queue_depth entries and at most that many requests are in flight, so it has room.
+  uint32_t tail = *sq_tail_;
+  uint32_t index = tail & sq_mask_;
+  io_uring_sqe& sqe = static_cast<io_uring_sqe*>(sqes_)[index];
+  std::memset(&sqe, 0, sizeof(sqe));
+
+  bool fixed = buffers_registered_ && request.buffer_index >= 0;
+  if (request.operation == IoOperation::READ) {
+    sqe.opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+  } else {
+    sqe.opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+  }
+  sqe.fd = request.file->getFileDescriptor();
+  sqe.off = static_cast<uint64_t>(request.file->getPageOffset(request.page_id));
+  sqe.addr = reinterpret_cast<uint64_t>(request.buffer);
+  sqe.len = static_cast<uint32_t>(request.file->getPageSize());
+  if (fixed) {
+    sqe.buf_index = static_cast<uint16_t>(request.buffer_index);
+  }
+  sqe.user_data = request.user_data;
+
+  sq_array_[index] = index;
+  storeRelease(sq_tail_, tail + 1);
+  ++unsubmitted_;
+  ++in_flight_;
+  return true;
+}
+
+void IoUringEngine::submit() {
+  std::lock_guard<std::mutex> submit_lock(submit_mutex_);
+  while (unsubmitted_ > 0) {
+    int submitted = ioUringEnter(ring_fd_, unsubmitted_, 0, 0);
+    if (submitted > 0) {
+      unsubmitted_ -= static_cast<uint32_t>(submitted);
+      continue;
+    }
+    if (submitted < 0 && errno == EINTR) {
+      continue;
+    }
+
+    // The kernel took none of the remaining entries: withdraw them and fail them
+    uint32_t tail = *sq_tail_;
+    std::lock_guard<std::mutex> lock(failed_mutex_);
+    for (uint32_t i = unsubmitted_; i > 0; --i) {
+      const io_uring_sqe& sqe = static_cast<io_uring_sqe*>(sqes_)[(tail - i) & sq_mask_];
+      failed_.push_back(IoCompletion{ sqe.user_data, 0 });
+    }
+    storeRelease(sq_tail_, tail - unsubmitted_);
+    unsubmitted_ = 0;
+  }
+}
+
+size_t IoUringEngine::reap(std::vector<IoCompletion>& completions, size_t min_complete) {
+  size_t count = 0;
+  {
+    std::lock_guard<std::mutex> lock(failed_mutex_);
+    completions.insert(completions.end(), failed_.begin(), failed_.end());
+    count = failed_.size();
+    failed_.clear();
+  }
+
+  const auto* cqes = static_cast<const io_uring_cqe*>(cqes_);
+  while (true) {
+    uint32_t head = *cq_head_;  // Only the reaper moves the head
+    uint32_t tail = loadAcquire(cq_tail_);
+    for (; head != tail; ++head) {
+      const io_uring_cqe& cqe = cqes[head & cq_mask_];
+      completions.push_back(IoCompletion{ cqe.user_data, cqe.res > 0 ? static_cast<size_t>(cqe.res) : 0 });
+      ++count;
+    }
+    storeRelease(cq_head_, head);
+
+    if (count >= min_complete) {
+      break;
+    }
+    int result = ioUringEnter(ring_fd_, 0, min_complete - count, IORING_ENTER_GETEVENTS);
+    if (result < 0 && errno != EINTR) {
+      break;  // The caller sees fewer completions than it asked for and retries
+    }
+  }
+
+  in_flight_ -= count;
+  return count;
+}
+
+#else  // No io_uring on this platform
+
+std::unique_ptr<IoUringEngine> IoUringEngine::open([[maybe_unused]] size_t queue_depth) {
+  return nullptr;
+}
+
+IoUringEngine::IoUringEngine(int ring_fd, size_t queue_depth) noexcept
+    : IoEngine(queue_depth),
+      ring_fd_(ring_fd) {
+}
+
+IoUringEngine::~IoUringEngine() = default;
+
+bool IoUringEngine::registerBuffers([[maybe_unused]] std::span<std::byte* const> buffers,
+                                    [[maybe_unused]] size_t buffer_size) {
+  return false;
+}
+
+bool IoUringEngine::prepare([[maybe_unused]] const IoRequest& request) {
+  return false;
+}
+
+void IoUringEngine::submit() {
+}
+
+size_t IoUringEngine::reap([[maybe_unused]] std::vector<IoCompletion>& completions,
+                           [[maybe_unused]] size_t min_complete) {
+  return 0;
+}
+
+#endif
+
+}  // namespace database
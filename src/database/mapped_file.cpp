@@ -0,0 +1,89 @@
+#include "database/mapped_file.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace database {
+
+std::optional<MappedFile> MappedFile::open(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    return std::nullopt;
+  }
+
+  auto size = static_cast<size_t>(st.st_size);
+  if (size == 0) {
+    ::close(fd);
+    return MappedFile(nullptr, 0);  // mmap cannot map an empty file
+  }
+
+  void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);  // The mapping keeps the file referenced
+  if (addr == MAP_FAILED) {
+    return std::nullopt;
+  }
+
+  return MappedFile(static_cast<std::byte*>(addr), size);
+}
+
+MappedFile::~MappedFile() {
+  unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+void MappedFile::adviseSequential() const noexcept {
+  if (data_) {
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+  }
+}
+
+void MappedFile::adviseSequential(size_t offset, size_t length) const noexcept {
+  advise(offset, length, MADV_SEQUENTIAL);
+}
+
+void MappedFile::adviseWillNeed(size_t offset, size_t length) const noexcept {
+  advise(offset, length, MADV_WILLNEED);
+}
+
+void MappedFile::advise(size_t offset, size_t length, int advice) const noexcept {
+  if (!data_ || offset >= size_) {
+    return;
+  }
+
+  // madvise needs a page-aligned start address
+  auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  size_t aligned_offset = offset - offset % page_size;
+  size_t end = offset + length < size_ ? offset + length : size_;
+  ::madvise(data_ + aligned_offset, end - aligned_offset, advice);
+}
+
+void MappedFile::unmap() noexcept {
+  if (data_) {
+    ::munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+}
+
+}  // namespace database
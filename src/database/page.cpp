@@ -1,112 +1,363 @@
 #include "database/page.hpp"
 #include <algorithm>
 #include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace database {
 
 Page::Page(PageId page_id, size_t page_size)
     : page_id_(page_id),
       page_size_(page_size),
-      free_space_(page_size - sizeof(Page)),  // Approximate: subtract page overhead
-      next_slot_(0) {
+      storage_(std::make_unique<std::byte[]>(page_size)),
+      data_(storage_.get()) {
+  if (page_size < sizeof(PageHeader) || page_size > MAX_PAGE_SIZE) {
+    throw std::invalid_argument("Page size must be between the page header size and MAX_PAGE_SIZE");
+  }
+
+  reset(page_id);
 }
 
-std::unique_ptr<TupleId> Page::insertTuple(const Tuple& tuple) {
-  size_t required_size = calculateSlotSize(tuple);
-  
-  if (!hasFreeSpace(required_size)) {
-    return nullptr;
+Page::Page(PageId page_id, size_t page_size, std::byte* data) noexcept
+    : page_id_(page_id),
+      page_size_(page_size),
+      data_(data) {
+}
+
+std::optional<Page> Page::view(PageId page_id, const std::byte* data, size_t page_size) noexcept {
+  if (page_size < sizeof(PageHeader) || page_size > MAX_PAGE_SIZE) {
+    return std::nullopt;
+  }
+  // Only const members are reached through a view, so the bytes are never written
+  Page page(page_id, page_size, const_cast<std::byte*>(data));
+  if (!page.loadHeader(page_id)) {
+    return std::nullopt;
   }
-  
-  uint16_t slot = next_slot_++;
-  auto tuple_copy = std::make_unique<Tuple>(tuple);
-  slots_[slot] = std::move(tuple_copy);
-  
-  free_space_ -= required_size;
-  
-  return std::make_unique<TupleId>(std::make_pair(page_id_, slot));
+  return page;
 }
 
-const Tuple* Page::getTuple(const TupleId& tuple_id) const {
-  // Verify this tuple belongs to this page
-  if (tuple_id.first != page_id_) {
+void Page::reset(PageId page_id) noexcept {
+  page_id_ = page_id;
+  PageHeader& hdr = header();
+  hdr.page_id = page_id;
+  hdr.lsn = 0;
+  hdr.lower = static_cast<uint16_t>(sizeof(PageHeader));
+  hdr.upper = static_cast<uint16_t>(page_size_ & ~(TUPLE_ALIGNMENT - 1));
+  hdr.slot_count = 0;
+  hdr.flags = 0;
+}
+
+bool Page::loadHeader(PageId page_id) noexcept {
+  const PageHeader& hdr = header();
+  if (hdr.page_id != page_id ||
+      hdr.lower != sizeof(PageHeader) + hdr.slot_count * sizeof(LinePointer) ||
+      hdr.lower > hdr.upper || hdr.upper > page_size_) {
+    return false;
+  }
+  page_id_ = page_id;
+  return true;
+}
+
+void Page::setPageId(PageId page_id) noexcept {
+  page_id_ = page_id;
+  header().page_id = page_id;
+}
+
+size_t Page::getFreeSpace() const noexcept {
+  const PageHeader& hdr = header();
+  return static_cast<size_t>(hdr.upper - hdr.lower);
+}
+
+std::unique_ptr<TupleId> Page::insertTuple(const Tuple& tuple) {
+  if (!tuple.matchesSchema()) {
     return nullptr;
   }
-  
-  uint16_t slot = tuple_id.second;
-  auto it = slots_.find(slot);
-  if (it == slots_.end()) {
+
+  auto slot = addTuple(tuple, tuple.getSize());
+  if (!slot) {
     return nullptr;
   }
-  
+
+  return std::make_unique<TupleId>(std::make_pair(page_id_, *slot));
+}
+
+std::optional<uint16_t> Page::addTuple(const Tuple& tuple, size_t tuple_size) {
+  auto offset = allocateTupleSpace(tuple_size, sizeof(LinePointer));
+  if (!offset) {
+    return std::nullopt;
+  }
+
+  tuple.serialize(data_ + *offset);
+  return addLinePointer(*offset, tuple_size);
+}
+
+std::optional<uint16_t> Page::addTupleBytes(std::span<const std::byte> tuple_bytes) {
+  auto offset = allocateTupleSpace(tuple_bytes.size(), sizeof(LinePointer));
+  if (!offset) {
+    return std::nullopt;
+  }
+
+  std::memcpy(data_ + *offset, tuple_bytes.data(), tuple_bytes.size());
+  return addLinePointer(*offset, tuple_bytes.size());
+}
+
+std::optional<TupleView> Page::getTuple(const TupleId& tuple_id, const Schema& schema) const {
+  const LinePointer* lp = findLinePointer(tuple_id);
+  if (!lp) {
+    return std::nullopt;
+  }
+
   // Check if tuple is deleted
-  if (it->second->getHeader().isDeleted()) {
+  if (tupleHeaderAt(lp->getOffset()).isDeleted()) {
+    return std::nullopt;
+  }
+
+  return TupleView(schema, data_ + lp->getOffset(), lp->getLength());
+}
+
+TupleHeader* Page::getTupleHeader(const TupleId& tuple_id) noexcept {
+  const LinePointer* lp = findLinePointer(tuple_id);
+  if (!lp || tupleHeaderAt(lp->getOffset()).isDeleted()) {
     return nullptr;
   }
-  
-  return it->second.get();
+  return &tupleHeaderAt(lp->getOffset());
 }
 
 bool Page::updateTuple(const TupleId& tuple_id, const Tuple& new_tuple) {
-  // Verify this tuple belongs to this page
-  if (tuple_id.first != page_id_) {
+  if (!new_tuple.matchesSchema()) {
     return false;
   }
-  
-  uint16_t slot = tuple_id.second;
-  auto it = slots_.find(slot);
-  if (it == slots_.end()) {
+
+  size_t new_size = new_tuple.getSize();
+  auto offset = placeUpdate(tuple_id, new_size);
+  if (!offset) {
     return false;
   }
-  
-  // Check if tuple is deleted
-  if (it->second->getHeader().isDeleted()) {
+
+  new_tuple.serialize(data_ + *offset);
+  linePointers()[tuple_id.second] = LinePointer(*offset, static_cast<uint16_t>(new_size), LinePointer::State::NORMAL);
+  setPrunable();
+  return true;
+}
+
+bool Page::updateTupleBytes(const TupleId& tuple_id, std::span<const std::byte> tuple_bytes) {
+  auto offset = placeUpdate(tuple_id, tuple_bytes.size());
+  if (!offset) {
     return false;
   }
-  
-  // Calculate size difference
-  size_t old_size = calculateSlotSize(*it->second);
-  size_t new_size = calculateSlotSize(new_tuple);
-  size_t size_diff = new_size - old_size;
-  
-  if (size_diff > 0 && !hasFreeSpace(size_diff)) {
-    return false;  // Not enough space for update
-  }
-  
-  // Update the tuple by replacing it
-  it->second = std::make_unique<Tuple>(new_tuple);
-  free_space_ -= size_diff;
-  
+
+  std::memcpy(data_ + *offset, tuple_bytes.data(), tuple_bytes.size());
+  linePointers()[tuple_id.second] =
+      LinePointer(*offset, static_cast<uint16_t>(tuple_bytes.size()), LinePointer::State::NORMAL);
+  setPrunable();
   return true;
 }
 
+std::optional<uint16_t> Page::placeUpdate(const TupleId& tuple_id, size_t new_size) noexcept {
+  const LinePointer* lp = findLinePointer(tuple_id);
+  if (!lp) {
+    return std::nullopt;
+  }
+
+  // Check if tuple is deleted
+  if (tupleHeaderAt(lp->getOffset()).isDeleted()) {
+    return std::nullopt;
+  }
+
+  // Reuse the old bytes if the new version fits, otherwise move it into free space.
+  // The old bytes stay behind until the page is compacted.
+  if (new_size > alignTupleSize(lp->getLength())) {
+    return allocateTupleSpace(new_size, 0);
+  }
+  return lp->getOffset();
+}
+
 void Page::deleteTuple(const TupleId& tuple_id) {
-  // Verify this tuple belongs to this page
-  if (tuple_id.first != page_id_) {
+  const LinePointer* lp = findLinePointer(tuple_id);
+  if (!lp) {
     return;
   }
-  
-  uint16_t slot = tuple_id.second;
-  auto it = slots_.find(slot);
-  if (it == slots_.end()) {
-    return;
+
+  // Mark as deleted in the on-page header; the bytes are reclaimed when the page is compacted
+  tupleHeaderAt(lp->getOffset()).setDeleted(true);
+  setPrunable();
+}
+
+size_t Page::prune(const std::function<bool(const TupleHeader&)>& is_dead) {
+  PageHeader& hdr = header();
+  LinePointer* lps = linePointers();
+  size_t free_before = getFreeSpace();
+  uint16_t slot_count = hdr.slot_count;
+
+  std::vector<bool> dead(slot_count, false);
+  bool prunable = false;
+  for (uint16_t slot = 0; slot < slot_count; ++slot) {
+    if (lps[slot].isNormal()) {
+      const TupleHeader& version = tupleHeaderAt(lps[slot].getOffset());
+      dead[slot] = version.isDeleted() || is_dead(version);
+      prunable = prunable || (!dead[slot] && version.getXmax() != 0);
+    }
+  }
+
+  // Point every chain root whose head died at the first surviving version of its HOT chain
+  for (uint16_t slot = 0; slot < slot_count; ++slot) {
+    const LinePointer& lp = lps[slot];
+    bool dead_root = lp.isNormal() && dead[slot] && !tupleHeaderAt(lp.getOffset()).isHeapOnly();
+    if (!dead_root && !lp.isRedirect()) {
+      continue;
+    }
+
+    std::optional<uint16_t> survivor;
+    uint16_t current = lp.isRedirect() ? lp.getOffset() : slot;
+    for (uint16_t hops = 0; hops < slot_count && current < slot_count && lps[current].isNormal(); ++hops) {
+      if (!dead[current]) {
+        survivor = current;
+        break;
+      }
+      const TupleHeader& version = tupleHeaderAt(lps[current].getOffset());
+      TupleId next = version.getCtid();
+      if (!version.isHotUpdated() || next.first != page_id_ || next.second >= slot_count ||
+          !lps[next.second].isNormal()) {
+        break;
+      }
+      const TupleHeader& successor = tupleHeaderAt(lps[next.second].getOffset());
+      if (!successor.isHeapOnly() || successor.getXmin() != version.getXmax()) {
+        break;
+      }
+      current = next.second;
+    }
+    lps[slot] = survivor ? LinePointer(*survivor, 0, LinePointer::State::REDIRECT)
+                         : LinePointer(0, 0, LinePointer::State::DEAD);
+  }
+
+  // No index points at a heap-only version, so its line pointer can be reused right away
+  for (uint16_t slot = 0; slot < slot_count; ++slot) {
+    if (lps[slot].isNormal() && dead[slot]) {
+      lps[slot] = LinePointer();
+    }
+  }
+  trimLinePointers();
+  slot_count = hdr.slot_count;
+  hdr.flags = static_cast<uint16_t>((hdr.flags & ~PageHeader::PRUNABLE) | (prunable ? PageHeader::PRUNABLE : 0));
+
+  // Pack the remaining tuples against the end of the page, highest first,
+  // so each moves up (or stays) and never overwrites one not yet moved
+  std::vector<std::pair<uint16_t, uint16_t>> tuples;  // (offset, slot)
+  for (uint16_t slot = 0; slot < slot_count; ++slot) {
+    if (lps[slot].isNormal()) {
+      tuples.emplace_back(lps[slot].getOffset(), slot);
+    }
+  }
+  std::sort(tuples.begin(), tuples.end(), std::greater<>());
+  size_t upper = page_size_ & ~(TUPLE_ALIGNMENT - 1);
+  for (const auto& [offset, slot] : tuples) {
+    uint16_t length = lps[slot].getLength();
+    upper -= alignTupleSize(length);
+    std::memmove(data_ + upper, data_ + offset, length);
+    lps[slot] = LinePointer(static_cast<uint16_t>(upper), length, LinePointer::State::NORMAL);
+  }
+  hdr.upper = static_cast<uint16_t>(upper);
+
+  return getFreeSpace() - free_before;
+}
+
+void Page::collectDeadLines(std::vector<uint16_t>& slots) const {
+  const LinePointer* lps = linePointers();
+  for (uint16_t slot = 0; slot < header().slot_count; ++slot) {
+    if (lps[slot].getState() == LinePointer::State::DEAD) {
+      slots.push_back(slot);
+    }
+  }
+}
+
+size_t Page::freeDeadLines(std::span<const uint16_t> slots) noexcept {
+  LinePointer* lps = linePointers();
+  size_t freed = 0;
+  for (uint16_t slot : slots) {
+    if (slot < header().slot_count && lps[slot].getState() == LinePointer::State::DEAD) {
+      lps[slot] = LinePointer();
+      ++freed;
+    }
+  }
+  if (freed > 0) {
+    trimLinePointers();
   }
-  
-  // Mark as deleted
-  it->second->getHeader().setDeleted(true);
-  
-  // Reclaim space (we could do this more efficiently, but for now just mark as deleted)
-  // In a real implementation, we might want to actually remove it or mark the slot as free
+  return freed;
+}
+
+TupleId Page::resolveRedirect(const TupleId& tuple_id) const noexcept {
+  if (tuple_id.first != page_id_ || tuple_id.second >= header().slot_count) {
+    return tuple_id;
+  }
+  const LinePointer& lp = linePointers()[tuple_id.second];
+  return lp.isRedirect() ? std::make_pair(page_id_, lp.getOffset()) : tuple_id;
 }
 
 bool Page::hasFreeSpace(size_t required_size) const noexcept {
-  return free_space_ >= required_size;
+  return getFreeSpace() >= required_size;
 }
 
-size_t Page::calculateSlotSize(const Tuple& tuple) const {
-  // Approximate size: tuple size + some overhead for slot management
-  return tuple.getSize() + sizeof(uint16_t) + sizeof(void*);  // slot number + pointer overhead
+LinePointer* Page::linePointers() noexcept {
+  return reinterpret_cast<LinePointer*>(data_ + sizeof(PageHeader));
 }
 
-}  // namespace database
+const LinePointer* Page::linePointers() const noexcept {
+  return reinterpret_cast<const LinePointer*>(data_ + sizeof(PageHeader));
+}
+
+const LinePointer* Page::findLinePointer(const TupleId& tuple_id) const noexcept {
+  // Verify this tuple belongs to this page
+  if (tuple_id.first != page_id_ || tuple_id.second >= header().slot_count) {
+    return nullptr;
+  }
+
+  const LinePointer* lp = &linePointers()[tuple_id.second];
+  return lp->isNormal() ? lp : nullptr;
+}
 
+std::optional<uint16_t> Page::allocateTupleSpace(size_t tuple_size, size_t extra) noexcept {
+  size_t aligned_size = alignTupleSize(tuple_size);
+  if (!hasFreeSpace(aligned_size + extra)) {
+    return std::nullopt;
+  }
+
+  PageHeader& hdr = header();
+  hdr.upper = static_cast<uint16_t>(hdr.upper - aligned_size);
+  return hdr.upper;
+}
+
+void Page::trimLinePointers() noexcept {
+  PageHeader& hdr = header();
+  const LinePointer* lps = linePointers();
+  while (hdr.slot_count > 0 && lps[hdr.slot_count - 1].getState() == LinePointer::State::UNUSED) {
+    --hdr.slot_count;
+  }
+  hdr.lower = static_cast<uint16_t>(sizeof(PageHeader) + hdr.slot_count * sizeof(LinePointer));
+  bool has_free_lines = std::any_of(lps, lps + hdr.slot_count, [](const LinePointer& lp) {
+    return lp.getState() == LinePointer::State::UNUSED;
+  });
+  hdr.flags = static_cast<uint16_t>((hdr.flags & ~PageHeader::HAS_FREE_LINES) |
+                                    (has_free_lines ? PageHeader::HAS_FREE_LINES : 0));
+}
+
+uint16_t Page::addLinePointer(uint16_t offset, size_t tuple_size) noexcept {
+  PageHeader& hdr = header();
+  LinePointer lp(offset, static_cast<uint16_t>(tuple_size), LinePointer::State::NORMAL);
+  if (hdr.flags & PageHeader::HAS_FREE_LINES) {
+    for (uint16_t slot = 0; slot < hdr.slot_count; ++slot) {
+      if (linePointers()[slot].getState() == LinePointer::State::UNUSED) {
+        linePointers()[slot] = lp;
+        return slot;
+      }
+    }
+    hdr.flags = static_cast<uint16_t>(hdr.flags & ~PageHeader::HAS_FREE_LINES);
+  }
+
+  uint16_t slot = hdr.slot_count++;
+  linePointers()[slot] = lp;
+  hdr.lower = static_cast<uint16_t>(hdr.lower + sizeof(LinePointer));
+  return slot;
+}
+
+}  // namespace database
@@ -0,0 +1,52 @@
+#include "database/page_directory.hpp"
+
+namespace database {
+
+void PageDirectory::set(PageId page_id, Page* page) {
+  if (!page) {
+    erase(page_id);
+    return;
+  }
+
+  size_t chunk_index = page_id >> CHUNK_BITS;
+  if (chunk_index >= chunks_.size()) {
+    chunks_.resize(chunk_index + 1);
+  }
+  if (!chunks_[chunk_index]) {
+    chunks_[chunk_index] = std::make_unique<Chunk>();
+  }
+
+  Chunk& chunk = *chunks_[chunk_index];
+  Page*& entry = chunk.entries[page_id & (CHUNK_SIZE - 1)];
+  if (!entry) {
+    ++chunk.used;
+    ++size_;
+  }
+  entry = page;
+}
+
+void PageDirectory::erase(PageId page_id) {
+  size_t chunk_index = page_id >> CHUNK_BITS;
+  if (chunk_index >= chunks_.size() || !chunks_[chunk_index]) {
+    return;
+  }
+
+  Chunk& chunk = *chunks_[chunk_index];
+  Page*& entry = chunk.entries[page_id & (CHUNK_SIZE - 1)];
+  if (!entry) {
+    return;
+  }
+
+  entry = nullptr;
+  --size_;
+  if (--chunk.used == 0) {
+    chunks_[chunk_index].reset();
+  }
+
+  // Trim trailing empty chunks so a truncated table gives back its directory
+  while (!chunks_.empty() && !chunks_.back()) {
+    chunks_.pop_back();
+  }
+}
+
+}  // namespace database
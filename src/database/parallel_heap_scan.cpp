@@ -0,0 +1,22 @@
+#include "database/parallel_heap_scan.hpp"
+#include <algorithm>
+
+namespace database {
+
+ParallelHeapScan::ParallelHeapScan(const HeapFile& heap_file, size_t worker_count, size_t pages_per_chunk)
+    : heap_file_(heap_file),
+      worker_count_(std::max<size_t>(1, worker_count)),
+      pages_per_chunk_(std::max<size_t>(1, pages_per_chunk)),
+      end_page_id_(heap_file.getPageIdLimit()),
+      next_page_id_(1) {
+}
+
+std::optional<HeapScan> ParallelHeapScan::claimChunk() {
+  PageId first = next_page_id_.fetch_add(pages_per_chunk_, std::memory_order_relaxed);
+  if (first >= end_page_id_) {
+    return std::nullopt;
+  }
+  return HeapScan(heap_file_, first, std::min<PageId>(first + pages_per_chunk_, end_page_id_));
+}
+
+}  // namespace database
@@ -0,0 +1,238 @@
+#include "database/recovery_manager.hpp"
+#include "database/control_file.hpp"
+#include "database/heap_file.hpp"
+#include "database/segment_file.hpp"
+#include "database/transaction_manager.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace database {
+
+namespace {
+
+/**
+ * @brief Records one redo thread replays, and what it did with them
+ */
+struct RedoPartition {
+  std::vector<const WalRecord*> records;
+  size_t applied = 0;
+  size_t skipped = 0;
+  std::string error_message;
+};
+
+bool isPageChange(WalRecordType type) {
+  switch (type) {
+    case WalRecordType::INSERT:
+    case WalRecordType::UPDATE:
+    case WalRecordType::DELETE:
+    case WalRecordType::PAGE_IMAGE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+size_t partitionOf(TableId table_id, PageId page_id, size_t partition_count) {
+  uint64_t key = (static_cast<uint64_t>(table_id) << 40) ^ page_id;
+  return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) % partition_count;
+}
+
+/**
+ * @brief Apply one record to its page unless the page already reflects it
+ * @return Empty on success, otherwise the error message
+ */
+std::string_view redo(BufferPool& buffer_pool, SegmentFile& segment, const WalRecord& record,
+                      RedoPartition& partition) {
+  PageId page_id = record.tuple_id.first;
+  PageGuard page = buffer_pool.fetchPage(segment, page_id);
+  if (!page) {
+    // Never written, or a hole left by a later page reaching disk first
+    page = buffer_pool.newPage(segment, page_id);
+    if (!page) {
+      return "no free buffer frame";
+    }
+  }
+
+  if (page->getLsn() >= record.lsn) {
+    ++partition.skipped;
+    return {};
+  }
+
+  bool applied = true;
+  switch (record.type) {
+    case WalRecordType::INSERT: {
+      auto slot = page->addTupleBytes(record.payload);
+      applied = slot && *slot == record.tuple_id.second;
+      break;
+    }
+    case WalRecordType::UPDATE:
+      applied = page->updateTupleBytes(record.tuple_id, record.payload);
+      break;
+    case WalRecordType::DELETE: {
+      TupleHeader* header = page->getTupleHeader(record.tuple_id);
+      applied = header != nullptr;
+      if (applied) {
+        header->setXmax(record.txn_id);
+        page->setPrunable();
+      }
+      break;
+    }
+    case WalRecordType::PAGE_IMAGE:
+      applied = record.payload.size() == page->getPageSize();
+      if (applied) {
+        std::memcpy(page->getData(), record.payload.data(), record.payload.size());
+        applied = page->loadHeader(page_id);
+      }
+      break;
+    default:
+      break;
+  }
+  if (!applied) {
+    return "record does not apply to its page";
+  }
+
+  page->setLsn(record.lsn);
+  page.markDirty();
+  ++partition.applied;
+  return {};
+}
+
+/**
+ * @brief Outcome of every transaction in the log; ABORTED if it has none
+ */
+std::map<TransactionId, TransactionStatus> collectOutcomes(const std::vector<WalRecord>& records) {
+  std::map<TransactionId, TransactionStatus> statuses;
+  for (const WalRecord& record : records) {
+    if (record.txn_id == 0) {
+      continue;  // Page images and checkpoints belong to no transaction
+    }
+    TransactionStatus& status = statuses.try_emplace(record.txn_id, TransactionStatus::ABORTED).first->second;
+    if (record.type == WalRecordType::COMMIT) {
+      status = TransactionStatus::COMMITTED;
+    } else if (record.type == WalRecordType::ABORT) {
+      status = TransactionStatus::ABORTED;
+    }
+  }
+  return statuses;
+}
+
+RecoveryResult failure(Lsn redo_lsn, std::string message) {
+  RecoveryResult result;
+  result.redo_lsn = redo_lsn;
+  result.error_message = std::move(message);
+  return result;
+}
+
+}  // namespace
+
+RecoveryManager::RecoveryManager(BufferPool& buffer_pool, std::string wal_path, std::string control_path,
+                                 SegmentPathFunction segment_path, TransactionManager* txn_manager)
+    : buffer_pool_(buffer_pool),
+      wal_path_(std::move(wal_path)),
+      control_path_(std::move(control_path)),
+      segment_path_(std::move(segment_path)),
+      txn_manager_(txn_manager) {
+}
+
+RecoveryResult RecoveryManager::recover(size_t thread_count) {
+  auto control = ControlFile::read(control_path_);
+  Lsn redo_lsn = control ? control->redo_lsn : 0;
+
+  auto records = WriteAheadLog::readAll(wal_path_, redo_lsn);
+  if (!records) {
+    return failure(redo_lsn, "cannot read the write-ahead log from the checkpoint's redo LSN");
+  }
+
+  // Outcomes logged before the redo LSN are in the commit log the checkpoint saved
+  if (txn_manager_ && control) {
+    std::ifstream clog(ControlFile::getCommitLogPath(control_path_), std::ios::binary);
+    if (control->next_txn_id == 0 || !txn_manager_->loadCommitLog(clog)) {
+      return failure(redo_lsn, "cannot read the commit log saved by the checkpoint");
+    }
+  }
+
+  std::map<TableId, std::unique_ptr<SegmentFile>> segments;
+  for (const WalRecord& record : *records) {
+    if (!isPageChange(record.type) || segments.count(record.table_id) > 0) {
+      continue;
+    }
+    auto segment = SegmentFile::open(segment_path_(record.table_id), buffer_pool_.getPageSize());
+    if (!segment) {
+      return failure(redo_lsn, "cannot open the segment file of table " + std::to_string(record.table_id));
+    }
+    segments.emplace(record.table_id, std::move(segment));
+  }
+
+  if (thread_count == 0) {
+    thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+  thread_count = std::clamp<size_t>(thread_count, 1, buffer_pool_.getFrameCount());
+
+  // Records of one page always land in the same partition, in log order
+  std::vector<RedoPartition> partitions(thread_count);
+  for (const WalRecord& record : *records) {
+    if (isPageChange(record.type) && record.tuple_id.first != 0) {
+      partitions[partitionOf(record.table_id, record.tuple_id.first, thread_count)].records.push_back(&record);
+    }
+  }
+
+  auto worker = [&](size_t index) {
+    RedoPartition& partition = partitions[index];
+    for (const WalRecord* record : partition.records) {
+      std::string_view error = redo(buffer_pool_, *segments.at(record->table_id), *record, partition);
+      if (!error.empty()) {
+        partition.error_message = "LSN " + std::to_string(record->lsn) + ": " + std::string(error);
+        return;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count - 1);
+  for (size_t i = 1; i < thread_count; ++i) {
+    threads.emplace_back(worker, i);
+  }
+  worker(0);  // The calling thread replays the first partition
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  RecoveryResult result;
+  result.redo_lsn = redo_lsn;
+  for (const auto& partition : partitions) {
+    if (!partition.error_message.empty() && result.error_message.empty()) {
+      result.error_message = partition.error_message;
+    }
+    result.records_applied += partition.applied;
+    result.records_skipped += partition.skipped;
+  }
+
+  // Make the replayed pages durable so the tables open on a consistent file.
+  // Free space maps are only written on a clean close, so they are stale.
+  for (auto& [table_id, segment] : segments) {
+    if (result.error_message.empty() && !buffer_pool_.flushFile(*segment)) {
+      result.error_message = "cannot write back the pages of table " + std::to_string(table_id);
+    }
+    buffer_pool_.discardFile(*segment);  // The segment files close on return
+    std::remove(HeapFile::getFreeSpaceMapPath(segment->getPath()).c_str());
+  }
+
+  if (result.error_message.empty() && txn_manager_) {
+    auto statuses = collectOutcomes(*records);
+    txn_manager_->recoverTransactions(statuses, control ? control->next_txn_id : 1,
+                                      control ? control->oldest_txn_id : 1);
+    result.transactions_recovered = statuses.size();
+  }
+
+  result.success = result.error_message.empty();
+  return result;
+}
+
+}  // namespace database
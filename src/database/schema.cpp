@@ -1,4 +1,7 @@
 #include "database/schema.hpp"
+#include "database/tuple.hpp"
+#include <istream>
+#include <ostream>
 
 namespace database {
 
@@ -11,8 +14,65 @@ Column::Column(ColumnId column_id, const std::string& name, DataType data_type,
       primary_key_(primary_key) {
 }
 
+namespace {
+
+constexpr size_t FIXED_AREA_ALIGNMENT = 8;
+
+constexpr uint8_t NULLABLE_FLAG = 0x1;
+constexpr uint8_t PRIMARY_KEY_FLAG = 0x2;
+
+template <typename T>
+void writeRaw(std::ostream& out, T value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool readRaw(std::istream& in, T& value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+TupleLayout::TupleLayout(const std::vector<Column>& columns)
+    : null_bitmap_offset_(static_cast<uint16_t>(sizeof(TupleHeader))),
+      column_offsets_(columns.size(), 0) {
+  column_types_.reserve(columns.size());
+  for (const auto& col : columns) {
+    column_types_.push_back(col.getDataType());
+  }
+  
+  size_t offset = alignUp(null_bitmap_offset_ + (columns.size() + 7) / 8, FIXED_AREA_ALIGNMENT);
+  
+  // Place columns in decreasing alignment order so no padding is needed between them
+  auto place = [&](DataType type, size_t width) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+      if (column_types_[i] == type) {
+        column_offsets_[i] = static_cast<uint16_t>(offset);
+        offset += width;
+      }
+    }
+  };
+  place(DataType::INTEGER, sizeof(int64_t));
+  place(DataType::DOUBLE, sizeof(double));
+  place(DataType::TEXT, sizeof(TextDescriptor));
+  place(DataType::BOOLEAN, sizeof(uint8_t));
+  
+  fixed_size_ = static_cast<uint16_t>(offset);
+  
+  for (size_t i = 0; i < columns.size(); ++i) {
+    if (column_types_[i] == DataType::TEXT) {
+      text_columns_.push_back(static_cast<ColumnId>(i));
+    }
+  }
+}
+
 void Schema::addColumn(const Column& column) {
   columns_.push_back(column);
+  layout_ = TupleLayout(columns_);
 }
 
 const Column* Schema::getColumn(ColumnId column_id) const {
@@ -24,5 +84,52 @@ const Column* Schema::getColumn(ColumnId column_id) const {
   return nullptr;
 }
 
-}  // namespace database
+Schema Schema::clone() const {
+  Schema schema;
+  schema.columns_ = columns_;
+  schema.layout_ = layout_;
+  return schema;
+}
+
+bool Schema::writeTo(std::ostream& out) const {
+  writeRaw(out, static_cast<uint16_t>(columns_.size()));
+  for (const auto& col : columns_) {
+    auto flags = static_cast<uint8_t>((col.isNullable() ? NULLABLE_FLAG : 0) | (col.isPrimaryKey() ? PRIMARY_KEY_FLAG : 0));
+    writeRaw(out, col.getColumnId());
+    writeRaw(out, static_cast<uint8_t>(col.getDataType()));
+    writeRaw(out, flags);
+    writeRaw(out, static_cast<uint16_t>(col.getName().size()));
+    out.write(col.getName().data(), static_cast<std::streamsize>(col.getName().size()));
+  }
+  return static_cast<bool>(out);
+}
 
+std::optional<Schema> Schema::readFrom(std::istream& in) {
+  uint16_t column_count = 0;
+  if (!readRaw(in, column_count)) {
+    return std::nullopt;
+  }
+
+  Schema schema;
+  schema.columns_.reserve(column_count);
+  for (uint16_t i = 0; i < column_count; ++i) {
+    ColumnId column_id = 0;
+    uint8_t type = 0;
+    uint8_t flags = 0;
+    uint16_t name_length = 0;
+    if (!readRaw(in, column_id) || !readRaw(in, type) || !readRaw(in, flags) || !readRaw(in, name_length) ||
+        type > static_cast<uint8_t>(DataType::BOOLEAN)) {
+      return std::nullopt;
+    }
+    std::string name(name_length, '\0');
+    if (!in.read(name.data(), name_length)) {
+      return std::nullopt;
+    }
+    schema.columns_.emplace_back(column_id, name, static_cast<DataType>(type), (flags & NULLABLE_FLAG) != 0,
+                                 (flags & PRIMARY_KEY_FLAG) != 0);
+  }
+  schema.layout_ = TupleLayout(schema.columns_);
+  return schema;
+}
+
+}  // namespace database
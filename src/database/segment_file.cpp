@@ -0,0 +1,85 @@
+#include "database/segment_file.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace database {
+
+std::unique_ptr<SegmentFile> SegmentFile::open(const std::string& path, size_t page_size) {
+  if (page_size == 0) {
+    return nullptr;
+  }
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return nullptr;
+  }
+  return std::unique_ptr<SegmentFile>(new SegmentFile(path, page_size, fd));
+}
+
+SegmentFile::~SegmentFile() {
+  ::close(fd_);
+}
+
+size_t SegmentFile::getPageCount() const {
+  struct stat st {};
+  if (::fstat(fd_, &st) != 0) {
+    return 0;
+  }
+  return static_cast<size_t>(st.st_size) / page_size_;
+}
+
+bool SegmentFile::readPage(PageId page_id, std::byte* out) const {
+  if (page_id == 0) {
+    return false;
+  }
+
+  size_t done = 0;
+  while (done < page_size_) {
+    ssize_t n = ::pread(fd_, out + done, page_size_ - done, getPageOffset(page_id) + static_cast<off_t>(done));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;  // Error, or a short page at the end of the file
+    }
+    done += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+bool SegmentFile::writePage(PageId page_id, const std::byte* data) {
+  if (page_id == 0) {
+    return false;
+  }
+
+  size_t done = 0;
+  while (done < page_size_) {
+    ssize_t n = ::pwrite(fd_, data + done, page_size_ - done, getPageOffset(page_id) + static_cast<off_t>(done));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    done += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+bool SegmentFile::truncate(size_t page_count) {
+  if (getPageCount() <= page_count) {
+    return true;
+  }
+  return ::ftruncate(fd_, static_cast<off_t>(page_count * page_size_)) == 0;
+}
+
+bool SegmentFile::sync() {
+  return ::fdatasync(fd_) == 0;
+}
+
+off_t SegmentFile::getPageOffset(PageId page_id) const noexcept {
+  return static_cast<off_t>((page_id - 1) * page_size_);
+}
+
+}  // namespace database
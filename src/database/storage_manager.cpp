@@ -1,25 +1,102 @@
 #include "database/storage_manager.hpp"
+#include <stdexcept>
 
 namespace database {
 
 StorageManager::StorageManager()
-    : next_table_id_(1) {
+    : catalog_(std::make_unique<Catalog>()) {
+}
+
+StorageManager::StorageManager(const std::string& data_directory, StorageOptions options)
+    : data_directory_(data_directory),
+      read_only_(options.read_only),
+      catalog_(Catalog::open(data_directory + "/catalog")) {
+  if (!catalog_) {
+    throw std::runtime_error("Cannot read the catalog in " + data_directory);
+  }
+  if (read_only_) {
+    return;
+  }
+
+  wal_ = WriteAheadLog::open(data_directory + "/wal.log", options.wal);
+  buffer_pool_ = std::make_unique<BufferPool>(options.buffer_pool_frames);
+  if (!wal_) {
+    throw std::runtime_error("Cannot open the write-ahead log in " + data_directory);
+  }
+  buffer_pool_->setWriteAheadLog(wal_.get());
+  txn_manager_ = std::make_unique<TransactionManager>(*wal_);
+
+  std::string control_path = data_directory + "/control";
+  RecoveryManager recovery(*buffer_pool_, data_directory + "/wal.log", control_path,
+                           [this](TableId table_id) { return getSegmentPath(table_id); }, txn_manager_.get());
+  recovery_result_ = recovery.recover(options.redo_threads);
+  if (!recovery_result_.success) {
+    throw std::runtime_error("Crash recovery of " + data_directory + " failed: " + recovery_result_.error_message);
+  }
+
+  checkpointer_ = std::make_unique<Checkpointer>(*wal_, *buffer_pool_, control_path, options.checkpoint,
+                                                  txn_manager_.get());
 }
 
 TableId StorageManager::createTable(const std::string& name, const Schema& schema) {
-  TableId table_id = next_table_id_++;
-  auto heap_file = std::make_unique<HeapFile>(table_id, schema);
-  heap_files_[table_id] = std::move(heap_file);
+  if (read_only_) {
+    return 0;
+  }
+  TableId table_id = catalog_->createTable(name, schema);
+  if (table_id == 0 || !openTable(table_id)) {
+    return 0;
+  }
   return table_id;
 }
 
 HeapFile* StorageManager::getTable(TableId table_id) {
   auto it = heap_files_.find(table_id);
-  if (it == heap_files_.end()) {
+  if (it != heap_files_.end()) {
+    return it->second.get();
+  }
+  return openTable(table_id);
+}
+
+HeapFile* StorageManager::getTable(const std::string& name) {
+  TableId table_id = catalog_->findTable(name);
+  return table_id == 0 ? nullptr : getTable(table_id);
+}
+
+TableId StorageManager::getTableId(const std::string& name) const {
+  return catalog_->findTable(name);
+}
+
+bool StorageManager::checkpoint() {
+  return checkpointer_ && checkpointer_->checkpoint();
+}
+
+std::string StorageManager::getSegmentPath(TableId table_id) const {
+  const CatalogEntry* entry = catalog_->getEntry(table_id);
+  return data_directory_ + "/" + (entry ? entry->file_name : std::to_string(table_id) + ".heap");
+}
+
+HeapFile* StorageManager::openTable(TableId table_id) {
+  const Schema* schema = catalog_->getSchema(table_id);
+  if (!schema) {
+    return nullptr;
+  }
+
+  std::unique_ptr<HeapFile> heap_file;
+  if (read_only_) {
+    heap_file = HeapFile::openMapped(table_id, *schema, getSegmentPath(table_id));
+  } else if (buffer_pool_) {
+    heap_file = HeapFile::open(table_id, *schema, *buffer_pool_, getSegmentPath(table_id));
+    if (heap_file) {
+      heap_file->setWriteAheadLog(wal_.get());
+      heap_file->setTransactionManager(txn_manager_.get());
+    }
+  } else {
+    heap_file = std::make_unique<HeapFile>(table_id, *schema);
+  }
+  if (!heap_file) {
     return nullptr;
   }
-  return it->second.get();
+  return heap_files_.emplace(table_id, std::move(heap_file)).first->second.get();
 }
 
 }  // namespace database
-
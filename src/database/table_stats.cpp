@@ -0,0 +1,42 @@
+#include "database/table_stats.hpp"
+#include <cstdint>
+
+namespace database {
+
+namespace {
+
+std::atomic<size_t> next_stripe{0};
+thread_local size_t stripe_index = SIZE_MAX;  // Constant-initialized, so reading it needs no guard
+
+}  // namespace
+
+TableCounters TableStats::read() const noexcept {
+  TableCounters counters;
+  for (const Stripe& stripe : stripes_) {
+    counters.inserts += stripe.inserts.load(std::memory_order_relaxed);
+    counters.updates += stripe.updates.load(std::memory_order_relaxed);
+    counters.deletes += stripe.deletes.load(std::memory_order_relaxed);
+  }
+  uint64_t dead = counters.updates + counters.deletes;
+  uint64_t vacuumed = vacuumed_dead_.load(std::memory_order_relaxed);
+  counters.dead_tuples = dead > vacuumed ? dead - vacuumed : 0;
+  return counters;
+}
+
+void TableStats::markVacuumed(const TableCounters& at_start) noexcept {
+  // Keep the later start if vacuums of the table finish out of order
+  uint64_t dead = at_start.updates + at_start.deletes;
+  uint64_t vacuumed = vacuumed_dead_.load(std::memory_order_relaxed);
+  while (vacuumed < dead && !vacuumed_dead_.compare_exchange_weak(vacuumed, dead, std::memory_order_relaxed)) {
+  }
+}
+
+TableStats::Stripe& TableStats::stripe() noexcept {
+  // Threads take stripes in turn, so the first STRIPE_COUNT threads each have their own in every table
+  if (stripe_index == SIZE_MAX) [[unlikely]] {
+    stripe_index = next_stripe.fetch_add(1, std::memory_order_relaxed) % STRIPE_COUNT;
+  }
+  return stripes_[stripe_index];
+}
+
+}  // namespace database
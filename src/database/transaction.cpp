@@ -16,15 +16,21 @@ void Transaction::addOperation(const Operation& op) {
   }
 }
 
-bool Transaction::commit() {
+bool Transaction::prepareCommit() {
   if (state_ != TransactionState::ACTIVE) {
-    return false;  // Already committed or aborted
+    return false;
   }
   
   state_ = TransactionState::IN_COMMIT;
-  // In a real implementation, we'd perform commit operations here
-  state_ = TransactionState::COMMITTED;
+  return true;
+}
+
+bool Transaction::commit() {
+  if (state_ != TransactionState::ACTIVE && state_ != TransactionState::IN_COMMIT) {
+    return false;  // Already committed or aborted
+  }
   
+  state_ = TransactionState::COMMITTED;
   return true;
 }
 
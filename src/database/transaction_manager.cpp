@@ -1,86 +1,313 @@
 #include "database/transaction_manager.hpp"
+#include <algorithm>
+#include <functional>
+#include <thread>
 
 namespace database {
 
-TransactionManager::TransactionManager()
-    : next_txn_id_(1) {
+TransactionManager::TransactionManager(size_t max_active_transactions)
+    : next_txn_id_(1),
+      wal_(nullptr),
+      proc_array_(std::max<size_t>(max_active_transactions, 1)),
+      shards_(SHARD_COUNT),
+      last_csn_(CsnLog::FROZEN_CSN),
+      xmin_horizon_(1) {
+}
+
+TransactionManager::TransactionManager(WriteAheadLog& wal, size_t max_active_transactions)
+    : next_txn_id_(1),
+      wal_(&wal),
+      proc_array_(std::max<size_t>(max_active_transactions, 1)),
+      shards_(SHARD_COUNT),
+      last_csn_(CsnLog::FROZEN_CSN),
+      xmin_horizon_(1) {
 }
 
 TransactionId TransactionManager::beginTransaction(IsolationLevel isolation_level) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  // Claim the slot before taking an ID, so an ID that has been handed out
+  // is always either in the proc array or about to be (see RESERVED_SLOT)
+  size_t slot = claimSlot();
+  if (slot == NO_SLOT) {
+    return 0;  // Too many transactions running
+  }
+  proc_array_[slot].begin_csn.store(last_csn_.load());
+  TransactionId txn_id = next_txn_id_.fetch_add(1, std::memory_order_acq_rel);
+  proc_array_[slot].word.store(txn_id, std::memory_order_release);
   
-  TransactionId txn_id = next_txn_id_++;
   auto txn = createTransaction(txn_id, isolation_level);
-  active_transactions_[txn_id] = std::move(txn);
+  Shard& shard = getShard(txn_id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.transactions.emplace(txn_id, TransactionEntry{ std::move(txn), slot });
   
   return txn_id;
 }
 
 bool TransactionManager::commitTransaction(TransactionId txn_id) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  
-  auto it = active_transactions_.find(txn_id);
-  if (it == active_transactions_.end()) {
-    return false;  // Transaction not found
+  Shard& shard = getShard(txn_id);
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    
+    auto it = shard.transactions.find(txn_id);
+    if (it == shard.transactions.end()) {
+      return false;  // Transaction not found
+    }
+    TransactionEntry& entry = it->second;
+    if (!wal_) {
+      entry.txn->commit();
+      retireTransaction(shard, txn_id, TransactionStatus::COMMITTED);
+      return true;
+    }
+    if (!entry.txn->prepareCommit()) {
+      return false;
+    }
+    proc_array_[entry.slot].word.store(txn_id | IN_COMMIT_FLAG, std::memory_order_release);
   }
   
-  bool committed = it->second->commit();
-  // Keep transaction in map even after commit (for testing/debugging)
-  // In a real implementation, we might move it to a committed list
+  // Wait for the commit record outside the lock so other commits can join the flush
+  std::shared_lock<std::shared_mutex> barrier(commit_barrier_);
+  if (!wal_->flush(wal_->append(WalRecordType::COMMIT, txn_id, 0, std::make_pair(0, 0)))) {
+    return false;  // The record may yet reach disk: leave the outcome to recovery
+  }
   
-  return committed;
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  retireTransaction(shard, txn_id, TransactionStatus::COMMITTED);
+  return true;
 }
 
 bool TransactionManager::rollbackTransaction(TransactionId txn_id) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  Shard& shard = getShard(txn_id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
   
-  auto it = active_transactions_.find(txn_id);
-  if (it == active_transactions_.end()) {
+  auto it = shard.transactions.find(txn_id);
+  if (it == shard.transactions.end()) {
     return false;  // Transaction not found
   }
+  TransactionEntry& entry = it->second;
   
-  it->second->rollback();
-  // Keep transaction in map even after rollback (for testing/debugging)
-  // In a real implementation, we might move it to an aborted list
+  if (entry.txn->getState() == TransactionState::IN_COMMIT) {
+    return false;  // Its commit record may already be durable
+  }
+  if (wal_ && entry.txn->getState() == TransactionState::ACTIVE) {
+    wal_->append(WalRecordType::ABORT, txn_id, 0, std::make_pair(0, 0));  // Needs no flush
+  }
+  entry.txn->rollback();
+  retireTransaction(shard, txn_id, TransactionStatus::ABORTED);
   
   return true;
 }
 
 Transaction* TransactionManager::getTransaction(TransactionId txn_id) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  Shard& shard = getShard(txn_id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
   
-  auto it = active_transactions_.find(txn_id);
-  if (it == active_transactions_.end()) {
+  auto it = shard.transactions.find(txn_id);
+  if (it == shard.transactions.end()) {
     return nullptr;
   }
   
-  return it->second.get();
+  return it->second.txn.get();
 }
 
 bool TransactionManager::isTransactionActive(TransactionId txn_id) const {
-  std::lock_guard<std::mutex> lock(mutex_);
+  Shard& shard = getShard(txn_id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
   
-  auto it = active_transactions_.find(txn_id);
-  return it != active_transactions_.end() && 
-         it->second->getState() == TransactionState::ACTIVE;
+  auto it = shard.transactions.find(txn_id);
+  return it != shard.transactions.end() && 
+         it->second.txn->getState() == TransactionState::ACTIVE;
 }
 
 std::vector<TransactionId> TransactionManager::getActiveTransactionIds() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  
   std::vector<TransactionId> active_ids;
-  for (const auto& [txn_id, txn] : active_transactions_) {
-    if (txn->getState() == TransactionState::ACTIVE) {
-      active_ids.push_back(txn_id);
+  for (const auto& slot : proc_array_) {
+    uint64_t word = slot.word.load(std::memory_order_acquire);
+    if (word != 0 && (word & IN_COMMIT_FLAG) == 0) {
+      active_ids.push_back(word);
     }
   }
   
+  std::sort(active_ids.begin(), active_ids.end());
   return active_ids;
 }
 
+TransactionId TransactionManager::getOldestActiveTransactionId() const {
+  // Read the counter first: anything beginning after that gets a larger ID
+  TransactionId oldest = next_txn_id_.load(std::memory_order_acquire);
+  for (const auto& slot : proc_array_) {
+    uint64_t word = slot.word.load(std::memory_order_acquire);
+    while (word == RESERVED_SLOT) {
+      // Its ID may predate the counter read above; wait for it to show up
+      std::this_thread::yield();
+      word = slot.word.load(std::memory_order_acquire);
+    }
+    word &= ~IN_COMMIT_FLAG;
+    if (word != 0 && word < oldest) {
+      oldest = word;
+    }
+  }
+  
+  TransactionId horizon = xmin_horizon_.load();
+  while (horizon < oldest && !xmin_horizon_.compare_exchange_weak(horizon, oldest)) {
+  }
+  return oldest;
+}
+
+Snapshot TransactionManager::getOldestSnapshot() const {
+  // Read the CSN first: anything beginning after that begins at it or later
+  CommitSeqNo oldest = last_csn_.load();
+  for (const auto& slot : proc_array_) {
+    uint64_t word = slot.word.load();
+    while (word == RESERVED_SLOT) {
+      std::this_thread::yield();  // Its begin CSN may predate the read above
+      word = slot.word.load();
+    }
+    if (word != 0) {
+      oldest = std::min(oldest, slot.begin_csn.load());
+    }
+  }
+  return Snapshot{ oldest, 0, 0 };
+}
+
+void TransactionManager::truncateCommitLog(TransactionId frozen_txn_id) {
+  TransactionId horizon = std::min(frozen_txn_id, getOldestActiveTransactionId());
+  commit_log_.truncate(horizon);
+  csn_log_.truncate(horizon);
+}
+
+void TransactionManager::recoverTransactions(const std::map<TransactionId, TransactionStatus>& statuses,
+                                             TransactionId next_txn_id, TransactionId oldest_txn_id) {
+  for (const auto& [txn_id, status] : statuses) {
+    if (commit_log_.getStatus(txn_id) != TransactionStatus::COMMITTED) {  // Saved by the checkpoint
+      commit_log_.setStatus(txn_id, status);
+    }
+  }
+  next_txn_id = std::max(next_txn_id, next_txn_id_.load());
+  if (!statuses.empty()) {
+    next_txn_id = std::max(next_txn_id, statuses.rbegin()->first + 1);
+  }
+
+  // Only the last CSN page can hold IDs below next_txn_id; the others report
+  // FROZEN_CSN. Commits on it that are not visited keep CSN 0, which every
+  // snapshot covers as well.
+  csn_log_.truncate(next_txn_id);
+  TransactionId first_txn_id = std::max({ commit_log_.getOldestTransactionId(), oldest_txn_id, TransactionId{1} });
+  for (TransactionId txn_id = first_txn_id; txn_id < next_txn_id; ++txn_id) {
+    switch (commit_log_.getStatus(txn_id)) {
+      case TransactionStatus::COMMITTED:
+        csn_log_.setCsn(txn_id, CsnLog::FROZEN_CSN);
+        break;
+      case TransactionStatus::IN_PROGRESS:
+      case TransactionStatus::SUB_COMMITTED:
+        commit_log_.setStatus(txn_id, TransactionStatus::ABORTED);  // Running at the crash
+        break;
+      default:
+        break;
+    }
+  }
+
+  next_txn_id_.store(next_txn_id);
+  xmin_horizon_.store(std::max(xmin_horizon_.load(), next_txn_id));
+}
+
+const Snapshot& TransactionManager::getSnapshot(Transaction& txn) const {
+  const auto& cached = txn.getSnapshot();
+  if (cached) {
+    bool per_transaction = txn.getIsolationLevel() == IsolationLevel::REPEATABLE_READ ||
+                           txn.getIsolationLevel() == IsolationLevel::SERIALIZABLE;
+    if (per_transaction || cached->csn == last_csn_.load()) {
+      return *cached;
+    }
+  }
+  txn.setSnapshot(takeSnapshot(txn.getTransactionId()));
+  return *txn.getSnapshot();
+}
+
+bool TransactionManager::isCommittedInSnapshot(TransactionId txn_id, const Snapshot& snapshot) const {
+  if (txn_id == snapshot.txn_id && txn_id != 0) {
+    return true;
+  }
+  if (commit_log_.getStatus(txn_id) != TransactionStatus::COMMITTED) {
+    return false;  // Running or aborted; if it commits, it will take a newer CSN
+  }
+  return isCommittedBefore(txn_id, snapshot);
+}
+
+bool TransactionManager::isCommittedBefore(TransactionId txn_id, const Snapshot& snapshot) const {
+  if (txn_id < snapshot.xmin) {
+    return true;
+  }
+  CommitSeqNo csn = csn_log_.getCsn(txn_id);
+  while (csn == CsnLog::COMMITTING) {
+    std::this_thread::yield();  // Only the fetch_add of the CSN is left
+    csn = csn_log_.getCsn(txn_id);
+  }
+  return csn <= snapshot.csn;
+}
+
+TransactionManager::Shard& TransactionManager::getShard(TransactionId txn_id) const {
+  // Consecutive IDs, i.e. transactions begun by concurrent threads, land on different shards
+  return shards_[txn_id % SHARD_COUNT];
+}
+
+size_t TransactionManager::claimSlot() {
+  // Each thread starts probing at its own position, so threads rarely race for a slot
+  static thread_local size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  
+  size_t slot_count = proc_array_.size();
+  size_t start = hint % slot_count;
+  for (size_t i = 0; i < slot_count; ++i) {
+    size_t slot = (start + i) % slot_count;
+    uint64_t expected = 0;
+    if (proc_array_[slot].word.load(std::memory_order_relaxed) == 0 &&
+        proc_array_[slot].word.compare_exchange_strong(expected, RESERVED_SLOT, std::memory_order_acq_rel)) {
+      hint = slot;
+      return slot;
+    }
+  }
+  return NO_SLOT;
+}
+
+void TransactionManager::retireTransaction(Shard& shard, TransactionId txn_id, TransactionStatus status) {
+  auto it = shard.transactions.find(txn_id);
+  // The outcome is recorded before the slot is freed, so whoever no longer
+  // sees the transaction running finds its status
+  if (status == TransactionStatus::COMMITTED) {
+    csn_log_.setCsn(txn_id, CsnLog::COMMITTING);
+    commit_log_.setStatus(txn_id, status);
+    CommitSeqNo csn = last_csn_.fetch_add(1) + 1;
+    csn_log_.setCsn(txn_id, csn);
+    proc_array_[it->second.slot].word.store(0, std::memory_order_release);
+    if (csn % HORIZON_REFRESH_COMMITS == 0) {
+      refreshHorizon();
+    }
+  } else {
+    commit_log_.setStatus(txn_id, status);
+    proc_array_[it->second.slot].word.store(0, std::memory_order_release);
+  }
+  shard.transactions.erase(it);
+}
+
+void TransactionManager::refreshHorizon() {
+  // Every transaction below the horizon has finished, so its CSN is at most the one read after it
+  TransactionId horizon = getOldestActiveTransactionId();
+  CommitSeqNo csn = last_csn_.load();
+
+  std::unique_lock<std::mutex> lock(csn_truncation_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return;  // Another commit is refreshing
+  }
+  if (csn_truncation_xid_ > 0) {
+    if (getOldestSnapshot().csn < csn_truncation_csn_) {
+      return;  // A snapshot may still predate commits below the noted horizon
+    }
+    csn_log_.truncate(csn_truncation_xid_);
+  }
+  csn_truncation_xid_ = horizon;
+  csn_truncation_csn_ = csn;
+}
+
 std::unique_ptr<Transaction> TransactionManager::createTransaction(TransactionId txn_id, IsolationLevel isolation_level) {
   return std::make_unique<Transaction>(txn_id, isolation_level);
 }
 
 }  // namespace database
-
@@ -1,12 +1,34 @@
 #include "database/tuple.hpp"
+#include <cstring>
 
 namespace database {
 
+namespace {
+
+bool valueMatchesType(const Value& value, DataType type) {
+  switch (type) {
+    case DataType::INTEGER: return std::holds_alternative<int64_t>(value);
+    case DataType::DOUBLE: return std::holds_alternative<double>(value);
+    case DataType::TEXT: return std::holds_alternative<std::string>(value);
+    case DataType::BOOLEAN: return std::holds_alternative<bool>(value);
+  }
+  return false;
+}
+
+template <typename T>
+void writeRaw(std::byte* out, const T& value) {
+  std::memcpy(out, &value, sizeof(T));
+}
+
+}  // namespace
+
 TupleHeader::TupleHeader(TransactionId xmin)
     : xmin_(xmin),
       xmax_(0),
-      ctid_(std::make_pair(0, 0)),
-      deleted_(false) {
+      ctid_page_(0),
+      ctid_slot_(0),
+      deleted_(false),
+      infomask_(0) {
 }
 
 Tuple::Tuple(const Schema& schema, const std::vector<Value>& values, TransactionId xmin)
@@ -15,6 +37,15 @@ Tuple::Tuple(const Schema& schema, const std::vector<Value>& values, Transaction
       header_(xmin) {
 }
 
+Tuple::Tuple(const TupleView& view)
+    : schema_(view.getSchema()),
+      header_(view.getHeader()) {
+  values_.reserve(view.getColumnCount());
+  for (ColumnId i = 0; i < view.getColumnCount(); ++i) {
+    values_.push_back(*view.getValue(i));
+  }
+}
+
 std::optional<Value> Tuple::getValue(ColumnId column_id) const {
   if (column_id >= values_.size()) {
     return std::nullopt;
@@ -23,19 +54,121 @@ std::optional<Value> Tuple::getValue(ColumnId column_id) const {
 }
 
 size_t Tuple::getSize() const {
-  size_t size = sizeof(TupleHeader);
-  
-  for (const auto& value : values_) {
-    size += sizeof(Value);  // Base variant size
-    
-    // Add size for string values
-    if (std::holds_alternative<std::string>(value)) {
-      size += std::get<std::string>(value).size();
+  const TupleLayout& layout = schema_.getLayout();
+  size_t size = layout.getFixedSize();
+
+  // Only TEXT columns contribute variable-length bytes
+  for (ColumnId column_id : layout.getTextColumns()) {
+    if (column_id < values_.size() && std::holds_alternative<std::string>(values_[column_id])) {
+      size += std::get<std::string>(values_[column_id]).size();
     }
   }
-  
+
   return size;
 }
 
-}  // namespace database
+bool Tuple::matchesSchema() const {
+  const auto& columns = schema_.getColumns();
+  if (values_.size() != columns.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < columns.size(); ++i) {
+    if (std::holds_alternative<std::nullptr_t>(values_[i])) {
+      if (!columns[i].isNullable()) {
+        return false;
+      }
+    } else if (!valueMatchesType(values_[i], columns[i].getDataType())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void Tuple::serialize(std::byte* out) const {
+  const TupleLayout& layout = schema_.getLayout();
+
+  writeRaw(out, header_);
+  std::memset(out + sizeof(TupleHeader), 0, layout.getFixedSize() - sizeof(TupleHeader));
+
+  std::byte* null_bitmap = out + layout.getNullBitmapOffset();
+  size_t varlena_offset = layout.getFixedSize();
+
+  for (ColumnId i = 0; i < layout.getColumnCount(); ++i) {
+    std::byte* field = out + layout.getColumnOffset(i);
+    const Value* value = i < values_.size() ? &values_[i] : nullptr;
+
+    if (!value || std::holds_alternative<std::nullptr_t>(*value)) {
+      null_bitmap[i / 8] |= std::byte{static_cast<uint8_t>(1U << (i % 8))};
+      continue;
+    }
 
+    switch (layout.getColumnType(i)) {
+      case DataType::INTEGER:
+        writeRaw(field, std::get<int64_t>(*value));
+        break;
+      case DataType::DOUBLE:
+        writeRaw(field, std::get<double>(*value));
+        break;
+      case DataType::BOOLEAN:
+        writeRaw(field, static_cast<uint8_t>(std::get<bool>(*value) ? 1 : 0));
+        break;
+      case DataType::TEXT: {
+        const auto& str = std::get<std::string>(*value);
+        writeRaw(field, TextDescriptor{ static_cast<uint16_t>(varlena_offset), static_cast<uint16_t>(str.size()) });
+        std::memcpy(out + varlena_offset, str.data(), str.size());
+        varlena_offset += str.size();
+        break;
+      }
+    }
+  }
+}
+
+std::optional<Tuple> Tuple::deserialize(const Schema& schema, const std::byte* data, size_t size) {
+  TupleView view(schema, data, size);
+  if (!view.isWellFormed()) {
+    return std::nullopt;
+  }
+  return Tuple(view);
+}
+
+std::optional<Value> TupleView::getValue(ColumnId column_id) const {
+  if (column_id >= getColumnCount()) {
+    return std::nullopt;
+  }
+
+  if (isNull(column_id)) {
+    return Value{ nullptr };
+  }
+
+  switch (layout().getColumnType(column_id)) {
+    case DataType::INTEGER: return Value{ getInteger(column_id) };
+    case DataType::DOUBLE: return Value{ getDouble(column_id) };
+    case DataType::TEXT: return Value{ std::string(getText(column_id)) };
+    case DataType::BOOLEAN: return Value{ getBoolean(column_id) };
+  }
+  return std::nullopt;
+}
+
+bool TupleView::isWellFormed() const noexcept {
+  const TupleLayout& tuple_layout = layout();
+  if (size_ < tuple_layout.getFixedSize()) {
+    return false;
+  }
+
+  // Every TEXT value must point inside the varlena area
+  for (ColumnId column_id : tuple_layout.getTextColumns()) {
+    if (isNull(column_id)) {
+      continue;
+    }
+    auto desc = read<TextDescriptor>(column_id);
+    if (desc.offset < tuple_layout.getFixedSize() || static_cast<size_t>(desc.offset) + desc.length > size_) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace database
@@ -0,0 +1,105 @@
+#include "database/tuple_builder.hpp"
+#include <cstring>
+#include <limits>
+
+namespace database {
+
+namespace {
+
+template <typename T>
+void writeRaw(std::byte* out, const T& value) {
+  std::memcpy(out, &value, sizeof(T));
+}
+
+}  // namespace
+
+TupleBuilder::TupleBuilder(const Schema& schema)
+    : schema_(schema),
+      buffer_(schema.getLayout().getFixedSize()),
+      text_values_(schema.getColumnCount()) {
+  reset(0);
+}
+
+void TupleBuilder::reset(TransactionId xmin) {
+  const TupleLayout& layout = schema_.getLayout();
+  buffer_.resize(layout.getFixedSize());
+
+  writeRaw(buffer_.data(), TupleHeader(xmin));
+  std::memset(buffer_.data() + sizeof(TupleHeader), 0, layout.getFixedSize() - sizeof(TupleHeader));
+  for (ColumnId i = 0; i < layout.getColumnCount(); ++i) {
+    setNullBit(i, true);
+  }
+}
+
+void TupleBuilder::setNull(ColumnId column_id) noexcept {
+  setNullBit(column_id, true);
+}
+
+void TupleBuilder::setInteger(ColumnId column_id, int64_t value) noexcept {
+  writeRaw(buffer_.data() + schema_.getLayout().getColumnOffset(column_id), value);
+  setNullBit(column_id, false);
+}
+
+void TupleBuilder::setDouble(ColumnId column_id, double value) noexcept {
+  writeRaw(buffer_.data() + schema_.getLayout().getColumnOffset(column_id), value);
+  setNullBit(column_id, false);
+}
+
+void TupleBuilder::setBoolean(ColumnId column_id, bool value) noexcept {
+  writeRaw(buffer_.data() + schema_.getLayout().getColumnOffset(column_id), static_cast<uint8_t>(value ? 1 : 0));
+  setNullBit(column_id, false);
+}
+
+void TupleBuilder::setText(ColumnId column_id, std::string_view value) noexcept {
+  text_values_[column_id] = value;
+  setNullBit(column_id, false);
+}
+
+std::optional<std::span<const std::byte>> TupleBuilder::build() {
+  const TupleLayout& layout = schema_.getLayout();
+  const auto& columns = schema_.getColumns();
+
+  for (ColumnId i = 0; i < columns.size(); ++i) {
+    if (!columns[i].isNullable() && isNull(i)) {
+      return std::nullopt;
+    }
+  }
+
+  size_t size = layout.getFixedSize();
+  for (ColumnId column_id : layout.getTextColumns()) {
+    if (!isNull(column_id)) {
+      size += text_values_[column_id].size();
+    }
+  }
+  if (size > std::numeric_limits<uint16_t>::max()) {
+    return std::nullopt;  // TextDescriptor offsets are 16 bits
+  }
+
+  buffer_.resize(size);
+  size_t varlena_offset = layout.getFixedSize();
+  for (ColumnId column_id : layout.getTextColumns()) {
+    if (isNull(column_id)) {
+      continue;
+    }
+    std::string_view text = text_values_[column_id];
+    writeRaw(buffer_.data() + layout.getColumnOffset(column_id),
+             TextDescriptor{ static_cast<uint16_t>(varlena_offset), static_cast<uint16_t>(text.size()) });
+    std::memcpy(buffer_.data() + varlena_offset, text.data(), text.size());
+    varlena_offset += text.size();
+  }
+
+  return std::span<const std::byte>(buffer_.data(), buffer_.size());
+}
+
+void TupleBuilder::setNullBit(ColumnId column_id, bool is_null) noexcept {
+  std::byte& bits = buffer_[schema_.getLayout().getNullBitmapOffset() + column_id / 8U];
+  auto mask = std::byte{ static_cast<uint8_t>(1U << (column_id % 8U)) };
+  bits = is_null ? (bits | mask) : (bits & ~mask);
+}
+
+bool TupleBuilder::isNull(ColumnId column_id) const noexcept {
+  auto bits = buffer_[schema_.getLayout().getNullBitmapOffset() + column_id / 8U];
+  return (bits & std::byte{ static_cast<uint8_t>(1U << (column_id % 8U)) }) != std::byte{ 0 };
+}
+
+}  // namespace database
@@ -0,0 +1,237 @@
+#include "database/vacuum_manager.hpp"
+#include <algorithm>
+
+namespace database {
+
+VacuumManager::VacuumManager(TransactionManager& txn_manager, VacuumOptions options)
+    : txn_manager_(txn_manager),
+      options_(options) {
+  if (options_.interval.count() > 0) {
+    for (size_t i = 0; i < std::max<size_t>(options_.workers, 1); ++i) {
+      workers_.emplace_back(&VacuumManager::work, this);
+    }
+    scheduler_ = std::thread(&VacuumManager::schedule, this);
+  }
+}
+
+VacuumManager::~VacuumManager() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  stop_cv_.notify_all();
+  work_cv_.notify_all();
+  if (scheduler_.joinable()) {
+    scheduler_.join();
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+VacuumStats VacuumManager::vacuum(HeapFile& table, bool aggressive, const IndexCleanup& index_cleanup) {
+  return vacuumTable(table, nullptr, aggressive, index_cleanup);
+}
+
+void VacuumManager::addTable(HeapFile& table, std::mutex& table_mutex, IndexCleanup index_cleanup) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tables_.push_back(TableEntry{ &table, &table_mutex, std::move(index_cleanup), 0, std::chrono::steady_clock::now(),
+                                false, VacuumStats{} });
+}
+
+void VacuumManager::removeTable(HeapFile& table) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  table_done_cv_.wait(lock, [this, &table] {
+    auto it = findTable(&table);
+    return it == tables_.end() || !it->in_progress;
+  });
+  std::erase(queue_, &table);
+  std::erase_if(tables_, [&table](const TableEntry& entry) { return entry.table == &table; });
+}
+
+uint64_t VacuumManager::getVacuumCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return vacuum_count_;
+}
+
+VacuumStats VacuumManager::getLastStats(const HeapFile& table) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = std::find_if(tables_.begin(), tables_.end(), [&table](const TableEntry& entry) {
+    return entry.table == &table;
+  });
+  return it != tables_.end() ? it->last_stats : VacuumStats{};
+}
+
+void VacuumManager::schedule() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_cv_.wait_for(lock, options_.interval, [this] { return stopping_; })) {
+    // Rank the due tables by how fast they gathered dead tuples; one being
+    // vacuumed is left alone, its dead tuples are being dealt with
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::pair<double, HeapFile*>> due;
+    for (const TableEntry& entry : tables_) {
+      if (entry.in_progress) {
+        continue;
+      }
+      TableCounters counters = entry.table->getStats().read();
+      double threshold = static_cast<double>(options_.vacuum_threshold) +
+                         options_.vacuum_scale_factor * static_cast<double>(counters.getLiveTuples());
+      if (static_cast<double>(counters.dead_tuples) > threshold || needsAggressive(entry)) {
+        double seconds = std::chrono::duration<double>(now - entry.last_vacuum).count();
+        due.emplace_back(static_cast<double>(counters.dead_tuples) / std::max(seconds, 1e-3), entry.table);
+      }
+    }
+    std::sort(due.begin(), due.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    queue_.clear();
+    for (const auto& [rate, table] : due) {
+      queue_.push_back(table);
+    }
+    if (!queue_.empty()) {
+      work_cv_.notify_all();
+    }
+  }
+}
+
+void VacuumManager::work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    work_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+    if (stopping_) {
+      return;
+    }
+    HeapFile* table = queue_.front();
+    queue_.pop_front();
+    auto it = findTable(table);
+    if (it == tables_.end() || it->in_progress) {
+      continue;
+    }
+    it->in_progress = true;
+    std::mutex* table_mutex = it->table_mutex;
+    IndexCleanup index_cleanup = it->index_cleanup;
+    bool aggressive = needsAggressive(*it);
+    lock.unlock();
+
+    VacuumStats stats = vacuumTable(*table, table_mutex, aggressive, index_cleanup);
+
+    lock.lock();
+    it = findTable(table);  // Still there: removeTable() waits for the vacuum
+    it->in_progress = false;
+    it->last_vacuum = std::chrono::steady_clock::now();
+    it->last_stats = stats;
+    it->frozen_xid = std::max(it->frozen_xid, stats.frozen_xid);
+    if (stats.frozen_xid > 0) {
+      truncateCommitLog();
+    }
+    ++vacuum_count_;
+    table_done_cv_.notify_all();
+  }
+}
+
+bool VacuumManager::needsAggressive(const TableEntry& entry) const {
+  return txn_manager_.getOldestActiveTransactionId() - entry.frozen_xid > options_.freeze_table_age;
+}
+
+void VacuumManager::truncateCommitLog() {
+  TransactionId frozen_xid = 0;
+  for (const TableEntry& entry : tables_) {
+    if (entry.frozen_xid == 0) {
+      return;  // Its versions may still need any commit log page
+    }
+    frozen_xid = frozen_xid == 0 ? entry.frozen_xid : std::min(frozen_xid, entry.frozen_xid);
+  }
+  txn_manager_.truncateCommitLog(frozen_xid);
+}
+
+std::vector<VacuumManager::TableEntry>::iterator VacuumManager::findTable(const HeapFile* table) {
+  return std::find_if(tables_.begin(), tables_.end(), [table](const TableEntry& entry) { return entry.table == table; });
+}
+
+VacuumStats VacuumManager::vacuumTable(HeapFile& table, std::mutex* table_mutex, bool aggressive,
+                                       const IndexCleanup& index_cleanup) {
+  std::unique_lock<std::mutex> table_lock = table_mutex ? std::unique_lock<std::mutex>(*table_mutex)
+                                                        : std::unique_lock<std::mutex>();
+  TableCounters counters_at_start = table.getStats().read();
+
+  // Versions older than freeze_min_age transactions are unlikely to change again
+  TransactionId oldest = txn_manager_.getOldestActiveTransactionId();
+  TransactionId freeze_limit = oldest > options_.freeze_min_age ? oldest - options_.freeze_min_age : 1;
+  uint8_t skip_bits = aggressive ? VisibilityMap::ALL_FROZEN : VisibilityMap::ALL_VISIBLE;
+
+  VacuumStats stats;
+  TransactionId frozen_xid = freeze_limit;
+  bool stopped = false;
+  size_t round_pages = 0;
+  size_t round_dirtied = 0;
+  std::vector<TupleId> dead_tuple_ids;  // Waiting for index cleanup, in page order
+  auto cleanIndexes = [&] {
+    ++stats.index_cleanups;
+    if (index_cleanup(dead_tuple_ids)) {
+      stats.dead_lines_freed += table.freeDeadTuples(dead_tuple_ids);
+    }
+    dead_tuple_ids.clear();
+  };
+  for (PageId page_id = 1; page_id < table.getPageIdLimit() && !stopped; ++page_id) {
+    if (table.getVisibilityMap().getBits(page_id) & skip_bits) {
+      ++stats.pages_skipped;
+      continue;
+    }
+
+    std::optional<PageVacuumResult> result = table.vacuumPage(page_id, freeze_limit, !index_cleanup);
+    ++stats.pages_scanned;
+    ++round_pages;
+    if (!result) {
+      frozen_xid = 0;  // Nothing is known about the page
+    } else {
+      if (result->bytes_reclaimed > 0) {
+        ++stats.pages_pruned;
+        stats.bytes_reclaimed += result->bytes_reclaimed;
+      }
+      if (result->dirtied) {
+        ++stats.pages_dirtied;
+        ++round_dirtied;
+      }
+      frozen_xid = std::min(frozen_xid, result->frozen_xid);
+      stats.dead_lines_freed += result->dead_lines_freed;
+      dead_tuple_ids.insert(dead_tuple_ids.end(), result->dead_tuple_ids.begin(), result->dead_tuple_ids.end());
+      if (dead_tuple_ids.size() >= options_.max_dead_tuples) {
+        cleanIndexes();
+      }
+    }
+
+    if (round_pages >= options_.pages_per_round || round_dirtied >= options_.dirty_pages_per_round) {
+      // Let foreground work at the table in while pausing
+      if (table_mutex) {
+        table_lock.unlock();
+      }
+      stopped = !throttle();
+      if (table_mutex) {
+        table_lock.lock();
+      }
+      round_pages = 0;
+      round_dirtied = 0;
+    }
+  }
+
+  // DEAD line pointers stay DEAD while the table mutex is let go between
+  // rounds, so the ones collected before a pause are still there to free
+  if (!stopped && !dead_tuple_ids.empty()) {
+    cleanIndexes();
+  }
+
+  stats.pages_all_visible = table.getVisibilityMap().countAllVisible();
+  stats.pages_all_frozen = table.getVisibilityMap().countAllFrozen();
+  stats.completed = !stopped;
+  if (stats.completed) {
+    table.getStats().markVacuumed(counters_at_start);
+  }
+  stats.frozen_xid = aggressive && stats.completed ? frozen_xid : 0;
+  return stats;
+}
+
+bool VacuumManager::throttle() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return !stop_cv_.wait_for(lock, options_.round_delay, [this] { return stopping_; });
+}
+
+}  // namespace database
@@ -0,0 +1,74 @@
+#include "database/visibility_checker.hpp"
+
+namespace database {
+
+bool VisibilityChecker::isVisible(const TupleHeader& header, const Snapshot& snapshot, bool set_hints) const {
+  if (!sees(header, header.getXmin(), snapshot, set_hints, TupleHeader::XMIN_COMMITTED, TupleHeader::XMIN_INVALID)) {
+    return false;
+  }
+  TransactionId xmax = header.getXmax();
+  return xmax == 0 ||
+         !sees(header, xmax, snapshot, set_hints, TupleHeader::XMAX_COMMITTED, TupleHeader::XMAX_INVALID);
+}
+
+bool VisibilityChecker::isDead(const TupleHeader& header, const Snapshot& oldest_snapshot, bool set_hints) const {
+  if (hasAborted(header, header.getXmin(), set_hints, TupleHeader::XMIN_COMMITTED, TupleHeader::XMIN_INVALID)) {
+    return true;
+  }
+  TransactionId xmax = header.getXmax();
+  return xmax != 0 &&
+         sees(header, xmax, oldest_snapshot, set_hints, TupleHeader::XMAX_COMMITTED, TupleHeader::XMAX_INVALID);
+}
+
+bool VisibilityChecker::sees(const TupleHeader& header, TransactionId txn_id, const Snapshot& snapshot,
+                             bool set_hints, uint16_t committed_hint, uint16_t invalid_hint) const {
+  uint16_t infomask = header.getInfomask();
+  if (infomask & invalid_hint) {
+    return false;
+  }
+  if (infomask & committed_hint) {
+    return txn_manager_.isCommittedBefore(txn_id, snapshot);
+  }
+  if (txn_id == snapshot.txn_id && txn_id != 0) {
+    return true;
+  }
+
+  switch (txn_manager_.getTransactionStatus(txn_id)) {
+    case TransactionStatus::COMMITTED:
+      if (set_hints) {
+        header.setHintBits(committed_hint);
+      }
+      return txn_manager_.isCommittedBefore(txn_id, snapshot);
+    case TransactionStatus::ABORTED:
+      if (set_hints) {
+        header.setHintBits(invalid_hint);
+      }
+      return false;
+    default:
+      return false;  // Running; if it commits, it will take a newer CSN
+  }
+}
+
+bool VisibilityChecker::hasAborted(const TupleHeader& header, TransactionId txn_id, bool set_hints,
+                                   uint16_t committed_hint, uint16_t invalid_hint) const {
+  uint16_t infomask = header.getInfomask();
+  if (infomask & (committed_hint | invalid_hint)) {
+    return (infomask & invalid_hint) != 0;
+  }
+  switch (txn_manager_.getTransactionStatus(txn_id)) {
+    case TransactionStatus::COMMITTED:
+      if (set_hints) {
+        header.setHintBits(committed_hint);
+      }
+      return false;
+    case TransactionStatus::ABORTED:
+      if (set_hints) {
+        header.setHintBits(invalid_hint);
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace database
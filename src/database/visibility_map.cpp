@@ -0,0 +1,58 @@
+#include "database/visibility_map.hpp"
+#include <bit>
+
+namespace database {
+
+namespace {
+
+constexpr uint64_t BITS_MASK = 0x3;
+constexpr uint64_t ALL_VISIBLE_BITS = 0x5555555555555555ULL;  // The low bit of every page's pair
+
+}  // namespace
+
+uint8_t VisibilityMap::getBits(PageId page_id) const noexcept {
+  size_t word = page_id / PAGES_PER_WORD;
+  if (word >= words_.size()) {
+    return 0;
+  }
+  uint64_t shift = (page_id % PAGES_PER_WORD) * 2;
+  return static_cast<uint8_t>((words_[word] >> shift) & BITS_MASK);
+}
+
+void VisibilityMap::setBits(PageId page_id, uint8_t bits) {
+  if ((bits & ALL_VISIBLE) == 0) {
+    clear(page_id);
+    return;
+  }
+  size_t word = page_id / PAGES_PER_WORD;
+  if (word >= words_.size()) {
+    words_.resize(word + 1, 0);
+  }
+  uint64_t shift = (page_id % PAGES_PER_WORD) * 2;
+  words_[word] = (words_[word] & ~(BITS_MASK << shift)) | ((bits & BITS_MASK) << shift);
+}
+
+void VisibilityMap::clear(PageId page_id) noexcept {
+  size_t word = page_id / PAGES_PER_WORD;
+  if (word < words_.size()) {
+    words_[word] &= ~(BITS_MASK << ((page_id % PAGES_PER_WORD) * 2));
+  }
+}
+
+size_t VisibilityMap::countAllVisible() const noexcept {
+  return countBits(ALL_VISIBLE_BITS);
+}
+
+size_t VisibilityMap::countAllFrozen() const noexcept {
+  return countBits(ALL_VISIBLE_BITS << 1);
+}
+
+size_t VisibilityMap::countBits(uint64_t mask) const noexcept {
+  size_t count = 0;
+  for (uint64_t word : words_) {
+    count += static_cast<size_t>(std::popcount(word & mask));
+  }
+  return count;
+}
+
+}  // namespace database
@@ -0,0 +1,264 @@
+#include "database/write_ahead_log.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace database {
+
+namespace {
+
+static_assert(sizeof(WalRecordHeader) == 32, "WalRecordHeader must not contain padding");
+
+constexpr size_t CHECKSUM_START = offsetof(WalRecordHeader, txn_id);
+
+constexpr std::array<uint32_t, 256> makeCrcTable() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 1U) ? (crc >> 1) ^ 0xEDB88320U : crc >> 1;
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+constexpr std::array<uint32_t, 256> CRC_TABLE = makeCrcTable();
+
+uint32_t crc32(uint32_t crc, std::span<const std::byte> data) {
+  crc = ~crc;
+  for (std::byte b : data) {
+    crc = CRC_TABLE[(crc ^ std::to_integer<uint32_t>(b)) & 0xFFU] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+uint32_t recordChecksum(const WalRecordHeader& header, std::span<const std::byte> payload) {
+  auto header_bytes = std::as_bytes(std::span(&header, 1)).subspan(CHECKSUM_START);
+  return crc32(crc32(0, header_bytes), payload);
+}
+
+/**
+ * @brief Read a file from offset start to its end
+ */
+std::optional<std::vector<std::byte>> readFileFrom(int fd, size_t start) {
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < start) {
+    return std::nullopt;
+  }
+
+  std::vector<std::byte> data(static_cast<size_t>(st.st_size) - start);
+  size_t done = 0;
+  while (done < data.size()) {
+    ssize_t n = ::pread(fd, data.data() + done, data.size() - done, static_cast<off_t>(start + done));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return std::nullopt;
+    }
+    done += static_cast<size_t>(n);
+  }
+  return data;
+}
+
+/**
+ * @brief Walk the valid records at the start of a log image that begins at start_lsn
+ * @return Length of the valid prefix
+ */
+template <typename Visitor>
+size_t scanRecords(const std::vector<std::byte>& data, Lsn start_lsn, Visitor&& visit) {
+  size_t pos = 0;
+  while (data.size() - pos >= sizeof(WalRecordHeader)) {
+    WalRecordHeader header;
+    std::memcpy(&header, data.data() + pos, sizeof(header));
+    if (header.length < sizeof(header) || header.length > data.size() - pos) {
+      break;
+    }
+
+    std::span<const std::byte> payload(data.data() + pos + sizeof(header), header.length - sizeof(header));
+    if (recordChecksum(header, payload) != header.checksum) {
+      break;
+    }
+
+    pos += header.length;
+    visit(header, payload, start_lsn + pos);
+  }
+  return pos;
+}
+
+}  // namespace
+
+std::unique_ptr<WriteAheadLog> WriteAheadLog::open(const std::string& path, WalOptions options) {
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  // Cut off a record torn by a crash so new records follow the last good one
+  auto data = readFileFrom(fd, 0);
+  if (!data) {
+    ::close(fd);
+    return nullptr;
+  }
+  size_t valid = scanRecords(*data, 0, [](const WalRecordHeader&, std::span<const std::byte>, Lsn) {});
+  if (valid != data->size() && (::ftruncate(fd, static_cast<off_t>(valid)) != 0 || ::fdatasync(fd) != 0)) {
+    ::close(fd);
+    return nullptr;
+  }
+
+  return std::unique_ptr<WriteAheadLog>(new WriteAheadLog(fd, valid, options));
+}
+
+WriteAheadLog::WriteAheadLog(int fd, Lsn end_lsn, WalOptions options)
+    : fd_(fd),
+      options_(options),
+      buffer_start_lsn_(end_lsn),
+      current_lsn_(end_lsn),
+      flushed_lsn_(end_lsn) {
+  buffer_.reserve(options_.buffer_size);
+  write_buffer_.reserve(options_.buffer_size);
+}
+
+WriteAheadLog::~WriteAheadLog() {
+  flushAll();
+  ::close(fd_);
+}
+
+Lsn WriteAheadLog::append(WalRecordType type, TransactionId txn_id, TableId table_id, TupleId tuple_id,
+                          std::span<const std::byte> payload) {
+  WalRecordHeader header{};
+  header.length = static_cast<uint32_t>(sizeof(header) + payload.size());
+  header.txn_id = txn_id;
+  header.page_id = tuple_id.first;
+  header.table_id = table_id;
+  header.slot = tuple_id.second;
+  header.type = type;
+  header.checksum = recordChecksum(header, payload);  // Computed outside the lock
+
+  Lsn lsn = 0;
+  bool spill = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto header_bytes = std::as_bytes(std::span(&header, 1));
+    buffer_.insert(buffer_.end(), header_bytes.begin(), header_bytes.end());
+    buffer_.insert(buffer_.end(), payload.begin(), payload.end());
+    current_lsn_ += header.length;
+    lsn = current_lsn_;
+
+    if (type == WalRecordType::COMMIT && ++pending_commits_ >= options_.group_commit_size) {
+      commits_cv_.notify_one();
+    }
+    spill = buffer_.size() >= options_.buffer_size && !flush_in_progress_;
+  }
+
+  if (spill) {
+    flush(lsn);
+  }
+  return lsn;
+}
+
+bool WriteAheadLog::flush(Lsn lsn) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  lsn = std::min(lsn, current_lsn_);
+
+  while (flushed_lsn_ < lsn) {
+    if (failed_) {
+      return false;
+    }
+    if (flush_in_progress_) {
+      flushed_cv_.wait(lock);  // The running flush may already cover lsn
+      continue;
+    }
+
+    // Become the leader. Optionally give more committers a chance to join.
+    flush_in_progress_ = true;
+    if (options_.group_commit_delay.count() > 0 && pending_commits_ < options_.group_commit_size) {
+      commits_cv_.wait_for(lock, options_.group_commit_delay,
+                           [this] { return pending_commits_ >= options_.group_commit_size; });
+    }
+
+    buffer_.swap(write_buffer_);
+    Lsn start_lsn = buffer_start_lsn_;
+    Lsn end_lsn = current_lsn_;
+    buffer_start_lsn_ = end_lsn;
+    pending_commits_ = 0;
+
+    lock.unlock();
+    bool ok = writeAndSync(write_buffer_, start_lsn);
+    lock.lock();
+
+    write_buffer_.clear();
+    ++sync_count_;
+    flush_in_progress_ = false;
+    if (ok) {
+      flushed_lsn_ = end_lsn;
+    } else {
+      failed_ = true;
+    }
+    flushed_cv_.notify_all();
+  }
+
+  return true;
+}
+
+bool WriteAheadLog::flushAll() {
+  return flush(getCurrentLsn());
+}
+
+Lsn WriteAheadLog::getCurrentLsn() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return current_lsn_;
+}
+
+Lsn WriteAheadLog::getFlushedLsn() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return flushed_lsn_;
+}
+
+uint64_t WriteAheadLog::getSyncCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sync_count_;
+}
+
+std::optional<std::vector<WalRecord>> WriteAheadLog::readAll(const std::string& path, Lsn start_lsn) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+  auto data = readFileFrom(fd, start_lsn);
+  ::close(fd);
+  if (!data) {
+    return std::nullopt;
+  }
+
+  std::vector<WalRecord> records;
+  scanRecords(*data, start_lsn, [&records](const WalRecordHeader& header, std::span<const std::byte> payload, Lsn lsn) {
+    records.push_back(WalRecord{ header.type, header.txn_id, header.table_id,
+                                 std::make_pair(header.page_id, header.slot), lsn,
+                                 std::vector<std::byte>(payload.begin(), payload.end()) });
+  });
+  return records;
+}
+
+bool WriteAheadLog::writeAndSync(const std::vector<std::byte>& data, Lsn start_lsn) {
+  size_t done = 0;
+  while (done < data.size()) {
+    ssize_t n = ::pwrite(fd_, data.data() + done, data.size() - done, static_cast<off_t>(start_lsn + done));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    done += static_cast<size_t>(n);
+  }
+  return ::fdatasync(fd_) == 0;
+}
+
+}  // namespace database
@@ -0,0 +1,418 @@
+#include "database/btree_index.hpp"
+#include "database/heap_file.hpp"
+#include "database/schema.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+std::vector<database::Value> key(database::Value value)
+{
+  return { std::move(value) };
+}
+
+std::vector<database::TupleId> scanAll(const database::BTreeIndex& index, const std::vector<database::Value>& lower,
+                                       bool lower_inclusive, const std::vector<database::Value>& upper,
+                                       bool upper_inclusive)
+{
+  std::vector<database::TupleId> tuple_ids;
+  index.scan(lower, lower_inclusive, upper, upper_inclusive, [&tuple_ids](const database::TupleId& tuple_id) {
+    tuple_ids.push_back(tuple_id);
+    return true;
+  });
+  return tuple_ids;
+}
+
+}  // namespace
+
+class BTreeIndexTest : public ::testing::Test {
+protected:
+  void SetUp() override
+  {
+    schema_.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+    schema_.addColumn(database::Column(1, "amount", database::DataType::DOUBLE, false, false));
+    schema_.addColumn(database::Column(2, "name", database::DataType::TEXT, true, false));
+    schema_.addColumn(database::Column(3, "active", database::DataType::BOOLEAN, false, false));
+  }
+
+  database::Schema schema_;
+};
+
+TEST_F(BTreeIndexTest, CreatesPrimaryKeyIndexFromSchema)
+{
+  auto index = database::BTreeIndex::createPrimaryKey(schema_);
+  ASSERT_NE(index, nullptr);
+  EXPECT_TRUE(index->isUnique());
+  EXPECT_EQ(index->getColumns(), std::vector<database::ColumnId>{ 0 });
+
+  database::Schema no_key;
+  no_key.addColumn(database::Column(0, "value", database::DataType::INTEGER, false, false));
+  EXPECT_EQ(database::BTreeIndex::createPrimaryKey(no_key), nullptr);
+  EXPECT_EQ(database::BTreeIndex::create(schema_, { 7 }, false), nullptr);
+}
+
+TEST_F(BTreeIndexTest, FindsIntegerKeysAcrossSplits)
+{
+  auto index = database::BTreeIndex::createPrimaryKey(schema_);
+  constexpr int64_t COUNT = 50000;
+  std::vector<int64_t> keys;
+  for (int64_t i = 0; i < COUNT; ++i) {
+    keys.push_back(i * 2 - COUNT);  // Negative keys too
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  for (int64_t k : keys) {
+    ASSERT_TRUE(index->insert(key(k), { static_cast<database::PageId>(k + COUNT), 1 }));
+  }
+
+  EXPECT_EQ(index->size(), static_cast<size_t>(COUNT));
+  EXPECT_GE(index->getHeight(), 2U);
+  for (int64_t k : keys) {
+    auto found = index->find(key(k));
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->first, static_cast<database::PageId>(k + COUNT));
+  }
+  EXPECT_FALSE(index->find(key(int64_t{1})).has_value());  // Odd keys were never inserted
+  EXPECT_FALSE(index->find(key(int64_t{COUNT * 2})).has_value());
+}
+
+TEST_F(BTreeIndexTest, RejectsLiveDuplicatesAndReplacesDeadOnes)
+{
+  auto index = database::BTreeIndex::createPrimaryKey(schema_);
+  ASSERT_TRUE(index->insert(key(int64_t{5}), { 1, 0 }));
+  EXPECT_FALSE(index->insert(key(int64_t{5}), { 1, 1 }));
+  EXPECT_FALSE(index->insert(key(int64_t{5}), { 1, 1 }, [](const database::TupleId&) { return true; }));
+
+  // The first tuple's deletion committed: its entry is taken over
+  EXPECT_TRUE(index->insert(key(int64_t{5}), { 1, 1 }, [](const database::TupleId&) { return false; }));
+  EXPECT_EQ(index->find(key(int64_t{5})), (database::TupleId{ 1, 1 }));
+  EXPECT_EQ(index->size(), 1U);
+}
+
+TEST_F(BTreeIndexTest, RejectsNullAndMistypedKeys)
+{
+  auto index = database::BTreeIndex::createPrimaryKey(schema_);
+  EXPECT_FALSE(index->insert(key(nullptr), { 1, 0 }));
+  EXPECT_FALSE(index->insert(key(std::string("5")), { 1, 0 }));
+  EXPECT_FALSE(index->insert({}, { 1, 0 }));
+
+  auto text_index = database::BTreeIndex::create(schema_, { 2 }, true);
+  EXPECT_FALSE(text_index->insert(key(std::string(database::BTreeIndex::MAX_KEY_SIZE, 'x')), { 1, 0 }));
+  EXPECT_EQ(text_index->size(), 0U);
+}
+
+TEST_F(BTreeIndexTest, ScansRangesInKeyOrder)
+{
+  auto index = database::BTreeIndex::createPrimaryKey(schema_);
+  for (int64_t k = 1000; k > 0; --k) {
+    ASSERT_TRUE(index->insert(key(k), { static_cast<database::PageId>(k), 0 }));
+  }
+
+  auto inclusive = scanAll(*index, key(int64_t{10}), true, key(int64_t{20}), true);
+  ASSERT_EQ(inclusive.size(), 11U);
+  EXPECT_EQ(inclusive.front().first, 10U);
+  EXPECT_EQ(inclusive.back().first, 20U);
+  EXPECT_TRUE(std::is_sorted(inclusive.begin(), inclusive.end()));
+
+  auto exclusive = scanAll(*index, key(int64_t{10}), false, key(int64_t{20}), false);
+  ASSERT_EQ(exclusive.size(), 9U);
+  EXPECT_EQ(exclusive.front().first, 11U);
+
+  EXPECT_EQ(scanAll(*index, {}, true, key(int64_t{3}), true).size(), 3U);
+  EXPECT_EQ(scanAll(*index, key(int64_t{998}), true, {}, true).size(), 3U);
+  EXPECT_EQ(scanAll(*index, {}, true, {}, true).size(), 1000U);
+
+  size_t visited = index->scan({}, true, {}, true, [](const database::TupleId& tuple_id) { return tuple_id.first < 5; });
+  EXPECT_EQ(visited, 5U);
+}
+
+TEST_F(BTreeIndexTest, OrdersDoubleBooleanAndTextKeys)
+{
+  auto doubles = database::BTreeIndex::create(schema_, { 1 }, true);
+  std::vector<double> values = { 2.5, -1.0, 0.0, -std::numeric_limits<double>::infinity(), 1e300, -1e-300, 3.0 };
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_TRUE(doubles->insert(key(values[i]), { i + 1, 0 }));
+  }
+  EXPECT_FALSE(doubles->insert(key(-0.0), { 99, 0 }));  // -0 equals 0
+  std::vector<double> scanned;
+  doubles->scan({}, true, {}, true, [&](const database::TupleId& tuple_id) {
+    scanned.push_back(values[tuple_id.first - 1]);
+    return true;
+  });
+  EXPECT_TRUE(std::is_sorted(scanned.begin(), scanned.end()));
+  EXPECT_EQ(scanned.size(), values.size());
+
+  auto booleans = database::BTreeIndex::create(schema_, { 3 }, false);
+  ASSERT_TRUE(booleans->insert(key(true), { 1, 0 }));
+  ASSERT_TRUE(booleans->insert(key(false), { 2, 0 }));
+  ASSERT_TRUE(booleans->insert(key(true), { 3, 0 }));
+  EXPECT_EQ(scanAll(*booleans, key(true), true, key(true), true), (std::vector<database::TupleId>{ { 1, 0 }, { 3, 0 } }));
+  EXPECT_EQ(booleans->find(key(false)), (database::TupleId{ 2, 0 }));
+
+  // Prefixes, embedded zero bytes and long shared prefixes sort bytewise
+  auto texts = database::BTreeIndex::create(schema_, { 2 }, true);
+  std::vector<std::string> strings = { "b", "a", "ab", std::string("a\0", 2), "", std::string(300, 'p') + "2",
+                                       std::string(300, 'p') + "1", "abc" };
+  for (size_t i = 0; i < strings.size(); ++i) {
+    ASSERT_TRUE(texts->insert(key(strings[i]), { i + 1, 0 }));
+  }
+  std::vector<std::string> sorted_strings;
+  texts->scan({}, true, {}, true, [&](const database::TupleId& tuple_id) {
+    sorted_strings.push_back(strings[tuple_id.first - 1]);
+    return true;
+  });
+  std::vector<std::string> expected = strings;
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(sorted_strings, expected);
+  EXPECT_EQ(texts->find(key(std::string("a\0", 2))), (database::TupleId{ 4, 0 }));
+  EXPECT_FALSE(texts->find(key(std::string("a\0\0", 3))).has_value());
+}
+
+TEST_F(BTreeIndexTest, NonUniqueIndexKeepsEveryTupleOfAKey)
+{
+  auto index = database::BTreeIndex::create(schema_, { 2 }, false);
+  for (uint16_t slot = 0; slot < 2000; ++slot) {
+    std::string name = "customer-" + std::to_string(slot % 10);
+    ASSERT_TRUE(index->insert(key(name), { 1 + slot / 100U, slot }));
+  }
+  EXPECT_FALSE(index->insert(key(std::string("customer-0")), { 1, 0 }));  // The same entry again
+
+  auto tuple_ids = scanAll(*index, key(std::string("customer-3")), true, key(std::string("customer-3")), true);
+  ASSERT_EQ(tuple_ids.size(), 200U);
+  EXPECT_TRUE(std::is_sorted(tuple_ids.begin(), tuple_ids.end()));
+  EXPECT_TRUE(std::all_of(tuple_ids.begin(), tuple_ids.end(), [](const auto& t) { return t.second % 10 == 3; }));
+
+  EXPECT_TRUE(index->remove(key(std::string("customer-3")), { 1, 3 }));
+  EXPECT_FALSE(index->remove(key(std::string("customer-3")), { 1, 3 }));
+  EXPECT_FALSE(index->remove(key(std::string("customer-4")), { 1, 3 }));
+  EXPECT_EQ(index->find(key(std::string("customer-3"))), (database::TupleId{ 1, 13 }));
+  EXPECT_EQ(index->size(), 1999U);
+}
+
+TEST_F(BTreeIndexTest, CompositeKeysScanByLeadingColumn)
+{
+  auto index = database::BTreeIndex::create(schema_, { 3, 0 }, true);
+  for (int64_t id = 0; id < 100; ++id) {
+    std::vector<database::Value> values = { database::Value{ id % 2 == 0 }, database::Value{ id } };
+    ASSERT_TRUE(index->insert(values, { static_cast<database::PageId>(id + 1), 0 }));
+  }
+  auto even = scanAll(*index, key(true), true, key(true), true);
+  ASSERT_EQ(even.size(), 50U);
+  EXPECT_EQ(even.front().first, 1U);
+  EXPECT_EQ(scanAll(*index, key(false), false, {}, true).size(), 50U);
+  EXPECT_FALSE(index->find(key(true)).has_value());  // Needs the whole key
+}
+
+TEST_F(BTreeIndexTest, RemovedKeysCanBeInsertedAgain)
+{
+  auto index = database::BTreeIndex::createPrimaryKey(schema_);
+  for (int64_t k = 0; k < 20000; ++k) {
+    ASSERT_TRUE(index->insert(key(k), { static_cast<database::PageId>(k + 1), 0 }));
+  }
+  for (int64_t k = 0; k < 20000; k += 2) {
+    ASSERT_TRUE(index->remove(key(k), { static_cast<database::PageId>(k + 1), 0 }));
+  }
+  EXPECT_FALSE(index->remove(key(int64_t{1}), { 99, 0 }));  // Key matches, tuple does not
+  EXPECT_EQ(index->size(), 10000U);
+  EXPECT_FALSE(index->find(key(int64_t{4})).has_value());
+  EXPECT_EQ(scanAll(*index, key(int64_t{0}), true, key(int64_t{9}), true).size(), 5U);
+
+  size_t nodes = index->getNodeCount();
+  for (int64_t k = 0; k < 20000; k += 2) {
+    ASSERT_TRUE(index->insert(key(k), { static_cast<database::PageId>(k + 1), 1 }));
+  }
+  EXPECT_EQ(index->getNodeCount(), nodes);  // Reuses the space of removed entries
+  EXPECT_EQ(index->find(key(int64_t{4})), (database::TupleId{ 5, 1 }));
+}
+
+TEST_F(BTreeIndexTest, MatchesOrderedMapUnderRandomChanges)
+{
+  auto index = database::BTreeIndex::create(schema_, { 2 }, true);
+  std::map<std::string, database::TupleId> expected;
+  std::mt19937 rng(7);
+  for (uint16_t i = 0; i < 20000; ++i) {
+    // Long keys with shared prefixes make few entries fit a node and separators matter
+    std::string name = std::string(rng() % 400, 'k') + std::to_string(rng() % 5000);
+    database::TupleId tuple_id{ 1, i };
+    if (rng() % 4 == 0 && !expected.empty()) {
+      auto it = expected.lower_bound(name);
+      if (it == expected.end()) {
+        it = expected.begin();
+      }
+      ASSERT_TRUE(index->remove(key(it->first), it->second));
+      expected.erase(it);
+    } else {
+      ASSERT_EQ(index->insert(key(name), tuple_id), expected.emplace(name, tuple_id).second);
+    }
+  }
+
+  std::vector<database::TupleId> expected_ids;
+  for (const auto& [name, tuple_id] : expected) {
+    expected_ids.push_back(tuple_id);
+  }
+  EXPECT_EQ(scanAll(*index, {}, true, {}, true), expected_ids);
+  EXPECT_EQ(index->size(), expected.size());
+  EXPECT_GE(index->getHeight(), 3U);
+}
+
+TEST_F(BTreeIndexTest, IndexesHeapTuplesByPrimaryKey)
+{
+  database::HeapFile heap_file(1, schema_);
+  auto index = database::BTreeIndex::createPrimaryKey(schema_);
+  for (int64_t id = 0; id < 1000; ++id) {
+    std::vector<database::Value> values = { database::Value{ id }, database::Value{ 0.5 },
+                                            database::Value{ "name-" + std::to_string(id) }, database::Value{ true } };
+    auto tuple_id = heap_file.insertTuple(database::Tuple(schema_, values, 1), 1);
+    ASSERT_NE(tuple_id, nullptr);
+    auto tuple = heap_file.getTuple(*tuple_id);
+    ASSERT_TRUE(tuple.has_value());
+    ASSERT_TRUE(index->insert(*tuple, *tuple_id));
+  }
+
+  auto tuple_id = index->find(key(int64_t{777}));
+  ASSERT_TRUE(tuple_id.has_value());
+  auto tuple = heap_file.getTuple(*tuple_id);
+  ASSERT_TRUE(tuple.has_value());
+  EXPECT_EQ(tuple->getText(2), "name-777");
+}
+
+TEST_F(BTreeIndexTest, AscendingInsertsFillLeaves)
+{
+  auto index = database::BTreeIndex::createPrimaryKey(schema_);
+  constexpr int64_t COUNT = 100000;
+  for (int64_t k = 0; k < COUNT; ++k) {
+    ASSERT_TRUE(index->insert(key(k), { 1, 0 }));
+  }
+  // 8-byte keys take 32 bytes per entry, so a full node holds 254 of them
+  size_t full_leaves = static_cast<size_t>(COUNT) / 254 + 1;
+  EXPECT_LE(index->getNodeCount(), full_leaves + full_leaves / 50 + 2);
+  EXPECT_EQ(index->getHeight(), 3U);
+}
+
+TEST_F(BTreeIndexTest, ConcurrentInsertsAndLookups)
+{
+  auto index = database::BTreeIndex::createPrimaryKey(schema_);
+  constexpr int64_t PRELOADED = 10000;
+  constexpr int64_t PER_WRITER = 20000;
+  constexpr int64_t WRITERS = 4;
+  for (int64_t k = 0; k < PRELOADED; ++k) {
+    ASSERT_TRUE(index->insert(key(k * WRITERS * 2), { static_cast<database::PageId>(k + 1), 0 }));
+  }
+
+  // Writers fill in keys between the preloaded ones while readers look the preloaded ones up
+  std::atomic<bool> writing{ true };
+  std::atomic<int64_t> missed{ 0 };
+  std::vector<std::thread> readers;
+  for (int64_t r = 0; r < 4; ++r) {
+    readers.emplace_back([&, r] {
+      std::mt19937_64 rng(static_cast<uint64_t>(r));
+      while (writing.load()) {
+        auto k = static_cast<int64_t>(rng() % PRELOADED);
+        auto found = index->find(key(k * WRITERS * 2));
+        if (!found || found->first != static_cast<database::PageId>(k + 1)) {
+          ++missed;
+        }
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  for (int64_t w = 0; w < WRITERS; ++w) {
+    writers.emplace_back([&, w] {
+      for (int64_t i = 0; i < PER_WRITER; ++i) {
+        int64_t k = i * WRITERS * 2 + w * 2 + 1;
+        if (!index->insert(key(k), { 1, static_cast<uint16_t>(w) })) {
+          ++missed;
+        }
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  writing.store(false);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(missed.load(), 0);
+  EXPECT_EQ(index->size(), static_cast<size_t>(PRELOADED + WRITERS * PER_WRITER));
+  std::vector<int64_t> keys;
+  index->scan({}, true, {}, true, [&keys](const database::TupleId& tuple_id) {
+    keys.push_back(static_cast<int64_t>(tuple_id.first));
+    return true;
+  });
+  EXPECT_EQ(keys.size(), index->size());
+  for (int64_t w = 0; w < WRITERS; ++w) {
+    EXPECT_EQ(index->find(key(int64_t{ (PER_WRITER - 1) * WRITERS * 2 + w * 2 + 1 })), (database::TupleId{ 1, w }));
+  }
+}
+
+TEST_F(BTreeIndexTest, ConcurrentDuplicateInsertsAdmitOneEntry)
+{
+  auto index = database::BTreeIndex::createPrimaryKey(schema_);
+  constexpr int64_t KEYS = 20000;
+  std::atomic<int64_t> inserted{ 0 };
+  std::vector<std::thread> threads;
+  for (uint16_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (int64_t k = 0; k < KEYS; ++k) {
+        if (index->insert(key(k), { 1, t })) {
+          ++inserted;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(inserted.load(), KEYS);
+  EXPECT_EQ(index->size(), static_cast<size_t>(KEYS));
+}
+
+TEST_F(BTreeIndexTest, ScansStaySortedDuringInserts)
+{
+  auto index = database::BTreeIndex::create(schema_, { 2 }, false);
+  std::vector<std::string> names;
+  std::mt19937 rng(3);
+  for (size_t i = 0; i < 30000; ++i) {
+    names.push_back("name-" + std::to_string(rng() % 100000));
+  }
+  std::atomic<bool> writing{ true };
+  std::thread writer([&] {
+    for (uint16_t i = 0; i < names.size(); ++i) {
+      index->insert(key(names[i]), { 1, i });
+    }
+    writing.store(false);
+  });
+
+  // A scan sees each entry at most once and in key order, whatever splits happen under it
+  auto in_order = [&names](const database::TupleId& a, const database::TupleId& b) {
+    return std::tie(names[a.second], a) < std::tie(names[b.second], b);
+  };
+  size_t scans = 0;
+  bool sorted = true;
+  while (writing.load() || scans == 0) {
+    std::vector<database::TupleId> tuple_ids = scanAll(*index, {}, true, {}, true);
+    sorted = sorted && std::adjacent_find(tuple_ids.begin(), tuple_ids.end(), [&](const auto& a, const auto& b) {
+      return !in_order(a, b);
+    }) == tuple_ids.end();
+    ++scans;
+  }
+  writer.join();
+  EXPECT_TRUE(sorted);
+  EXPECT_EQ(scanAll(*index, {}, true, {}, true).size(), index->size());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
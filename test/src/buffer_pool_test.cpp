@@ -0,0 +1,314 @@
+#include "database/buffer_pool.hpp"
+#include "database/segment_file.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 4096;
+
+class BufferPoolTest : public ::testing::Test {
+protected:
+  void SetUp() override
+  {
+    path_ = ::testing::TempDir() + "buffer_pool_test.heap";
+    std::remove(path_.c_str());
+    segment_ = database::SegmentFile::open(path_, PAGE_SIZE);
+    ASSERT_NE(segment_, nullptr);
+  }
+  
+  void TearDown() override
+  {
+    segment_.reset();
+    std::remove(path_.c_str());
+  }
+  
+  // Write empty pages 1..count to disk and start from a cold, zeroed pool
+  void writePages(database::BufferPool& pool, database::PageId count)
+  {
+    for (database::PageId page_id = 1; page_id <= count; ++page_id) {
+      auto page = pool.newPage(*segment_, page_id);
+      ASSERT_TRUE(page);
+    }
+    ASSERT_TRUE(pool.flushFile(*segment_));
+    pool.discardFile(*segment_);
+    pool.resetStats();
+  }
+  
+  std::string path_;
+  std::unique_ptr<database::SegmentFile> segment_;
+};
+
+}  // namespace
+
+TEST_F(BufferPoolTest, NewPageIsEmptyAndWrittenOnFlush)
+{
+  database::BufferPool pool(4, PAGE_SIZE);
+  {
+    auto page = pool.newPage(*segment_, 1);
+    ASSERT_TRUE(page);
+    EXPECT_EQ(page->getPageId(), 1);
+    EXPECT_EQ(page->getSlotCount(), 0);
+  }
+  EXPECT_EQ(segment_->getPageCount(), 0);
+  
+  ASSERT_TRUE(pool.flushFile(*segment_));
+  EXPECT_EQ(segment_->getPageCount(), 1);
+  EXPECT_EQ(pool.getStats().writes, 1);
+}
+
+TEST_F(BufferPoolTest, CountsHitsAndMisses)
+{
+  database::BufferPool pool(4, PAGE_SIZE);
+  writePages(pool, 2);
+  
+  EXPECT_TRUE(pool.fetchPage(*segment_, 1));
+  EXPECT_TRUE(pool.fetchPage(*segment_, 1));
+  EXPECT_TRUE(pool.fetchPage(*segment_, 2));
+  
+  auto stats = pool.getStats();
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_DOUBLE_EQ(stats.getHitRate(), 1.0 / 3.0);
+}
+
+TEST_F(BufferPoolTest, FetchFailsForMissingOrCorruptPage)
+{
+  std::string garbage(PAGE_SIZE, '\x7f');
+  for (auto type : {database::IoEngineType::PREAD, database::IoEngineType::AUTO}) {
+    database::BufferPool pool(4, PAGE_SIZE, type);
+    EXPECT_FALSE(pool.fetchPage(*segment_, 2));
+    
+    ASSERT_TRUE(segment_->writePage(1, reinterpret_cast<const std::byte*>(garbage.data())));
+    EXPECT_FALSE(pool.fetchPage(*segment_, 1));
+    
+    // The failed reads gave their frames back
+    for (database::PageId page_id = 3; page_id <= 6; ++page_id) {
+      EXPECT_TRUE(pool.newPage(*segment_, page_id));
+    }
+  }
+}
+
+TEST_F(BufferPoolTest, EvictsUnpinnedPagesAndWritesBackDirtyOnes)
+{
+  database::BufferPool pool(2, PAGE_SIZE);
+  writePages(pool, 3);
+  
+  {
+    auto page = pool.fetchPage(*segment_, 1);
+    ASSERT_TRUE(page);
+    std::string bytes(64, 'x');
+    ASSERT_TRUE(page->addTupleBytes(std::as_bytes(std::span(bytes))).has_value());
+    page.markDirty();
+  }
+  EXPECT_TRUE(pool.fetchPage(*segment_, 2));
+  EXPECT_TRUE(pool.fetchPage(*segment_, 3));  // Forces an eviction
+  EXPECT_GE(pool.getStats().evictions, 1);
+  
+  // Page 1 was evicted at some point or is still cached; either way it is intact
+  for (database::PageId page_id = 2; page_id <= 3; ++page_id) {
+    EXPECT_TRUE(pool.fetchPage(*segment_, page_id));
+  }
+  auto page = pool.fetchPage(*segment_, 1);
+  ASSERT_TRUE(page);
+  EXPECT_EQ(page->getSlotCount(), 1);
+}
+
+TEST_F(BufferPoolTest, FlushDirtyPagesWritesInRoundsAndWaitsForPins)
+{
+  database::BufferPool pool(8, PAGE_SIZE);
+  auto pinned = pool.newPage(*segment_, 1);
+  ASSERT_TRUE(pinned);
+  for (database::PageId page_id = 2; page_id <= 5; ++page_id) {
+    ASSERT_TRUE(pool.newPage(*segment_, page_id));
+  }
+  
+  std::vector<size_t> rounds;
+  bool ok = pool.flushDirtyPages(2, [&](size_t written) {
+    rounds.push_back(written);
+    if (rounds.size() == 3) {
+      pinned.release();  // The pinned page is written once its pin is gone
+    }
+    return true;
+  });
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(rounds, (std::vector<size_t>{ 2, 2, 0 }));
+  EXPECT_EQ(pool.getStats().writes, 5);
+  EXPECT_EQ(segment_->getPageCount(), 5);
+  
+  // Nothing is dirty any more, and a throttle that gives up fails the flush
+  EXPECT_TRUE(pool.flushDirtyPages(2, [](size_t) { return false; }));
+  auto page = pool.fetchPage(*segment_, 1);
+  page.markDirty();
+  EXPECT_FALSE(pool.flushDirtyPages(2, [](size_t) { return false; }));
+}
+
+TEST_F(BufferPoolTest, PinnedPagesAreNeverEvicted)
+{
+  database::BufferPool pool(2, PAGE_SIZE);
+  writePages(pool, 3);
+  
+  auto page1 = pool.fetchPage(*segment_, 1);
+  auto page2 = pool.fetchPage(*segment_, 2);
+  ASSERT_TRUE(page1);
+  ASSERT_TRUE(page2);
+  EXPECT_FALSE(pool.fetchPage(*segment_, 3));  // Every frame is pinned
+  
+  page2.release();
+  auto page3 = pool.fetchPage(*segment_, 3);
+  ASSERT_TRUE(page3);
+  EXPECT_EQ(page1->getPageId(), 1);
+  EXPECT_EQ(page3->getPageId(), 3);
+}
+
+TEST_F(BufferPoolTest, ClockKeepsFrequentlyUsedPages)
+{
+  database::BufferPool pool(4, PAGE_SIZE);
+  writePages(pool, 20);
+  
+  // Page 1 is hot; pages 2..20 are each touched once
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(pool.fetchPage(*segment_, 1));
+  }
+  for (database::PageId page_id = 2; page_id <= 20; ++page_id) {
+    EXPECT_TRUE(pool.fetchPage(*segment_, page_id));
+    EXPECT_TRUE(pool.fetchPage(*segment_, 1));
+  }
+  
+  auto stats = pool.getStats();
+  EXPECT_EQ(stats.misses, 20);  // Page 1 missed only once
+}
+
+TEST_F(BufferPoolTest, MovedGuardKeepsPin)
+{
+  database::BufferPool pool(1, PAGE_SIZE);
+  writePages(pool, 2);
+  
+  database::PageGuard outer;
+  {
+    auto page = pool.fetchPage(*segment_, 1);
+    outer = std::move(page);
+  }
+  EXPECT_FALSE(pool.fetchPage(*segment_, 2));
+  outer.release();
+  EXPECT_TRUE(pool.fetchPage(*segment_, 2));
+}
+
+TEST_F(BufferPoolTest, PrefetchedPagesAreHitsOnFetch)
+{
+  for (auto type : {database::IoEngineType::PREAD, database::IoEngineType::AUTO}) {
+    database::BufferPool pool(16, PAGE_SIZE, type);
+    writePages(pool, 4);
+    
+    EXPECT_EQ(pool.prefetchPages(*segment_, 1, 4), 4);
+    for (database::PageId page_id = 1; page_id <= 4; ++page_id) {
+      auto page = pool.fetchPage(*segment_, page_id);
+      ASSERT_TRUE(page);
+      EXPECT_EQ(page->getPageId(), page_id);
+    }
+    
+    auto stats = pool.getStats();
+    EXPECT_EQ(stats.prefetches, 4);
+    EXPECT_EQ(stats.hits, 4);
+    EXPECT_EQ(stats.misses, 0);
+    pool.discardFile(*segment_);
+  }
+}
+
+TEST_F(BufferPoolTest, PrefetchSkipsCachedAndMissingPagesAndIsBounded)
+{
+  // The pread engine finishes reads on submit, so earlier prefetches never count against the limit
+  database::BufferPool pool(16, PAGE_SIZE, database::IoEngineType::PREAD);
+  writePages(pool, 12);
+  
+  EXPECT_TRUE(pool.fetchPage(*segment_, 2));
+  EXPECT_EQ(pool.prefetchPages(*segment_, 1, 3), 3);   // Page 2 is cached
+  EXPECT_EQ(pool.prefetchPages(*segment_, 11, 4), 2);  // Stops at the end of the file
+  EXPECT_EQ(pool.prefetchPages(*segment_, 4, 7), 4);   // At most a quarter of the frames at once
+  EXPECT_EQ(pool.getStats().prefetches, 8);
+  
+  // A prefetched page that fails to load is read (and rejected) again on fetch
+  std::vector<std::byte> garbage(PAGE_SIZE, std::byte{0x5A});
+  ASSERT_TRUE(segment_->writePage(12, garbage.data()));
+  database::BufferPool cold(16, PAGE_SIZE);
+  EXPECT_EQ(cold.prefetchPages(*segment_, 11, 2), 2);
+  EXPECT_FALSE(cold.fetchPage(*segment_, 12));
+  EXPECT_TRUE(cold.fetchPage(*segment_, 11));
+}
+
+TEST_F(BufferPoolTest, FlushDirtyPagesWorksWithEitherEngine)
+{
+  for (auto type : {database::IoEngineType::PREAD, database::IoEngineType::AUTO}) {
+    database::BufferPool pool(16, PAGE_SIZE, type);
+    for (database::PageId page_id = 1; page_id <= 10; ++page_id) {
+      ASSERT_TRUE(pool.newPage(*segment_, page_id));
+    }
+    
+    ASSERT_TRUE(pool.flushDirtyPages(4, [](size_t) { return true; }));
+    EXPECT_EQ(pool.getStats().writes, 10);
+    EXPECT_EQ(segment_->getPageCount(), 10);
+    
+    pool.discardFile(*segment_);
+    auto page = pool.fetchPage(*segment_, 10);
+    ASSERT_TRUE(page);
+    EXPECT_EQ(page->getPageId(), 10);
+  }
+}
+
+TEST_F(BufferPoolTest, ConcurrentMissesAndEvictionsKeepEveryChange)
+{
+  // Each thread changes its own pages; the pool is too small to hold them,
+  // so fetches miss and evict dirty pages while other threads do the same
+  constexpr size_t THREADS = 4;
+  constexpr database::PageId PAGES = 32;
+  constexpr size_t ROUNDS = 5;
+  for (auto type : {database::IoEngineType::PREAD, database::IoEngineType::AUTO}) {
+    database::BufferPool pool(8, PAGE_SIZE, type);
+    writePages(pool, PAGES);
+    for (database::PageId page_id = 1; page_id <= PAGES; ++page_id) {
+      ASSERT_EQ(pool.fetchPage(*segment_, page_id)->getSlotCount(), 0);
+    }
+    
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; ++t) {
+      threads.emplace_back([&pool, this, t] {
+        std::string bytes(16, static_cast<char>('a' + t));
+        for (size_t round = 0; round < ROUNDS; ++round) {
+          for (database::PageId page_id = t + 1; page_id <= PAGES; page_id += THREADS) {
+            auto page = pool.fetchPage(*segment_, page_id);
+            ASSERT_TRUE(page);
+            ASSERT_EQ(page->getPageId(), page_id);
+            ASSERT_TRUE(page->addTupleBytes(std::as_bytes(std::span(bytes))).has_value());
+            page.markDirty();
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_GT(pool.getStats().evictions, 0);
+    
+    ASSERT_TRUE(pool.flushFile(*segment_));
+    pool.discardFile(*segment_);
+    for (database::PageId page_id = 1; page_id <= PAGES; ++page_id) {
+      auto page = pool.fetchPage(*segment_, page_id);
+      ASSERT_TRUE(page);
+      EXPECT_EQ(page->getSlotCount(), ROUNDS);
+      page.release();
+      ASSERT_TRUE(pool.newPage(*segment_, page_id));  // Empty again for the next engine
+    }
+    ASSERT_TRUE(pool.flushFile(*segment_));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
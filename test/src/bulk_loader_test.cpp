@@ -0,0 +1,415 @@
+#include "database/bulk_loader.hpp"
+#include "database/buffer_pool.hpp"
+#include "database/heap_file.hpp"
+#include "database/heap_scan.hpp"
+#include "database/schema.hpp"
+#include "database/transaction_manager.hpp"
+#include "database/visibility_checker.hpp"
+
+#include <gtest/gtest.h>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+namespace {
+
+void makeSchema(database::Schema& schema)
+{
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  schema.addColumn(database::Column(2, "score", database::DataType::DOUBLE, true, false));
+  schema.addColumn(database::Column(3, "active", database::DataType::BOOLEAN, true, false));
+}
+
+std::vector<database::Tuple> scanAll(const database::HeapFile& heap_file)
+{
+  std::vector<database::Tuple> tuples;
+  database::HeapScan scan(heap_file);
+  while (auto scanned = scan.next()) {
+    tuples.emplace_back(scanned->tuple);
+  }
+  return tuples;
+}
+
+std::string makeCsv(int64_t rows)
+{
+  std::string csv;
+  for (int64_t i = 0; i < rows; ++i) {
+    csv += std::to_string(i) + ",name" + std::to_string(i) + "," + std::to_string(i) + ".5," + (i % 2 ? "true" : "f") + "\n";
+  }
+  return csv;
+}
+
+}  // namespace
+
+TEST(BulkLoaderTest, LoadsCsvRows)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  database::BulkLoader loader(heap_file);
+  
+  auto result = loader.loadCsvData("1,alice,1.5,true\n2,bob,-2,0\n", 100);
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_EQ(result.rows_loaded, 2);
+  
+  auto tuples = scanAll(heap_file);
+  ASSERT_EQ(tuples.size(), 2);
+  EXPECT_EQ(std::get<int64_t>(*tuples[0].getValue(0)), 1);
+  EXPECT_EQ(std::get<std::string>(*tuples[0].getValue(1)), "alice");
+  EXPECT_DOUBLE_EQ(std::get<double>(*tuples[0].getValue(2)), 1.5);
+  EXPECT_TRUE(std::get<bool>(*tuples[0].getValue(3)));
+  EXPECT_EQ(std::get<std::string>(*tuples[1].getValue(1)), "bob");
+  EXPECT_FALSE(std::get<bool>(*tuples[1].getValue(3)));
+  EXPECT_EQ(tuples[1].getHeader().getXmin(), 100);
+}
+
+TEST(BulkLoaderTest, HandlesQuotesNullsHeaderAndCrlf)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  database::BulkLoadOptions options;
+  options.has_header = true;
+  database::BulkLoader loader(heap_file, options);
+  
+  auto result = loader.loadCsvData("id,name,score,active\r\n1,\"say \"\"hi\"\", ok\",,\r\n2,\"\",3,T\r\n", 1);
+  ASSERT_TRUE(result.success) << result.error_message;
+  
+  auto tuples = scanAll(heap_file);
+  ASSERT_EQ(tuples.size(), 2);
+  EXPECT_EQ(std::get<std::string>(*tuples[0].getValue(1)), "say \"hi\", ok");
+  EXPECT_TRUE(std::holds_alternative<std::nullptr_t>(*tuples[0].getValue(2)));
+  EXPECT_TRUE(std::holds_alternative<std::nullptr_t>(*tuples[0].getValue(3)));
+  EXPECT_EQ(std::get<std::string>(*tuples[1].getValue(1)), "");
+  EXPECT_TRUE(std::get<bool>(*tuples[1].getValue(3)));
+}
+
+TEST(BulkLoaderTest, CustomDelimiter)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  database::BulkLoadOptions options;
+  options.delimiter = '|';
+  database::BulkLoader loader(heap_file, options);
+  
+  auto result = loader.loadCsvData("1|a,b|2|false", 1);
+  ASSERT_TRUE(result.success) << result.error_message;
+  auto tuples = scanAll(heap_file);
+  ASSERT_EQ(tuples.size(), 1);
+  EXPECT_EQ(std::get<std::string>(*tuples[0].getValue(1)), "a,b");
+}
+
+TEST(BulkLoaderTest, ErrorsReportLineAndLoadNothing)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  database::BulkLoader loader(heap_file);
+  
+  auto bad_number = loader.loadCsvData("1,a,1,t\n2,b,x,t\n", 1);
+  EXPECT_FALSE(bad_number.success);
+  EXPECT_EQ(bad_number.error_line, 2);
+  
+  auto missing_id = loader.loadCsvData("1,a,1,t\n\n,b,1,t\n", 1);
+  EXPECT_FALSE(missing_id.success);
+  EXPECT_EQ(missing_id.error_line, 3);
+  
+  EXPECT_FALSE(loader.loadCsvData("1,a,1\n", 1).success);
+  EXPECT_FALSE(loader.loadCsvData("1,a,1,t,extra\n", 1).success);
+  EXPECT_FALSE(loader.loadCsvData("1,\"open,1,t\n", 1).success);
+  
+  EXPECT_EQ(heap_file.getPageCount(), 0);
+}
+
+TEST(BulkLoaderTest, ParallelChunksKeepInputOrder)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  database::BulkLoadOptions options;
+  options.thread_count = 4;
+  options.min_chunk_size = 1024;
+  database::BulkLoader loader(heap_file, options);
+  
+  auto result = loader.loadCsvData(makeCsv(5000), 1);
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_EQ(result.rows_loaded, 5000);
+  
+  database::HeapScan scan(heap_file);
+  int64_t expected = 0;
+  while (auto scanned = scan.next()) {
+    EXPECT_EQ(scanned->tuple.getInteger(0), expected++);
+  }
+  EXPECT_EQ(expected, 5000);
+  
+  // Loaded pages take part in regular inserts afterwards
+  database::Tuple tuple(schema, {database::Value{int64_t{-1}}, database::Value{nullptr},
+                                 database::Value{nullptr}, database::Value{nullptr}}, 2);
+  EXPECT_NE(heap_file.insertTuple(tuple, 2), nullptr);
+}
+
+TEST(BulkLoaderTest, ParallelErrorLineIsGlobal)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  database::BulkLoadOptions options;
+  options.thread_count = 4;
+  options.min_chunk_size = 1024;
+  database::BulkLoader loader(heap_file, options);
+  
+  std::string csv = makeCsv(3000) + "oops,a,1,t\n" + makeCsv(10);
+  auto result = loader.loadCsvData(csv, 1);
+  EXPECT_FALSE(result.success);
+  EXPECT_EQ(result.error_line, 3001);
+  EXPECT_EQ(heap_file.getPageCount(), 0);
+}
+
+TEST(BulkLoaderTest, FailedParallelLoadKeepsEarlierRows)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  ASSERT_TRUE(database::BulkLoader(heap_file).loadCsvData(makeCsv(100), 1).success);
+  size_t pages = heap_file.getPageCount();
+  
+  // The chunks before the bad row are appended before it is found
+  database::BulkLoadOptions options;
+  options.thread_count = 4;
+  options.min_chunk_size = 1024;
+  database::BulkLoader loader(heap_file, options);
+  auto result = loader.loadCsvData(makeCsv(3000) + "oops,a,1,t\n", 2);
+  EXPECT_FALSE(result.success);
+  EXPECT_EQ(result.error_line, 3001);
+  EXPECT_EQ(heap_file.getPageCount(), pages);
+  EXPECT_EQ(scanAll(heap_file).size(), 100);
+  
+  result = loader.loadCsvData(makeCsv(3000), 3);
+  ASSERT_TRUE(result.success) << result.error_message;
+  auto tuples = scanAll(heap_file);
+  ASSERT_EQ(tuples.size(), 3100);
+  EXPECT_EQ(tuples.back().getHeader().getXmin(), 3);
+}
+
+TEST(BulkLoaderTest, LoadsCsvFile)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  database::BulkLoader loader(heap_file);
+  
+  std::string path = ::testing::TempDir() + "bulk_loader_test.csv";
+  {
+    std::ofstream out(path);
+    out << makeCsv(100);
+  }
+  auto result = loader.loadCsv(path, 1);
+  std::remove(path.c_str());
+  
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_EQ(result.rows_loaded, 100);
+  EXPECT_FALSE(loader.loadCsv(path, 1).success);
+}
+
+TEST(BulkLoaderTest, BinaryRoundTrip)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+  database::HeapFile source(1, schema);
+  database::BulkLoader source_loader(source);
+  auto loader_txn = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  ASSERT_TRUE(source_loader.loadCsvData("1,alice,1.5,true\n2,,,\n3,carol,3,f\n", loader_txn).success);
+  ASSERT_TRUE(txn_manager.commitTransaction(loader_txn));
+  
+  std::string path = ::testing::TempDir() + "bulk_loader_test.bin";
+  ASSERT_TRUE(database::BulkLoader::dumpBinary(source, path, checker, txn_manager.takeSnapshot()));
+  
+  database::HeapFile target(2, schema);
+  database::BulkLoader loader(target);
+  auto result = loader.loadBinary(path, 9);
+  std::remove(path.c_str());
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_EQ(result.rows_loaded, 3);
+  
+  auto expected = scanAll(source);
+  auto actual = scanAll(target);
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < actual.size(); ++i) {
+    EXPECT_EQ(actual[i].getHeader().getXmin(), 9);
+    for (database::ColumnId c = 0; c < schema.getColumnCount(); ++c) {
+      EXPECT_EQ(*actual[i].getValue(c), *expected[i].getValue(c));
+    }
+  }
+}
+
+TEST(BulkLoaderTest, LoadsBinaryInParallelChunks)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+  database::HeapFile source(1, schema);
+  auto loader_txn = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  ASSERT_TRUE(database::BulkLoader(source).loadCsvData(makeCsv(3000), loader_txn).success);
+  ASSERT_TRUE(txn_manager.commitTransaction(loader_txn));
+  std::string path = ::testing::TempDir() + "bulk_loader_parallel.bin";
+  ASSERT_TRUE(database::BulkLoader::dumpBinary(source, path, checker, txn_manager.takeSnapshot()));
+  
+  database::BulkLoadOptions options;
+  options.thread_count = 4;
+  options.min_chunk_size = 1024;
+  database::HeapFile target(2, schema);
+  database::BulkLoader loader(target, options);
+  auto result = loader.loadBinary(path, 9);
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_EQ(result.rows_loaded, 3000);
+  auto tuples = scanAll(target);
+  ASSERT_EQ(tuples.size(), 3000);
+  for (size_t i = 0; i < tuples.size(); ++i) {
+    EXPECT_EQ(tuples[i].getHeader().getXmin(), 9);
+    EXPECT_EQ(*tuples[i].getValue(0), database::Value(static_cast<int64_t>(i)));
+  }
+  
+  // A bad record at the end is numbered across chunks and undoes the load
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    uint32_t length = 4;
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out << "abcd";
+  }
+  size_t pages = target.getPageCount();
+  result = loader.loadBinary(path, 10);
+  std::remove(path.c_str());
+  EXPECT_FALSE(result.success);
+  EXPECT_EQ(result.error_line, 3001);
+  EXPECT_EQ(target.getPageCount(), pages);
+  EXPECT_EQ(scanAll(target).size(), 3000);
+}
+
+TEST(BulkLoaderTest, BinaryDumpHoldsOnlyVisibleVersions)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+  database::HeapFile source(1, schema);
+  database::BulkLoader source_loader(source);
+  auto loader_txn = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  ASSERT_TRUE(source_loader.loadCsvData("1,alice,1.5,true\n2,bob,2,f\n", loader_txn).success);
+  ASSERT_TRUE(txn_manager.commitTransaction(loader_txn));
+  auto before_changes = txn_manager.takeSnapshot();
+  
+  // Delete the first row and update the second, leaving three versions on the page
+  auto writer = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  source.deleteTuple(std::make_pair(1, 0), writer);
+  std::vector<database::Value> values = { database::Value{ int64_t{ 2 } }, database::Value{ std::string("robert") },
+                                          database::Value{ 2.0 }, database::Value{ false } };
+  ASSERT_NE(source.updateTuple(std::make_pair(1, 1), database::Tuple(schema, values, 0), writer), nullptr);
+  ASSERT_TRUE(txn_manager.commitTransaction(writer));
+  ASSERT_EQ(scanAll(source).size(), 3);
+  
+  std::string path = ::testing::TempDir() + "bulk_loader_visible.bin";
+  ASSERT_TRUE(database::BulkLoader::dumpBinary(source, path, checker, txn_manager.takeSnapshot()));
+  database::HeapFile target(2, schema);
+  auto result = database::BulkLoader(target).loadBinary(path, 9);
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_EQ(result.rows_loaded, 1);
+  auto tuples = scanAll(target);
+  ASSERT_EQ(tuples.size(), 1);
+  EXPECT_EQ(std::get<std::string>(*tuples[0].getValue(1)), "robert");
+  
+  // An older snapshot dumps the rows as they were before the changes
+  ASSERT_TRUE(database::BulkLoader::dumpBinary(source, path, checker, before_changes));
+  database::HeapFile old_target(3, schema);
+  result = database::BulkLoader(old_target).loadBinary(path, 9);
+  std::remove(path.c_str());
+  ASSERT_TRUE(result.success) << result.error_message;
+  tuples = scanAll(old_target);
+  ASSERT_EQ(tuples.size(), 2);
+  EXPECT_EQ(std::get<std::string>(*tuples[0].getValue(1)), "alice");
+  EXPECT_EQ(std::get<std::string>(*tuples[1].getValue(1)), "bob");
+}
+
+TEST(BulkLoaderTest, RunningOutOfFramesPartWayUndoesTheLoad)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  std::string path = ::testing::TempDir() + "bulk_loader_frames.db";
+  std::remove(path.c_str());
+  std::remove(database::HeapFile::getFreeSpaceMapPath(path).c_str());
+  database::BufferPool buffer_pool(1);
+  auto heap_file = database::HeapFile::open(1, schema, buffer_pool, path);
+  ASSERT_NE(heap_file, nullptr);
+  database::BulkLoader loader(*heap_file);
+  std::string csv = makeCsv(1000);  // Several pages
+  
+  // With one frame, each new page evicts the previous one; once the file
+  // may not grow past one page, evicting the second page fails
+  rlimit limit{};
+  ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &limit), 0);
+  auto old_handler = std::signal(SIGXFSZ, SIG_IGN);
+  rlimit small = limit;
+  small.rlim_cur = database::HeapFile::DEFAULT_PAGE_SIZE;
+  ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &small), 0);
+  auto result = loader.loadCsvData(csv, 1);
+  setrlimit(RLIMIT_FSIZE, &limit);
+  std::signal(SIGXFSZ, old_handler);
+  
+  EXPECT_FALSE(result.success);
+  EXPECT_EQ(heap_file->getPageCount(), 0);
+  EXPECT_TRUE(scanAll(*heap_file).empty());
+  EXPECT_FALSE(heap_file->getFreeSpaceMap().findPage(1).has_value());
+  
+  // The pages cut off are reused by the next load
+  result = loader.loadCsvData(csv, 2);
+  ASSERT_TRUE(result.success) << result.error_message;
+  auto tuples = scanAll(*heap_file);
+  ASSERT_EQ(tuples.size(), 1000);
+  EXPECT_EQ(tuples.front().getHeader().getXmin(), 2);
+  EXPECT_EQ(std::get<int64_t>(*tuples.back().getValue(0)), 999);
+  
+  heap_file.reset();
+  std::remove(path.c_str());
+  std::remove(database::HeapFile::getFreeSpaceMapPath(path).c_str());
+}
+
+TEST(BulkLoaderTest, RejectsCorruptBinary)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  database::BulkLoader loader(heap_file);
+  std::string path = ::testing::TempDir() + "bulk_loader_corrupt.bin";
+  
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "NOTMAGIC";
+  }
+  EXPECT_FALSE(loader.loadBinary(path, 1).success);
+  
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << database::BulkLoader::BINARY_MAGIC;
+    uint32_t length = 4;
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out << "abcd";
+  }
+  auto result = loader.loadBinary(path, 1);
+  std::remove(path.c_str());
+  EXPECT_FALSE(result.success);
+  EXPECT_EQ(result.error_line, 1);
+  EXPECT_EQ(heap_file.getPageCount(), 0);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,153 @@
+#include "database/catalog.hpp"
+#include "database/schema.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+database::Schema usersSchema()
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  return schema;
+}
+
+std::string freshPath(const std::string& name)
+{
+  std::string path = ::testing::TempDir() + name;
+  std::remove(path.c_str());
+  return path;
+}
+
+}  // namespace
+
+TEST(CatalogTest, FindsTablesByNameAndId)
+{
+  database::Catalog catalog;
+  auto users = catalog.createTable("users", usersSchema());
+  auto posts = catalog.createTable("posts", usersSchema());
+  EXPECT_EQ(users, 1);
+  EXPECT_EQ(posts, 2);
+  EXPECT_EQ(catalog.getTableCount(), 2);
+
+  EXPECT_EQ(catalog.findTable("users"), users);
+  EXPECT_EQ(catalog.findTable("posts"), posts);
+  EXPECT_EQ(catalog.findTable("missing"), 0);
+
+  const auto* entry = catalog.getEntry(posts);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->name, "posts");
+  EXPECT_EQ(entry->file_name, "2.heap");
+  EXPECT_EQ(catalog.getEntry(99), nullptr);
+  EXPECT_EQ(catalog.getSchema(99), nullptr);
+}
+
+TEST(CatalogTest, RejectsEmptyAndDuplicateNames)
+{
+  database::Catalog catalog;
+  EXPECT_EQ(catalog.createTable("", usersSchema()), 0);
+  EXPECT_EQ(catalog.createTable("users", usersSchema()), 1);
+  EXPECT_EQ(catalog.createTable("users", usersSchema()), 0);
+  EXPECT_EQ(catalog.createTable("posts", usersSchema()), 2);
+  EXPECT_EQ(catalog.getTableCount(), 2);
+}
+
+TEST(CatalogTest, KeepsItsOwnCopyOfTheSchema)
+{
+  database::Catalog catalog;
+  database::TableId table_id;
+  {
+    database::Schema schema = usersSchema();
+    table_id = catalog.createTable("users", schema);
+  }
+  const auto* schema = catalog.getSchema(table_id);
+  ASSERT_NE(schema, nullptr);
+  ASSERT_EQ(schema->getColumnCount(), 2);
+  EXPECT_EQ(schema->getColumn(1)->getName(), "name");
+}
+
+TEST(CatalogTest, PersistsTablesAndLoadsSchemasLazily)
+{
+  std::string path = freshPath("catalog_test_persist");
+  {
+    auto catalog = database::Catalog::open(path);
+    ASSERT_NE(catalog, nullptr);
+    EXPECT_EQ(catalog->getTableCount(), 0);
+    for (int i = 0; i < 50; ++i) {
+      ASSERT_EQ(catalog->createTable("table_" + std::to_string(i), usersSchema()), static_cast<database::TableId>(i + 1));
+    }
+  }
+
+  auto catalog = database::Catalog::open(path);
+  ASSERT_NE(catalog, nullptr);
+  EXPECT_EQ(catalog->getTableCount(), 50);
+  EXPECT_EQ(catalog->getLoadedSchemaCount(), 0);
+
+  auto table_id = catalog->findTable("table_17");
+  EXPECT_EQ(table_id, 18);
+  EXPECT_EQ(catalog->getEntry(table_id)->file_name, "18.heap");
+  EXPECT_EQ(catalog->getLoadedSchemaCount(), 0);
+
+  const auto* schema = catalog->getSchema(table_id);
+  ASSERT_NE(schema, nullptr);
+  EXPECT_EQ(catalog->getLoadedSchemaCount(), 1);
+  ASSERT_EQ(schema->getColumnCount(), 2);
+  EXPECT_EQ(schema->getColumn(0)->getName(), "id");
+  EXPECT_TRUE(schema->getColumn(0)->isPrimaryKey());
+  EXPECT_EQ(schema->getColumn(1)->getDataType(), database::DataType::TEXT);
+  EXPECT_EQ(catalog->getSchema(table_id), schema);
+  EXPECT_EQ(catalog->getLoadedSchemaCount(), 1);
+
+  // Creating a table rewrites the file with every schema without decoding
+  // the unloaded ones, and IDs keep counting
+  EXPECT_EQ(catalog->createTable("table_50", usersSchema()), 51);
+  EXPECT_EQ(catalog->createTable("table_51", usersSchema()), 52);
+  EXPECT_EQ(catalog->getLoadedSchemaCount(), 3);
+  ASSERT_NE(catalog->getSchema(catalog->findTable("table_3")), nullptr);
+  EXPECT_EQ(catalog->getSchema(catalog->findTable("table_3"))->getColumn(1)->getName(), "name");
+
+  catalog = database::Catalog::open(path);
+  ASSERT_NE(catalog, nullptr);
+  EXPECT_EQ(catalog->getTableCount(), 52);
+  for (int i = 0; i < 52; ++i) {
+    const auto* reopened = catalog->getSchema(catalog->findTable("table_" + std::to_string(i)));
+    ASSERT_NE(reopened, nullptr);
+    EXPECT_EQ(reopened->getColumn(0)->getName(), "id");
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST(CatalogTest, RejectsMalformedFiles)
+{
+  std::string path = freshPath("catalog_test_malformed");
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "not a catalog";
+  }
+  EXPECT_EQ(database::Catalog::open(path), nullptr);
+
+  // A valid catalog cut short inside its entries
+  std::remove(path.c_str());
+  {
+    auto catalog = database::Catalog::open(path);
+    ASSERT_NE(catalog, nullptr);
+    catalog->createTable("users", usersSchema());
+    catalog->createTable("posts", usersSchema());
+  }
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+  EXPECT_EQ(database::Catalog::open(path), nullptr);
+
+  std::remove(path.c_str());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,152 @@
+#include "database/checkpointer.hpp"
+#include "database/control_file.hpp"
+#include "database/heap_file.hpp"
+#include "database/schema.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+class CheckpointerTest : public ::testing::Test {
+protected:
+  void SetUp() override
+  {
+    directory_ = ::testing::TempDir() + "checkpointer_test";
+    std::filesystem::remove_all(directory_);
+    std::filesystem::create_directories(directory_);
+    wal_ = database::WriteAheadLog::open(directory_ + "/wal.log");
+    ASSERT_NE(wal_, nullptr);
+    pool_.setWriteAheadLog(wal_.get());
+    schema_.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  }
+  
+  void TearDown() override
+  {
+    std::filesystem::remove_all(directory_);
+  }
+  
+  std::unique_ptr<database::HeapFile> openHeap()
+  {
+    auto heap_file = database::HeapFile::open(1, schema_, pool_, directory_ + "/1.heap");
+    if (heap_file) {
+      heap_file->setWriteAheadLog(wal_.get());
+    }
+    return heap_file;
+  }
+  
+  std::string controlPath() const { return directory_ + "/control"; }
+  
+  std::string directory_;
+  std::unique_ptr<database::WriteAheadLog> wal_;
+  database::BufferPool pool_{ 32 };
+  database::Schema schema_;
+};
+
+}  // namespace
+
+TEST(ControlFileTest, RoundTripsAndRejectsGarbage)
+{
+  std::string path = ::testing::TempDir() + "control_file_test";
+  std::filesystem::remove(path);
+  EXPECT_FALSE(database::ControlFile::read(path).has_value());
+  
+  ASSERT_TRUE(database::ControlFile::write(path, database::ControlData{ 200, 100 }));
+  ASSERT_TRUE(database::ControlFile::write(path, database::ControlData{ 400, 300, 42, 17 }));
+  auto data = database::ControlFile::read(path);
+  ASSERT_TRUE(data.has_value());
+  EXPECT_EQ(data->checkpoint_lsn, 400);
+  EXPECT_EQ(data->redo_lsn, 300);
+  EXPECT_EQ(data->next_txn_id, 42);
+  EXPECT_EQ(data->oldest_txn_id, 17);
+  
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << "not a control file at all";
+  }
+  EXPECT_FALSE(database::ControlFile::read(path).has_value());
+  std::filesystem::remove(path);
+}
+
+TEST_F(CheckpointerTest, CheckpointWritesDirtyPagesAndRecordsRedoLsn)
+{
+  auto heap_file = openHeap();
+  ASSERT_NE(heap_file, nullptr);
+  for (int64_t i = 0; i < 300; ++i) {
+    database::Tuple tuple(schema_, {database::Value{i}}, 100);
+    ASSERT_NE(heap_file->insertTuple(tuple, 100), nullptr);
+  }
+  database::Lsn redo_lsn = wal_->getCurrentLsn();
+  EXPECT_EQ(std::filesystem::file_size(directory_ + "/1.heap"), 0);
+  
+  database::CheckpointOptions options;
+  options.pages_per_round = 1;
+  options.round_delay = std::chrono::milliseconds(1);
+  database::Checkpointer checkpointer(*wal_, pool_, controlPath(), options);
+  ASSERT_TRUE(checkpointer.checkpoint());
+  EXPECT_EQ(checkpointer.getCheckpointCount(), 1);
+  EXPECT_EQ(checkpointer.getRedoLsn(), redo_lsn);
+  
+  // Every page is on disk, and the log ends with the checkpoint record
+  EXPECT_EQ(std::filesystem::file_size(directory_ + "/1.heap"),
+            heap_file->getPageCount() * database::HeapFile::DEFAULT_PAGE_SIZE);
+  auto control = database::ControlFile::read(controlPath());
+  ASSERT_TRUE(control.has_value());
+  EXPECT_EQ(control->redo_lsn, redo_lsn);
+  EXPECT_EQ(control->checkpoint_lsn, wal_->getFlushedLsn());
+  
+  auto records = database::WriteAheadLog::readAll(directory_ + "/wal.log", redo_lsn);
+  ASSERT_TRUE(records.has_value());
+  ASSERT_EQ(records->size(), 1);
+  EXPECT_EQ((*records)[0].type, database::WalRecordType::CHECKPOINT);
+  database::Lsn logged_redo_lsn = 0;
+  ASSERT_EQ((*records)[0].payload.size(), sizeof(logged_redo_lsn));
+  std::memcpy(&logged_redo_lsn, (*records)[0].payload.data(), sizeof(logged_redo_lsn));
+  EXPECT_EQ(logged_redo_lsn, redo_lsn);
+}
+
+TEST_F(CheckpointerTest, GivesUpWhenPagesStayPinned)
+{
+  auto heap_file = openHeap();
+  ASSERT_NE(heap_file, nullptr);
+  database::Tuple tuple(schema_, {database::Value{int64_t{1}}}, 100);
+  auto tuple_id = heap_file->insertTuple(tuple, 100);
+  ASSERT_NE(tuple_id, nullptr);
+  auto view = heap_file->getTuple(*tuple_id);  // Holds a pin on the only dirty page
+  ASSERT_TRUE(view.has_value());
+  
+  database::CheckpointOptions options;
+  options.round_delay = std::chrono::milliseconds(1);
+  options.pinned_page_timeout = std::chrono::milliseconds(20);
+  database::Checkpointer checkpointer(*wal_, pool_, controlPath(), options);
+  EXPECT_FALSE(checkpointer.checkpoint());
+  EXPECT_FALSE(database::ControlFile::read(controlPath()).has_value());
+  
+  view.reset();
+  EXPECT_TRUE(checkpointer.checkpoint());
+}
+
+TEST_F(CheckpointerTest, BackgroundThreadCheckpointsPeriodically)
+{
+  database::CheckpointOptions options;
+  options.interval = std::chrono::milliseconds(5);
+  database::Checkpointer checkpointer(*wal_, pool_, controlPath(), options);
+  
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (checkpointer.getCheckpointCount() < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_GE(checkpointer.getCheckpointCount(), 2);
+  EXPECT_TRUE(database::ControlFile::read(controlPath()).has_value());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
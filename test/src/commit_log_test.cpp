@@ -0,0 +1,144 @@
+#include "database/commit_log.hpp"
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+TEST(CommitLogTest, UnknownTransactionsAreInProgress)
+{
+  database::CommitLog commit_log;
+  EXPECT_EQ(commit_log.getStatus(1), database::TransactionStatus::IN_PROGRESS);
+  EXPECT_EQ(commit_log.getStatus(1000000), database::TransactionStatus::IN_PROGRESS);
+  EXPECT_EQ(commit_log.getPageCount(), 0);
+}
+
+TEST(CommitLogTest, StoresTwoBitsPerTransaction)
+{
+  database::CommitLog commit_log;
+  commit_log.setStatus(1, database::TransactionStatus::COMMITTED);
+  commit_log.setStatus(2, database::TransactionStatus::ABORTED);
+  commit_log.setStatus(3, database::TransactionStatus::SUB_COMMITTED);
+  commit_log.setStatus(31, database::TransactionStatus::ABORTED);
+  commit_log.setStatus(32, database::TransactionStatus::COMMITTED);
+
+  EXPECT_EQ(commit_log.getStatus(1), database::TransactionStatus::COMMITTED);
+  EXPECT_EQ(commit_log.getStatus(2), database::TransactionStatus::ABORTED);
+  EXPECT_EQ(commit_log.getStatus(3), database::TransactionStatus::SUB_COMMITTED);
+  EXPECT_EQ(commit_log.getStatus(4), database::TransactionStatus::IN_PROGRESS);
+  EXPECT_EQ(commit_log.getStatus(31), database::TransactionStatus::ABORTED);
+  EXPECT_EQ(commit_log.getStatus(32), database::TransactionStatus::COMMITTED);
+  EXPECT_EQ(commit_log.getPageCount(), 1);
+
+  // A subtransaction's status changes once its parent commits
+  commit_log.setStatus(3, database::TransactionStatus::COMMITTED);
+  EXPECT_EQ(commit_log.getStatus(3), database::TransactionStatus::COMMITTED);
+  EXPECT_EQ(commit_log.getStatus(2), database::TransactionStatus::ABORTED);
+}
+
+TEST(CommitLogTest, AllocatesPagesAsIdsReachThem)
+{
+  constexpr size_t XIDS_PER_PAGE = database::CommitLog::XIDS_PER_PAGE;
+  EXPECT_EQ(XIDS_PER_PAGE, database::CommitLog::PAGE_SIZE * 4);
+
+  database::CommitLog commit_log;
+  commit_log.setStatus(XIDS_PER_PAGE - 1, database::TransactionStatus::COMMITTED);
+  EXPECT_EQ(commit_log.getPageCount(), 1);
+  commit_log.setStatus(3 * XIDS_PER_PAGE, database::TransactionStatus::ABORTED);
+  EXPECT_EQ(commit_log.getPageCount(), 4);
+  EXPECT_EQ(commit_log.getStatus(XIDS_PER_PAGE - 1), database::TransactionStatus::COMMITTED);
+  EXPECT_EQ(commit_log.getStatus(XIDS_PER_PAGE), database::TransactionStatus::IN_PROGRESS);
+  EXPECT_EQ(commit_log.getStatus(3 * XIDS_PER_PAGE), database::TransactionStatus::ABORTED);
+}
+
+TEST(CommitLogTest, TruncateDropsWholePagesOnly)
+{
+  constexpr size_t XIDS_PER_PAGE = database::CommitLog::XIDS_PER_PAGE;
+  database::CommitLog commit_log;
+  for (database::TransactionId txn_id = 1; txn_id < 3 * XIDS_PER_PAGE; ++txn_id) {
+    commit_log.setStatus(txn_id, txn_id % 2 == 0 ? database::TransactionStatus::ABORTED
+                                                 : database::TransactionStatus::COMMITTED);
+  }
+  EXPECT_EQ(commit_log.getPageCount(), 3);
+
+  commit_log.truncate(XIDS_PER_PAGE + 10);
+  EXPECT_EQ(commit_log.getPageCount(), 2);
+  EXPECT_EQ(commit_log.getOldestTransactionId(), XIDS_PER_PAGE);
+  EXPECT_EQ(commit_log.getStatus(XIDS_PER_PAGE + 2), database::TransactionStatus::ABORTED);
+
+  // Truncated IDs count as committed and can no longer be changed
+  EXPECT_EQ(commit_log.getStatus(2), database::TransactionStatus::COMMITTED);
+  commit_log.setStatus(2, database::TransactionStatus::ABORTED);
+  EXPECT_EQ(commit_log.getStatus(2), database::TransactionStatus::COMMITTED);
+
+  // Truncating backwards does nothing; past the last page drops everything
+  commit_log.truncate(1);
+  EXPECT_EQ(commit_log.getPageCount(), 2);
+  commit_log.truncate(10 * XIDS_PER_PAGE);
+  EXPECT_EQ(commit_log.getPageCount(), 0);
+  commit_log.setStatus(10 * XIDS_PER_PAGE + 1, database::TransactionStatus::ABORTED);
+  EXPECT_EQ(commit_log.getPageCount(), 1);
+  EXPECT_EQ(commit_log.getStatus(10 * XIDS_PER_PAGE + 1), database::TransactionStatus::ABORTED);
+}
+
+TEST(CommitLogTest, RoundTripsThroughAStream)
+{
+  constexpr size_t XIDS_PER_PAGE = database::CommitLog::XIDS_PER_PAGE;
+  database::CommitLog saved;
+  for (database::TransactionId txn_id = 1; txn_id < 3 * XIDS_PER_PAGE; txn_id += 3) {
+    saved.setStatus(txn_id, database::TransactionStatus::COMMITTED);
+    saved.setStatus(txn_id + 1, database::TransactionStatus::ABORTED);
+  }
+  saved.truncate(XIDS_PER_PAGE);
+  std::stringstream stream;
+  ASSERT_TRUE(saved.writeTo(stream));
+
+  database::CommitLog loaded;
+  loaded.setStatus(5, database::TransactionStatus::ABORTED);
+  ASSERT_TRUE(loaded.readFrom(stream));
+  EXPECT_EQ(loaded.getPageCount(), 2);
+  EXPECT_EQ(loaded.getOldestTransactionId(), XIDS_PER_PAGE);
+  EXPECT_EQ(loaded.getStatus(5), database::TransactionStatus::COMMITTED);  // Truncated
+  for (database::TransactionId txn_id = XIDS_PER_PAGE; txn_id < 3 * XIDS_PER_PAGE; ++txn_id) {
+    ASSERT_EQ(loaded.getStatus(txn_id), saved.getStatus(txn_id)) << txn_id;
+  }
+
+  // A cut-off image leaves the commit log alone
+  std::stringstream full;
+  ASSERT_TRUE(saved.writeTo(full));
+  std::stringstream cut(full.str().substr(0, full.str().size() / 2));
+  EXPECT_FALSE(loaded.readFrom(cut));
+  EXPECT_EQ(loaded.getPageCount(), 2);
+}
+
+TEST(CommitLogTest, ConcurrentWritersShareWords)
+{
+  constexpr size_t THREADS = 4;
+  constexpr database::TransactionId XIDS = 100000;
+  database::CommitLog commit_log;
+
+  // Thread t finishes every ID congruent to t, so every word has several writers
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&, t] {
+      for (database::TransactionId txn_id = t; txn_id < XIDS; txn_id += THREADS) {
+        commit_log.setStatus(txn_id, t % 2 == 0 ? database::TransactionStatus::COMMITTED
+                                                : database::TransactionStatus::ABORTED);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (database::TransactionId txn_id = 0; txn_id < XIDS; ++txn_id) {
+    ASSERT_EQ(commit_log.getStatus(txn_id), (txn_id % THREADS) % 2 == 0 ? database::TransactionStatus::COMMITTED
+                                                                        : database::TransactionStatus::ABORTED);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,51 @@
+#include "database/csn_log.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(CsnLogTest, UncommittedTransactionsHaveNoCsn)
+{
+  database::CsnLog csn_log;
+  EXPECT_EQ(csn_log.getCsn(1), 0);
+  EXPECT_EQ(csn_log.getCsn(1000000), 0);
+  EXPECT_EQ(csn_log.getPageCount(), 0);
+}
+
+TEST(CsnLogTest, StoresOneCsnPerTransaction)
+{
+  constexpr size_t XIDS_PER_PAGE = database::CsnLog::XIDS_PER_PAGE;
+  database::CsnLog csn_log;
+  csn_log.setCsn(1, database::CsnLog::COMMITTING);
+  csn_log.setCsn(2, 7);
+  csn_log.setCsn(XIDS_PER_PAGE + 1, 8);
+
+  EXPECT_EQ(csn_log.getCsn(1), database::CsnLog::COMMITTING);
+  EXPECT_EQ(csn_log.getCsn(2), 7);
+  EXPECT_EQ(csn_log.getCsn(3), 0);
+  EXPECT_EQ(csn_log.getCsn(XIDS_PER_PAGE + 1), 8);
+  EXPECT_EQ(csn_log.getPageCount(), 2);
+
+  csn_log.setCsn(1, 9);
+  EXPECT_EQ(csn_log.getCsn(1), 9);
+}
+
+TEST(CsnLogTest, TruncatedTransactionsAreFrozen)
+{
+  constexpr size_t XIDS_PER_PAGE = database::CsnLog::XIDS_PER_PAGE;
+  database::CsnLog csn_log;
+  csn_log.setCsn(5, 10);
+  csn_log.setCsn(XIDS_PER_PAGE + 5, 11);
+
+  csn_log.truncate(XIDS_PER_PAGE + 3);
+  EXPECT_EQ(csn_log.getPageCount(), 1);
+  EXPECT_EQ(csn_log.getCsn(5), database::CsnLog::FROZEN_CSN);
+  EXPECT_EQ(csn_log.getCsn(XIDS_PER_PAGE + 5), 11);
+
+  csn_log.setCsn(6, 12);
+  EXPECT_EQ(csn_log.getCsn(6), database::CsnLog::FROZEN_CSN);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,107 @@
+#include "database/free_space_map.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <sstream>
+
+TEST(FreeSpaceMapTest, EmptyMapFindsNothing)
+{
+  database::FreeSpaceMap fsm(8192);
+  EXPECT_FALSE(fsm.findPage(100).has_value());
+}
+
+TEST(FreeSpaceMapTest, FindsPageWithEnoughSpace)
+{
+  database::FreeSpaceMap fsm(8192);
+  fsm.update(1, 100);
+  fsm.update(2, 4000);
+  fsm.update(3, 8000);
+
+  EXPECT_EQ(fsm.findPage(50), 1);
+  EXPECT_EQ(fsm.findPage(1000), 2);
+  EXPECT_EQ(fsm.findPage(5000), 3);
+  EXPECT_FALSE(fsm.findPage(8192).has_value());
+}
+
+TEST(FreeSpaceMapTest, RecordedSpaceIsLowerBound)
+{
+  database::FreeSpaceMap fsm(8192);
+  fsm.update(1, 1000);
+
+  EXPECT_LE(fsm.getFreeSpace(1), 1000);
+  EXPECT_GT(fsm.getFreeSpace(1), 1000 - 32);
+
+  // Rounding down means a request for the full amount is not promised
+  EXPECT_FALSE(fsm.findPage(1000).has_value());
+  EXPECT_EQ(fsm.findPage(fsm.getFreeSpace(1)), 1);
+}
+
+TEST(FreeSpaceMapTest, UpdateLowersAvailableSpace)
+{
+  database::FreeSpaceMap fsm(8192);
+  fsm.update(1, 4000);
+  ASSERT_EQ(fsm.findPage(2000), 1);
+
+  fsm.update(1, 100);
+  EXPECT_FALSE(fsm.findPage(2000).has_value());
+}
+
+TEST(FreeSpaceMapTest, GrowsBeyondInitialCapacity)
+{
+  database::FreeSpaceMap fsm(8192);
+  for (database::PageId page_id = 1; page_id <= 10000; ++page_id) {
+    fsm.update(page_id, 0);
+  }
+  fsm.update(9999, 6000);
+
+  EXPECT_EQ(fsm.findPage(5000), 9999);
+}
+
+TEST(FreeSpaceMapTest, RemoveForgetsPage)
+{
+  database::FreeSpaceMap fsm(8192);
+  fsm.update(1, 4000);
+  fsm.remove(1);
+
+  EXPECT_FALSE(fsm.findPage(100).has_value());
+}
+
+TEST(FreeSpaceMapTest, RoundTripsThroughStream)
+{
+  database::FreeSpaceMap fsm(8192);
+  fsm.update(1, 100);
+  fsm.update(200, 6000);
+
+  std::stringstream stream;
+  ASSERT_TRUE(fsm.writeTo(stream));
+
+  auto loaded = database::FreeSpaceMap::readFrom(stream);
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_EQ(loaded->getPageSize(), 8192);
+  EXPECT_EQ(loaded->getFreeSpace(1), fsm.getFreeSpace(1));
+  EXPECT_EQ(loaded->findPage(5000), 200);
+}
+
+TEST(FreeSpaceMapTest, ReadRejectsTruncatedStream)
+{
+  std::stringstream stream("short");
+  EXPECT_FALSE(database::FreeSpaceMap::readFrom(stream).has_value());
+}
+
+TEST(FreeSpaceMapTest, ReadRejectsPageCountBeyondTheStream)
+{
+  // A corrupt header claiming far more pages than follow must not be allocated for
+  std::stringstream stream;
+  uint64_t page_size = 8192;
+  uint64_t page_count = uint64_t{1} << 60;
+  stream.write(reinterpret_cast<const char*>(&page_size), sizeof(page_size));
+  stream.write(reinterpret_cast<const char*>(&page_count), sizeof(page_count));
+  stream << "abcd";
+  EXPECT_FALSE(database::FreeSpaceMap::readFrom(stream).has_value());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
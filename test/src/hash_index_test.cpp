@@ -0,0 +1,249 @@
+#include "database/hash_index.hpp"
+#include "database/heap_file.hpp"
+#include "database/schema.hpp"
+#include "database/transaction_manager.hpp"
+#include "database/visibility_checker.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+std::vector<database::TupleId> candidates(const database::HashIndex& index, const database::Value& key)
+{
+  std::vector<database::TupleId> tuple_ids;
+  index.findCandidates(key, tuple_ids);
+  std::sort(tuple_ids.begin(), tuple_ids.end());
+  return tuple_ids;
+}
+
+}  // namespace
+
+class HashIndexTest : public ::testing::Test {
+protected:
+  void SetUp() override
+  {
+    schema_.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+    schema_.addColumn(database::Column(1, "amount", database::DataType::DOUBLE, false, false));
+    schema_.addColumn(database::Column(2, "name", database::DataType::TEXT, true, false));
+    schema_.addColumn(database::Column(3, "active", database::DataType::BOOLEAN, false, false));
+  }
+
+  database::Schema schema_;
+};
+
+TEST_F(HashIndexTest, RejectsMissingColumnsAndBadEntries)
+{
+  EXPECT_EQ(database::HashIndex::create(schema_, 7), nullptr);
+  auto index = database::HashIndex::create(schema_, 0);
+  ASSERT_NE(index, nullptr);
+  EXPECT_EQ(index->getColumnId(), 0U);
+
+  EXPECT_FALSE(index->insert(database::Value{ nullptr }, { 1, 0 }));
+  EXPECT_FALSE(index->insert(database::Value{ std::string("1") }, { 1, 0 }));
+  EXPECT_FALSE(index->insert(database::Value{ int64_t{ 1 } }, { 0, 0 }));
+  EXPECT_FALSE(index->insert(database::Value{ int64_t{ 1 } }, { database::PageId{ 1 } << 48, 0 }));
+  EXPECT_EQ(index->hashKey(database::Value{ 1.0 }), std::nullopt);
+  EXPECT_EQ(index->size(), 0U);
+  EXPECT_TRUE(candidates(*index, database::Value{ nullptr }).empty());
+}
+
+TEST_F(HashIndexTest, FindsDuplicateKeysAndRemovesEntries)
+{
+  auto index = database::HashIndex::create(schema_, 0);
+  for (uint16_t slot = 0; slot < 20; ++slot) {
+    ASSERT_TRUE(index->insert(database::Value{ int64_t{ 42 } }, { 3, slot }));
+  }
+  ASSERT_TRUE(index->insert(database::Value{ int64_t{ 43 } }, { 4, 0 }));
+
+  // Twenty entries of one key span an overflow chain
+  auto found = candidates(*index, database::Value{ int64_t{ 42 } });
+  ASSERT_EQ(found.size(), 20U);
+  EXPECT_EQ(found.front(), database::TupleId(3, 0));
+  EXPECT_EQ(found.back(), database::TupleId(3, 19));
+  EXPECT_GT(index->getOverflowBucketCount(), 0U);
+
+  EXPECT_TRUE(index->remove(database::Value{ int64_t{ 42 } }, { 3, 7 }));
+  EXPECT_FALSE(index->remove(database::Value{ int64_t{ 42 } }, { 3, 7 }));
+  EXPECT_FALSE(index->remove(database::Value{ int64_t{ 43 } }, { 3, 8 }));
+  EXPECT_EQ(candidates(*index, database::Value{ int64_t{ 42 } }).size(), 19U);
+  for (uint16_t slot = 0; slot < 20; ++slot) {
+    if (slot != 7) {
+      ASSERT_TRUE(index->remove(database::Value{ int64_t{ 42 } }, { 3, slot }));
+    }
+  }
+  EXPECT_TRUE(candidates(*index, database::Value{ int64_t{ 42 } }).empty());
+  EXPECT_EQ(candidates(*index, database::Value{ int64_t{ 43 } }), std::vector<database::TupleId>(1, { 4, 0 }));
+  EXPECT_EQ(index->getOverflowBucketCount(), 0U);
+  EXPECT_EQ(index->size(), 1U);
+}
+
+TEST_F(HashIndexTest, HashesEqualValuesAlike)
+{
+  auto amounts = database::HashIndex::create(schema_, 1);
+  EXPECT_EQ(amounts->hashKey(database::Value{ -0.0 }), amounts->hashKey(database::Value{ 0.0 }));
+  ASSERT_TRUE(amounts->insert(database::Value{ -0.0 }, { 1, 0 }));
+  EXPECT_EQ(candidates(*amounts, database::Value{ 0.0 }).size(), 1U);
+
+  auto names = database::HashIndex::create(schema_, 2);
+  ASSERT_TRUE(names->insert(database::Value{ std::string("alice") }, { 1, 0 }));
+  ASSERT_TRUE(names->insert(database::Value{ std::string("bob") }, { 1, 1 }));
+  EXPECT_EQ(candidates(*names, database::Value{ std::string("alice") }), std::vector<database::TupleId>(1, { 1, 0 }));
+  EXPECT_TRUE(candidates(*names, database::Value{ std::string("carol") }).empty());
+
+  auto flags = database::HashIndex::create(schema_, 3);
+  ASSERT_TRUE(flags->insert(database::Value{ true }, { 1, 0 }));
+  EXPECT_EQ(candidates(*flags, database::Value{ true }).size(), 1U);
+  EXPECT_TRUE(candidates(*flags, database::Value{ false }).empty());
+}
+
+TEST_F(HashIndexTest, GrowsOneBucketAtATime)
+{
+  auto index = database::HashIndex::create(schema_, 0);
+  size_t initial_buckets = index->getBucketCount();
+  constexpr int64_t COUNT = 200000;
+  for (int64_t k = 0; k < COUNT; ++k) {
+    ASSERT_TRUE(index->insert(database::Value{ k }, { static_cast<database::PageId>(k + 1), 0 }));
+    size_t capacity = index->getBucketCount() * database::HashIndex::BUCKET_ENTRIES;
+    ASSERT_LE(static_cast<double>(index->size()), database::HashIndex::MAX_FILL * static_cast<double>(capacity) + 1);
+  }
+  EXPECT_GT(index->getBucketCount(), initial_buckets);
+  // At half fill few buckets overflow, so most lookups read one bucket
+  EXPECT_LT(index->getOverflowBucketCount(), index->getBucketCount() / 10);
+
+  size_t extra_candidates = 0;
+  for (int64_t k = 0; k < COUNT; ++k) {
+    auto found = candidates(*index, database::Value{ k });
+    ASSERT_NE(std::find(found.begin(), found.end(), database::TupleId(static_cast<database::PageId>(k + 1), 0)),
+              found.end());
+    extra_candidates += found.size() - 1;
+  }
+  // Keys sharing a 32-bit hash code are rare
+  EXPECT_LT(extra_candidates, 100U);
+  EXPECT_TRUE(candidates(*index, database::Value{ int64_t{ -1 } }).empty());
+  EXPECT_TRUE(candidates(*index, database::Value{ std::numeric_limits<int64_t>::max() }).empty());
+}
+
+TEST_F(HashIndexTest, MatchesMultimapUnderRandomChanges)
+{
+  auto index = database::HashIndex::create(schema_, 0);
+  std::unordered_multimap<int64_t, database::TupleId> expected;
+  std::mt19937_64 rng(42);
+  for (int round = 0; round < 100000; ++round) {
+    int64_t k = static_cast<int64_t>(rng() % 5000);
+    auto [first, last] = expected.equal_range(k);
+    if (rng() % 3 != 0 || first == last) {
+      database::TupleId tuple_id(rng() % 1000 + 1, static_cast<uint16_t>(round));
+      ASSERT_TRUE(index->insert(database::Value{ k }, tuple_id));
+      expected.emplace(k, tuple_id);
+    } else {
+      ASSERT_TRUE(index->remove(database::Value{ k }, first->second));
+      expected.erase(first);
+    }
+  }
+
+  EXPECT_EQ(index->size(), expected.size());
+  for (int64_t k = 0; k < 5000; ++k) {
+    std::vector<database::TupleId> want;
+    auto [first, last] = expected.equal_range(k);
+    for (auto it = first; it != last; ++it) {
+      want.push_back(it->second);
+    }
+    std::sort(want.begin(), want.end());
+    ASSERT_EQ(candidates(*index, database::Value{ k }), want) << "key " << k;
+  }
+}
+
+TEST_F(HashIndexTest, BuildsFromHeapFileAndRechecksKeys)
+{
+  database::HeapFile heap_file(1, schema_);
+  for (int64_t id = 0; id < 1000; ++id) {
+    std::vector<database::Value> values = { database::Value{ id }, database::Value{ 0.5 },
+                                            database::Value{ "name-" + std::to_string(id % 10) },
+                                            database::Value{ true } };
+    ASSERT_NE(heap_file.insertTuple(database::Tuple(schema_, values, 1), 1), nullptr);
+  }
+  EXPECT_EQ(database::HashIndex::build(heap_file, 7), nullptr);
+  auto index = database::HashIndex::build(heap_file, 2);
+  ASSERT_NE(index, nullptr);
+  EXPECT_EQ(index->size(), 1000U);
+
+  auto tuple_ids = index->find(heap_file, database::Value{ std::string("name-7") });
+  ASSERT_EQ(tuple_ids.size(), 100U);
+  for (const auto& tuple_id : tuple_ids) {
+    EXPECT_EQ(heap_file.getTuple(tuple_id)->getInteger(0) % 10, 7);
+  }
+
+  // An entry whose tuple has another key, as when keys share a hash code, is filtered out
+  ASSERT_TRUE(index->insert(database::Value{ std::string("name-3") }, tuple_ids.front()));
+  EXPECT_EQ(candidates(*index, database::Value{ std::string("name-3") }).size(), 101U);
+  EXPECT_EQ(index->find(heap_file, database::Value{ std::string("name-3") }).size(), 100U);
+  EXPECT_TRUE(index->find(heap_file, database::Value{ std::string("name-99") }).empty());
+}
+
+TEST_F(HashIndexTest, FindsVisibleVersionsThroughUpdateChains)
+{
+  database::HeapFile heap_file(1, schema_);
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+  auto index = database::HashIndex::create(schema_, 0);
+
+  auto inserter = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  std::vector<database::Value> values = { database::Value{ int64_t{ 1 } }, database::Value{ 1.0 },
+                                          database::Value{ std::string("a") }, database::Value{ true } };
+  auto root = heap_file.insertTuple(database::Tuple(schema_, values, inserter), inserter);
+  ASSERT_NE(root, nullptr);
+  ASSERT_TRUE(index->insert(*heap_file.getTuple(*root), *root));
+  ASSERT_TRUE(txn_manager.commitTransaction(inserter));
+  auto before_update = txn_manager.takeSnapshot();
+
+  // The update changes a column the index does not cover, so it adds no entry
+  auto updater = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  values[1] = database::Value{ 2.0 };
+  auto updated = heap_file.updateTuple(*root, database::Tuple(schema_, values, 0), updater);
+  ASSERT_NE(updated, nullptr);
+  ASSERT_TRUE(txn_manager.commitTransaction(updater));
+
+  auto old_versions = index->findVisible(heap_file, database::Value{ int64_t{ 1 } }, checker, before_update);
+  ASSERT_EQ(old_versions.size(), 1U);
+  EXPECT_EQ(old_versions[0].getDouble(1), 1.0);
+  auto new_versions = index->findVisible(heap_file, database::Value{ int64_t{ 1 } }, checker,
+                                         txn_manager.takeSnapshot());
+  ASSERT_EQ(new_versions.size(), 1U);
+  EXPECT_EQ(new_versions[0].getDouble(1), 2.0);
+
+  // An update of the key adds an entry for the new version; the old entry no longer matches
+  auto key_updater = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  values[0] = database::Value{ int64_t{ 2 } };
+  auto moved = heap_file.updateTuple(*updated, database::Tuple(schema_, values, 0), key_updater, true);
+  ASSERT_NE(moved, nullptr);
+  ASSERT_TRUE(index->insert(*heap_file.getTuple(*moved), *moved));
+  ASSERT_TRUE(txn_manager.commitTransaction(key_updater));
+
+  auto snapshot = txn_manager.takeSnapshot();
+  EXPECT_TRUE(index->findVisible(heap_file, database::Value{ int64_t{ 1 } }, checker, snapshot).empty());
+  auto moved_versions = index->findVisible(heap_file, database::Value{ int64_t{ 2 } }, checker, snapshot);
+  ASSERT_EQ(moved_versions.size(), 1U);
+  EXPECT_EQ(moved_versions[0].getInteger(0), 2);
+
+  // A rebuilt index skips the heap-only version and finds it from the chain's root
+  auto rebuilt = database::HashIndex::build(heap_file, 0);
+  ASSERT_NE(rebuilt, nullptr);
+  EXPECT_EQ(rebuilt->size(), 2U);
+  EXPECT_TRUE(rebuilt->findVisible(heap_file, database::Value{ int64_t{ 1 } }, checker, snapshot).empty());
+  old_versions = rebuilt->findVisible(heap_file, database::Value{ int64_t{ 1 } }, checker, before_update);
+  ASSERT_EQ(old_versions.size(), 1U);
+  EXPECT_EQ(old_versions[0].getDouble(1), 1.0);
+  EXPECT_EQ(rebuilt->findVisible(heap_file, database::Value{ int64_t{ 2 } }, checker, snapshot).size(), 1U);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,8 +1,11 @@
 #include "database/heap_file.hpp"
 #include "database/tuple.hpp"
 #include "database/schema.hpp"
+#include "database/visibility_checker.hpp"
 
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
 #include <vector>
 
 TEST(HeapFileTest, CanCreateHeapFile)
@@ -34,6 +37,20 @@ TEST(HeapFileTest, CanInsertTuple)
   EXPECT_GE(tuple_id->second, 0);  // Some slot
 }
 
+TEST(HeapFileTest, InsertRejectsTupleNotMatchingSchema)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  database::HeapFile heap_file(1, schema);
+  
+  std::vector<database::Value> values = {database::Value{std::string("not an integer")}};
+  database::Tuple tuple(schema, values, 100);
+  
+  EXPECT_EQ(heap_file.insertTuple(tuple, 100), nullptr);
+  EXPECT_EQ(heap_file.getPageCount(), 0);
+}
+
 TEST(HeapFileTest, CanGetTuple)
 {
   database::TableId table_id = 1;
@@ -49,7 +66,7 @@ TEST(HeapFileTest, CanGetTuple)
   ASSERT_NE(tuple_id, nullptr);
   
   auto retrieved = heap_file.getTuple(*tuple_id);
-  ASSERT_NE(retrieved, nullptr);
+  ASSERT_TRUE(retrieved.has_value());
   EXPECT_EQ(retrieved->getXmin(), 100);
   
   auto value = retrieved->getValue(0);
@@ -57,6 +74,30 @@ TEST(HeapFileTest, CanGetTuple)
   EXPECT_EQ(std::get<int64_t>(value.value()), 42);
 }
 
+TEST(HeapFileTest, InsertsStampTheInsertingTransaction)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  database::HeapFile heap_file(1, schema);
+  
+  // The header the caller built the tuple with is replaced
+  database::Tuple tuple(schema, {database::Value{int64_t{1}}}, 0);
+  tuple.getHeader().setXmax(7);
+  auto tuple_id = heap_file.insertTuple(tuple, 42);
+  ASSERT_NE(tuple_id, nullptr);
+  auto inserted = heap_file.getTuple(*tuple_id);
+  ASSERT_TRUE(inserted.has_value());
+  EXPECT_EQ(inserted->getXmin(), 42);
+  EXPECT_EQ(inserted->getHeader().getXmax(), 0);
+  
+  std::vector<database::Tuple> batch(3, database::Tuple(schema, {database::Value{int64_t{2}}}, 0));
+  std::vector<database::TupleId> batch_ids(batch.size());
+  ASSERT_EQ(heap_file.insertBatch(batch, batch_ids, 43), batch.size());
+  for (const auto& batch_id : batch_ids) {
+    EXPECT_EQ(heap_file.getTuple(batch_id)->getXmin(), 43);
+  }
+}
+
 TEST(HeapFileTest, CanUpdateTuple)
 {
   database::TableId table_id = 1;
@@ -78,10 +119,230 @@ TEST(HeapFileTest, CanUpdateTuple)
   ASSERT_NE(updated_id, nullptr);
   
   auto retrieved = heap_file.getTuple(*updated_id);
-  ASSERT_NE(retrieved, nullptr);
+  ASSERT_TRUE(retrieved.has_value());
   auto value = retrieved->getValue(0);
   ASSERT_TRUE(value.has_value());
   EXPECT_EQ(std::get<int64_t>(value.value()), 43);
+  EXPECT_EQ(retrieved->getXmin(), 200);
+  
+  // The old version stays, stamped with its updater and successor
+  auto old_version = heap_file.getTuple(*tuple_id);
+  ASSERT_TRUE(old_version.has_value());
+  EXPECT_EQ(old_version->getInteger(0), 42);
+  EXPECT_EQ(old_version->getHeader().getXmax(), 200);
+  EXPECT_EQ(old_version->getHeader().getCtid(), *updated_id);
+}
+
+TEST(HeapFileTest, UpdateKeepsNewVersionOnThePageAsHeapOnly)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  database::HeapFile heap_file(1, schema);
+  
+  auto tuple_id = heap_file.insertTuple(database::Tuple(schema, {database::Value{int64_t{1}}}, 100), 100);
+  ASSERT_NE(tuple_id, nullptr);
+  auto hot_id = heap_file.updateTuple(*tuple_id, database::Tuple(schema, {database::Value{int64_t{2}}}, 0), 200);
+  ASSERT_NE(hot_id, nullptr);
+  EXPECT_EQ(hot_id->first, tuple_id->first);
+  EXPECT_TRUE(heap_file.getTuple(*tuple_id)->getHeader().isHotUpdated());
+  EXPECT_TRUE(heap_file.getTuple(*hot_id)->getHeader().isHeapOnly());
+  
+  // Changing an indexed column needs an index entry, so the version is not heap-only
+  auto indexed_id = heap_file.updateTuple(*hot_id, database::Tuple(schema, {database::Value{int64_t{3}}}, 0), 300, true);
+  ASSERT_NE(indexed_id, nullptr);
+  EXPECT_EQ(indexed_id->first, tuple_id->first);
+  EXPECT_FALSE(heap_file.getTuple(*hot_id)->getHeader().isHotUpdated());
+  EXPECT_FALSE(heap_file.getTuple(*indexed_id)->getHeader().isHeapOnly());
+  EXPECT_EQ(heap_file.getTuple(*hot_id)->getHeader().getCtid(), *indexed_id);
+}
+
+TEST(HeapFileTest, UpdateOfRowOnFullPageMovesItToAnotherPage)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  database::HeapFile heap_file(1, schema);
+  
+  std::vector<database::TupleId> tuple_ids;
+  while (heap_file.getPageCount() < 2) {
+    auto tuple_id = heap_file.insertTuple(database::Tuple(schema, {database::Value{int64_t{0}}}, 100), 100);
+    ASSERT_NE(tuple_id, nullptr);
+    tuple_ids.push_back(*tuple_id);
+  }
+  
+  auto updated_id = heap_file.updateTuple(tuple_ids[0], database::Tuple(schema, {database::Value{int64_t{1}}}, 0), 200);
+  ASSERT_NE(updated_id, nullptr);
+  EXPECT_NE(updated_id->first, tuple_ids[0].first);
+  EXPECT_FALSE(heap_file.getTuple(tuple_ids[0])->getHeader().isHotUpdated());
+  EXPECT_FALSE(heap_file.getTuple(*updated_id)->getHeader().isHeapOnly());
+  EXPECT_EQ(heap_file.getTuple(tuple_ids[0])->getHeader().getCtid(), *updated_id);
+  
+  EXPECT_EQ(heap_file.updateTuple(std::make_pair(9, 0), database::Tuple(schema, {database::Value{int64_t{1}}}, 0), 200),
+            nullptr);
+}
+
+TEST(HeapFileTest, ReadersFollowTheChainToTheVisibleVersion)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  database::HeapFile heap_file(1, schema);
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+  
+  auto inserter = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto root = heap_file.insertTuple(database::Tuple(schema, {database::Value{int64_t{1}}}, inserter), inserter);
+  ASSERT_NE(root, nullptr);
+  ASSERT_TRUE(txn_manager.commitTransaction(inserter));
+  auto before_updates = txn_manager.takeSnapshot();
+  
+  // Committed, aborted and running updates, each building on the chain
+  database::TupleId latest = *root;
+  for (int64_t value = 2; value <= 4; ++value) {
+    auto updater = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+    auto updated = heap_file.updateTuple(latest, database::Tuple(schema, {database::Value{value}}, 0), updater);
+    ASSERT_NE(updated, nullptr);
+    if (value == 2) {
+      ASSERT_TRUE(txn_manager.commitTransaction(updater));
+      latest = *updated;
+    } else if (value == 3) {
+      ASSERT_TRUE(txn_manager.rollbackTransaction(updater));  // latest stays the committed version
+    }
+  }
+  
+  auto visible_value = [&](const database::Snapshot& snapshot) -> std::optional<int64_t> {
+    auto tuple = heap_file.getVisibleTuple(*root, checker, snapshot);
+    return tuple ? std::optional<int64_t>(tuple->getInteger(0)) : std::nullopt;
+  };
+  EXPECT_EQ(visible_value(before_updates), 1);
+  EXPECT_EQ(visible_value(txn_manager.takeSnapshot()), 2);
+  EXPECT_EQ(heap_file.getVisibleTuple(std::make_pair(9, 0), checker, txn_manager.takeSnapshot()), std::nullopt);
+  
+  // A delete ends the chain once it commits
+  auto deleter = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  heap_file.deleteTuple(latest, deleter);
+  EXPECT_EQ(visible_value(txn_manager.takeSnapshot()), 2);
+  EXPECT_EQ(visible_value(txn_manager.takeSnapshot(deleter)), std::nullopt);
+  ASSERT_TRUE(txn_manager.commitTransaction(deleter));
+  EXPECT_EQ(visible_value(txn_manager.takeSnapshot()), std::nullopt);
+}
+
+TEST(HeapFileTest, PruningKeepsTableSizeFlatUnderUpdates)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, false, false));
+  database::HeapFile heap_file(1, schema);
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+  heap_file.setTransactionManager(&txn_manager);
+  
+  auto loader = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  std::vector<database::TupleId> roots;
+  for (int64_t i = 0; i < 100; ++i) {
+    roots.push_back(*heap_file.insertTuple(database::Tuple(schema, {database::Value{i}, database::Value{std::string(40, 'x')}}, loader), loader));
+  }
+  ASSERT_TRUE(txn_manager.commitTransaction(loader));
+  std::vector<database::TupleId> latest = roots;
+  std::vector<database::TupleId> entries = roots;  // What an index would point at
+  
+  auto update_all = [&](int64_t round) {
+    for (size_t i = 0; i < latest.size(); ++i) {
+      auto txn = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+      database::Tuple tuple(schema, {database::Value{round}, database::Value{std::string(40, 'y')}}, txn);
+      auto updated = heap_file.updateTuple(latest[i], tuple, txn);
+      ASSERT_NE(updated, nullptr);
+      latest[i] = *updated;
+      if (!heap_file.getTuple(*updated)->getHeader().isHeapOnly()) {
+        entries[i] = *updated;  // Moved to another page or not HOT: it gets its own index entry
+      }
+      ASSERT_TRUE(txn_manager.commitTransaction(txn));
+    }
+  };
+  
+  // A running transaction holds back pruning of the versions it may see
+  auto old_reader = txn_manager.beginTransaction(database::IsolationLevel::REPEATABLE_READ);
+  auto old_snapshot = txn_manager.takeSnapshot(old_reader);
+  update_all(1);
+  size_t held_pages = heap_file.getPageCount();
+  EXPECT_GT(held_pages, 1);
+  EXPECT_EQ(heap_file.getVisibleTuple(roots[7], checker, old_snapshot)->getText(1), std::string(40, 'x'));
+  ASSERT_TRUE(txn_manager.commitTransaction(old_reader));
+  
+  // Afterwards every round of updates fits in the space the previous ones freed
+  for (int64_t round = 2; round <= 50; ++round) {
+    update_all(round);
+  }
+  EXPECT_LE(heap_file.getPageCount(), held_pages + 1);
+  
+  // Every row still leads from its index entry to its newest version
+  auto snapshot = txn_manager.takeSnapshot();
+  for (size_t i = 0; i < entries.size(); ++i) {
+    auto tuple = heap_file.getVisibleTuple(entries[i], checker, snapshot);
+    ASSERT_TRUE(tuple.has_value()) << "row " << i;
+    EXPECT_EQ(tuple->getInteger(0), 50);
+  }
+}
+
+TEST(HeapFileTest, VacuumedPageIsAllVisibleUntilChanged)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  database::HeapFile heap_file(1, schema);
+  database::TransactionManager txn_manager;
+  heap_file.setTransactionManager(&txn_manager);
+  
+  auto txn = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto tuple_id = *heap_file.insertTuple(database::Tuple(schema, {database::Value{int64_t{1}}}, txn), txn);
+  database::PageId page_id = tuple_id.first;
+  
+  // A version whose creator is still running keeps the page from being all-visible
+  ASSERT_TRUE(heap_file.vacuumPage(page_id, 0).has_value());
+  EXPECT_FALSE(heap_file.getVisibilityMap().isAllVisible(page_id));
+  ASSERT_TRUE(txn_manager.commitTransaction(txn));
+  
+  auto result = heap_file.vacuumPage(page_id, 0);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_FALSE(result->dirtied);
+  EXPECT_EQ(result->frozen_xid, 0);
+  EXPECT_TRUE(heap_file.getVisibilityMap().isAllVisible(page_id));
+  EXPECT_FALSE(heap_file.getVisibilityMap().isAllFrozen(page_id));
+  
+  // Frozen once its xmin is below the limit; the hint bits are written out with the page
+  result = heap_file.vacuumPage(page_id, txn + 1);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(result->dirtied);
+  EXPECT_EQ(result->frozen_xid, txn + 1);
+  EXPECT_TRUE(heap_file.getVisibilityMap().isAllFrozen(page_id));
+  
+  auto updater = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  ASSERT_NE(heap_file.updateTuple(tuple_id, database::Tuple(schema, {database::Value{int64_t{2}}}, updater), updater), nullptr);
+  EXPECT_EQ(heap_file.getVisibilityMap().getBits(page_id), 0);
+  
+  // Without a transaction manager nothing is known about the versions
+  database::HeapFile unmanaged(2, schema);
+  unmanaged.insertTuple(database::Tuple(schema, {database::Value{int64_t{1}}}, 1), 1);
+  EXPECT_FALSE(unmanaged.vacuumPage(1, 0).has_value());
+}
+
+TEST(HeapFileTest, CountsInsertsUpdatesAndDeletes)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  database::HeapFile heap_file(1, schema);
+  
+  std::vector<database::Tuple> batch(3, database::Tuple(schema, {database::Value{int64_t{1}}}, 1));
+  std::vector<database::TupleId> batch_ids(batch.size());
+  ASSERT_EQ(heap_file.insertBatch(batch, batch_ids, 1), 3);
+  auto tuple_id = heap_file.insertTuple(database::Tuple(schema, {database::Value{int64_t{2}}}, 1), 1);
+  auto updated = heap_file.updateTuple(*tuple_id, database::Tuple(schema, {database::Value{int64_t{3}}}, 2), 2);
+  ASSERT_NE(updated, nullptr);
+  heap_file.deleteTuple(batch_ids[0], 3);
+  
+  auto counters = heap_file.getStats().read();
+  EXPECT_EQ(counters.inserts, 4);
+  EXPECT_EQ(counters.updates, 1);
+  EXPECT_EQ(counters.deletes, 1);
+  EXPECT_EQ(counters.dead_tuples, 2);
+  EXPECT_EQ(counters.getLiveTuples(), 3);
 }
 
 TEST(HeapFileTest, CanDeleteTuple)
@@ -100,8 +361,49 @@ TEST(HeapFileTest, CanDeleteTuple)
   
   heap_file.deleteTuple(*tuple_id, 200);
   
+  // The version stays until pruning, stamped with its deleter
   auto retrieved = heap_file.getTuple(*tuple_id);
-  EXPECT_EQ(retrieved, nullptr);  // Should be deleted
+  ASSERT_TRUE(retrieved.has_value());
+  EXPECT_EQ(retrieved->getHeader().getXmax(), 200);
+  
+  // Deleting a slot with no live version changes nothing
+  heap_file.deleteTuple(std::make_pair(tuple_id->first, uint16_t{7}), 300);
+  EXPECT_EQ(heap_file.getStats().read().deletes, 1);
+}
+
+TEST(HeapFileTest, UncommittedDeletesStayVisibleAndUnpruned)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  database::HeapFile heap_file(1, schema);
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+  heap_file.setTransactionManager(&txn_manager);
+  
+  auto creator = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto tuple_id = heap_file.insertTuple(database::Tuple(schema, {database::Value{int64_t{1}}}, creator), creator);
+  ASSERT_NE(tuple_id, nullptr);
+  ASSERT_TRUE(txn_manager.commitTransaction(creator));
+  
+  // While the deleter runs, other snapshots see the row and pruning keeps it
+  auto deleter = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  heap_file.deleteTuple(*tuple_id, deleter);
+  EXPECT_TRUE(heap_file.getVisibleTuple(*tuple_id, checker, txn_manager.takeSnapshot()).has_value());
+  EXPECT_FALSE(heap_file.getVisibleTuple(*tuple_id, checker, txn_manager.takeSnapshot(deleter)).has_value());
+  EXPECT_EQ(heap_file.prunePage(tuple_id->first), 0);
+  
+  // An abort brings it back for good
+  ASSERT_TRUE(txn_manager.rollbackTransaction(deleter));
+  EXPECT_TRUE(heap_file.getVisibleTuple(*tuple_id, checker, txn_manager.takeSnapshot()).has_value());
+  EXPECT_EQ(heap_file.prunePage(tuple_id->first), 0);
+  
+  // A committed delete is reclaimed once no snapshot can see the row
+  auto committed_deleter = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  heap_file.deleteTuple(*tuple_id, committed_deleter);
+  ASSERT_TRUE(txn_manager.commitTransaction(committed_deleter));
+  EXPECT_FALSE(heap_file.getVisibleTuple(*tuple_id, checker, txn_manager.takeSnapshot()).has_value());
+  EXPECT_GT(heap_file.prunePage(tuple_id->first), 0);
+  EXPECT_FALSE(heap_file.getTuple(*tuple_id).has_value());
 }
 
 TEST(HeapFileTest, CreatesNewPageWhenNeeded)
@@ -124,6 +426,249 @@ TEST(HeapFileTest, CreatesNewPageWhenNeeded)
   EXPECT_GT(heap_file.getPageCount(), 0);
 }
 
+TEST(HeapFileTest, FillsPagesBeforeAllocatingNewOnes)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  database::HeapFile heap_file(1, schema);
+  
+  std::vector<database::Value> values = {database::Value{0LL}};
+  database::Tuple tuple(schema, values, 100);
+  size_t per_page = (8192 - sizeof(database::PageHeader)) / database::Page::getRequiredSpace(tuple.getSize());
+  
+  for (size_t i = 0; i < per_page * 3; ++i) {
+    ASSERT_NE(heap_file.insertTuple(tuple, 100), nullptr);
+  }
+  EXPECT_EQ(heap_file.getPageCount(), 3);
+  
+  ASSERT_NE(heap_file.insertTuple(tuple, 100), nullptr);
+  EXPECT_EQ(heap_file.getPageCount(), 4);
+  EXPECT_TRUE(heap_file.getFreeSpaceMap().findPage(database::Page::getRequiredSpace(tuple.getSize())).has_value());
+}
+
+TEST(HeapFileTest, InsertBatchPacksTuplesIntoNewPages)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  database::HeapFile heap_file(1, schema);
+  
+  std::vector<database::Tuple> tuples;
+  for (int64_t i = 0; i < 5000; ++i) {
+    tuples.emplace_back(schema, std::vector<database::Value>{database::Value{i}}, 100);
+  }
+  std::vector<database::TupleId> tuple_ids(tuples.size());
+  
+  EXPECT_EQ(heap_file.insertBatch(tuples, tuple_ids, 100), 5000);
+  
+  size_t per_page = (8192 - sizeof(database::PageHeader)) / database::Page::getRequiredSpace(tuples[0].getSize());
+  EXPECT_EQ(heap_file.getPageCount(), (5000 + per_page - 1) / per_page);
+  for (size_t i = 0; i < tuples.size(); ++i) {
+    auto retrieved = heap_file.getTuple(tuple_ids[i]);
+    ASSERT_TRUE(retrieved.has_value());
+    EXPECT_EQ(retrieved->getInteger(0), static_cast<int64_t>(i));
+  }
+}
+
+TEST(HeapFileTest, InsertBatchStopsAtInvalidTuple)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  database::HeapFile heap_file(1, schema);
+  
+  std::vector<database::Tuple> tuples;
+  tuples.emplace_back(schema, std::vector<database::Value>{database::Value{1LL}}, 100);
+  tuples.emplace_back(schema, std::vector<database::Value>{database::Value{std::nullptr_t{}}}, 100);
+  tuples.emplace_back(schema, std::vector<database::Value>{database::Value{3LL}}, 100);
+  std::vector<database::TupleId> tuple_ids(tuples.size());
+  
+  EXPECT_EQ(heap_file.insertBatch(tuples, tuple_ids, 100), 1);
+  EXPECT_TRUE(heap_file.getTuple(tuple_ids[0]).has_value());
+}
+
+TEST(HeapFileTest, DiskBackedHeapFileSurvivesReopen)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  std::string path = ::testing::TempDir() + "heap_file_reopen.heap";
+  std::remove(path.c_str());
+  std::remove((path + ".fsm").c_str());
+  
+  database::BufferPool pool(4);
+  std::vector<database::TupleId> tuple_ids;
+  {
+    auto heap_file = database::HeapFile::open(1, schema, pool, path);
+    ASSERT_NE(heap_file, nullptr);
+    EXPECT_TRUE(heap_file->isDiskBacked());
+    
+    // More pages than buffer frames, so some are evicted along the way
+    for (int64_t i = 0; i < 3000; ++i) {
+      database::Tuple tuple(schema, {database::Value{i}, database::Value{"row" + std::to_string(i)}}, 100);
+      auto tuple_id = heap_file->insertTuple(tuple, 100);
+      ASSERT_NE(tuple_id, nullptr);
+      tuple_ids.push_back(*tuple_id);
+    }
+    EXPECT_GT(heap_file->getPageCount(), pool.getFrameCount());
+    heap_file->deleteTuple(tuple_ids[0], 200);
+  }
+  
+  auto heap_file = database::HeapFile::open(1, schema, pool, path);
+  ASSERT_NE(heap_file, nullptr);
+  EXPECT_EQ(heap_file->getTuple(tuple_ids[0])->getHeader().getXmax(), 200);
+  for (size_t i = 1; i < tuple_ids.size(); ++i) {
+    auto retrieved = heap_file->getTuple(tuple_ids[i]);
+    ASSERT_TRUE(retrieved.has_value());
+    EXPECT_EQ(retrieved->getInteger(0), static_cast<int64_t>(i));
+    EXPECT_EQ(retrieved->getText(1), "row" + std::to_string(i));
+  }
+  
+  // The free space map was persisted, so inserts reuse the last page
+  size_t page_count = heap_file->getPageCount();
+  database::Tuple tuple(schema, {database::Value{int64_t{-1}}, database::Value{nullptr}}, 300);
+  ASSERT_NE(heap_file->insertTuple(tuple, 300), nullptr);
+  EXPECT_EQ(heap_file->getPageCount(), page_count);
+  
+  heap_file.reset();
+  std::remove(path.c_str());
+  std::remove((path + ".fsm").c_str());
+}
+
+TEST(HeapFileTest, DiskBackedHeapFileRebuildsMissingFreeSpaceMap)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  std::string path = ::testing::TempDir() + "heap_file_rebuild.heap";
+  std::remove(path.c_str());
+  
+  database::BufferPool pool(8);
+  {
+    auto heap_file = database::HeapFile::open(1, schema, pool, path);
+    ASSERT_NE(heap_file, nullptr);
+    database::Tuple tuple(schema, {database::Value{int64_t{1}}}, 100);
+    ASSERT_NE(heap_file->insertTuple(tuple, 100), nullptr);
+  }
+  std::remove((path + ".fsm").c_str());
+  
+  auto heap_file = database::HeapFile::open(1, schema, pool, path);
+  ASSERT_NE(heap_file, nullptr);
+  EXPECT_EQ(heap_file->getPageCount(), 1);
+  EXPECT_GT(heap_file->getFreeSpaceMap().getFreeSpace(1), 0);
+  
+  heap_file.reset();
+  std::remove(path.c_str());
+  std::remove((path + ".fsm").c_str());
+}
+
+TEST(HeapFileTest, FreeSpaceSurvivesATemporaryShortageOfFrames)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, false, false));
+  std::string path = ::testing::TempDir() + "heap_file_short.heap";
+  std::string other_path = ::testing::TempDir() + "heap_file_pinning.heap";
+  for (const auto& file : {path, other_path}) {
+    std::remove(file.c_str());
+    std::remove((file + ".fsm").c_str());
+  }
+  
+  database::BufferPool pool(2);
+  auto heap_file = database::HeapFile::open(1, schema, pool, path);
+  auto other = database::HeapFile::open(2, schema, pool, other_path);
+  ASSERT_NE(heap_file, nullptr);
+  ASSERT_NE(other, nullptr);
+  database::Tuple small(schema, {database::Value{int64_t{1}}, database::Value{std::string("a")}}, 1);
+  ASSERT_NE(heap_file->insertTuple(small, 1), nullptr);
+  size_t required = database::Page::getRequiredSpace(small.getSize());
+  
+  // Another table's readers pin both frames: an insert can neither read page 1 nor create a page
+  database::Tuple large(schema, {database::Value{int64_t{2}}, database::Value{std::string(5000, 'b')}}, 1);
+  auto first = other->insertTuple(large, 1);
+  auto second = other->insertTuple(large, 1);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  ASSERT_NE(first->first, second->first);
+  {
+    auto first_view = other->getTuple(*first);
+    auto second_view = other->getTuple(*second);
+    ASSERT_TRUE(first_view.has_value());
+    ASSERT_TRUE(second_view.has_value());
+    EXPECT_EQ(heap_file->insertTuple(small, 1), nullptr);
+    EXPECT_EQ(heap_file->getFreeSpaceMap().findPage(required), 1);
+  }
+  
+  // Once the readers are done the insert goes to page 1 again
+  auto tuple_id = heap_file->insertTuple(small, 1);
+  ASSERT_NE(tuple_id, nullptr);
+  EXPECT_EQ(tuple_id->first, 1);
+  EXPECT_EQ(heap_file->getPageCount(), 1);
+  
+  heap_file.reset();
+  other.reset();
+  for (const auto& file : {path, other_path}) {
+    std::remove(file.c_str());
+    std::remove((file + ".fsm").c_str());
+  }
+}
+
+TEST(HeapFileTest, OpenRejectsMismatchedPoolPageSize)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  database::BufferPool pool(4, 4096);
+  EXPECT_EQ(database::HeapFile::open(1, schema, pool, ::testing::TempDir() + "heap_file_bad.heap"), nullptr);
+}
+
+TEST(HeapFileTest, MappedHeapFileServesReadsAndRejectsWrites)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  std::string path = ::testing::TempDir() + "heap_file_mapped.heap";
+  std::remove(path.c_str());
+  std::remove((path + ".fsm").c_str());
+  
+  std::vector<database::TupleId> tuple_ids;
+  {
+    database::BufferPool pool(4);
+    auto heap_file = database::HeapFile::open(1, schema, pool, path);
+    ASSERT_NE(heap_file, nullptr);
+    for (int64_t i = 0; i < 1000; ++i) {
+      database::Tuple tuple(schema, {database::Value{i}, database::Value{"row" + std::to_string(i)}}, 100);
+      auto tuple_id = heap_file->insertTuple(tuple, 100);
+      ASSERT_NE(tuple_id, nullptr);
+      tuple_ids.push_back(*tuple_id);
+    }
+    heap_file->deleteTuple(tuple_ids[0], 200);
+  }
+  
+  auto heap_file = database::HeapFile::openMapped(1, schema, path);
+  ASSERT_NE(heap_file, nullptr);
+  EXPECT_TRUE(heap_file->isDiskBacked());
+  EXPECT_TRUE(heap_file->isReadOnly());
+  EXPECT_GT(heap_file->getPageCount(), 1);
+  
+  EXPECT_EQ(heap_file->getTuple(tuple_ids[0])->getHeader().getXmax(), 200);
+  auto retrieved = heap_file->getTuple(tuple_ids[999]);
+  ASSERT_TRUE(retrieved.has_value());
+  EXPECT_EQ(retrieved->getInteger(0), 999);
+  EXPECT_EQ(retrieved->getText(1), "row999");
+  EXPECT_FALSE(heap_file->getTuple(std::make_pair(heap_file->getPageIdLimit(), 0)).has_value());
+  
+  database::Tuple tuple(schema, {database::Value{int64_t{-1}}, database::Value{nullptr}}, 300);
+  EXPECT_EQ(heap_file->insertTuple(tuple, 300), nullptr);
+  EXPECT_EQ(heap_file->updateTuple(tuple_ids[1], tuple, 300), nullptr);
+  heap_file->deleteTuple(tuple_ids[1], 300);
+  EXPECT_EQ(heap_file->getTuple(tuple_ids[1])->getHeader().getXmax(), 0);
+  
+  heap_file.reset();
+  EXPECT_EQ(database::HeapFile::openMapped(1, schema, ::testing::TempDir() + "heap_file_missing.heap"), nullptr);
+  std::remove(path.c_str());
+  std::remove((path + ".fsm").c_str());
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
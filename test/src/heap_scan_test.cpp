@@ -0,0 +1,256 @@
+#include "database/heap_scan.hpp"
+#include "database/heap_file.hpp"
+#include "database/buffer_pool.hpp"
+#include "database/schema.hpp"
+#include "database/visibility_checker.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+void makeSchema(database::Schema& schema)
+{
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+}
+
+void insertRows(database::HeapFile& heap_file, const database::Schema& schema, int64_t count)
+{
+  for (int64_t i = 0; i < count; ++i) {
+    std::vector<database::Value> values = {database::Value{i}, database::Value{"row" + std::to_string(i)}};
+    database::Tuple tuple(schema, values, 100);
+    ASSERT_NE(heap_file.insertTuple(tuple, 100), nullptr);
+  }
+}
+
+}  // namespace
+
+TEST(HeapScanTest, EmptyHeapYieldsNothing)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  
+  database::HeapScan scan(heap_file);
+  EXPECT_FALSE(scan.next().has_value());
+}
+
+TEST(HeapScanTest, YieldsAllTuplesInPhysicalOrder)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  insertRows(heap_file, schema, 1000);
+  ASSERT_GT(heap_file.getPageCount(), 1);
+  
+  database::HeapScan scan(heap_file);
+  int64_t expected = 0;
+  database::TupleId previous = std::make_pair(0, 0);
+  while (auto scanned = scan.next()) {
+    EXPECT_EQ(scanned->tuple.getInteger(0), expected);
+    EXPECT_EQ(scanned->tuple.getText(1), "row" + std::to_string(expected));
+    EXPECT_LT(previous, scanned->tuple_id);
+    previous = scanned->tuple_id;
+    ++expected;
+  }
+  EXPECT_EQ(expected, 1000);
+}
+
+TEST(HeapScanTest, SkipsDeletedTuples)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+  
+  auto creator = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  std::vector<database::Value> values = {database::Value{1LL}, database::Value{std::string("a")}};
+  database::Tuple tuple(schema, values, creator);
+  auto first = heap_file.insertTuple(tuple, creator);
+  auto second = heap_file.insertTuple(tuple, creator);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  ASSERT_TRUE(txn_manager.commitTransaction(creator));
+  auto deleter = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  heap_file.deleteTuple(*first, deleter);
+  ASSERT_TRUE(txn_manager.commitTransaction(deleter));
+  
+  database::HeapScan scan(heap_file);
+  scan.setSnapshot(checker, txn_manager.takeSnapshot());
+  auto scanned = scan.next();
+  ASSERT_TRUE(scanned.has_value());
+  EXPECT_EQ(scanned->tuple_id, *second);
+  EXPECT_FALSE(scan.next().has_value());
+}
+
+TEST(HeapScanTest, NextBatchReturnsBoundedBatches)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  insertRows(heap_file, schema, 250);
+  
+  database::HeapScan scan(heap_file);
+  std::vector<database::ScannedTuple> batch;
+  size_t total = 0;
+  size_t batches = 0;
+  while (size_t n = scan.nextBatch(batch, 100)) {
+    EXPECT_LE(n, 100);
+    EXPECT_EQ(batch.size(), n);
+    total += n;
+    ++batches;
+  }
+  EXPECT_EQ(total, 250);
+  EXPECT_EQ(batches, 3);
+}
+
+TEST(HeapScanTest, CanScanPageRange)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  insertRows(heap_file, schema, 1000);
+  ASSERT_GE(heap_file.getPageCount(), 2);
+  
+  size_t total = 0;
+  for (database::PageId page_id = 1; page_id < heap_file.getPageIdLimit(); ++page_id) {
+    database::HeapScan scan(heap_file, page_id, page_id + 1);
+    while (auto scanned = scan.next()) {
+      EXPECT_EQ(scanned->tuple_id.first, page_id);
+      ++total;
+    }
+  }
+  EXPECT_EQ(total, 1000);
+}
+
+TEST(HeapScanTest, DiskBackedScanReadsAhead)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  std::string path = ::testing::TempDir() + "heap_scan_readahead.heap";
+  std::remove(path.c_str());
+  std::remove((path + ".fsm").c_str());
+  
+  database::BufferPool pool(64);
+  {
+    auto heap_file = database::HeapFile::open(1, schema, pool, path);
+    ASSERT_NE(heap_file, nullptr);
+    insertRows(*heap_file, schema, 20000);
+    ASSERT_GT(heap_file->getPageCount(), pool.getFrameCount());
+  }
+  
+  auto heap_file = database::HeapFile::open(1, schema, pool, path);
+  ASSERT_NE(heap_file, nullptr);
+  pool.resetStats();
+  
+  int64_t expected = 0;
+  database::HeapScan scan(*heap_file);
+  while (auto scanned = scan.next()) {
+    EXPECT_EQ(scanned->tuple.getInteger(0), expected++);
+  }
+  EXPECT_EQ(expected, 20000);
+  
+  // Nearly every page was already cached or being read when the scan reached it
+  auto stats = pool.getStats();
+  EXPECT_GT(stats.prefetches, 0);
+  EXPECT_LE(stats.misses, 1);
+  
+  heap_file.reset();
+  std::remove(path.c_str());
+  std::remove((path + ".fsm").c_str());
+}
+
+TEST(HeapScanTest, ScansMappedHeapFile)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  std::string path = ::testing::TempDir() + "heap_scan_mapped.heap";
+  std::remove(path.c_str());
+  std::remove((path + ".fsm").c_str());
+  
+  {
+    database::BufferPool pool(16);
+    auto heap_file = database::HeapFile::open(1, schema, pool, path);
+    ASSERT_NE(heap_file, nullptr);
+    insertRows(*heap_file, schema, 5000);
+  }
+  
+  auto heap_file = database::HeapFile::openMapped(1, schema, path);
+  ASSERT_NE(heap_file, nullptr);
+  int64_t expected = 0;
+  std::vector<database::ScannedTuple> batch;
+  database::HeapScan scan(*heap_file);
+  while (scan.nextBatch(batch, 256) > 0) {
+    for (const auto& scanned : batch) {
+      EXPECT_EQ(scanned.tuple.getInteger(0), expected++);
+    }
+  }
+  EXPECT_EQ(expected, 5000);
+  
+  heap_file.reset();
+  std::remove(path.c_str());
+  std::remove((path + ".fsm").c_str());
+}
+
+TEST(HeapScanTest, ScanWithSnapshotYieldsVisibleVersionsAndLeavesHints)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  database::HeapFile heap_file(1, schema);
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+  
+  // Rows 0-99 committed, 100-199 aborted, 200-299 still running
+  database::TransactionId running = 0;
+  for (int64_t i = 0; i < 300; ++i) {
+    if (i % 100 == 0) {
+      running = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+    }
+    database::Tuple tuple(schema, {database::Value{i}, database::Value{"row" + std::to_string(i)}}, running);
+    ASSERT_NE(heap_file.insertTuple(tuple, running), nullptr);
+    if (i == 99) {
+      ASSERT_TRUE(txn_manager.commitTransaction(running));
+    } else if (i == 199) {
+      ASSERT_TRUE(txn_manager.rollbackTransaction(running));
+    }
+  }
+  
+  for (int pass = 0; pass < 2; ++pass) {
+    database::HeapScan scan(heap_file);
+    scan.setSnapshot(checker, txn_manager.takeSnapshot());
+    int64_t expected = 0;
+    while (auto scanned = scan.next()) {
+      EXPECT_EQ(scanned->tuple.getInteger(0), expected++);
+      EXPECT_TRUE(scanned->tuple.getHeader().hasHintBits(database::TupleHeader::XMIN_COMMITTED));
+    }
+    EXPECT_EQ(expected, 100);
+  }
+  
+  // The running transaction sees its own rows too
+  database::HeapScan own_scan(heap_file);
+  own_scan.setSnapshot(checker, txn_manager.takeSnapshot(running));
+  size_t count = 0;
+  while (own_scan.next()) {
+    ++count;
+  }
+  EXPECT_EQ(count, 200);
+  
+  // Aborted rows got their hint, running ones none
+  database::HeapScan unfiltered(heap_file);
+  while (auto scanned = unfiltered.next()) {
+    int64_t id = scanned->tuple.getInteger(0);
+    uint16_t expected_hints = id < 100 ? database::TupleHeader::XMIN_COMMITTED
+                              : id < 200 ? database::TupleHeader::XMIN_INVALID : 0;
+    EXPECT_EQ(scanned->tuple.getHeader().getInfomask(), expected_hints) << "row " << id;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
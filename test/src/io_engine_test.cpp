@@ -0,0 +1,145 @@
+#include "database/io_engine.hpp"
+#include "database/segment_file.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 4096;
+constexpr size_t PAGES = 8;
+
+class IoEngineTest : public ::testing::TestWithParam<database::IoEngineType> {
+protected:
+  void SetUp() override
+  {
+    engine_ = database::IoEngine::create(GetParam(), 4);
+    if (!engine_) {
+      GTEST_SKIP() << "io_uring is not available";
+    }
+    path_ = ::testing::TempDir() + "io_engine_test.heap";
+    std::remove(path_.c_str());
+    segment_ = database::SegmentFile::open(path_, PAGE_SIZE);
+    ASSERT_NE(segment_, nullptr);
+
+    buffers_.resize(PAGES, std::vector<std::byte>(PAGE_SIZE));
+    for (auto& buffer : buffers_) {
+      buffer_pointers_.push_back(buffer.data());
+    }
+  }
+
+  void TearDown() override
+  {
+    segment_.reset();
+    std::remove(path_.c_str());
+  }
+
+  // Run requests for pages 1..PAGES in batches of the queue depth
+  std::vector<database::IoCompletion> runAll(database::IoOperation operation, bool registered)
+  {
+    std::vector<database::IoCompletion> completions;
+    for (size_t i = 0; i < PAGES;) {
+      size_t batch = 0;
+      for (; i < PAGES; ++i, ++batch) {
+        database::IoRequest request{ operation, segment_.get(), i + 1, buffer_pointers_[i],
+                                     registered ? static_cast<int>(i) : -1, i };
+        if (!engine_->prepare(request)) {
+          break;
+        }
+      }
+      engine_->submit();
+      engine_->reap(completions, batch);
+    }
+    return completions;
+  }
+
+  std::unique_ptr<database::IoEngine> engine_;
+  std::string path_;
+  std::unique_ptr<database::SegmentFile> segment_;
+  std::vector<std::vector<std::byte>> buffers_;
+  std::vector<std::byte*> buffer_pointers_;
+};
+
+}  // namespace
+
+TEST_P(IoEngineTest, CreatesRequestedType)
+{
+  if (GetParam() != database::IoEngineType::AUTO) {
+    EXPECT_EQ(engine_->getType(), GetParam());
+  }
+  EXPECT_EQ(engine_->getQueueDepth(), 4);
+  EXPECT_EQ(engine_->getInFlight(), 0);
+}
+
+TEST_P(IoEngineTest, PrepareStopsAtQueueDepth)
+{
+  std::vector<std::byte> page(PAGE_SIZE, std::byte{0x42});
+  for (database::PageId page_id = 1; page_id <= 4; ++page_id) {
+    EXPECT_TRUE(engine_->prepare({ database::IoOperation::WRITE, segment_.get(), page_id, page.data(), -1, page_id }));
+  }
+  EXPECT_FALSE(engine_->prepare({ database::IoOperation::WRITE, segment_.get(), 5, page.data(), -1, 5 }));
+  EXPECT_EQ(engine_->getInFlight(), 4);
+
+  engine_->submit();
+  std::vector<database::IoCompletion> completions;
+  EXPECT_EQ(engine_->reap(completions, 4), 4);
+  EXPECT_EQ(engine_->getInFlight(), 0);
+  EXPECT_EQ(segment_->getPageCount(), 4);
+}
+
+TEST_P(IoEngineTest, WritesAndReadsBatches)
+{
+  for (bool registered : {false, true}) {
+    if (registered && !engine_->registerBuffers(buffer_pointers_, PAGE_SIZE)) {
+      continue;
+    }
+    for (size_t i = 0; i < PAGES; ++i) {
+      std::fill(buffers_[i].begin(), buffers_[i].end(), std::byte{static_cast<uint8_t>(i + (registered ? 100 : 1))});
+    }
+    auto written = runAll(database::IoOperation::WRITE, registered);
+    ASSERT_EQ(written.size(), PAGES);
+    for (const auto& completion : written) {
+      EXPECT_EQ(completion.transferred, PAGE_SIZE);
+    }
+
+    for (auto& buffer : buffers_) {
+      std::fill(buffer.begin(), buffer.end(), std::byte{0});
+    }
+    auto read = runAll(database::IoOperation::READ, registered);
+    ASSERT_EQ(read.size(), PAGES);
+    for (const auto& completion : read) {
+      ASSERT_LT(completion.user_data, PAGES);
+      EXPECT_EQ(completion.transferred, PAGE_SIZE);
+      EXPECT_EQ(buffers_[completion.user_data][PAGE_SIZE - 1],
+                std::byte{static_cast<uint8_t>(completion.user_data + (registered ? 100 : 1))});
+    }
+  }
+}
+
+TEST_P(IoEngineTest, ReadPastEndOfFileFails)
+{
+  ASSERT_TRUE(segment_->writePage(1, buffer_pointers_[0]));
+  ASSERT_TRUE(engine_->prepare({ database::IoOperation::READ, segment_.get(), 1, buffer_pointers_[0], -1, 1 }));
+  ASSERT_TRUE(engine_->prepare({ database::IoOperation::READ, segment_.get(), 2, buffer_pointers_[1], -1, 2 }));
+  engine_->submit();
+
+  std::vector<database::IoCompletion> completions;
+  ASSERT_EQ(engine_->reap(completions, 2), 2);
+  std::sort(completions.begin(), completions.end(),
+            [](const auto& a, const auto& b) { return a.user_data < b.user_data; });
+  EXPECT_EQ(completions[0].transferred, PAGE_SIZE);
+  EXPECT_LT(completions[1].transferred, PAGE_SIZE);
+}
+
+INSTANTIATE_TEST_SUITE_P(Engines, IoEngineTest,
+                         ::testing::Values(database::IoEngineType::PREAD, database::IoEngineType::IO_URING,
+                                           database::IoEngineType::AUTO));
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,83 @@
+#include "database/page_directory.hpp"
+#include "database/page.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(PageDirectoryTest, EmptyDirectoryReturnsNull)
+{
+  database::PageDirectory directory;
+  EXPECT_EQ(directory.get(1), nullptr);
+  EXPECT_EQ(directory.size(), 0);
+}
+
+TEST(PageDirectoryTest, CanSetAndGetPages)
+{
+  database::Page page1(1, 8192);
+  database::Page page2(5000, 8192);
+  
+  database::PageDirectory directory;
+  directory.set(1, &page1);
+  directory.set(5000, &page2);
+  
+  EXPECT_EQ(directory.get(1), &page1);
+  EXPECT_EQ(directory.get(5000), &page2);
+  EXPECT_EQ(directory.get(2), nullptr);
+  EXPECT_EQ(directory.get(1000000), nullptr);
+  EXPECT_EQ(directory.size(), 2);
+}
+
+TEST(PageDirectoryTest, EraseRemovesPage)
+{
+  database::Page page1(1, 8192);
+  database::Page page2(2, 8192);
+  
+  database::PageDirectory directory;
+  directory.set(1, &page1);
+  directory.set(2, &page2);
+  directory.erase(2);
+  directory.erase(3);  // Unknown pages are ignored
+  
+  EXPECT_EQ(directory.get(1), &page1);
+  EXPECT_EQ(directory.get(2), nullptr);
+  EXPECT_EQ(directory.size(), 1);
+}
+
+TEST(PageDirectoryTest, ReplacingPageKeepsSize)
+{
+  database::Page page1(1, 8192);
+  database::Page page2(1, 8192);
+  
+  database::PageDirectory directory;
+  directory.set(1, &page1);
+  directory.set(1, &page2);
+  
+  EXPECT_EQ(directory.get(1), &page2);
+  EXPECT_EQ(directory.size(), 1);
+}
+
+TEST(PageDirectoryTest, WorksAfterTruncatingTail)
+{
+  database::Page page(1, 8192);
+  
+  database::PageDirectory directory;
+  directory.set(1, &page);
+  for (database::PageId page_id = 2; page_id <= 5000; ++page_id) {
+    directory.set(page_id, &page);
+  }
+  for (database::PageId page_id = 5000; page_id >= 2; --page_id) {
+    directory.erase(page_id);
+  }
+  
+  EXPECT_EQ(directory.size(), 1);
+  EXPECT_EQ(directory.get(1), &page);
+  EXPECT_EQ(directory.get(4000), nullptr);
+  
+  directory.set(4000, &page);
+  EXPECT_EQ(directory.get(4000), &page);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
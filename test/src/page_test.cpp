@@ -12,7 +12,7 @@ TEST(PageTest, CanCreatePage)
   database::Page page(page_id, page_size);
   
   EXPECT_EQ(page.getPageId(), 1);
-  EXPECT_GE(page.getFreeSpace(), page_size - sizeof(database::Page));  // Some space used by page header
+  EXPECT_EQ(page.getFreeSpace(), page_size - sizeof(database::PageHeader));  // Some space used by page header
 }
 
 TEST(PageTest, CanInsertTuple)
@@ -46,8 +46,8 @@ TEST(PageTest, CanGetTuple)
   auto slot = page.insertTuple(tuple);
   ASSERT_NE(slot, nullptr);
   
-  auto retrieved = page.getTuple(*slot);
-  ASSERT_NE(retrieved, nullptr);
+  auto retrieved = page.getTuple(*slot, schema);
+  ASSERT_TRUE(retrieved.has_value());
   EXPECT_EQ(retrieved->getXmin(), 100);
   
   auto value = retrieved->getValue(0);
@@ -71,8 +71,8 @@ TEST(PageTest, CanDeleteTuple)
   
   page.deleteTuple(*slot);
   
-  auto retrieved = page.getTuple(*slot);
-  EXPECT_EQ(retrieved, nullptr);  // Should be deleted
+  auto retrieved = page.getTuple(*slot, schema);
+  EXPECT_FALSE(retrieved.has_value());  // Should be deleted
 }
 
 TEST(PageTest, CanUpdateTuple)
@@ -95,8 +95,8 @@ TEST(PageTest, CanUpdateTuple)
   bool updated = page.updateTuple(*slot, tuple2);
   EXPECT_TRUE(updated);
   
-  auto retrieved = page.getTuple(*slot);
-  ASSERT_NE(retrieved, nullptr);
+  auto retrieved = page.getTuple(*slot, schema);
+  ASSERT_TRUE(retrieved.has_value());
   auto value = retrieved->getValue(0);
   ASSERT_TRUE(value.has_value());
   EXPECT_EQ(std::get<int64_t>(value.value()), 43);
@@ -133,6 +133,247 @@ TEST(PageTest, ReturnsFalseWhenNoFreeSpace)
   EXPECT_FALSE(page.hasFreeSpace(huge_size));
 }
 
+TEST(PageTest, FreeSpaceAccountsForTupleAndLinePointer)
+{
+  database::Page page(1, 8192);
+  
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  std::vector<database::Value> values = {database::Value{42LL}};
+  database::Tuple tuple(schema, values, 100);
+  
+  size_t before = page.getFreeSpace();
+  ASSERT_NE(page.insertTuple(tuple), nullptr);
+  EXPECT_EQ(page.getFreeSpace(), before - database::Page::getRequiredSpace(tuple.getSize()));
+  EXPECT_EQ(page.getSlotCount(), 1);
+}
+
+TEST(PageTest, InsertFailsWhenPageIsFull)
+{
+  database::Page page(1, 8192);
+  
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  std::vector<database::Value> values = {database::Value{42LL}};
+  database::Tuple tuple(schema, values, 100);
+  
+  size_t expected_slots = page.getFreeSpace() / database::Page::getRequiredSpace(tuple.getSize());
+  size_t inserted = 0;
+  while (page.insertTuple(tuple) != nullptr) {
+    ++inserted;
+  }
+  
+  EXPECT_EQ(inserted, expected_slots);
+  EXPECT_LT(page.getFreeSpace(), database::Page::getRequiredSpace(tuple.getSize()));
+}
+
+TEST(PageTest, UpdateCanGrowTuple)
+{
+  database::Page page(1, 8192);
+  
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "name", database::DataType::TEXT, true, false));
+  
+  std::vector<database::Value> values1 = {database::Value{std::string("a")}};
+  database::Tuple tuple1(schema, values1, 100);
+  auto slot = page.insertTuple(tuple1);
+  ASSERT_NE(slot, nullptr);
+  
+  std::vector<database::Value> values2 = {database::Value{std::string(200, 'b')}};
+  database::Tuple tuple2(schema, values2, 200);
+  EXPECT_TRUE(page.updateTuple(*slot, tuple2));
+  
+  auto retrieved = page.getTuple(*slot, schema);
+  ASSERT_TRUE(retrieved.has_value());
+  EXPECT_EQ(retrieved->getXmin(), 200);
+  EXPECT_EQ(std::get<std::string>(retrieved->getValue(0).value()), std::string(200, 'b'));
+}
+
+TEST(PageTest, UpdateTupleBytesPlacesBytesLikeUpdateTuple)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "name", database::DataType::TEXT, true, false));
+  database::Tuple small(schema, {database::Value{std::string("a")}}, 100);
+  database::Tuple large(schema, {database::Value{std::string(200, 'b')}}, 200);
+  
+  database::Page updated(1, 8192);
+  database::Page replayed(1, 8192);
+  auto slot = updated.insertTuple(small);
+  ASSERT_NE(slot, nullptr);
+  ASSERT_NE(replayed.insertTuple(small), nullptr);
+  ASSERT_TRUE(updated.updateTuple(*slot, large));
+  
+  auto view = updated.getTuple(*slot, schema);
+  ASSERT_TRUE(view.has_value());
+  EXPECT_TRUE(replayed.updateTupleBytes(*slot, std::span(view->getData(), view->getSize())));
+  EXPECT_EQ(replayed.getFreeSpace(), updated.getFreeSpace());
+  
+  auto retrieved = replayed.getTuple(*slot, schema);
+  ASSERT_TRUE(retrieved.has_value());
+  EXPECT_EQ(retrieved->getText(0), std::string(200, 'b'));
+  
+  replayed.deleteTuple(*slot);
+  EXPECT_FALSE(replayed.updateTupleBytes(*slot, std::span(view->getData(), view->getSize())));
+}
+
+TEST(PageTest, PruneRedirectsChainRootsAndReusesHeapOnlySlots)
+{
+  database::Page page(1, 8192);
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  auto insert = [&](int64_t value, database::TransactionId xmin) {
+    auto tuple_id = page.insertTuple(database::Tuple(schema, {database::Value{value}}, xmin));
+    EXPECT_NE(tuple_id, nullptr);
+    return *tuple_id;
+  };
+  // Link version to successor as a HOT update by successor's creator
+  auto link = [&](const database::TupleId& version, const database::TupleId& successor) {
+    database::TupleHeader* header = page.getTupleHeader(version);
+    header->setXmax(page.getTupleHeader(successor)->getXmin());
+    header->setCtid(successor);
+    header->setHotUpdated(true);
+    page.getTupleHeader(successor)->setHeapOnly(true);
+  };
+  
+  // A chain root -> v1 -> v2 updated by transactions 2 and 3, and a deleted row
+  auto root = insert(0, 1);
+  auto v1 = insert(1, 2);
+  auto v2 = insert(2, 3);
+  auto deleted = insert(9, 1);
+  link(root, v1);
+  link(v1, v2);
+  page.deleteTuple(deleted);
+  ASSERT_TRUE(page.isPrunable());
+  size_t tuple_space = database::Page::getRequiredSpace(database::Tuple(schema, {database::Value{int64_t{0}}}, 0).getSize()) -
+                       sizeof(database::LinePointer);
+  
+  // Transaction 2 is old enough: the root's version is dead but v1 lives on
+  auto dead_before = [](database::TransactionId horizon) {
+    return [horizon](const database::TupleHeader& header) {
+      return header.isDeleted() || (header.getXmax() != 0 && header.getXmax() < horizon);
+    };
+  };
+  size_t free_before = page.getFreeSpace();
+  EXPECT_EQ(page.prune(dead_before(3)), 2 * tuple_space);
+  EXPECT_EQ(page.getFreeSpace(), free_before + 2 * tuple_space);
+  EXPECT_EQ(page.resolveRedirect(root), v1);
+  EXPECT_EQ(page.resolveRedirect(deleted), deleted);
+  EXPECT_FALSE(page.getTuple(root, schema).has_value());
+  EXPECT_FALSE(page.getTuple(deleted, schema).has_value());
+  EXPECT_EQ(page.getTuple(v1, schema)->getInteger(0), 1);
+  EXPECT_EQ(page.getTuple(v2, schema)->getInteger(0), 2);
+  EXPECT_TRUE(page.isPrunable());  // v1's updater is not old enough yet
+  
+  // Then v1 dies too: the redirect moves on and v1's slot is reused
+  EXPECT_EQ(page.prune(dead_before(4)), tuple_space);
+  EXPECT_EQ(page.resolveRedirect(root), v2);
+  EXPECT_FALSE(page.isPrunable());
+  EXPECT_EQ(insert(5, 4), v1);
+  EXPECT_EQ(page.getTuple(v1, schema)->getInteger(0), 5);
+  EXPECT_EQ(page.getTuple(v2, schema)->getInteger(0), 2);
+  EXPECT_EQ(insert(6, 4).second, 4);
+  EXPECT_EQ(page.getSlotCount(), 5);
+  
+  // Nothing left to prune
+  EXPECT_EQ(page.prune(dead_before(4)), 0);
+}
+
+TEST(PageTest, PruneCompactsSpaceLeftByMovedTuples)
+{
+  database::Page page(1, 8192);
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "name", database::DataType::TEXT, false, false));
+  
+  auto first = page.insertTuple(database::Tuple(schema, {database::Value{std::string(10, 'a')}}, 1));
+  auto second = page.insertTuple(database::Tuple(schema, {database::Value{std::string(10, 'b')}}, 1));
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  size_t free_after_inserts = page.getFreeSpace();
+  ASSERT_TRUE(page.updateTuple(*first, database::Tuple(schema, {database::Value{std::string(100, 'c')}}, 1)));
+  size_t grown = database::Page::getRequiredSpace(database::Tuple(schema, {database::Value{std::string(100, 'c')}}, 1).getSize()) -
+                 database::Page::getRequiredSpace(database::Tuple(schema, {database::Value{std::string(10, 'a')}}, 1).getSize());
+  
+  // The old bytes of the moved tuple are given back; both tuples survive
+  EXPECT_GT(page.prune([](const database::TupleHeader&) { return false; }), 0);
+  EXPECT_EQ(page.getFreeSpace(), free_after_inserts - grown);
+  EXPECT_EQ(page.getTuple(*first, schema)->getText(0), std::string(100, 'c'));
+  EXPECT_EQ(page.getTuple(*second, schema)->getText(0), std::string(10, 'b'));
+}
+
+TEST(PageTest, FreedDeadLinesAreReused)
+{
+  database::Page page(1, 8192);
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  std::vector<database::TupleId> rows;
+  for (int64_t i = 0; i < 4; ++i) {
+    rows.push_back(*page.insertTuple(database::Tuple(schema, {database::Value{i}}, 1)));
+  }
+  page.deleteTuple(rows[1]);
+  page.deleteTuple(rows[3]);
+  page.prune([](const database::TupleHeader& header) { return header.isDeleted(); });
+  
+  // Dead chain roots keep their line pointers until index entries are gone
+  std::vector<uint16_t> dead;
+  page.collectDeadLines(dead);
+  EXPECT_EQ(dead, (std::vector<uint16_t>{1, 3}));
+  EXPECT_EQ(page.getSlotCount(), 4);
+  size_t free_before = page.getFreeSpace();
+  
+  // Only DEAD line pointers are freed; the trailing one is given back to the free space
+  std::vector<uint16_t> slots = {0, 1, 3};
+  EXPECT_EQ(page.freeDeadLines(slots), 2);
+  EXPECT_EQ(page.getSlotCount(), 3);
+  EXPECT_EQ(page.getFreeSpace(), free_before + sizeof(database::LinePointer));
+  EXPECT_EQ(page.getTuple(rows[0], schema)->getInteger(0), 0);
+  EXPECT_EQ(page.freeDeadLines(slots), 0);
+  dead.clear();
+  page.collectDeadLines(dead);
+  EXPECT_TRUE(dead.empty());
+  
+  // The next insert takes the freed slot instead of a new line pointer
+  EXPECT_EQ(*page.insertTuple(database::Tuple(schema, {database::Value{int64_t{9}}}, 2)), rows[1]);
+  EXPECT_EQ(page.getSlotCount(), 3);
+}
+
+TEST(PageTest, GetTupleReturnsNulloptForUnknownSlot)
+{
+  database::Page page(1, 8192);
+  
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  EXPECT_FALSE(page.getTuple(std::make_pair(1, 0), schema).has_value());
+  EXPECT_FALSE(page.getTuple(std::make_pair(2, 0), schema).has_value());
+}
+
+TEST(PageTest, ViewReadsBytesOwnedElsewhere)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  database::Page page(3, 8192);
+  database::Tuple tuple(schema, {database::Value{int64_t{7}}}, 100);
+  auto tuple_id = page.insertTuple(tuple);
+  ASSERT_NE(tuple_id, nullptr);
+  
+  auto view = database::Page::view(3, page.getData(), 8192);
+  ASSERT_TRUE(view.has_value());
+  EXPECT_EQ(view->getData(), page.getData());
+  EXPECT_EQ(view->getSlotCount(), 1);
+  auto retrieved = view->getTuple(*tuple_id, schema);
+  ASSERT_TRUE(retrieved.has_value());
+  EXPECT_EQ(retrieved->getInteger(0), 7);
+  
+  // The bytes must be a well-formed page with the expected ID
+  EXPECT_FALSE(database::Page::view(4, page.getData(), 8192).has_value());
+  std::vector<std::byte> garbage(8192, std::byte{0x5A});
+  EXPECT_FALSE(database::Page::view(3, garbage.data(), 8192).has_value());
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
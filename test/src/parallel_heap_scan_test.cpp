@@ -0,0 +1,91 @@
+#include "database/parallel_heap_scan.hpp"
+#include "database/heap_file.hpp"
+#include "database/schema.hpp"
+
+#include <gtest/gtest.h>
+#include <set>
+#include <vector>
+
+namespace {
+
+void fillHeap(database::HeapFile& heap_file, const database::Schema& schema, int64_t count)
+{
+  for (int64_t i = 0; i < count; ++i) {
+    std::vector<database::Value> values = {database::Value{i}};
+    database::Tuple tuple(schema, values, 100);
+    ASSERT_NE(heap_file.insertTuple(tuple, 100), nullptr);
+  }
+}
+
+}  // namespace
+
+TEST(ParallelHeapScanTest, ChunksCoverEveryPageOnce)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  database::HeapFile heap_file(1, schema);
+  fillHeap(heap_file, schema, 5000);
+  
+  database::ParallelHeapScan parallel_scan(heap_file, 1, 2);
+  std::set<int64_t> seen;
+  while (auto scan = parallel_scan.claimChunk()) {
+    while (auto scanned = scan->next()) {
+      EXPECT_TRUE(seen.insert(scanned->tuple.getInteger(0)).second);
+    }
+  }
+  EXPECT_EQ(seen.size(), 5000);
+  EXPECT_FALSE(parallel_scan.claimChunk().has_value());
+}
+
+TEST(ParallelHeapScanTest, FilterAndCountMatchesSequentialScan)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  database::HeapFile heap_file(1, schema);
+  fillHeap(heap_file, schema, 20000);
+  
+  for (size_t workers : {size_t{1}, size_t{2}, size_t{4}, size_t{8}}) {
+    database::ParallelHeapScan parallel_scan(heap_file, workers, 4);
+    auto count = parallel_scan.run(
+      size_t{0},
+      [](size_t& partial, const database::ScannedTuple& scanned) {
+        if (scanned.tuple.getInteger(0) % 3 == 0) {
+          ++partial;
+        }
+      },
+      [](size_t& result, size_t partial) { result += partial; });
+    EXPECT_EQ(count, 6667) << "workers=" << workers;
+  }
+}
+
+TEST(ParallelHeapScanTest, CanRunTwice)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  database::HeapFile heap_file(1, schema);
+  fillHeap(heap_file, schema, 1000);
+  
+  database::ParallelHeapScan parallel_scan(heap_file, 2);
+  auto count = [](size_t& partial, const database::ScannedTuple&) { ++partial; };
+  auto sum = [](size_t& result, size_t partial) { result += partial; };
+  EXPECT_EQ(parallel_scan.run(size_t{0}, count, sum), 1000);
+  EXPECT_EQ(parallel_scan.run(size_t{0}, count, sum), 1000);
+}
+
+TEST(ParallelHeapScanTest, EmptyHeap)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  database::HeapFile heap_file(1, schema);
+  
+  database::ParallelHeapScan parallel_scan(heap_file, 4);
+  auto count = parallel_scan.run(
+    size_t{0}, [](size_t& partial, const database::ScannedTuple&) { ++partial; }, [](size_t& r, size_t p) { r += p; });
+  EXPECT_EQ(count, 0);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
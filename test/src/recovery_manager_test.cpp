@@ -0,0 +1,250 @@
+#include "database/recovery_manager.hpp"
+#include "database/bulk_loader.hpp"
+#include "database/checkpointer.hpp"
+#include "database/heap_file.hpp"
+#include "database/heap_scan.hpp"
+#include "database/schema.hpp"
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief A data directory that is "crashed" by copying what reached disk into a second one
+ */
+class RecoveryManagerTest : public ::testing::Test {
+protected:
+  void SetUp() override
+  {
+    live_ = makeDirectory("recovery_live");
+    crashed_ = makeDirectory("recovery_crashed");
+    wal_ = database::WriteAheadLog::open(live_ + "/wal.log");
+    ASSERT_NE(wal_, nullptr);
+    pool_.setWriteAheadLog(wal_.get());
+    schema_.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+    schema_.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  }
+  
+  void TearDown() override
+  {
+    std::filesystem::remove_all(live_);
+    std::filesystem::remove_all(crashed_);
+  }
+  
+  static std::string makeDirectory(const std::string& name)
+  {
+    std::string directory = ::testing::TempDir() + name;
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    return directory;
+  }
+  
+  static std::string segmentPath(const std::string& directory, database::TableId table_id)
+  {
+    return directory + "/" + std::to_string(table_id) + ".heap";
+  }
+  
+  std::unique_ptr<database::HeapFile> openLive(database::TableId table_id)
+  {
+    auto heap_file = database::HeapFile::open(table_id, schema_, pool_, segmentPath(live_, table_id));
+    if (heap_file) {
+      heap_file->setWriteAheadLog(wal_.get());
+    }
+    return heap_file;
+  }
+  
+  void insertRows(database::HeapFile& heap_file, int64_t first, int64_t count)
+  {
+    for (int64_t i = first; i < first + count; ++i) {
+      database::Tuple tuple(schema_, {database::Value{i}, database::Value{"row " + std::to_string(i)}}, 100);
+      ASSERT_NE(heap_file.insertTuple(tuple, 100), nullptr);
+    }
+  }
+  
+  // Keep only the durable log and the pages written so far
+  void crash()
+  {
+    ASSERT_TRUE(wal_->flushAll());
+    std::filesystem::copy(live_, crashed_,
+                          std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing);
+  }
+  
+  static database::RecoveryResult recover(database::BufferPool& pool, const std::string& directory,
+                                          size_t thread_count)
+  {
+    database::RecoveryManager recovery(pool, directory + "/wal.log", directory + "/control",
+                                       [directory](database::TableId table_id) {
+                                         return segmentPath(directory, table_id);
+                                       });
+    return recovery.recover(thread_count);
+  }
+  
+  // Ids of the recovered versions that no update or delete has stamped
+  std::vector<int64_t> recoveredIds(database::BufferPool& pool, const std::string& directory,
+                                    database::TableId table_id)
+  {
+    std::vector<int64_t> ids;
+    auto heap_file = database::HeapFile::open(table_id, schema_, pool, segmentPath(directory, table_id));
+    if (!heap_file) {
+      return ids;
+    }
+    database::HeapScan scan(*heap_file);
+    while (auto scanned = scan.next()) {
+      if (scanned->tuple.getHeader().getXmax() == 0) {
+        ids.push_back(scanned->tuple.getInteger(0));
+      }
+    }
+    return ids;
+  }
+  
+  static std::vector<int64_t> range(int64_t first, int64_t count)
+  {
+    std::vector<int64_t> ids;
+    for (int64_t i = first; i < first + count; ++i) {
+      ids.push_back(i);
+    }
+    return ids;
+  }
+  
+  std::string live_;
+  std::string crashed_;
+  std::unique_ptr<database::WriteAheadLog> wal_;
+  database::BufferPool pool_{ 64 };
+  database::Schema schema_;
+};
+
+}  // namespace
+
+TEST_F(RecoveryManagerTest, RecreatesPagesThatNeverReachedDisk)
+{
+  auto heap_file = openLive(1);
+  ASSERT_NE(heap_file, nullptr);
+  insertRows(*heap_file, 0, 1000);
+  crash();
+  EXPECT_EQ(std::filesystem::file_size(segmentPath(crashed_, 1)), 0);
+  
+  database::BufferPool pool(16);
+  auto result = recover(pool, crashed_, 2);
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_EQ(result.redo_lsn, 0);
+  EXPECT_EQ(result.records_applied, 1000);
+  EXPECT_EQ(result.records_skipped, 0);
+  EXPECT_EQ(recoveredIds(pool, crashed_, 1), range(0, 1000));
+}
+
+TEST_F(RecoveryManagerTest, SkipsChangesPagesAlreadyHave)
+{
+  auto heap_file = openLive(1);
+  ASSERT_NE(heap_file, nullptr);
+  insertRows(*heap_file, 0, 500);
+  ASSERT_TRUE(heap_file->flush());
+  crash();
+  
+  database::BufferPool pool(16);
+  auto result = recover(pool, crashed_, 1);
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_EQ(result.records_applied, 0);
+  EXPECT_EQ(result.records_skipped, 500);
+  EXPECT_EQ(recoveredIds(pool, crashed_, 1), range(0, 500));
+}
+
+TEST_F(RecoveryManagerTest, StartsAtCheckpointRedoLsn)
+{
+  auto heap_file = openLive(1);
+  ASSERT_NE(heap_file, nullptr);
+  insertRows(*heap_file, 0, 400);
+  database::Checkpointer checkpointer(*wal_, pool_, live_ + "/control");
+  ASSERT_TRUE(checkpointer.checkpoint());
+  insertRows(*heap_file, 400, 300);
+  crash();
+  
+  database::BufferPool pool(16);
+  auto result = recover(pool, crashed_, 4);
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_EQ(result.redo_lsn, checkpointer.getRedoLsn());
+  EXPECT_EQ(result.records_applied + result.records_skipped, 300);
+  EXPECT_EQ(recoveredIds(pool, crashed_, 1), range(0, 700));
+}
+
+TEST_F(RecoveryManagerTest, ParallelRedoMatchesSerialRedo)
+{
+  auto first = openLive(1);
+  auto second = openLive(2);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  insertRows(*first, 0, 800);
+  insertRows(*second, 1000, 800);
+  
+  // Updates add new versions and relink the old ones; deletes stamp them
+  for (int64_t slot = 0; slot < 20; ++slot) {
+    database::TupleId tuple_id = std::make_pair(1, static_cast<uint16_t>(slot));
+    database::Tuple tuple(schema_, {database::Value{-slot}, database::Value{std::string(40, 'u')}}, 101);
+    ASSERT_NE(first->updateTuple(tuple_id, tuple, 101), nullptr);
+    second->deleteTuple(tuple_id, 101);
+  }
+  crash();
+  std::string serial_directory = makeDirectory("recovery_serial");
+  std::filesystem::copy(crashed_, serial_directory, std::filesystem::copy_options::overwrite_existing |
+                                                    std::filesystem::copy_options::recursive);
+  
+  database::BufferPool parallel_pool(16);
+  auto parallel = recover(parallel_pool, crashed_, 8);
+  ASSERT_TRUE(parallel.success) << parallel.error_message;
+  database::BufferPool serial_pool(16);
+  auto serial = recover(serial_pool, serial_directory, 1);
+  ASSERT_TRUE(serial.success) << serial.error_message;
+  EXPECT_EQ(parallel.records_applied, serial.records_applied);
+  
+  for (database::TableId table_id = 1; table_id <= 2; ++table_id) {
+    EXPECT_EQ(recoveredIds(parallel_pool, crashed_, table_id), recoveredIds(serial_pool, serial_directory, table_id));
+  }
+  EXPECT_EQ(recoveredIds(serial_pool, serial_directory, 1).size(), 800);
+  EXPECT_EQ(recoveredIds(serial_pool, serial_directory, 2).size(), 780);
+  std::filesystem::remove_all(serial_directory);
+}
+
+TEST_F(RecoveryManagerTest, ReplaysBulkLoadedPageImages)
+{
+  auto heap_file = openLive(1);
+  ASSERT_NE(heap_file, nullptr);
+  std::string csv;
+  for (int i = 0; i < 2000; ++i) {
+    csv += std::to_string(i) + ",bulk\n";
+  }
+  database::BulkLoader loader(*heap_file);
+  ASSERT_TRUE(loader.loadCsvData(csv, 100).success);
+  crash();
+  
+  database::BufferPool pool(16);
+  auto result = recover(pool, crashed_, 2);
+  ASSERT_TRUE(result.success) << result.error_message;
+  EXPECT_EQ(result.records_applied, heap_file->getPageCount());
+  EXPECT_EQ(recoveredIds(pool, crashed_, 1), range(0, 2000));
+}
+
+TEST_F(RecoveryManagerTest, FailsOnRecordThatDoesNotMatchItsPage)
+{
+  auto heap_file = openLive(1);
+  ASSERT_NE(heap_file, nullptr);
+  insertRows(*heap_file, 0, 10);
+  // An insert claiming a slot the page would not hand out
+  database::Tuple tuple(schema_, {database::Value{int64_t{99}}, database::Value{nullptr}}, 100);
+  std::vector<std::byte> bytes(tuple.getSize());
+  tuple.serialize(bytes.data());
+  wal_->append(database::WalRecordType::INSERT, 100, 1, std::make_pair(1, 42), bytes);
+  crash();
+  
+  database::BufferPool pool(16);
+  auto result = recover(pool, crashed_, 1);
+  EXPECT_FALSE(result.success);
+  EXPECT_FALSE(result.error_message.empty());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
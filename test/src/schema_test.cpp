@@ -1,6 +1,7 @@
 #include "database/schema.hpp"
 
 #include <gtest/gtest.h>
+#include <sstream>
 #include <string>
 
 TEST(SchemaTest, CanCreateEmptySchema)
@@ -65,6 +66,60 @@ TEST(ColumnTest, PrimaryKeyColumn)
   EXPECT_FALSE(col.isNullable());
 }
 
+TEST(SchemaTest, LayoutPlacesFixedWidthColumnsAligned)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "active", database::DataType::BOOLEAN, false, false));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  schema.addColumn(database::Column(2, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(3, "score", database::DataType::DOUBLE, true, false));
+  
+  const auto& layout = schema.getLayout();
+  EXPECT_EQ(layout.getColumnCount(), 4);
+  EXPECT_EQ(layout.getColumnOffset(2) % 8, 0);
+  EXPECT_EQ(layout.getColumnOffset(3), layout.getColumnOffset(2) + 8);
+  EXPECT_EQ(layout.getColumnOffset(1), layout.getColumnOffset(3) + 8);
+  EXPECT_EQ(layout.getColumnOffset(0), layout.getColumnOffset(1) + 4);
+  EXPECT_EQ(layout.getFixedSize(), layout.getColumnOffset(0) + 1);
+  ASSERT_EQ(layout.getTextColumns().size(), 1);
+  EXPECT_EQ(layout.getTextColumns()[0], 1);
+}
+
+TEST(SchemaTest, CloneAndSerializationPreserveColumnsAndLayout)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  schema.addColumn(database::Column(2, "score", database::DataType::DOUBLE, true, false));
+  schema.addColumn(database::Column(3, "active", database::DataType::BOOLEAN, false, false));
+  
+  std::stringstream stream;
+  ASSERT_TRUE(schema.writeTo(stream));
+  auto loaded = database::Schema::readFrom(stream);
+  ASSERT_TRUE(loaded.has_value());
+  
+  database::Schema cloned = schema.clone();
+  for (const database::Schema* copy : {&cloned, &*loaded}) {
+    ASSERT_EQ(copy->getColumnCount(), 4);
+    for (database::ColumnId i = 0; i < 4; ++i) {
+      const auto& expected = schema.getColumns()[i];
+      const auto& actual = copy->getColumns()[i];
+      EXPECT_EQ(actual.getColumnId(), expected.getColumnId());
+      EXPECT_EQ(actual.getName(), expected.getName());
+      EXPECT_EQ(actual.getDataType(), expected.getDataType());
+      EXPECT_EQ(actual.isNullable(), expected.isNullable());
+      EXPECT_EQ(actual.isPrimaryKey(), expected.isPrimaryKey());
+      EXPECT_EQ(copy->getLayout().getColumnOffset(i), schema.getLayout().getColumnOffset(i));
+    }
+    EXPECT_EQ(copy->getLayout().getFixedSize(), schema.getLayout().getFixedSize());
+  }
+  
+  // Truncated input is rejected
+  std::string bytes = stream.str();
+  std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+  EXPECT_FALSE(database::Schema::readFrom(truncated).has_value());
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
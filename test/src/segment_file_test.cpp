@@ -0,0 +1,90 @@
+#include "database/segment_file.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 4096;
+
+std::string tempPath(const std::string& name)
+{
+  std::string path = ::testing::TempDir() + name;
+  std::remove(path.c_str());
+  return path;
+}
+
+std::vector<std::byte> filledPage(uint8_t fill)
+{
+  return std::vector<std::byte>(PAGE_SIZE, std::byte{fill});
+}
+
+}  // namespace
+
+TEST(SegmentFileTest, NewFileIsEmpty)
+{
+  std::string path = tempPath("segment_new.heap");
+  auto segment = database::SegmentFile::open(path, PAGE_SIZE);
+  ASSERT_NE(segment, nullptr);
+  EXPECT_EQ(segment->getPageCount(), 0);
+  EXPECT_EQ(segment->getPageSize(), PAGE_SIZE);
+  
+  std::vector<std::byte> out(PAGE_SIZE);
+  EXPECT_FALSE(segment->readPage(1, out.data()));
+  std::remove(path.c_str());
+}
+
+TEST(SegmentFileTest, WritesAndReadsPages)
+{
+  std::string path = tempPath("segment_rw.heap");
+  auto segment = database::SegmentFile::open(path, PAGE_SIZE);
+  ASSERT_NE(segment, nullptr);
+  
+  auto page1 = filledPage(0x11);
+  auto page3 = filledPage(0x33);
+  ASSERT_TRUE(segment->writePage(1, page1.data()));
+  ASSERT_TRUE(segment->writePage(3, page3.data()));
+  EXPECT_EQ(segment->getPageCount(), 3);
+  
+  std::vector<std::byte> out(PAGE_SIZE);
+  ASSERT_TRUE(segment->readPage(3, out.data()));
+  EXPECT_EQ(out, page3);
+  ASSERT_TRUE(segment->readPage(2, out.data()));  // Hole reads back as zeros
+  EXPECT_EQ(out, filledPage(0));
+  EXPECT_FALSE(segment->readPage(0, out.data()));
+  EXPECT_FALSE(segment->readPage(4, out.data()));
+  std::remove(path.c_str());
+}
+
+TEST(SegmentFileTest, PagesSurviveReopen)
+{
+  std::string path = tempPath("segment_reopen.heap");
+  {
+    auto segment = database::SegmentFile::open(path, PAGE_SIZE);
+    ASSERT_NE(segment, nullptr);
+    auto page = filledPage(0x42);
+    ASSERT_TRUE(segment->writePage(1, page.data()));
+    ASSERT_TRUE(segment->sync());
+  }
+  
+  auto segment = database::SegmentFile::open(path, PAGE_SIZE);
+  ASSERT_NE(segment, nullptr);
+  EXPECT_EQ(segment->getPageCount(), 1);
+  std::vector<std::byte> out(PAGE_SIZE);
+  ASSERT_TRUE(segment->readPage(1, out.data()));
+  EXPECT_EQ(out, filledPage(0x42));
+  std::remove(path.c_str());
+}
+
+TEST(SegmentFileTest, OpenFailsForMissingDirectory)
+{
+  EXPECT_EQ(database::SegmentFile::open(::testing::TempDir() + "no/such/dir/file.heap", PAGE_SIZE), nullptr);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,7 +1,28 @@
 #include "database/storage_manager.hpp"
+#include "database/control_file.hpp"
 #include "database/schema.hpp"
+#include "database/heap_scan.hpp"
+#include "database/visibility_checker.hpp"
 
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief An empty directory under the test temp directory
+ */
+std::string freshDirectory(const std::string& name)
+{
+  std::string directory = ::testing::TempDir() + name;
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  return directory;
+}
+
+}  // namespace
 
 TEST(StorageManagerTest, CanCreateStorageManager)
 {
@@ -66,9 +87,257 @@ TEST(StorageManagerTest, CanCreateMultipleTables)
   EXPECT_NE(table1, table2);
 }
 
+TEST(StorageManagerTest, DiskBackedTablesPersistAcrossRestart)
+{
+  std::string directory = freshDirectory("storage_manager_restart");
+  database::StorageOptions options;
+  options.buffer_pool_frames = 16;
+  
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  database::TupleId tuple_id;
+  {
+    database::StorageManager storage(directory, options);
+    ASSERT_NE(storage.getBufferPool(), nullptr);
+    auto table_id = storage.createTable("users", schema);
+    EXPECT_EQ(storage.createTable("users", schema), 0);
+    ASSERT_EQ(table_id, 1);
+    auto* table = storage.getTable(table_id);
+    ASSERT_TRUE(table->isDiskBacked());
+    
+    database::Tuple tuple(schema, {database::Value{int64_t{42}}}, 100);
+    auto inserted = table->insertTuple(tuple, 100);
+    ASSERT_NE(inserted, nullptr);
+    tuple_id = *inserted;
+  }
+  
+  database::StorageManager storage(directory, options);
+  EXPECT_EQ(storage.createTable("users", schema), 0);
+  auto* table = storage.getTable("users");
+  ASSERT_NE(table, nullptr);
+  EXPECT_EQ(table->getTableId(), 1);
+  EXPECT_EQ(table->getSchema().getColumnCount(), 1);
+  auto retrieved = table->getTuple(tuple_id);
+  ASSERT_TRUE(retrieved.has_value());
+  EXPECT_EQ(retrieved->getInteger(0), 42);
+  
+  std::filesystem::remove_all(directory);
+}
+
+TEST(StorageManagerTest, TablesAreFoundByNameAndOpenedLazily)
+{
+  std::string directory = freshDirectory("storage_manager_lazy");
+  database::StorageOptions options;
+  options.buffer_pool_frames = 16;
+  
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  {
+    database::StorageManager storage(directory, options);
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_NE(storage.createTable("table_" + std::to_string(i), schema), 0);
+    }
+    EXPECT_EQ(storage.getOpenTableCount(), 100);
+  }
+  
+  database::StorageManager storage(directory, options);
+  EXPECT_EQ(storage.getCatalog().getTableCount(), 100);
+  EXPECT_EQ(storage.getCatalog().getLoadedSchemaCount(), 0);
+  EXPECT_EQ(storage.getOpenTableCount(), 0);
+  
+  auto table_id = storage.getTableId("table_42");
+  EXPECT_EQ(table_id, 43);
+  EXPECT_EQ(storage.getTableId("missing"), 0);
+  EXPECT_EQ(storage.getTable("missing"), nullptr);
+  EXPECT_EQ(storage.getOpenTableCount(), 0);
+  
+  auto* table = storage.getTable(table_id);
+  ASSERT_NE(table, nullptr);
+  EXPECT_EQ(storage.getTable("table_42"), table);
+  EXPECT_EQ(storage.getOpenTableCount(), 1);
+  EXPECT_EQ(storage.getCatalog().getLoadedSchemaCount(), 1);
+  
+  // IDs keep counting after a restart
+  EXPECT_EQ(storage.createTable("table_100", schema), 101);
+  EXPECT_EQ(storage.createTable("table_100", schema), 0);
+  
+  std::filesystem::remove_all(directory);
+}
+
+TEST(StorageManagerTest, ReadOnlyOpenMapsExistingTables)
+{
+  std::string directory = freshDirectory("storage_manager_read_only");
+  database::StorageOptions options;
+  options.buffer_pool_frames = 16;
+  
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  database::TupleId tuple_id;
+  {
+    database::StorageManager storage(directory, options);
+    auto table_id = storage.createTable("users", schema);
+    database::Tuple tuple(schema, {database::Value{int64_t{42}}}, 100);
+    auto inserted = storage.getTable(table_id)->insertTuple(tuple, 100);
+    ASSERT_NE(inserted, nullptr);
+    tuple_id = *inserted;
+  }
+  
+  options.read_only = true;
+  database::StorageManager storage(directory, options);
+  EXPECT_EQ(storage.getBufferPool(), nullptr);
+  EXPECT_EQ(storage.getWriteAheadLog(), nullptr);
+  EXPECT_FALSE(storage.checkpoint());
+  
+  auto* table = storage.getTable("users");
+  ASSERT_NE(table, nullptr);
+  EXPECT_TRUE(table->isReadOnly());
+  auto retrieved = table->getTuple(tuple_id);
+  ASSERT_TRUE(retrieved.has_value());
+  EXPECT_EQ(retrieved->getInteger(0), 42);
+  
+  // Nothing can be created in a read-only data directory
+  EXPECT_EQ(storage.createTable("posts", schema), 0);
+  
+  std::filesystem::remove_all(directory);
+}
+
+TEST(StorageManagerTest, RecoversChangesAfterCheckpointFromTheLog)
+{
+  std::string directory = freshDirectory("storage_manager_live");
+  std::string crashed = freshDirectory("storage_manager_crashed");
+  database::StorageOptions options;
+  options.buffer_pool_frames = 64;
+  options.redo_threads = 4;
+  
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  
+  std::vector<database::TupleId> tuple_ids;
+  {
+    database::StorageManager storage(directory, options);
+    auto* table = storage.getTable(storage.createTable("users", schema));
+    for (int64_t i = 0; i < 500; ++i) {
+      database::Tuple tuple(schema, {database::Value{i}, database::Value{std::string("before")}}, 100);
+      tuple_ids.push_back(*table->insertTuple(tuple, 100));
+    }
+    ASSERT_TRUE(storage.checkpoint());
+    
+    for (int64_t i = 500; i < 2000; ++i) {
+      database::Tuple tuple(schema, {database::Value{i}, database::Value{std::string("after")}}, 101);
+      tuple_ids.push_back(*table->insertTuple(tuple, 101));
+    }
+    database::Tuple updated(schema, {database::Value{int64_t{-1}}, database::Value{std::string("updated")}}, 102);
+    ASSERT_NE(table->updateTuple(tuple_ids[10], updated, 102), nullptr);
+    table->deleteTuple(tuple_ids[20], 102);
+    
+    // Crash: keep only what reached disk, i.e. the durable log and the pages written so far
+    ASSERT_TRUE(storage.getWriteAheadLog()->flushAll());
+    std::filesystem::copy(directory, crashed,
+                          std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing);
+  }
+  
+  database::StorageManager storage(crashed, options);
+  const auto& recovery = storage.getRecoveryResult();
+  EXPECT_TRUE(recovery.success);
+  EXPECT_GT(recovery.redo_lsn, 0U);
+  EXPECT_GE(recovery.records_applied, 1500U);
+  
+  auto* table = storage.getTable("users");
+  ASSERT_NE(table, nullptr);
+  for (size_t i = 0; i < tuple_ids.size(); ++i) {
+    auto tuple = table->getTuple(tuple_ids[i]);
+    ASSERT_TRUE(tuple.has_value()) << "row " << i;
+    if (i == 20) {
+      EXPECT_EQ(tuple->getHeader().getXmax(), 102);  // Deleted, kept for older snapshots
+      continue;
+    }
+    if (i == 10) {
+      // The old version is recovered with its link to the new one
+      EXPECT_EQ(tuple->getHeader().getXmax(), 102);
+      auto new_version = table->getTuple(tuple->getHeader().getCtid());
+      ASSERT_TRUE(new_version.has_value());
+      EXPECT_EQ(new_version->getInteger(0), -1);
+      EXPECT_EQ(new_version->getText(1), "updated");
+    } else {
+      EXPECT_EQ(tuple->getInteger(0), static_cast<int64_t>(i));
+    }
+  }
+  
+  std::filesystem::remove_all(directory);
+  std::filesystem::remove_all(crashed);
+}
+
+TEST(StorageManagerTest, CommittedRowsStayVisibleAfterRestart)
+{
+  std::string directory = freshDirectory("storage_manager_clog_live");
+  std::string crashed = freshDirectory("storage_manager_clog_crashed");
+  database::StorageOptions options;
+  options.buffer_pool_frames = 16;
+  
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  // Rows 0-9 committed before a checkpoint, 10-19 rolled back, 20-29 cut off by the crash
+  database::TransactionId last_txn_id = 0;
+  {
+    database::StorageManager storage(directory, options);
+    auto* txn_manager = storage.getTransactionManager();
+    ASSERT_NE(txn_manager, nullptr);
+    auto* table = storage.getTable(storage.createTable("users", schema));
+    for (int64_t i = 0; i < 30; ++i) {
+      if (i % 10 == 0) {
+        last_txn_id = txn_manager->beginTransaction(database::IsolationLevel::READ_COMMITTED);
+      }
+      database::Tuple tuple(schema, {database::Value{i}}, last_txn_id);
+      ASSERT_NE(table->insertTuple(tuple, last_txn_id), nullptr);
+      if (i == 9) {
+        ASSERT_TRUE(txn_manager->commitTransaction(last_txn_id));
+        ASSERT_TRUE(storage.checkpoint());
+      } else if (i == 19) {
+        ASSERT_TRUE(txn_manager->rollbackTransaction(last_txn_id));
+      }
+    }
+    
+    ASSERT_TRUE(storage.getWriteAheadLog()->flushAll());
+    std::filesystem::copy(directory, crashed,
+                          std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing);
+  }
+  
+  // The first outcome comes from the commit log the checkpoint saved, not from the log
+  database::StorageManager storage(crashed, options);
+  EXPECT_EQ(storage.getRecoveryResult().transactions_recovered, 2U);
+  auto* txn_manager = storage.getTransactionManager();
+  EXPECT_EQ(txn_manager->getTransactionStatus(last_txn_id - 2), database::TransactionStatus::COMMITTED);
+  EXPECT_EQ(txn_manager->getTransactionStatus(last_txn_id - 1), database::TransactionStatus::ABORTED);
+  EXPECT_EQ(txn_manager->getTransactionStatus(last_txn_id), database::TransactionStatus::ABORTED);
+  
+  // No ID already in a tuple header is handed out again
+  auto txn_id = txn_manager->beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  EXPECT_GT(txn_id, last_txn_id);
+  
+  database::VisibilityChecker checker(*txn_manager);
+  database::HeapScan scan(*storage.getTable("users"));
+  scan.setSnapshot(checker, txn_manager->getSnapshot(*txn_manager->getTransaction(txn_id)));
+  int64_t expected = 0;
+  while (auto scanned = scan.next()) {
+    EXPECT_EQ(scanned->tuple.getInteger(0), expected++);
+  }
+  EXPECT_EQ(expected, 10);
+  
+  // Without the saved commit log the outcomes before the redo LSN are unknown
+  std::filesystem::remove(database::ControlFile::getCommitLogPath(directory + "/control"));
+  EXPECT_THROW(database::StorageManager(directory, options), std::runtime_error);
+  
+  std::filesystem::remove_all(directory);
+  std::filesystem::remove_all(crashed);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
 }
-
@@ -0,0 +1,69 @@
+#include "database/table_stats.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(TableStatsTest, CountsAndEstimatesDeadTuples)
+{
+  database::TableStats stats;
+  stats.countInserts(10);
+  stats.countUpdate();
+  stats.countUpdate();
+  stats.countDelete();
+
+  auto counters = stats.read();
+  EXPECT_EQ(counters.inserts, 10);
+  EXPECT_EQ(counters.updates, 2);
+  EXPECT_EQ(counters.deletes, 1);
+  EXPECT_EQ(counters.dead_tuples, 3);
+  EXPECT_EQ(counters.getLiveTuples(), 9);
+}
+
+TEST(TableStatsTest, VacuumKeepsDeadTuplesCountedAfterItStarted)
+{
+  database::TableStats stats;
+  stats.countUpdate();
+  stats.countDelete();
+  auto at_start = stats.read();
+  stats.countUpdate();  // During the vacuum
+
+  stats.markVacuumed(at_start);
+  EXPECT_EQ(stats.read().dead_tuples, 1);
+  EXPECT_EQ(stats.read().updates, 2);
+
+  // A vacuum that started earlier and finished later changes nothing
+  stats.markVacuumed(database::TableCounters{});
+  EXPECT_EQ(stats.read().dead_tuples, 1);
+}
+
+TEST(TableStatsTest, ThreadsCountConcurrently)
+{
+  constexpr size_t THREAD_COUNT = 2 * database::TableStats::STRIPE_COUNT;  // Some share stripes
+  constexpr uint64_t OPERATIONS = 10000;
+  database::TableStats stats;
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < THREAD_COUNT; ++i) {
+    threads.emplace_back([&stats] {
+      for (uint64_t j = 0; j < OPERATIONS; ++j) {
+        stats.countInserts(1);
+        stats.countUpdate();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto counters = stats.read();
+  EXPECT_EQ(counters.inserts, THREAD_COUNT * OPERATIONS);
+  EXPECT_EQ(counters.updates, THREAD_COUNT * OPERATIONS);
+  EXPECT_EQ(counters.dead_tuples, THREAD_COUNT * OPERATIONS);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
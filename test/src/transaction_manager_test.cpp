@@ -1,6 +1,10 @@
 #include "database/transaction_manager.hpp"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 TEST(TransactionManagerTest, CanCreateTransactionManager)
 {
@@ -37,9 +41,10 @@ TEST(TransactionManagerTest, CanCommitTransaction)
   
   EXPECT_TRUE(committed);
   
-  auto* txn = txn_manager.getTransaction(txn_id);
-  ASSERT_NE(txn, nullptr);
-  EXPECT_EQ(txn->getState(), database::TransactionState::COMMITTED);
+  // The finished transaction is retired to the commit log
+  EXPECT_EQ(txn_manager.getTransaction(txn_id), nullptr);
+  EXPECT_EQ(txn_manager.getTransactionStatus(txn_id), database::TransactionStatus::COMMITTED);
+  EXPECT_FALSE(txn_manager.commitTransaction(txn_id));
 }
 
 TEST(TransactionManagerTest, CanRollbackTransaction)
@@ -51,9 +56,9 @@ TEST(TransactionManagerTest, CanRollbackTransaction)
   
   EXPECT_TRUE(rolled_back);
   
-  auto* txn = txn_manager.getTransaction(txn_id);
-  ASSERT_NE(txn, nullptr);
-  EXPECT_EQ(txn->getState(), database::TransactionState::ABORTED);
+  EXPECT_EQ(txn_manager.getTransaction(txn_id), nullptr);
+  EXPECT_EQ(txn_manager.getTransactionStatus(txn_id), database::TransactionStatus::ABORTED);
+  EXPECT_FALSE(txn_manager.rollbackTransaction(txn_id));
 }
 
 TEST(TransactionManagerTest, IsTransactionActive)
@@ -62,6 +67,7 @@ TEST(TransactionManagerTest, IsTransactionActive)
   
   auto txn_id = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
   EXPECT_TRUE(txn_manager.isTransactionActive(txn_id));
+  EXPECT_EQ(txn_manager.getTransactionStatus(txn_id), database::TransactionStatus::IN_PROGRESS);
   
   txn_manager.commitTransaction(txn_id);
   EXPECT_FALSE(txn_manager.isTransactionActive(txn_id));
@@ -83,6 +89,179 @@ TEST(TransactionManagerTest, GetActiveTransactionIds)
   EXPECT_EQ(active_txns[0], txn_id2);
 }
 
+TEST(TransactionManagerTest, TruncatesCommitLogBelowOldestActiveTransaction)
+{
+  constexpr size_t XIDS_PER_PAGE = database::CommitLog::XIDS_PER_PAGE;
+  database::TransactionManager txn_manager;
+  
+  auto oldest = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  for (size_t i = 0; i < 3 * XIDS_PER_PAGE; ++i) {
+    auto txn_id = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+    ASSERT_TRUE(txn_manager.commitTransaction(txn_id));
+  }
+  EXPECT_EQ(txn_manager.getCommitLog().getPageCount(), 4);
+  EXPECT_EQ(txn_manager.getOldestActiveTransactionId(), oldest);
+  
+  // Capped at the oldest running transaction, which is on the first page
+  txn_manager.truncateCommitLog(3 * XIDS_PER_PAGE);
+  EXPECT_EQ(txn_manager.getCommitLog().getPageCount(), 4);
+  
+  ASSERT_TRUE(txn_manager.rollbackTransaction(oldest));
+  EXPECT_EQ(txn_manager.getOldestActiveTransactionId(), 3 * XIDS_PER_PAGE + 2);
+  txn_manager.truncateCommitLog(2 * XIDS_PER_PAGE + 5);
+  EXPECT_EQ(txn_manager.getCommitLog().getPageCount(), 2);
+  EXPECT_EQ(txn_manager.getCommitLog().getOldestTransactionId(), 2 * XIDS_PER_PAGE);
+  EXPECT_EQ(txn_manager.getTransactionStatus(2 * XIDS_PER_PAGE + 5), database::TransactionStatus::COMMITTED);
+}
+
+TEST(TransactionManagerTest, RecoveryAbortsTransactionsCutOffByTheCrash)
+{
+  // A checkpoint saves the commit log while one transaction runs
+  database::TransactionManager before_crash;
+  auto committed = before_crash.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  ASSERT_TRUE(before_crash.commitTransaction(committed));
+  auto running = before_crash.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto oldest = before_crash.getOldestActiveTransactionId();
+  EXPECT_EQ(oldest, running);
+  auto next = before_crash.getNextTransactionId();
+  std::stringstream clog;
+  ASSERT_TRUE(before_crash.getCommitLog().writeTo(clog));
+  
+  // After it, next committed in the log and next + 1 never finished
+  database::TransactionManager txn_manager;
+  ASSERT_TRUE(txn_manager.loadCommitLog(clog));
+  txn_manager.recoverTransactions({ { next + 1, database::TransactionStatus::COMMITTED } }, next, oldest);
+  EXPECT_EQ(txn_manager.getTransactionStatus(committed), database::TransactionStatus::COMMITTED);
+  EXPECT_EQ(txn_manager.getTransactionStatus(running), database::TransactionStatus::ABORTED);
+  EXPECT_EQ(txn_manager.getTransactionStatus(next), database::TransactionStatus::ABORTED);
+  EXPECT_EQ(txn_manager.getTransactionStatus(next + 1), database::TransactionStatus::COMMITTED);
+  EXPECT_EQ(txn_manager.getNextTransactionId(), next + 2);
+  EXPECT_TRUE(txn_manager.isCommittedInSnapshot(next + 1, txn_manager.takeSnapshot()));
+}
+
+TEST(TransactionManagerTest, CsnLogIsTruncatedBehindOldSnapshots)
+{
+  constexpr size_t XIDS_PER_PAGE = database::CsnLog::XIDS_PER_PAGE;
+  database::TransactionManager txn_manager;
+  auto commitMany = [&txn_manager](size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      auto txn_id = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+      ASSERT_TRUE(txn_manager.commitTransaction(txn_id));
+    }
+  };
+  
+  // writer commits below the horizon after reader took its snapshot
+  auto writer = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto reader = txn_manager.beginTransaction(database::IsolationLevel::REPEATABLE_READ);
+  auto snapshot = txn_manager.getSnapshot(*txn_manager.getTransaction(reader));
+  ASSERT_TRUE(txn_manager.commitTransaction(writer));
+  commitMany(4 * XIDS_PER_PAGE);
+  EXPECT_FALSE(txn_manager.isCommittedInSnapshot(writer, snapshot));
+  
+  ASSERT_TRUE(txn_manager.commitTransaction(reader));
+  commitMany(4 * XIDS_PER_PAGE);
+  EXPECT_LE(txn_manager.getCsnLog().getPageCount(), 2);
+  EXPECT_TRUE(txn_manager.isCommittedInSnapshot(writer, txn_manager.takeSnapshot()));
+}
+
+TEST(TransactionManagerTest, SnapshotsAdvanceWithCommitsOnly)
+{
+  database::TransactionManager txn_manager;
+  auto initial = txn_manager.takeSnapshot();
+  
+  auto txn_id1 = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto txn_id2 = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  ASSERT_TRUE(txn_manager.rollbackTransaction(txn_id2));
+  EXPECT_EQ(txn_manager.takeSnapshot().csn, initial.csn);
+  
+  ASSERT_TRUE(txn_manager.commitTransaction(txn_id1));
+  auto snapshot = txn_manager.takeSnapshot(txn_id2);
+  EXPECT_EQ(snapshot.csn, initial.csn + 1);
+  EXPECT_EQ(snapshot.txn_id, txn_id2);
+  EXPECT_EQ(txn_manager.getLastCommitSeqNo(), snapshot.csn);
+  
+  EXPECT_FALSE(txn_manager.isCommittedInSnapshot(txn_id1, initial));
+  EXPECT_TRUE(txn_manager.isCommittedInSnapshot(txn_id1, snapshot));
+  EXPECT_FALSE(txn_manager.isCommittedInSnapshot(txn_id2, txn_manager.takeSnapshot()));
+}
+
+TEST(TransactionManagerTest, SnapshotPerIsolationLevel)
+{
+  database::TransactionManager txn_manager;
+  auto read_committed = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto repeatable_read = txn_manager.beginTransaction(database::IsolationLevel::REPEATABLE_READ);
+  auto* rc_txn = txn_manager.getTransaction(read_committed);
+  auto* rr_txn = txn_manager.getTransaction(repeatable_read);
+  
+  auto rc_first = txn_manager.getSnapshot(*rc_txn);
+  auto rr_first = txn_manager.getSnapshot(*rr_txn);
+  EXPECT_EQ(rc_first.txn_id, read_committed);
+  EXPECT_EQ(rr_first.txn_id, repeatable_read);
+  
+  // No commit in between: READ_COMMITTED reuses its cached snapshot
+  EXPECT_EQ(&txn_manager.getSnapshot(*rc_txn), &*rc_txn->getSnapshot());
+  EXPECT_EQ(txn_manager.getSnapshot(*rc_txn).csn, rc_first.csn);
+  
+  txn_manager.commitTransaction(txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED));
+  EXPECT_EQ(txn_manager.getSnapshot(*rc_txn).csn, rc_first.csn + 1);
+  EXPECT_EQ(txn_manager.getSnapshot(*rr_txn).csn, rr_first.csn);
+}
+
+TEST(TransactionManagerTest, BeginFailsWhileEveryProcSlotIsTaken)
+{
+  database::TransactionManager txn_manager(2);
+  EXPECT_EQ(txn_manager.getMaxActiveTransactions(), 2);
+  
+  auto txn_id1 = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto txn_id2 = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  ASSERT_NE(txn_id1, 0);
+  ASSERT_NE(txn_id2, 0);
+  EXPECT_EQ(txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED), 0);
+  
+  // Finishing a transaction frees its slot
+  ASSERT_TRUE(txn_manager.rollbackTransaction(txn_id1));
+  auto txn_id3 = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  EXPECT_GT(txn_id3, txn_id2);
+  EXPECT_EQ(txn_manager.getActiveTransactionIds(), (std::vector<database::TransactionId>{txn_id2, txn_id3}));
+}
+
+TEST(TransactionManagerTest, ConcurrentBeginAndCommitAssignUniqueIds)
+{
+  constexpr size_t THREADS = 8;
+  constexpr size_t TRANSACTIONS_PER_THREAD = 2000;
+  database::TransactionManager txn_manager(THREADS);
+  
+  std::vector<std::vector<database::TransactionId>> txn_ids(THREADS);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t i = 0; i < TRANSACTIONS_PER_THREAD; ++i) {
+        auto txn_id = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+        ASSERT_NE(txn_id, 0);
+        ASSERT_TRUE(txn_manager.isTransactionActive(txn_id));
+        if (i % 4 == 0) {
+          ASSERT_TRUE(txn_manager.rollbackTransaction(txn_id));
+        } else {
+          ASSERT_TRUE(txn_manager.commitTransaction(txn_id));
+        }
+        txn_ids[t].push_back(txn_id);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  
+  std::vector<database::TransactionId> all_ids;
+  for (const auto& ids : txn_ids) {
+    all_ids.insert(all_ids.end(), ids.begin(), ids.end());
+  }
+  std::sort(all_ids.begin(), all_ids.end());
+  EXPECT_EQ(std::adjacent_find(all_ids.begin(), all_ids.end()), all_ids.end());
+  EXPECT_EQ(all_ids.size(), THREADS * TRANSACTIONS_PER_THREAD);
+  EXPECT_TRUE(txn_manager.getActiveTransactionIds().empty());
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
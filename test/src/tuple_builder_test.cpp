@@ -0,0 +1,126 @@
+#include "database/tuple_builder.hpp"
+#include "database/schema.hpp"
+#include "database/tuple.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+void makeSchema(database::Schema& schema)
+{
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  schema.addColumn(database::Column(2, "score", database::DataType::DOUBLE, true, false));
+  schema.addColumn(database::Column(3, "active", database::DataType::BOOLEAN, true, false));
+  schema.addColumn(database::Column(4, "note", database::DataType::TEXT, true, false));
+}
+
+}  // namespace
+
+TEST(TupleBuilderTest, BuildsSameBytesAsTupleSerialize)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  
+  database::Tuple tuple(schema, {database::Value{int64_t{7}}, database::Value{"alice"}, database::Value{2.5},
+                                 database::Value{true}, database::Value{"hi"}}, 42);
+  std::string expected(tuple.getSize(), '\0');
+  tuple.serialize(reinterpret_cast<std::byte*>(expected.data()));
+  
+  database::TupleBuilder builder(schema);
+  builder.reset(42);
+  builder.setInteger(0, 7);
+  builder.setText(1, "alice");
+  builder.setDouble(2, 2.5);
+  builder.setBoolean(3, true);
+  builder.setText(4, "hi");
+  auto bytes = builder.build();
+  ASSERT_TRUE(bytes.has_value());
+  
+  // TupleHeader padding is unspecified, so compare the header by field
+  ASSERT_EQ(bytes->size(), expected.size());
+  database::TupleView view(schema, bytes->data(), bytes->size());
+  EXPECT_EQ(view.getXmin(), 42);
+  size_t body = sizeof(database::TupleHeader);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(bytes->data()) + body, bytes->size() - body), expected.substr(body));
+}
+
+TEST(TupleBuilderTest, UnsetColumnsAreNull)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  
+  database::TupleBuilder builder(schema);
+  builder.reset(1);
+  builder.setInteger(0, 1);
+  builder.setText(4, "note");
+  auto bytes = builder.build();
+  ASSERT_TRUE(bytes.has_value());
+  
+  database::TupleView view(schema, bytes->data(), bytes->size());
+  ASSERT_TRUE(view.isWellFormed());
+  EXPECT_EQ(view.getXmin(), 1);
+  EXPECT_EQ(view.getInteger(0), 1);
+  EXPECT_TRUE(view.isNull(1));
+  EXPECT_TRUE(view.isNull(2));
+  EXPECT_TRUE(view.isNull(3));
+  EXPECT_EQ(view.getText(4), "note");
+}
+
+TEST(TupleBuilderTest, RejectsNullInNonNullableColumn)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  
+  database::TupleBuilder builder(schema);
+  builder.reset(1);
+  builder.setText(1, "no id");
+  EXPECT_FALSE(builder.build().has_value());
+  
+  builder.setInteger(0, 3);
+  builder.setNull(0);
+  EXPECT_FALSE(builder.build().has_value());
+}
+
+TEST(TupleBuilderTest, RejectsRowsTooLargeForTextOffsets)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  std::string big(70000, 'x');
+  
+  database::TupleBuilder builder(schema);
+  builder.reset(1);
+  builder.setInteger(0, 1);
+  builder.setText(1, big);
+  EXPECT_FALSE(builder.build().has_value());
+}
+
+TEST(TupleBuilderTest, ResetStartsAFreshRow)
+{
+  database::Schema schema;
+  makeSchema(schema);
+  
+  database::TupleBuilder builder(schema);
+  builder.reset(1);
+  builder.setInteger(0, 1);
+  builder.setText(1, "a much longer first row");
+  ASSERT_TRUE(builder.build().has_value());
+  
+  builder.reset(2);
+  builder.setInteger(0, 2);
+  auto bytes = builder.build();
+  ASSERT_TRUE(bytes.has_value());
+  EXPECT_EQ(bytes->size(), schema.getLayout().getFixedSize());
+  
+  database::TupleView view(schema, bytes->data(), bytes->size());
+  EXPECT_EQ(view.getXmin(), 2);
+  EXPECT_EQ(view.getInteger(0), 2);
+  EXPECT_TRUE(view.isNull(1));
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
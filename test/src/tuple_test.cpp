@@ -40,6 +40,24 @@ TEST(TupleHeaderTest, CanSetCtid)
   EXPECT_EQ(header.getCtid(), next_tuple_id);
 }
 
+TEST(TupleHeaderTest, HintBitsAccumulateAndXmaxHintsResetWithXmax)
+{
+  const database::TupleHeader header(100);
+  EXPECT_EQ(header.getInfomask(), 0);
+  
+  header.setHintBits(database::TupleHeader::XMIN_COMMITTED);
+  header.setHintBits(database::TupleHeader::XMAX_INVALID);
+  EXPECT_TRUE(header.hasHintBits(database::TupleHeader::XMIN_COMMITTED | database::TupleHeader::XMAX_INVALID));
+  EXPECT_FALSE(header.hasHintBits(database::TupleHeader::XMIN_INVALID));
+  
+  // A copy, e.g. into page bytes, keeps the hints
+  database::TupleHeader copy = header;
+  EXPECT_EQ(copy.getInfomask(), header.getInfomask());
+  
+  copy.setXmax(200);
+  EXPECT_EQ(copy.getInfomask(), database::TupleHeader::XMIN_COMMITTED);
+}
+
 TEST(TupleTest, CanCreateTuple)
 {
   database::Schema schema;
@@ -93,6 +111,97 @@ TEST(TupleTest, CanGetSize)
   EXPECT_GT(size, 0);  // Should have some size
 }
 
+TEST(TupleTest, SerializeRoundTrip)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  schema.addColumn(database::Column(2, "score", database::DataType::DOUBLE, true, false));
+  schema.addColumn(database::Column(3, "active", database::DataType::BOOLEAN, true, false));
+  
+  std::vector<database::Value> values = {
+    database::Value{42LL}, database::Value{std::string("test")}, database::Value{2.5}, database::Value{std::nullptr_t{}}
+  };
+  database::Tuple tuple(schema, values, 100);
+  tuple.getHeader().setXmax(200);
+  
+  std::vector<std::byte> buffer(tuple.getSize());
+  tuple.serialize(buffer.data());
+  
+  auto decoded = database::Tuple::deserialize(schema, buffer.data(), buffer.size());
+  ASSERT_TRUE(decoded.has_value());
+  EXPECT_EQ(decoded->getXmin(), 100);
+  EXPECT_EQ(decoded->getHeader().getXmax(), 200);
+  for (database::ColumnId i = 0; i < 4; ++i) {
+    EXPECT_EQ(decoded->getValue(i), tuple.getValue(i));
+  }
+}
+
+TEST(TupleTest, DeserializeRejectsTruncatedInput)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "name", database::DataType::TEXT, true, false));
+  
+  std::vector<database::Value> values = {database::Value{std::string("hello")}};
+  database::Tuple tuple(schema, values, 100);
+  
+  std::vector<std::byte> buffer(tuple.getSize());
+  tuple.serialize(buffer.data());
+  
+  EXPECT_FALSE(database::Tuple::deserialize(schema, buffer.data(), buffer.size() - 1).has_value());
+}
+
+TEST(TupleViewTest, ReadsFieldsFromSerializedBytes)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "active", database::DataType::BOOLEAN, false, false));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  schema.addColumn(database::Column(2, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(3, "score", database::DataType::DOUBLE, true, false));
+  
+  std::vector<database::Value> values = {
+    database::Value{true}, database::Value{std::string("alice")}, database::Value{7LL}, database::Value{std::nullptr_t{}}
+  };
+  database::Tuple tuple(schema, values, 100);
+  ASSERT_TRUE(tuple.matchesSchema());
+  
+  std::vector<std::byte> buffer(tuple.getSize());
+  tuple.serialize(buffer.data());
+  
+  database::TupleView view(schema, buffer.data(), buffer.size());
+  EXPECT_EQ(view.getXmin(), 100);
+  EXPECT_TRUE(view.getBoolean(0));
+  EXPECT_EQ(view.getText(1), "alice");
+  EXPECT_EQ(view.getInteger(2), 7);
+  EXPECT_FALSE(view.isNull(2));
+  EXPECT_TRUE(view.isNull(3));
+  EXPECT_TRUE(std::holds_alternative<std::nullptr_t>(view.getValue(3).value()));
+  EXPECT_FALSE(view.getValue(4).has_value());
+}
+
+TEST(TupleTest, SizeIsFixedAreaPlusText)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  schema.addColumn(database::Column(1, "name", database::DataType::TEXT, true, false));
+  
+  std::vector<database::Value> values = {database::Value{42LL}, database::Value{std::string("test")}};
+  database::Tuple tuple(schema, values, 100);
+  
+  EXPECT_EQ(tuple.getSize(), schema.getLayout().getFixedSize() + 4);
+}
+
+TEST(TupleTest, MatchesSchemaRejectsWrongTypesAndNulls)
+{
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  
+  EXPECT_FALSE(database::Tuple(schema, {database::Value{std::string("42")}}, 100).matchesSchema());
+  EXPECT_FALSE(database::Tuple(schema, {database::Value{std::nullptr_t{}}}, 100).matchesSchema());
+  EXPECT_FALSE(database::Tuple(schema, {}, 100).matchesSchema());
+  EXPECT_TRUE(database::Tuple(schema, {database::Value{42LL}}, 100).matchesSchema());
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
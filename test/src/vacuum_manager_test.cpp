@@ -0,0 +1,453 @@
+#include "database/vacuum_manager.hpp"
+#include "database/visibility_checker.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class VacuumManagerTest : public ::testing::Test {
+protected:
+  void SetUp() override
+  {
+    schema_.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+    schema_.addColumn(database::Column(1, "name", database::DataType::TEXT, false, false));
+    heap_file_.setTransactionManager(&txn_manager_);
+  }
+
+  database::Tuple makeTuple(int64_t id, char fill, database::TransactionId txn_id) const
+  {
+    return database::Tuple(schema_, {database::Value{id}, database::Value{std::string(100, fill)}}, txn_id);
+  }
+
+  // Inserts rows in one committed transaction, enough for several pages
+  void loadRows(int64_t count)
+  {
+    auto txn = txn_manager_.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+    for (int64_t i = 0; i < count; ++i) {
+      rows_.push_back(*heap_file_.insertTuple(makeTuple(i, 'a', txn), txn));
+    }
+    ASSERT_TRUE(txn_manager_.commitTransaction(txn));
+  }
+
+  // Updates every row in its own transaction, committing unless told otherwise
+  void updateRows(char fill, bool commit = true)
+  {
+    for (auto& row : rows_) {
+      auto txn = txn_manager_.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+      auto updated = heap_file_.updateTuple(row, makeTuple(0, fill, txn), txn);
+      ASSERT_NE(updated, nullptr);
+      if (commit) {
+        ASSERT_TRUE(txn_manager_.commitTransaction(txn));
+        row = *updated;
+      } else {
+        ASSERT_TRUE(txn_manager_.rollbackTransaction(txn));
+      }
+    }
+  }
+
+  database::Schema schema_;
+  database::HeapFile heap_file_{ 1, schema_ };
+  database::TransactionManager txn_manager_;
+  std::vector<database::TupleId> rows_;  // Newest committed version of each row
+};
+
+}  // namespace
+
+TEST_F(VacuumManagerTest, ReclaimsDeadVersionsAndMarksPagesAllVisible)
+{
+  loadRows(200);
+  updateRows('b');
+  database::VacuumManager vacuum_manager(txn_manager_);
+
+  auto stats = vacuum_manager.vacuum(heap_file_);
+  EXPECT_TRUE(stats.completed);
+  EXPECT_EQ(stats.pages_scanned, heap_file_.getPageCount());
+  EXPECT_EQ(stats.pages_skipped, 0);
+  EXPECT_GT(stats.pages_pruned, 0);
+  EXPECT_GT(stats.bytes_reclaimed, 0);  // Whatever updates did not prune on the way
+  EXPECT_EQ(stats.pages_all_visible, heap_file_.getPageCount());
+  EXPECT_EQ(stats.frozen_xid, 0);  // Not aggressive
+
+  database::VisibilityChecker checker(txn_manager_);
+  auto snapshot = txn_manager_.takeSnapshot();
+  for (const auto& row : rows_) {
+    auto tuple = heap_file_.getVisibleTuple(row, checker, snapshot);
+    ASSERT_TRUE(tuple.has_value());
+    EXPECT_EQ(tuple->getText(1), std::string(100, 'b'));
+  }
+}
+
+TEST_F(VacuumManagerTest, LaterVacuumsSkipAllVisiblePages)
+{
+  loadRows(200);
+  database::VacuumManager vacuum_manager(txn_manager_);
+  ASSERT_EQ(vacuum_manager.vacuum(heap_file_).pages_all_visible, heap_file_.getPageCount());
+
+  auto stats = vacuum_manager.vacuum(heap_file_);
+  EXPECT_EQ(stats.pages_scanned, 0);
+  EXPECT_EQ(stats.pages_skipped, heap_file_.getPageCount());
+
+  // Changing a row clears the bits of its page, so only that page is visited again
+  auto txn = txn_manager_.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  heap_file_.deleteTuple(rows_[0], txn);
+  ASSERT_TRUE(txn_manager_.commitTransaction(txn));
+  EXPECT_FALSE(heap_file_.getVisibilityMap().isAllVisible(rows_[0].first));
+
+  stats = vacuum_manager.vacuum(heap_file_);
+  EXPECT_EQ(stats.pages_scanned, 1);
+  EXPECT_EQ(stats.pages_pruned, 1);
+  EXPECT_EQ(stats.pages_all_visible, heap_file_.getPageCount());
+}
+
+TEST_F(VacuumManagerTest, RunningTransactionHoldsBackTheHorizon)
+{
+  loadRows(50);
+  auto reader = txn_manager_.beginTransaction(database::IsolationLevel::REPEATABLE_READ);
+  auto reader_snapshot = txn_manager_.takeSnapshot(reader);
+  auto original_rows = rows_;
+  updateRows('b');
+  database::VacuumManager vacuum_manager(txn_manager_);
+
+  // The reader may still see the old versions, so they stay and no page is all-visible
+  auto stats = vacuum_manager.vacuum(heap_file_);
+  EXPECT_EQ(stats.bytes_reclaimed, 0);
+  EXPECT_EQ(stats.pages_all_visible, 0);
+  database::VisibilityChecker checker(txn_manager_);
+  auto tuple = heap_file_.getVisibleTuple(original_rows[3], checker, reader_snapshot);
+  ASSERT_TRUE(tuple.has_value());
+  EXPECT_EQ(tuple->getText(1), std::string(100, 'a'));
+
+  ASSERT_TRUE(txn_manager_.commitTransaction(reader));
+  stats = vacuum_manager.vacuum(heap_file_);
+  EXPECT_GT(stats.bytes_reclaimed, 0);
+  EXPECT_EQ(stats.pages_all_visible, heap_file_.getPageCount());
+}
+
+TEST_F(VacuumManagerTest, AggressiveVacuumFreezesSoTheCommitLogCanBeTruncated)
+{
+  loadRows(200);
+  updateRows('b', false);  // Leaves aborted xmax on every row
+
+  // Push the oldest IDs past a whole commit log page
+  for (size_t i = 0; i < database::CommitLog::XIDS_PER_PAGE; ++i) {
+    auto txn = txn_manager_.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+    ASSERT_TRUE(txn_manager_.commitTransaction(txn));
+  }
+
+  database::VacuumOptions options;
+  options.freeze_min_age = 0;
+  database::VacuumManager vacuum_manager(txn_manager_, options);
+  auto stats = vacuum_manager.vacuum(heap_file_, true);
+  EXPECT_TRUE(stats.completed);
+  EXPECT_EQ(stats.pages_scanned, heap_file_.getPageCount());
+  EXPECT_EQ(stats.pages_all_frozen, heap_file_.getPageCount());
+  EXPECT_EQ(stats.frozen_xid, txn_manager_.getOldestActiveTransactionId());
+
+  // The hint bits now answer every status the commit log no longer has
+  size_t clog_pages = txn_manager_.getCommitLog().getPageCount();
+  txn_manager_.truncateCommitLog(stats.frozen_xid);
+  EXPECT_LT(txn_manager_.getCommitLog().getPageCount(), clog_pages);
+  database::VisibilityChecker checker(txn_manager_);
+  auto snapshot = txn_manager_.takeSnapshot();
+  for (const auto& row : rows_) {
+    auto tuple = heap_file_.getVisibleTuple(row, checker, snapshot);
+    ASSERT_TRUE(tuple.has_value());
+    EXPECT_EQ(tuple->getText(1), std::string(100, 'a'));
+  }
+
+  // All-frozen pages are skipped even by aggressive vacuums
+  EXPECT_EQ(vacuum_manager.vacuum(heap_file_, true).pages_skipped, heap_file_.getPageCount());
+}
+
+TEST_F(VacuumManagerTest, IndexCleanupComesBeforeDeadLinePointersAreFreed)
+{
+  loadRows(200);
+  auto deleter = txn_manager_.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  for (size_t i = 0; i < rows_.size(); i += 2) {
+    heap_file_.deleteTuple(rows_[i], deleter);
+  }
+  ASSERT_TRUE(txn_manager_.commitTransaction(deleter));
+  database::VacuumManager vacuum_manager(txn_manager_);
+  
+  // An index that cannot be cleaned yet keeps every deleted row's line pointer DEAD
+  std::vector<database::TupleId> cleaned;
+  auto stats = vacuum_manager.vacuum(heap_file_, false, [&](std::span<const database::TupleId> tuple_ids) {
+    cleaned.assign(tuple_ids.begin(), tuple_ids.end());
+    return false;
+  });
+  EXPECT_EQ(stats.index_cleanups, 1);
+  EXPECT_EQ(stats.dead_lines_freed, 0);
+  ASSERT_EQ(cleaned.size(), 100);
+  for (size_t i = 0; i < cleaned.size(); ++i) {
+    EXPECT_EQ(cleaned[i], rows_[2 * i]);
+  }
+  EXPECT_EQ(stats.pages_all_visible, 0);  // Revisited by the next vacuum
+  
+  // Once the index lets them go they are freed and reused by inserts
+  stats = vacuum_manager.vacuum(heap_file_, false, [](std::span<const database::TupleId> tuple_ids) {
+    return tuple_ids.size() == 100;
+  });
+  EXPECT_EQ(stats.dead_lines_freed, 100);
+  size_t pages = heap_file_.getPageCount();
+  auto txn = txn_manager_.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto reused = heap_file_.insertTuple(makeTuple(0, 'c', txn), txn);
+  ASSERT_NE(reused, nullptr);
+  EXPECT_TRUE(std::find(cleaned.begin(), cleaned.end(), *reused) != cleaned.end());
+  EXPECT_EQ(heap_file_.getPageCount(), pages);
+}
+
+TEST_F(VacuumManagerTest, TableWithoutIndexStaysFlatUnderInsertDeleteChurn)
+{
+  database::VacuumManager vacuum_manager(txn_manager_);
+  size_t pages = 0;
+  for (int round = 0; round < 20; ++round) {
+    rows_.clear();
+    loadRows(200);
+    auto deleter = txn_manager_.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+    for (const auto& row : rows_) {
+      heap_file_.deleteTuple(row, deleter);
+    }
+    ASSERT_TRUE(txn_manager_.commitTransaction(deleter));
+    
+    auto stats = vacuum_manager.vacuum(heap_file_);
+    EXPECT_EQ(stats.index_cleanups, 0);
+    EXPECT_EQ(stats.dead_lines_freed, 200);
+    if (round == 0) {
+      pages = heap_file_.getPageCount();
+    }
+  }
+  EXPECT_EQ(heap_file_.getPageCount(), pages);
+}
+
+TEST_F(VacuumManagerTest, PausesBetweenRounds)
+{
+  loadRows(200);
+  updateRows('b');
+  ASSERT_GE(heap_file_.getPageCount(), 4);
+
+  database::VacuumOptions options;
+  options.pages_per_round = 1;
+  options.round_delay = std::chrono::milliseconds(20);
+  database::VacuumManager vacuum_manager(txn_manager_, options);
+
+  auto start = std::chrono::steady_clock::now();
+  auto stats = vacuum_manager.vacuum(heap_file_);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_TRUE(stats.completed);
+  EXPECT_GE(elapsed, static_cast<int64_t>(stats.pages_scanned - 1) * options.round_delay);
+}
+
+TEST_F(VacuumManagerTest, VacuumResetsTheDeadTupleEstimate)
+{
+  loadRows(100);
+  updateRows('b');
+  EXPECT_EQ(heap_file_.getStats().read().dead_tuples, 100);
+
+  database::VacuumManager vacuum_manager(txn_manager_);
+  ASSERT_TRUE(vacuum_manager.vacuum(heap_file_).completed);
+  EXPECT_EQ(heap_file_.getStats().read().dead_tuples, 0);
+  EXPECT_EQ(heap_file_.getStats().read().updates, 100);
+}
+
+TEST_F(VacuumManagerTest, BackgroundWorkersVacuumRegisteredTables)
+{
+  std::mutex table_mutex;
+  {
+    std::lock_guard<std::mutex> lock(table_mutex);
+    loadRows(200);
+    updateRows('b');
+  }
+
+  database::VacuumOptions options;
+  options.interval = std::chrono::milliseconds(5);
+  options.round_delay = std::chrono::milliseconds(1);
+  database::VacuumManager vacuum_manager(txn_manager_, options);
+  vacuum_manager.addTable(heap_file_, table_mutex);
+
+  // Foreground work goes on under the table mutex while the worker runs
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (vacuum_manager.getVacuumCount() < 3 && std::chrono::steady_clock::now() < deadline) {
+    std::lock_guard<std::mutex> lock(table_mutex);
+    updateRows('c');
+  }
+  EXPECT_GE(vacuum_manager.getVacuumCount(), 3);
+  EXPECT_TRUE(vacuum_manager.getLastStats(heap_file_).completed);
+
+  vacuum_manager.removeTable(heap_file_);
+  EXPECT_EQ(vacuum_manager.getLastStats(heap_file_).pages_scanned, 0);  // Forgotten
+  auto stats = vacuum_manager.vacuum(heap_file_);
+  EXPECT_EQ(stats.pages_all_visible, heap_file_.getPageCount());
+}
+
+TEST_F(VacuumManagerTest, DestructionStopsBackgroundVacuumPartWay)
+{
+  std::mutex table_mutex;
+  loadRows(200);
+  updateRows('b');
+
+  database::VacuumOptions options;
+  options.interval = std::chrono::milliseconds(1);
+  options.pages_per_round = 1;
+  options.round_delay = std::chrono::hours(1);
+  auto start = std::chrono::steady_clock::now();
+  {
+    database::VacuumManager vacuum_manager(txn_manager_, options);
+    vacuum_manager.addTable(heap_file_, table_mutex);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::minutes(1));
+  EXPECT_LT(heap_file_.getVisibilityMap().countAllVisible(), heap_file_.getPageCount());
+}
+
+TEST_F(VacuumManagerTest, SchedulerSkipsTablesBelowTheThreshold)
+{
+  std::mutex table_mutex;
+  loadRows(100);
+  updateRows('b');
+  database::HeapFile quiet_table(2, schema_);
+  quiet_table.setTransactionManager(&txn_manager_);
+  auto txn = txn_manager_.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto tuple_id = quiet_table.insertTuple(makeTuple(1, 'a', txn), txn);
+  ASSERT_NE(quiet_table.updateTuple(*tuple_id, makeTuple(1, 'b', txn), txn), nullptr);
+  ASSERT_TRUE(txn_manager_.commitTransaction(txn));
+
+  database::VacuumOptions options;
+  options.interval = std::chrono::milliseconds(1);
+  database::VacuumManager vacuum_manager(txn_manager_, options);
+  vacuum_manager.addTable(heap_file_, table_mutex);
+  vacuum_manager.addTable(quiet_table, table_mutex);
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!vacuum_manager.getLastStats(heap_file_).completed && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));  // Many more scheduler checks
+  EXPECT_TRUE(vacuum_manager.getLastStats(heap_file_).completed);
+  EXPECT_FALSE(vacuum_manager.getLastStats(quiet_table).completed);  // 1 dead tuple, threshold 50
+  EXPECT_EQ(vacuum_manager.getVacuumCount(), 1);
+  vacuum_manager.removeTable(quiet_table);
+  vacuum_manager.removeTable(heap_file_);
+}
+
+TEST_F(VacuumManagerTest, FastestBloatingTableGoesFirst)
+{
+  // Two due tables, the fixture's with twice the dead tuples
+  std::mutex table_mutex;
+  std::mutex slow_table_mutex;
+  loadRows(200);
+  updateRows('b');
+  database::HeapFile slow_table(2, schema_);
+  slow_table.setTransactionManager(&txn_manager_);
+  for (int64_t i = 0; i < 100; ++i) {
+    auto txn = txn_manager_.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+    auto tuple_id = slow_table.insertTuple(makeTuple(i, 'a', txn), txn);
+    ASSERT_NE(slow_table.updateTuple(*tuple_id, makeTuple(i, 'b', txn), txn), nullptr);
+    ASSERT_TRUE(txn_manager_.commitTransaction(txn));
+  }
+
+  // The single worker blocks on the mutex of whichever table it takes first
+  std::unique_lock<std::mutex> lock(table_mutex);
+  std::unique_lock<std::mutex> slow_lock(slow_table_mutex);
+  database::VacuumOptions options;
+  options.interval = std::chrono::milliseconds(1);
+  database::VacuumManager vacuum_manager(txn_manager_, options);
+  vacuum_manager.addTable(slow_table, slow_table_mutex);
+  vacuum_manager.addTable(heap_file_, table_mutex);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  lock.unlock();
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!vacuum_manager.getLastStats(heap_file_).completed && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(vacuum_manager.getLastStats(heap_file_).completed);
+  EXPECT_FALSE(vacuum_manager.getLastStats(slow_table).completed);
+
+  slow_lock.unlock();
+  vacuum_manager.removeTable(heap_file_);
+  vacuum_manager.removeTable(slow_table);
+}
+
+TEST_F(VacuumManagerTest, WorkersVacuumTablesSideBySide)
+{
+  std::mutex table_mutex;
+  std::mutex other_table_mutex;
+  loadRows(200);
+  updateRows('b');
+  database::HeapFile other_table(2, schema_);
+  other_table.setTransactionManager(&txn_manager_);
+  for (int64_t i = 0; i < 100; ++i) {
+    auto txn = txn_manager_.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+    auto tuple_id = other_table.insertTuple(makeTuple(i, 'a', txn), txn);
+    ASSERT_NE(other_table.updateTuple(*tuple_id, makeTuple(i, 'b', txn), txn), nullptr);
+    ASSERT_TRUE(txn_manager_.commitTransaction(txn));
+  }
+
+  // One worker stays stuck on the faster-bloating fixture table; the other still gets through
+  std::unique_lock<std::mutex> lock(table_mutex);
+  database::VacuumOptions options;
+  options.interval = std::chrono::milliseconds(1);
+  options.workers = 2;
+  database::VacuumManager vacuum_manager(txn_manager_, options);
+  vacuum_manager.addTable(heap_file_, table_mutex);
+  vacuum_manager.addTable(other_table, other_table_mutex);
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!vacuum_manager.getLastStats(other_table).completed && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(vacuum_manager.getLastStats(other_table).completed);
+  EXPECT_FALSE(vacuum_manager.getLastStats(heap_file_).completed);
+
+  lock.unlock();
+  vacuum_manager.removeTable(heap_file_);
+  vacuum_manager.removeTable(other_table);
+}
+
+TEST_F(VacuumManagerTest, AggressiveVacuumsOfEveryTableTruncateTheCommitLog)
+{
+  std::mutex table_mutex;
+  loadRows(50);
+  // Enough transactions for several commit log pages
+  for (size_t i = 0; i < 2 * database::CommitLog::XIDS_PER_PAGE; ++i) {
+    auto txn = txn_manager_.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+    ASSERT_TRUE(txn_manager_.commitTransaction(txn));
+  }
+  size_t pages_before = txn_manager_.getCommitLog().getPageCount();
+  ASSERT_GE(pages_before, 3);
+
+  database::VacuumOptions options;
+  options.interval = std::chrono::milliseconds(1);
+  options.freeze_min_age = 0;
+  options.freeze_table_age = 0;
+  database::VacuumManager vacuum_manager(txn_manager_, options);
+  vacuum_manager.addTable(heap_file_, table_mutex);
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (vacuum_manager.getLastStats(heap_file_).frozen_xid == 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_GT(vacuum_manager.getLastStats(heap_file_).frozen_xid, 0);
+  vacuum_manager.removeTable(heap_file_);
+  EXPECT_LT(txn_manager_.getCommitLog().getPageCount(), pages_before);
+
+  // Every row was frozen, so it stays visible without the truncated pages
+  database::VisibilityChecker checker(txn_manager_);
+  auto snapshot = txn_manager_.takeSnapshot();
+  for (const auto& row : rows_) {
+    EXPECT_TRUE(heap_file_.getVisibleTuple(row, checker, snapshot).has_value());
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,220 @@
+#include "database/visibility_checker.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+database::TupleHeader versionOf(database::TransactionId xmin, database::TransactionId xmax = 0)
+{
+  database::TupleHeader header(xmin);
+  header.setXmax(xmax);
+  return header;
+}
+
+}  // namespace
+
+TEST(VisibilityCheckerTest, SeesOwnAndEarlierCommittedInserts)
+{
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+
+  auto writer = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto reader = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto row = versionOf(writer);
+
+  EXPECT_TRUE(checker.isVisible(row, txn_manager.takeSnapshot(writer)));
+  EXPECT_FALSE(checker.isVisible(row, txn_manager.takeSnapshot(reader)));
+
+  auto before_commit = txn_manager.takeSnapshot(reader);
+  ASSERT_TRUE(txn_manager.commitTransaction(writer));
+  auto after_commit = txn_manager.takeSnapshot(reader);
+  EXPECT_FALSE(checker.isVisible(row, before_commit));
+  EXPECT_TRUE(checker.isVisible(row, after_commit));
+  EXPECT_TRUE(checker.isVisible(row, txn_manager.takeSnapshot()));
+}
+
+TEST(VisibilityCheckerTest, AbortedInsertsAreNeverVisible)
+{
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+
+  auto writer = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto row = versionOf(writer);
+  ASSERT_TRUE(txn_manager.rollbackTransaction(writer));
+  EXPECT_FALSE(checker.isVisible(row, txn_manager.takeSnapshot()));
+
+  // Nor are versions whose creator this manager never saw
+  EXPECT_FALSE(checker.isVisible(versionOf(1000), txn_manager.takeSnapshot()));
+}
+
+TEST(VisibilityCheckerTest, DeletesHideVersionsOnceVisible)
+{
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+
+  auto creator = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  ASSERT_TRUE(txn_manager.commitTransaction(creator));
+  auto deleter = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto row = versionOf(creator, deleter);
+
+  // The deleter no longer sees the row, everyone else still does until it commits
+  EXPECT_FALSE(checker.isVisible(row, txn_manager.takeSnapshot(deleter)));
+  auto before_delete = txn_manager.takeSnapshot();
+  EXPECT_TRUE(checker.isVisible(row, before_delete));
+
+  ASSERT_TRUE(txn_manager.commitTransaction(deleter));
+  EXPECT_TRUE(checker.isVisible(row, before_delete));
+  EXPECT_FALSE(checker.isVisible(row, txn_manager.takeSnapshot()));
+
+  // An aborted delete leaves the row visible
+  auto aborted = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  ASSERT_TRUE(txn_manager.rollbackTransaction(aborted));
+  EXPECT_TRUE(checker.isVisible(versionOf(creator, aborted), txn_manager.takeSnapshot()));
+}
+
+TEST(VisibilityCheckerTest, TruncatedCreatorsAreVisibleToEveryone)
+{
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+
+  auto creator = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  ASSERT_TRUE(txn_manager.commitTransaction(creator));
+  auto old_snapshot = database::Snapshot{ database::CsnLog::FROZEN_CSN, 0 };
+  EXPECT_FALSE(checker.isVisible(versionOf(creator), old_snapshot));
+
+  for (size_t i = 0; i < database::CsnLog::XIDS_PER_PAGE; ++i) {
+    txn_manager.commitTransaction(txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED));
+  }
+  txn_manager.truncateCommitLog(database::CsnLog::XIDS_PER_PAGE);
+  EXPECT_TRUE(checker.isVisible(versionOf(creator), old_snapshot));
+}
+
+TEST(VisibilityCheckerTest, RecordsOutcomesInHintBits)
+{
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+  
+  auto creator = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto deleter = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto row = versionOf(creator, deleter);
+  
+  // Nothing is hinted while the transactions run
+  EXPECT_FALSE(checker.isVisible(row, txn_manager.takeSnapshot()));
+  EXPECT_EQ(row.getInfomask(), 0);
+  
+  ASSERT_TRUE(txn_manager.commitTransaction(creator));
+  ASSERT_TRUE(txn_manager.rollbackTransaction(deleter));
+  auto unhinted = row;
+  EXPECT_TRUE(checker.isVisible(unhinted, txn_manager.takeSnapshot(), false));
+  EXPECT_EQ(unhinted.getInfomask(), 0);
+  
+  EXPECT_TRUE(checker.isVisible(row, txn_manager.takeSnapshot()));
+  EXPECT_EQ(row.getInfomask(), database::TupleHeader::XMIN_COMMITTED | database::TupleHeader::XMAX_INVALID);
+  
+  auto aborted = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  ASSERT_TRUE(txn_manager.rollbackTransaction(aborted));
+  auto aborted_row = versionOf(aborted);
+  EXPECT_FALSE(checker.isVisible(aborted_row, txn_manager.takeSnapshot()));
+  EXPECT_EQ(aborted_row.getInfomask(), database::TupleHeader::XMIN_INVALID);
+}
+
+TEST(VisibilityCheckerTest, HintedVersionsOlderThanSnapshotXminNeedNoLookup)
+{
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+  
+  // Transactions this manager never saw look uncommitted, unless their versions say otherwise
+  auto snapshot = txn_manager.takeSnapshot();
+  snapshot.xmin = 2000;
+  auto hinted = versionOf(1000, 1500);
+  EXPECT_FALSE(checker.isVisible(hinted, snapshot));
+  hinted.setHintBits(database::TupleHeader::XMIN_COMMITTED | database::TupleHeader::XMAX_INVALID);
+  EXPECT_TRUE(checker.isVisible(hinted, snapshot));
+  hinted.setXmax(1700);
+  hinted.setHintBits(database::TupleHeader::XMAX_COMMITTED);
+  EXPECT_FALSE(checker.isVisible(hinted, snapshot));
+}
+
+TEST(VisibilityCheckerTest, CommitsAdvanceTheSnapshotXmin)
+{
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+  
+  auto old = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto creator = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  ASSERT_TRUE(txn_manager.commitTransaction(creator));
+  EXPECT_LE(txn_manager.takeSnapshot().xmin, old);
+  
+  ASSERT_TRUE(txn_manager.commitTransaction(old));
+  for (int i = 0; i < 64; ++i) {
+    txn_manager.commitTransaction(txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED));
+  }
+  auto snapshot = txn_manager.takeSnapshot();
+  EXPECT_GT(snapshot.xmin, creator);
+  EXPECT_LE(snapshot.xmin, txn_manager.getOldestActiveTransactionId());
+  
+  auto row = versionOf(creator);
+  EXPECT_TRUE(checker.isVisible(row, snapshot));
+  EXPECT_TRUE(row.hasHintBits(database::TupleHeader::XMIN_COMMITTED));
+}
+
+TEST(VisibilityCheckerTest, SnapshotVerdictsDoNotChangeUnderConcurrentCommits)
+{
+  constexpr size_t WRITERS = 4;
+  constexpr size_t TRANSACTIONS_PER_WRITER = 2000;
+  database::TransactionManager txn_manager;
+  database::VisibilityChecker checker(txn_manager);
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> writers;
+  for (size_t w = 0; w < WRITERS; ++w) {
+    writers.emplace_back([&] {
+      for (size_t i = 0; i < TRANSACTIONS_PER_WRITER; ++i) {
+        auto txn_id = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+        if (i % 3 == 0) {
+          txn_manager.rollbackTransaction(txn_id);
+        } else {
+          txn_manager.commitTransaction(txn_id);
+        }
+      }
+    });
+  }
+
+  // A snapshot must give the same answer for a transaction before and after
+  // it finishes, whether from a lookup or from hint bits left by earlier checks
+  std::vector<database::TupleHeader> rows;
+  for (database::TransactionId txn_id = 1; txn_id <= WRITERS * TRANSACTIONS_PER_WRITER; ++txn_id) {
+    rows.emplace_back(txn_id);
+  }
+  std::thread reader([&] {
+    while (!done.load()) {
+      auto snapshot = txn_manager.takeSnapshot();
+      database::TransactionId last = std::min<database::TransactionId>(
+          txn_manager.getOldestActiveTransactionId() + 16, rows.size());
+      std::vector<bool> first;
+      for (database::TransactionId txn_id = 1; txn_id <= last; ++txn_id) {
+        first.push_back(checker.isVisible(rows[txn_id - 1], snapshot));
+      }
+      for (database::TransactionId txn_id = 1; txn_id <= last; ++txn_id) {
+        ASSERT_EQ(checker.isVisible(rows[txn_id - 1], snapshot), first[txn_id - 1]) << "txn " << txn_id;
+        ASSERT_EQ(checker.isVisible(versionOf(txn_id), snapshot), first[txn_id - 1]) << "txn " << txn_id;
+      }
+    }
+  });
+
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  done.store(true);
+  reader.join();
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,52 @@
+#include "database/visibility_map.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(VisibilityMapTest, PagesStartWithNoBits)
+{
+  database::VisibilityMap map;
+  EXPECT_EQ(map.getBits(1), 0);
+  EXPECT_FALSE(map.isAllVisible(1000));
+  EXPECT_EQ(map.countAllVisible(), 0);
+}
+
+TEST(VisibilityMapTest, SetsAndClearsBitsPerPage)
+{
+  database::VisibilityMap map;
+  map.setBits(1, database::VisibilityMap::ALL_VISIBLE);
+  map.setBits(2, database::VisibilityMap::ALL_VISIBLE | database::VisibilityMap::ALL_FROZEN);
+  map.setBits(100, database::VisibilityMap::ALL_VISIBLE);
+
+  EXPECT_TRUE(map.isAllVisible(1));
+  EXPECT_FALSE(map.isAllFrozen(1));
+  EXPECT_TRUE(map.isAllFrozen(2));
+  EXPECT_FALSE(map.isAllVisible(3));
+  EXPECT_TRUE(map.isAllVisible(100));
+  EXPECT_EQ(map.countAllVisible(), 3);
+  EXPECT_EQ(map.countAllFrozen(), 1);
+
+  map.clear(2);
+  map.clear(5000);  // Never set
+  EXPECT_EQ(map.getBits(2), 0);
+  EXPECT_TRUE(map.isAllVisible(1));
+  EXPECT_EQ(map.countAllVisible(), 2);
+  EXPECT_EQ(map.countAllFrozen(), 0);
+}
+
+TEST(VisibilityMapTest, FrozenRequiresAllVisible)
+{
+  database::VisibilityMap map;
+  map.setBits(7, database::VisibilityMap::ALL_FROZEN);
+  EXPECT_EQ(map.getBits(7), 0);
+
+  map.setBits(7, database::VisibilityMap::ALL_VISIBLE | database::VisibilityMap::ALL_FROZEN);
+  map.setBits(7, database::VisibilityMap::ALL_VISIBLE);
+  EXPECT_TRUE(map.isAllVisible(7));
+  EXPECT_FALSE(map.isAllFrozen(7));
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,238 @@
+#include "database/write_ahead_log.hpp"
+#include "database/heap_file.hpp"
+#include "database/schema.hpp"
+#include "database/transaction_manager.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class WriteAheadLogTest : public ::testing::Test {
+protected:
+  void SetUp() override
+  {
+    path_ = ::testing::TempDir() + "write_ahead_log_test.log";
+    std::remove(path_.c_str());
+  }
+  
+  void TearDown() override
+  {
+    std::remove(path_.c_str());
+  }
+  
+  std::string path_;
+};
+
+std::vector<std::byte> bytes(const std::string& text)
+{
+  auto view = std::as_bytes(std::span(text.data(), text.size()));
+  return std::vector<std::byte>(view.begin(), view.end());
+}
+
+}  // namespace
+
+TEST_F(WriteAheadLogTest, AppendedRecordsAreReadBackAfterFlush)
+{
+  auto wal = database::WriteAheadLog::open(path_);
+  ASSERT_NE(wal, nullptr);
+  EXPECT_EQ(wal->getCurrentLsn(), 0);
+  
+  auto payload = bytes("tuple bytes");
+  database::Lsn insert_lsn = wal->append(database::WalRecordType::INSERT, 7, 3, std::make_pair(12, 4), payload);
+  database::Lsn commit_lsn = wal->append(database::WalRecordType::COMMIT, 7, 0, std::make_pair(0, 0));
+  EXPECT_EQ(insert_lsn, sizeof(database::WalRecordHeader) + payload.size());
+  EXPECT_EQ(commit_lsn, insert_lsn + sizeof(database::WalRecordHeader));
+  EXPECT_EQ(wal->getFlushedLsn(), 0);
+  
+  ASSERT_TRUE(wal->flush(commit_lsn));
+  EXPECT_EQ(wal->getFlushedLsn(), commit_lsn);
+  
+  auto records = database::WriteAheadLog::readAll(path_);
+  ASSERT_TRUE(records.has_value());
+  ASSERT_EQ(records->size(), 2);
+  const auto& insert = (*records)[0];
+  EXPECT_EQ(insert.type, database::WalRecordType::INSERT);
+  EXPECT_EQ(insert.txn_id, 7);
+  EXPECT_EQ(insert.table_id, 3);
+  EXPECT_EQ(insert.tuple_id, std::make_pair(database::PageId{12}, uint16_t{4}));
+  EXPECT_EQ(insert.lsn, insert_lsn);
+  EXPECT_EQ(insert.payload, payload);
+  EXPECT_EQ((*records)[1].type, database::WalRecordType::COMMIT);
+}
+
+TEST_F(WriteAheadLogTest, UnflushedRecordsAreNotOnDisk)
+{
+  auto wal = database::WriteAheadLog::open(path_);
+  ASSERT_NE(wal, nullptr);
+  wal->append(database::WalRecordType::DELETE, 1, 1, std::make_pair(1, 0));
+  
+  auto records = database::WriteAheadLog::readAll(path_);
+  ASSERT_TRUE(records.has_value());
+  EXPECT_TRUE(records->empty());
+}
+
+TEST_F(WriteAheadLogTest, ReopenContinuesAfterLastRecord)
+{
+  database::Lsn end_lsn = 0;
+  {
+    auto wal = database::WriteAheadLog::open(path_);
+    ASSERT_NE(wal, nullptr);
+    end_lsn = wal->append(database::WalRecordType::COMMIT, 1, 0, std::make_pair(0, 0));
+  }  // Destructor flushes
+  
+  auto wal = database::WriteAheadLog::open(path_);
+  ASSERT_NE(wal, nullptr);
+  EXPECT_EQ(wal->getCurrentLsn(), end_lsn);
+  EXPECT_EQ(wal->getFlushedLsn(), end_lsn);
+  ASSERT_TRUE(wal->flush(wal->append(database::WalRecordType::COMMIT, 2, 0, std::make_pair(0, 0))));
+  
+  auto records = database::WriteAheadLog::readAll(path_);
+  ASSERT_TRUE(records.has_value());
+  ASSERT_EQ(records->size(), 2);
+  EXPECT_EQ((*records)[1].txn_id, 2);
+}
+
+TEST_F(WriteAheadLogTest, TornTailIsTruncatedOnOpen)
+{
+  database::Lsn end_lsn = 0;
+  {
+    auto wal = database::WriteAheadLog::open(path_);
+    ASSERT_NE(wal, nullptr);
+    end_lsn = wal->append(database::WalRecordType::INSERT, 1, 1, std::make_pair(1, 0), bytes("complete"));
+  }
+  {
+    // Simulate a crash part way through writing the next record
+    std::ofstream out(path_, std::ios::binary | std::ios::app);
+    out << "partial record";
+  }
+  
+  auto wal = database::WriteAheadLog::open(path_);
+  ASSERT_NE(wal, nullptr);
+  EXPECT_EQ(wal->getCurrentLsn(), end_lsn);
+  
+  auto records = database::WriteAheadLog::readAll(path_);
+  ASSERT_TRUE(records.has_value());
+  EXPECT_EQ(records->size(), 1);
+}
+
+TEST_F(WriteAheadLogTest, ReadAllStartsAtGivenLsn)
+{
+  auto wal = database::WriteAheadLog::open(path_);
+  ASSERT_NE(wal, nullptr);
+  database::Lsn first_lsn = wal->append(database::WalRecordType::INSERT, 1, 1, std::make_pair(1, 0), bytes("one"));
+  database::Lsn second_lsn = wal->append(database::WalRecordType::INSERT, 1, 1, std::make_pair(1, 1), bytes("two"));
+  ASSERT_TRUE(wal->flushAll());
+  
+  auto records = database::WriteAheadLog::readAll(path_, first_lsn);
+  ASSERT_TRUE(records.has_value());
+  ASSERT_EQ(records->size(), 1);
+  EXPECT_EQ((*records)[0].lsn, second_lsn);
+  EXPECT_EQ((*records)[0].payload, bytes("two"));
+  
+  EXPECT_TRUE(database::WriteAheadLog::readAll(path_, second_lsn)->empty());
+  EXPECT_FALSE(database::WriteAheadLog::readAll(path_, second_lsn + 1).has_value());
+}
+
+TEST_F(WriteAheadLogTest, ConcurrentCommitsShareFlushes)
+{
+  database::WalOptions options;
+  options.group_commit_delay = std::chrono::microseconds(2000);
+  options.group_commit_size = 4;
+  auto wal = database::WriteAheadLog::open(path_, options);
+  ASSERT_NE(wal, nullptr);
+  
+  constexpr int THREADS = 8;
+  constexpr int COMMITS_PER_THREAD = 25;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&wal, t] {
+      for (int i = 0; i < COMMITS_PER_THREAD; ++i) {
+        auto txn_id = static_cast<database::TransactionId>(t * COMMITS_PER_THREAD + i + 1);
+        database::Lsn lsn = wal->append(database::WalRecordType::COMMIT, txn_id, 0, std::make_pair(0, 0));
+        EXPECT_TRUE(wal->flush(lsn));
+        EXPECT_GE(wal->getFlushedLsn(), lsn);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  
+  EXPECT_LT(wal->getSyncCount(), static_cast<uint64_t>(THREADS * COMMITS_PER_THREAD));
+  auto records = database::WriteAheadLog::readAll(path_);
+  ASSERT_TRUE(records.has_value());
+  EXPECT_EQ(records->size(), static_cast<size_t>(THREADS * COMMITS_PER_THREAD));
+}
+
+TEST_F(WriteAheadLogTest, HeapFileLogsChangesAndStampsPages)
+{
+  auto wal = database::WriteAheadLog::open(path_);
+  ASSERT_NE(wal, nullptr);
+  database::Schema schema;
+  schema.addColumn(database::Column(0, "id", database::DataType::INTEGER, false, true));
+  database::HeapFile heap_file(1, schema);
+  heap_file.setWriteAheadLog(wal.get());
+  
+  database::Tuple tuple(schema, {database::Value{int64_t{1}}}, 10);
+  auto tuple_id = heap_file.insertTuple(tuple, 10);
+  ASSERT_NE(tuple_id, nullptr);
+  database::Tuple updated(schema, {database::Value{int64_t{2}}}, 10);
+  auto updated_id = heap_file.updateTuple(*tuple_id, updated, 10);
+  ASSERT_NE(updated_id, nullptr);
+  heap_file.deleteTuple(*updated_id, 10);
+  ASSERT_TRUE(wal->flushAll());
+  
+  // The update inserts the new version and rewrites the old one's header; the delete rewrites its header too
+  auto records = database::WriteAheadLog::readAll(path_);
+  ASSERT_TRUE(records.has_value());
+  ASSERT_EQ(records->size(), 4);
+  EXPECT_EQ((*records)[0].type, database::WalRecordType::INSERT);
+  EXPECT_EQ((*records)[1].type, database::WalRecordType::INSERT);
+  EXPECT_EQ((*records)[2].type, database::WalRecordType::UPDATE);
+  EXPECT_EQ((*records)[3].type, database::WalRecordType::UPDATE);
+  std::vector<database::TupleId> expected_ids = { *tuple_id, *updated_id, *tuple_id, *updated_id };
+  for (size_t i = 0; i < records->size(); ++i) {
+    EXPECT_EQ((*records)[i].table_id, 1);
+    EXPECT_EQ((*records)[i].tuple_id, expected_ids[i]);
+  }
+  
+  // The INSERT payload is the serialized tuple
+  auto restored = database::Tuple::deserialize(schema, (*records)[0].payload.data(), (*records)[0].payload.size());
+  ASSERT_TRUE(restored.has_value());
+  EXPECT_EQ(std::get<int64_t>(*restored->getValue(0)), 1);
+}
+
+TEST_F(WriteAheadLogTest, TransactionManagerCommitIsDurable)
+{
+  auto wal = database::WriteAheadLog::open(path_);
+  ASSERT_NE(wal, nullptr);
+  database::TransactionManager txn_manager(*wal);
+  
+  auto committed = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  auto aborted = txn_manager.beginTransaction(database::IsolationLevel::READ_COMMITTED);
+  ASSERT_TRUE(txn_manager.rollbackTransaction(aborted));
+  ASSERT_TRUE(txn_manager.commitTransaction(committed));
+  EXPECT_EQ(txn_manager.getTransactionStatus(committed), database::TransactionStatus::COMMITTED);
+  EXPECT_EQ(txn_manager.getTransactionStatus(aborted), database::TransactionStatus::ABORTED);
+  EXPECT_FALSE(txn_manager.commitTransaction(committed));
+  
+  // The commit flushed everything before it, including the abort record
+  auto records = database::WriteAheadLog::readAll(path_);
+  ASSERT_TRUE(records.has_value());
+  ASSERT_EQ(records->size(), 2);
+  EXPECT_EQ((*records)[0].type, database::WalRecordType::ABORT);
+  EXPECT_EQ((*records)[0].txn_id, aborted);
+  EXPECT_EQ((*records)[1].type, database::WalRecordType::COMMIT);
+  EXPECT_EQ((*records)[1].txn_id, committed);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}